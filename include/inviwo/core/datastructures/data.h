@@ -125,6 +125,14 @@ public:
     template <typename T>
     bool hasRepresentation() const;
 
+    /**
+     * Check if a specific representation type exists and is valid, i.e. can be used without
+     * first being updated from another representation.
+     * @return true if existing and valid, false otherwise.
+     */
+    template <typename T>
+    bool hasValidRepresentation() const;
+
     /**
      * Check if the Data object has any representation.
      * @return true if any representation exist, false otherwise.
@@ -258,6 +266,14 @@ bool Data<Self, Repr>::hasRepresentation() const {
     return util::has_key(representations_, std::type_index(typeid(T)));
 }
 
+template <typename Self, typename Repr>
+template <typename T>
+bool Data<Self, Repr>::hasValidRepresentation() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = representations_.find(std::type_index(typeid(T)));
+    return it != representations_.end() && it->second->isValid();
+}
+
 template <typename Self, typename Repr>
 void Data<Self, Repr>::invalidateAllOther(const Repr* repr) {
     bool found = false;
@@ -32,7 +32,12 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/util/glm.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace inviwo {
@@ -76,6 +81,7 @@ protected:
 class IVW_CORE_API HistogramContainer {
 public:
     HistogramContainer() = default;
+    explicit HistogramContainer(std::vector<NormalizedHistogram> histograms);
     template <typename FirstIter, typename LastIter>
     HistogramContainer(dvec2 range, size_t bins, FirstIter begin, LastIter end);
 
@@ -94,66 +100,229 @@ private:
     std::vector<NormalizedHistogram> histograms_;
 };
 
-template <typename FirstIter, typename LastIter>
-HistogramContainer::HistogramContainer(dvec2 dataRange, size_t bins, FirstIter begin,
-                                       LastIter end) {
-    using T = typename std::iterator_traits<FirstIter>::value_type;
+namespace util {
+
+/**
+ * \brief Accumulates one histogram per component of values of type T.
+ *
+ * Values can be added in several parts, for example brick by brick, and builders of different
+ * parts can be merged, for example when the parts are processed in parallel. The histograms are
+ * created with finish().
+ *
+ * Bins are counted in integers. The mean and standard deviation are accumulated block by block
+ * using the deviations from the block mean, and blocks are merged with the pairwise update of Chan
+ * et al., which avoids the cancellation of summing squares. Scalar 8 and 16-bit integers are only
+ * counted per value without any conversion to double, bins and statistics are then computed
+ * exactly from the value counts in finish().
+ */
+template <typename T>
+class HistogramBuilder {
+public:
+    HistogramBuilder(dvec2 dataRange, size_t bins);
+
+    /**
+     * Add the values in [begin, end). The range is traversed twice, so the iterators must be at
+     * least forward iterators.
+     */
+    template <typename FirstIter, typename LastIter>
+    void add(FirstIter begin, LastIter end);
+
+    /**
+     * Add all values of \p other, which has to be created with the same data range and bins.
+     */
+    void merge(const HistogramBuilder<T>& other);
+
+    size_t getCount() const { return count_; }
 
+    std::vector<NormalizedHistogram> finish() const;
+
+private:
     // a double type with the same extent as T
     using D = typename util::same_extent<T, double>::type;
-    // a size_t type with same extent as T
-    using I = typename util::same_extent<T, size_t>::type;
 
-    constexpr size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    static constexpr size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    static constexpr bool countValues =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 2;
+    static constexpr size_t blockSize = 4096;
 
+    void mergeMoments(size_t count, const D& mean, const D& m2);
+
+    dvec2 dataRange_;
+    size_t bins_;
+    double rangeMin_;
+    double rangeScaleFactor_;
+
+    std::array<std::vector<std::uint64_t>, extent> counts_;
+    // Number of occurrences of each value, only used if countValues
+    std::vector<std::uint64_t> valueCounts_;
+
+    size_t count_{0};
+    D min_{std::numeric_limits<double>::max()};
+    D max_{std::numeric_limits<double>::lowest()};
+    D mean_{0};
+    D m2_{0};  // sum of squared deviations from the mean
+};
+
+template <typename T>
+HistogramBuilder<T>::HistogramBuilder(dvec2 dataRange, size_t bins)
+    : dataRange_{dataRange}, bins_{bins} {
     // check whether number of bins exceeds the data range only if it is an integral type
     if constexpr (!util::is_floating_point<typename util::value_type<T>::type>::value) {
-        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
+        bins_ = std::min(bins_, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
     }
+    rangeMin_ = dataRange_.x;
+    rangeScaleFactor_ = static_cast<double>(bins_ - 1) / (dataRange_.y - dataRange_.x);
 
-    std::array<std::vector<double>, extent> histData;
-    for (size_t i = 0; i < extent; ++i) {
-        histData[i].resize(bins, 0.0);
+    if constexpr (countValues) {
+        valueCounts_.resize(size_t{1} << (8 * sizeof(T)), 0);
+    } else {
+        for (size_t i = 0; i < extent; ++i) {
+            counts_[i].resize(bins_, 0);
+        }
     }
+}
 
-    D min(std::numeric_limits<double>::max());
-    D max(std::numeric_limits<double>::lowest());
-    D sum(0);
-    D sum2(0);
-    size_t count(0);
-
-    const D rangeMin(dataRange.x);
-    const D rangeScaleFactor(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
-
-    for (; begin != end; ++begin) {
-
-        const auto val = static_cast<D>(*begin);
+template <typename T>
+template <typename FirstIter, typename LastIter>
+void HistogramBuilder<T>::add(FirstIter begin, LastIter end) {
+    if constexpr (countValues) {
+        using U = std::make_unsigned_t<T>;
+        size_t count = 0;
+        for (; begin != end; ++begin, ++count) {
+            ++valueCounts_[static_cast<U>(*begin)];
+        }
+        count_ += count;
+    } else {
+        const D rangeMin(rangeMin_);
+        const D rangeScaleFactor(rangeScaleFactor_);
+        const auto bins = static_cast<double>(bins_);
+
+        while (begin != end) {
+            // first pass over a block: bins, min, max and sum
+            const auto blockBegin = begin;
+            size_t count = 0;
+            D sum{0};
+            for (; begin != end && count < blockSize; ++begin, ++count) {
+                const auto val = static_cast<D>(*begin);
+
+                min_ = glm::min(min_, val);
+                max_ = glm::max(max_, val);
+                sum += val;
+
+                const D ind = (val - rangeMin) * rangeScaleFactor;
+                for (size_t i = 0; i < extent; ++i) {
+                    const auto v = util::glmcomp(ind, i);
+                    if (v >= 0.0 && v < bins) {
+                        ++counts_[i][static_cast<size_t>(v)];
+                    }
+                }
+            }
 
-        min = glm::min(min, val);
-        max = glm::max(max, val);
-        sum += val;
-        sum2 += val * val;
-        count++;
+            // second pass: squared deviations from the block mean
+            const D mean = sum / static_cast<double>(count);
+            D m2{0};
+            for (auto it = blockBegin; it != begin; ++it) {
+                const D delta = static_cast<D>(*it) - mean;
+                m2 += delta * delta;
+            }
+            mergeMoments(count, mean, m2);
+        }
+    }
+}
 
-        const auto ind = static_cast<I>((val - rangeMin) * rangeScaleFactor);
+template <typename T>
+void HistogramBuilder<T>::mergeMoments(size_t count, const D& mean, const D& m2) {
+    if (count == 0) return;
+    const auto nA = static_cast<double>(count_);
+    const auto nB = static_cast<double>(count);
+    const auto n = nA + nB;
+
+    const D delta = mean - mean_;
+    mean_ += delta * (nB / n);
+    m2_ += m2 + delta * delta * (nA * nB / n);
+    count_ += count;
+}
 
+template <typename T>
+void HistogramBuilder<T>::merge(const HistogramBuilder<T>& other) {
+    if constexpr (countValues) {
+        for (size_t i = 0; i < valueCounts_.size(); ++i) {
+            valueCounts_[i] += other.valueCounts_[i];
+        }
+        count_ += other.count_;
+    } else {
         for (size_t i = 0; i < extent; ++i) {
-            const auto v = util::glmcomp(ind, i);
-            if (v < bins) {
-                histData[i][v]++;
+            for (size_t j = 0; j < bins_; ++j) {
+                counts_[i][j] += other.counts_[i][j];
             }
         }
+        min_ = glm::min(min_, other.min_);
+        max_ = glm::max(max_, other.max_);
+        mergeMoments(other.count_, other.mean_, other.m2_);
     }
+}
 
-    const auto dcount = static_cast<double>(count);
-    const auto mean = sum / dcount;
-    const auto stddev = glm::sqrt((dcount * sum2 - sum * sum) / (dcount * (dcount - D{1})));
+template <typename T>
+std::vector<NormalizedHistogram> HistogramBuilder<T>::finish() const {
+    std::array<std::vector<double>, extent> histData;
+    D min = min_;
+    D max = max_;
+    D mean = mean_;
+    D m2 = m2_;
+
+    if constexpr (countValues) {
+        using U = std::make_unsigned_t<T>;
+        const auto bins = static_cast<double>(bins_);
+        histData[0].resize(bins_, 0.0);
+
+        double sum = 0.0;
+        for (size_t i = 0; i < valueCounts_.size(); ++i) {
+            if (const auto c = valueCounts_[i]) {
+                const auto val = static_cast<double>(static_cast<T>(static_cast<U>(i)));
+                min = std::min(min, val);
+                max = std::max(max, val);
+                sum += static_cast<double>(c) * val;
+
+                const auto ind = (val - rangeMin_) * rangeScaleFactor_;
+                if (ind >= 0.0 && ind < bins) {
+                    histData[0][static_cast<size_t>(ind)] += static_cast<double>(c);
+                }
+            }
+        }
+        mean = sum / static_cast<double>(count_);
+        for (size_t i = 0; i < valueCounts_.size(); ++i) {
+            if (const auto c = valueCounts_[i]) {
+                const auto delta = static_cast<double>(static_cast<T>(static_cast<U>(i))) - mean;
+                m2 += static_cast<double>(c) * delta * delta;
+            }
+        }
+    } else {
+        for (size_t i = 0; i < extent; ++i) {
+            histData[i].assign(counts_[i].begin(), counts_[i].end());
+        }
+    }
 
+    const auto stddev = glm::sqrt(m2 / (static_cast<double>(count_) - 1.0));
+
+    std::vector<NormalizedHistogram> histograms;
     for (size_t i = 0; i < extent; ++i) {
-        histograms_.emplace_back(dataRange, std::move(histData[i]), util::glmcomp(min, i),
-                                 util::glmcomp(max, i), util::glmcomp(mean, i),
-                                 util::glmcomp(stddev, i));
+        histograms.emplace_back(dataRange_, std::move(histData[i]), util::glmcomp(min, i),
+                                util::glmcomp(max, i), util::glmcomp(mean, i),
+                                util::glmcomp(stddev, i));
     }
+    return histograms;
+}
+
+}  // namespace util
+
+template <typename FirstIter, typename LastIter>
+HistogramContainer::HistogramContainer(dvec2 dataRange, size_t bins, FirstIter begin,
+                                       LastIter end) {
+    using T = typename std::iterator_traits<FirstIter>::value_type;
+
+    util::HistogramBuilder<T> builder(dataRange, bins);
+    builder.add(begin, end);
+    histograms_ = builder.finish();
 }
 
 }  // namespace inviwo
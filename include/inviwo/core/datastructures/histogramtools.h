@@ -41,6 +41,7 @@
 namespace inviwo {
 
 class HistogramSupplier;
+class VolumeBricked;
 
 class IVW_CORE_API HistogramCalculationState {
 public:
@@ -55,6 +56,13 @@ public:
     ~HistogramCalculationState() { *stop_ = true; }
 
     void whenDone(std::function<void(const HistogramContainer&)> callback);
+    /**
+     * Register a callback that receives partial histograms while the calculation is running,
+     * together with the fraction of the data that they include. Partial histograms are delivered
+     * in the main thread, at most about ten times per calculation. The callback is not called
+     * after the calculation is done, use whenDone for the final histograms.
+     */
+    void whenProgress(std::function<void(const HistogramContainer&, double)> callback);
 
     size_t getBins() const { return bins_; }
     dvec2 getDataRange() const { return dataRange_; }
@@ -63,6 +71,9 @@ private:
     std::weak_ptr<HistogramContainer> container_;
     Dispatcher<void(const HistogramContainer&)> callbacks_;
     std::vector<std::shared_ptr<std::function<void(const HistogramContainer&)>>> callbackHandles_;
+    Dispatcher<void(const HistogramContainer&, double)> progressCallbacks_;
+    std::vector<std::shared_ptr<std::function<void(const HistogramContainer&, double)>>>
+        progressCallbackHandles_;
     std::shared_ptr<std::atomic<bool>> stop_;
     bool done = false;
 
@@ -85,12 +96,31 @@ public:
     HistogramContainer& getHistograms() { return *histograms_; }
 
 protected:
+    /**
+     * Calculate the histograms on the thread pool. The data is split into chunks that are
+     * processed in parallel and then merged.
+     */
     std::shared_ptr<HistogramCalculationState> startCalculation(
         std::shared_ptr<const VolumeRAM> volumeRam, dvec2 dataRange, size_t bins) const;
+    /**
+     * Calculate the histograms brick by brick without loading all of the volume.
+     */
+    std::shared_ptr<HistogramCalculationState> startCalculation(
+        std::shared_ptr<const VolumeBricked> volumeBricked, dvec2 dataRange, size_t bins) const;
 
 private:
+    bool newCalculation(dvec2 dataRange, size_t bins) const;
+    /**
+     * Run job(i, builder) for i in [0, jobs) on the thread pool, each with its own builder, and
+     * merge the builders into the final histograms.
+     */
+    template <typename T, typename Job>
+    static void calculate(const std::shared_ptr<HistogramCalculationState>& state, size_t jobs,
+                          Job job);
     static void done(std::shared_ptr<HistogramCalculationState> state,
                      HistogramContainer histograms);
+    static void progress(std::shared_ptr<HistogramCalculationState> state,
+                         const HistogramContainer& histograms, double fraction);
 
     mutable std::shared_ptr<HistogramCalculationState> calculation_;
     mutable std::shared_ptr<HistogramContainer> histograms_;
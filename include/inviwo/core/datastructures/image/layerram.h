@@ -31,6 +31,7 @@
 
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/datastructures/image/layerrepresentation.h>
+#include <inviwo/core/datastructures/minmaxcache.h>
 #include <inviwo/core/util/formats.h>
 #include <inviwo/core/util/assertion.h>
 #include <inviwo/core/util/formatdispatching.h>
@@ -86,6 +87,12 @@ public:
 
     virtual std::type_index getTypeIndex() const override final;
 
+    /**
+     * Cached component-wise min and max values of the data, cleared by all non-const functions
+     * that give access to the data. \see util::layerMinMax
+     */
+    MinMaxCache& getMinMaxCache() const { return minMax_; }
+
     /**
      * Dispatch functionality to retrieve the actual underlaying LayerRamPrecision.
      * The dispatcher takes a generic lambda as argument. Code will be instantiated for all the
@@ -140,6 +147,9 @@ public:
     template <typename Result, template <class> class Predicate = dispatching::filter::All,
               typename Callable, typename... Args>
     auto dispatch(Callable&& callable, Args&&... args) const -> Result;
+
+protected:
+    mutable MinMaxCache minMax_;
 };
 
 size_t inline LayerRAM::posToIndex(const size2_t& pos, const size2_t& dim) {
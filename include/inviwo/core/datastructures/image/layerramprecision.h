@@ -30,6 +30,7 @@
 #pragma once
 
 #include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/ramallocation.h>
 
 #include <algorithm>
 
@@ -48,6 +49,15 @@ public:
                                const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                                InterpolationType interpolation = InterpolationType::Linear,
                                const Wrapping2D& wrap = wrapping2d::clampAll);
+    /**
+     * Allocate the data according to \p allocation, see RAMAllocation. RAMAllocation::Zeroed
+     * initializes color layers to zero and depth layers to one, all other policies leave the
+     * data uninitialized. The policy is also used when the dimensions change.
+     */
+    LayerRAMPrecision(size2_t dimensions, LayerType type, RAMAllocation allocation,
+                      const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                      InterpolationType interpolation = InterpolationType::Linear,
+                      const Wrapping2D& wrap = wrapping2d::clampAll);
     LayerRAMPrecision(T* data, size2_t dimensions, LayerType type = LayerType::Color,
                       const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                       InterpolationType interpolation = InterpolationType::Linear,
@@ -55,7 +65,7 @@ public:
     LayerRAMPrecision(const LayerRAMPrecision<T>& rhs);
     LayerRAMPrecision<T>& operator=(const LayerRAMPrecision<T>& that);
     virtual LayerRAMPrecision<T>* clone() const override;
-    virtual ~LayerRAMPrecision() = default;
+    virtual ~LayerRAMPrecision();
 
     T* getDataTyped();
     const T* getDataTyped() const;
@@ -100,12 +110,18 @@ public:
     virtual void setFromNormalizedDVec3(const size2_t& pos, dvec3 val) override;
     virtual void setFromNormalizedDVec4(const size2_t& pos, dvec4 val) override;
 
+    RAMAllocation getAllocation() const;
+
 private:
+    void allocate(size2_t dimensions);
+
     size2_t dimensions_;
     std::unique_ptr<T[]> data_;
+    std::shared_ptr<void> dataOwner_;  // owns data_ if set, see RAMAllocation
     SwizzleMask swizzleMask_;
     InterpolationType interpolation_;
     Wrapping2D wrapping_;
+    RAMAllocation allocation_;
 };
 
 /**
@@ -124,30 +140,64 @@ IVW_CORE_API std::shared_ptr<LayerRAM> createLayerRAM(
     InterpolationType interpolation = InterpolationType::Linear,
     const Wrapping2D& wrapping = wrapping2d::clampAll);
 
+/**
+ * Factory for layers with a specific allocation policy, see RAMAllocation.
+ *
+ * @param dimensions of layer to create.
+ * @param type of layer to create.
+ * @param format of layer to create.
+ * @param allocation how to allocate the data.
+ * @return nullptr if no valid format was specified.
+ */
+IVW_CORE_API std::shared_ptr<LayerRAM> createLayerRAM(
+    const size2_t& dimensions, LayerType type, const DataFormatBase* format,
+    RAMAllocation allocation, const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+    InterpolationType interpolation = InterpolationType::Linear,
+    const Wrapping2D& wrapping = wrapping2d::clampAll);
+
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask,
                                         InterpolationType interpolation, const Wrapping2D& wrapping)
     : LayerRAM(type, DataFormat<T>::get())
     , dimensions_(dimensions)
-    , data_(new T[dimensions_.x * dimensions_.y]())
+    , data_(new T[dimensions_.x * dimensions_.y])
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
-    , wrapping_{wrapping} {
+    , wrapping_{wrapping}
+    , allocation_{RAMAllocation::Zeroed} {
     std::fill(data_.get(), data_.get() + glm::compMul(dimensions_),
               (type == LayerType::Depth) ? T{1} : T{0});
 }
 
+template <typename T>
+LayerRAMPrecision<T>::LayerRAMPrecision(size2_t dimensions, LayerType type,
+                                        RAMAllocation allocation, const SwizzleMask& swizzleMask,
+                                        InterpolationType interpolation, const Wrapping2D& wrapping)
+    : LayerRAM(type, DataFormat<T>::get())
+    , dimensions_(0)
+    , data_()
+    , swizzleMask_(swizzleMask)
+    , interpolation_{interpolation}
+    , wrapping_{wrapping}
+    , allocation_{allocation} {
+    allocate(dimensions);
+    if (allocation_ == RAMAllocation::Zeroed && type == LayerType::Depth) {
+        std::fill(data_.get(), data_.get() + glm::compMul(dimensions_), T{1});
+    }
+}
+
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask,
                                         InterpolationType interpolation, const Wrapping2D& wrapping)
     : LayerRAM(type, DataFormat<T>::get())
     , dimensions_(dimensions)
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y]())
+    , data_(data ? data : new T[dimensions_.x * dimensions_.y])
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
-    , wrapping_{wrapping} {
+    , wrapping_{wrapping}
+    , allocation_{RAMAllocation::Zeroed} {
     if (!data) {
         std::fill(data_.get(), data_.get() + glm::compMul(dimensions_),
                   (type == LayerType::Depth) ? T{1} : T{0});
@@ -158,10 +208,13 @@ template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(const LayerRAMPrecision<T>& rhs)
     : LayerRAM(rhs)
     , dimensions_(rhs.dimensions_)
-    , data_(new T[dimensions_.x * dimensions_.y])
+    , data_(rhs.allocation_ == RAMAllocation::Zeroed ? new T[dimensions_.x * dimensions_.y]
+                                                     : nullptr)
     , swizzleMask_(rhs.swizzleMask_)
     , interpolation_{rhs.interpolation_}
-    , wrapping_{rhs.wrapping_} {
+    , wrapping_{rhs.wrapping_}
+    , allocation_{rhs.allocation_} {
+    if (!data_) allocate(dimensions_);
     std::memcpy(data_.get(), rhs.data_.get(), dimensions_.x * dimensions_.y * sizeof(T));
 }
 
@@ -170,12 +223,10 @@ LayerRAMPrecision<T>& LayerRAMPrecision<T>::operator=(const LayerRAMPrecision<T>
     if (this != &that) {
         LayerRAM::operator=(that);
 
-        const auto dim = that.dimensions_;
-        auto data = std::make_unique<T[]>(dim.x * dim.y);
-        std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * sizeof(T));
-        data_.swap(data);
+        allocation_ = that.allocation_;
+        allocate(that.dimensions_);
+        std::memcpy(data_.get(), that.data_.get(), dimensions_.x * dimensions_.y * sizeof(T));
 
-        dimensions_ = that.dimensions_;
         swizzleMask_ = that.swizzleMask_;
         interpolation_ = that.interpolation_;
         wrapping_ = that.wrapping_;
@@ -183,6 +234,11 @@ LayerRAMPrecision<T>& LayerRAMPrecision<T>::operator=(const LayerRAMPrecision<T>
     return *this;
 }
 
+template <typename T>
+LayerRAMPrecision<T>::~LayerRAMPrecision() {
+    if (dataOwner_) data_.release();
+}
+
 template <typename T>
 LayerRAMPrecision<T>* LayerRAMPrecision<T>::clone() const {
     return new LayerRAMPrecision<T>(*this);
@@ -190,6 +246,7 @@ LayerRAMPrecision<T>* LayerRAMPrecision<T>::clone() const {
 
 template <typename T>
 T* inviwo::LayerRAMPrecision<T>::getDataTyped() {
+    minMax_.clear();
     return data_.get();
 }
 
@@ -200,6 +257,7 @@ const T* inviwo::LayerRAMPrecision<T>::getDataTyped() const {
 
 template <typename T>
 void* LayerRAMPrecision<T>::getData() {
+    minMax_.clear();
     return data_.get();
 }
 template <typename T>
@@ -209,18 +267,40 @@ const void* LayerRAMPrecision<T>::getData() const {
 
 template <typename T>
 void inviwo::LayerRAMPrecision<T>::setData(void* d, size2_t dimensions) {
+    minMax_.clear();
     std::unique_ptr<T[]> data(static_cast<T*>(d));
     data_.swap(data);
+    if (dataOwner_) data.release();
+    dataOwner_.reset();
     std::swap(dimensions_, dimensions);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setDimensions(size2_t dimensions) {
-    if (dimensions != dimensions_) {
-        auto data = std::make_unique<T[]>(dimensions.x * dimensions.y);
-        data_.swap(data);
-        std::swap(dimensions, dimensions_);
+    minMax_.clear();
+    if (dimensions != dimensions_) allocate(dimensions);
+}
+
+template <typename T>
+void LayerRAMPrecision<T>::allocate(size2_t dimensions) {
+    const size_t size = dimensions.x * dimensions.y;
+    std::unique_ptr<T[]> data;
+    std::shared_ptr<void> owner;
+    if (allocation_ == RAMAllocation::Zeroed) {
+        data.reset(new T[size]());
+    } else {
+        owner = util::allocateRAM(size * sizeof(T), allocation_);
+        data.reset(static_cast<T*>(owner.get()));
     }
+    data_.swap(data);
+    if (dataOwner_) data.release();
+    dataOwner_ = std::move(owner);
+    dimensions_ = dimensions;
+}
+
+template <typename T>
+RAMAllocation LayerRAMPrecision<T>::getAllocation() const {
+    return allocation_;
 }
 
 template <typename T>
@@ -280,21 +360,25 @@ dvec4 LayerRAMPrecision<T>::getAsDVec4(const size2_t& pos) const {
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDouble(const size2_t& pos, double val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec2(const size2_t& pos, dvec2 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec3(const size2_t& pos, dvec3 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec4(const size2_t& pos, dvec4 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
@@ -320,21 +404,25 @@ dvec4 LayerRAMPrecision<T>::getAsNormalizedDVec4(const size2_t& pos) const {
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDouble(const size2_t& pos, double val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec2(const size2_t& pos, dvec2 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec3(const size2_t& pos, dvec3 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec4(const size2_t& pos, dvec4 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
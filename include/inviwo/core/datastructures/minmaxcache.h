@@ -0,0 +1,69 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/glm.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace inviwo {
+
+/**
+ * \ingroup datastructures
+ * \brief Thread safe storage for the component-wise min and max values of a RAM representation.
+ *
+ * The values are computed by util::volumeMinMax and util::layerMinMax in the base module. The
+ * owning representation clears the cache whenever its data is accessed through a non-const
+ * function, so it is only valid as long as the data is not modified through a pointer obtained
+ * before the values were computed.
+ */
+class IVW_CORE_API MinMaxCache {
+public:
+    MinMaxCache() = default;
+    MinMaxCache(const MinMaxCache& rhs);
+    MinMaxCache& operator=(const MinMaxCache& that);
+    ~MinMaxCache() = default;
+
+    std::optional<std::pair<dvec4, dvec4>> get(bool ignoreSpecialValues) const;
+    void set(bool ignoreSpecialValues, const std::pair<dvec4, dvec4>& minMax);
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::atomic<bool> empty_{true};
+    std::array<std::optional<std::pair<dvec4, dvec4>>, 2> values_;
+};
+
+}  // namespace inviwo
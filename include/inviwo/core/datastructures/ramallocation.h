@@ -0,0 +1,77 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace inviwo {
+
+/**
+ * \ingroup datastructures
+ * How VolumeRAMPrecision and LayerRAMPrecision allocate their data.
+ */
+enum class RAMAllocation {
+    /// Value initialized memory, the default
+    Zeroed,
+    /// Uninitialized memory, for producers that overwrite every value anyway
+    Uninitialized,
+    /// Uninitialized memory aligned to 2MB and backed by huge pages where the OS supports it
+    HugePages,
+    /// Uninitialized memory reusing released buffers of the same size, see util::setRAMPoolCapacity
+    Pooled
+};
+
+namespace util {
+
+/**
+ * Allocate \p bytes of memory aligned to at least 64 bytes. The memory is released, or returned
+ * to the pool for RAMAllocation::Pooled, when the last copy of the returned pointer is destroyed.
+ * Only RAMAllocation::Zeroed initializes the memory.
+ */
+IVW_CORE_API std::shared_ptr<void> allocateRAM(size_t bytes, RAMAllocation allocation);
+
+/**
+ * Set the maximum number of bytes that the pool used by RAMAllocation::Pooled keeps in released
+ * buffers. Released buffers that do not fit are freed. The default is 1GB.
+ */
+IVW_CORE_API void setRAMPoolCapacity(size_t bytes);
+IVW_CORE_API size_t getRAMPoolCapacity();
+
+/**
+ * Free all buffers currently kept in the pool.
+ */
+IVW_CORE_API void clearRAMPool();
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -228,6 +228,17 @@ public:
      */
     void interpolateAndStoreColors(vec4* dataArray, const size_t size) const;
 
+    /**
+     * Interpolate the color between all neighboring pairs of \p points and write the result to
+     * dataArray, in the same way as for the TFPrimitives of a TFPrimitiveSet.
+     *
+     * @param points   primitive data sorted by position
+     * @param dataArray   write location for interpolated colors
+     * @param size   size of dataArray
+     */
+    static void interpolateAndStoreColors(const std::vector<TFPrimitiveData>& points,
+                                          vec4* dataArray, const size_t size);
+
     /**
      * flip the positions of the \p primitives with respect to the respective range, i.e.
      *      p' = range.max - (p - range.min)
@@ -106,17 +106,27 @@ public:
      * Simplify a vector of TF points by removing points that can be replaced by interpolating
      * between the previous and the next point, as long as the resulting error is less then delta.
      * the error is the absolute maximal component wise error at the point to be removed.
+     * The points are removed in order of increasing error, only the errors of the neighbors of a
+     * removed point are updated, giving a complexity of O(n log n).
      */
     static std::vector<TFPrimitiveData> simplify(const std::vector<TFPrimitiveData>& points,
                                                  double delta = 0.01);
 
 protected:
     void calcTransferValues() const;
+    /**
+     * Fill the texture data from \p points instead of the TFPrimitives. Used when the points are
+     * already at hand and known to match the TFPrimitives, i.e. right after adding them.
+     * @param points   primitive data sorted by position
+     */
+    void calcTransferValues(const std::vector<TFPrimitiveData>& points) const;
 
     virtual std::string serializationKey() const override;
     virtual std::string serializationItemKey() const override;
 
 private:
+    void applyMaskAndUpdate() const;
+
     double maskMin_;
     double maskMax_;
 
@@ -37,6 +37,7 @@
 #include <inviwo/core/datastructures/datamapper.h>
 #include <inviwo/core/datastructures/representationtraits.h>
 #include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/datastructures/volume/volumepyramid.h>
 #include <inviwo/core/metadata/metadataowner.h>
 #include <inviwo/core/util/glm.h>
 #include <inviwo/core/util/document.h>
@@ -63,7 +64,8 @@ class Camera;
 class IVW_CORE_API Volume : public Data<Volume, VolumeRepresentation>,
                             public StructuredGridEntity<3>,
                             public MetaDataOwner,
-                            public HistogramSupplier {
+                            public HistogramSupplier,
+                            public VolumePyramidSupplier {
 public:
     explicit Volume(size3_t defaultDimensions = size3_t(128, 128, 128),
                     const DataFormatBase* defaultFormat = DataUInt8::get(),
@@ -156,6 +158,13 @@ public:
 
     std::shared_ptr<HistogramCalculationState> calculateHistograms(size_t bins = 2048) const;
 
+    /**
+     * Get the pyramid of subsampled versions of this volume. It is created on first use and its
+     * levels are kept with the volume. Changing the dimensions drops the pyramid.
+     * @see util::getVolumeWithMaxVoxels
+     */
+    const VolumePyramid& getPyramid() const;
+
 protected:
     size3_t defaultDimensions_;
     const DataFormatBase* defaultDataFormat_;
@@ -0,0 +1,183 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+
+#include <memory>
+
+namespace inviwo {
+
+class Volume;
+class VolumeDisk;
+class VolumeRAM;
+
+/**
+ * \ingroup datastructures
+ * \brief An out-of-core volume representation that loads bricks of a VolumeDisk on demand.
+ *
+ * The volume is divided into bricks of getBrickDimensions() voxels, the bricks at the upper
+ * borders are smaller if the dimensions are not a multiple of the brick dimensions. Bricks are
+ * loaded when requested and kept in a least recently used cache whose size is bounded by
+ * getCacheSize() bytes. Hence a volume larger than the available memory can be processed brick by
+ * brick, \see forEachBrick, or region by region, \see getRegion.
+ *
+ * Bricks are read directly from the file, hence the loader of the VolumeDisk has to implement
+ * VolumeRegionLoader, \see VolumeDisk::canReadRegion.
+ *
+ * Clones share the source and the brick cache. All const functions are thread safe.
+ */
+class IVW_CORE_API VolumeBricked : public VolumeRepresentation {
+public:
+    static constexpr size_t defaultCacheSize = size_t{512} * 1024 * 1024;
+
+    /**
+     * @throws Exception if \p source is null or can not read regions
+     */
+    VolumeBricked(std::shared_ptr<const VolumeDisk> source, size3_t brickDimensions = size3_t{64},
+                  size_t cacheSize = defaultCacheSize);
+    VolumeBricked(const VolumeBricked& rhs) = default;
+    VolumeBricked& operator=(const VolumeBricked& that) = default;
+    virtual VolumeBricked* clone() const override;
+    virtual ~VolumeBricked() = default;
+
+    virtual std::type_index getTypeIndex() const override final;
+
+    /**
+     * @throws Exception, the dimensions are given by the source
+     */
+    virtual void setDimensions(size3_t dimensions) override;
+    virtual const size3_t& getDimensions() const override;
+
+    virtual void setSwizzleMask(const SwizzleMask& mask) override;
+    virtual SwizzleMask getSwizzleMask() const override;
+
+    virtual void setInterpolation(InterpolationType interpolation) override;
+    virtual InterpolationType getInterpolation() const override;
+
+    virtual void setWrapping(const Wrapping3D& wrapping) override;
+    virtual Wrapping3D getWrapping() const override;
+
+    const std::shared_ptr<const VolumeDisk>& getSource() const;
+    /**
+     * Replace the source, this will also drop all cached bricks.
+     * @throws Exception if \p source is null or can not read regions
+     */
+    void setSource(std::shared_ptr<const VolumeDisk> source);
+
+    size3_t getBrickDimensions() const;
+    size3_t getNumberOfBricks() const;
+    /**
+     * Voxel offset of brick \p brick, where \p brick is in [0, getNumberOfBricks())
+     */
+    size3_t getBrickOffset(size3_t brick) const;
+    /**
+     * Voxel dimensions of brick \p brick, smaller than getBrickDimensions() at the upper borders
+     */
+    size3_t getBrickExtent(size3_t brick) const;
+
+    /**
+     * Get brick \p brick, loading it if it is not in the cache.
+     * @throws RangeException if \p brick is outside of getNumberOfBricks()
+     */
+    std::shared_ptr<const VolumeRAM> getBrick(size3_t brick) const;
+
+    /**
+     * Load all bricks overlapping the region [offset, offset + extent) into the cache. The bricks
+     * are loaded on the thread pool when the application is initialized and synchronously
+     * otherwise.
+     */
+    void prefetch(size3_t offset, size3_t extent) const;
+
+    /**
+     * Copy the voxels in [offset, offset + extent) into a new VolumeRAM, loading only the bricks
+     * that overlap the region.
+     * @throws RangeException if the region is outside of the volume
+     */
+    std::shared_ptr<VolumeRAM> getRegion(size3_t offset, size3_t extent) const;
+
+    /**
+     * Call \p callback with each brick and its voxel offset, one brick at a time in x, y, z
+     * order. A brick is only kept alive by the cache after the callback returns.
+     * @param callback a callable with the signature void(const VolumeRAM& brick, size3_t offset)
+     */
+    template <typename Callback>
+    void forEachBrick(Callback&& callback) const;
+
+    /**
+     * Set the maximum number of bytes of cached bricks. The most recently used brick is always
+     * kept even if it is larger.
+     */
+    void setCacheSize(size_t bytes);
+    size_t getCacheSize() const;
+    /**
+     * The number of bytes of currently cached bricks
+     */
+    size_t getCachedBytes() const;
+    void clearCache() const;
+
+private:
+    class BrickCache;
+
+    std::shared_ptr<const VolumeDisk> source_;
+    size3_t brickDimensions_;
+    SwizzleMask swizzleMask_;
+    InterpolationType interpolation_;
+    Wrapping3D wrapping_;
+    std::shared_ptr<BrickCache> cache_;
+};
+
+template <typename Callback>
+void VolumeBricked::forEachBrick(Callback&& callback) const {
+    const auto bricks = getNumberOfBricks();
+    for (size_t z = 0; z < bricks.z; ++z) {
+        for (size_t y = 0; y < bricks.y; ++y) {
+            for (size_t x = 0; x < bricks.x; ++x) {
+                const size3_t brick{x, y, z};
+                callback(*getBrick(brick), getBrickOffset(brick));
+            }
+        }
+    }
+}
+
+namespace util {
+
+/**
+ * Get a VolumeBricked of \p volume if the volume data is only available on disk, i.e. if there is
+ * no valid VolumeRAM but a valid VolumeBricked, or a valid VolumeDisk that can read regions.
+ * Algorithms can then process the volume brick by brick instead of loading all of it. Returns
+ * nullptr otherwise.
+ */
+IVW_CORE_API const VolumeBricked* getBrickedRepresentation(const Volume& volume);
+
+}  // namespace util
+
+}  // namespace inviwo
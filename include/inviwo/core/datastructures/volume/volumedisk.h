@@ -76,6 +76,17 @@ public:
     virtual void setWrapping(const Wrapping3D& wrapping) override;
     virtual Wrapping3D getWrapping() const override;
 
+    /**
+     * Check if the loader can read parts of the volume, \see VolumeRegionLoader
+     */
+    bool canReadRegion() const;
+    /**
+     * Read the voxels in [offset, offset + extent) into \p dest.
+     * @throws Exception if the loader can not read parts of the volume
+     * \see VolumeRegionLoader::readRegion
+     */
+    void readRegion(size3_t offset, size3_t extent, void* dest) const;
+
 private:
     size3_t dimensions_;
     SwizzleMask swizzleMask_;
@@ -83,6 +94,24 @@ private:
     Wrapping3D wrapping_;
 };
 
+/**
+ * \ingroup datastructures
+ * Interface for volume DiskRepresentationLoaders that can read a part of a volume without loading
+ * all of it. Used by VolumeBricked to load bricks on demand.
+ */
+class IVW_CORE_API VolumeRegionLoader {
+public:
+    virtual ~VolumeRegionLoader() = default;
+
+    /**
+     * Read the voxels in [offset, offset + extent) of the volume described by \p src into
+     * \p dest. \p dest must have room for glm::compMul(extent) voxels of the data format of
+     * \p src, which are stored linearized in x, then y, then z.
+     */
+    virtual void readRegion(const VolumeRepresentation& src, size3_t offset, size3_t extent,
+                            void* dest) const = 0;
+};
+
 template <>
 struct representation_traits<Volume, kind::Disk> {
     using type = VolumeDisk;
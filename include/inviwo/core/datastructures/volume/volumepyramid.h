@@ -0,0 +1,168 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/glm.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+class Volume;
+class VolumeRAM;
+
+/**
+ * \brief A multiresolution pyramid of a volume where each level halves the resolution of the
+ * previous one.
+ *
+ * Level 0 is the volume itself. The other levels are created with util::volumeSubSample2x when
+ * they are first requested and are then kept, so interactive processors can ask for the level that
+ * fits a voxel budget and only pay for the subsampling once. The dimensions of level i + 1 are
+ * (dimensions of level i + 1) / 2, the last level has dimensions (1, 1, 1).
+ *
+ * A pyramid belongs to its volume, see Volume::getPyramid, and only holds the levels below it to
+ * avoid a reference cycle. Use util::getVolumePyramidLevel to get any level as a shared pointer.
+ * Like the histograms, the levels are not updated when the voxel data is edited.
+ *
+ * The pyramid is a cache, so all functions are const and thread safe.
+ */
+class IVW_CORE_API VolumePyramid {
+public:
+    explicit VolumePyramid(const Volume& volume);
+    VolumePyramid(const VolumePyramid&) = delete;
+    VolumePyramid& operator=(const VolumePyramid&) = delete;
+
+    const Volume& getVolume() const;
+
+    size_t getNumberOfLevels() const;
+    size3_t getLevelDimensions(size_t level) const;
+
+    /**
+     * The finest level with at most \p maxVoxels voxels, or the coarsest level if no level fits.
+     */
+    size_t getLevelFor(size_t maxVoxels) const;
+
+    /**
+     * Get level \p level, creating it and all coarser levels up to it if needed.
+     * @throws RangeException if \p level is 0 or >= getNumberOfLevels()
+     */
+    std::shared_ptr<const Volume> getLevel(size_t level) const;
+
+    /**
+     * Check if level \p level has been created or set. Level 0 always exists.
+     */
+    bool hasLevel(size_t level) const;
+
+    /**
+     * Set level \p level, for example when it was loaded from \p file. Does nothing if the level
+     * already exists.
+     * @return true if the level was set
+     * @throws RangeException if \p level is 0 or >= getNumberOfLevels()
+     * @throws Exception if the dimensions or format of \p volume do not match the level
+     */
+    bool setLevel(size_t level, std::shared_ptr<const Volume> volume,
+                  const std::string& file = "") const;
+
+    /**
+     * The file level \p level was loaded from or saved to, or an empty string.
+     */
+    std::string getLevelFile(size_t level) const;
+    void setLevelFile(size_t level, const std::string& file) const;
+
+private:
+    std::shared_ptr<const Volume> createLevel(const Volume& previous) const;
+
+    const Volume& volume_;
+    size3_t dimensions_;
+    mutable std::mutex mutex_;
+    mutable std::vector<std::shared_ptr<const Volume>> levels_;  // levels_[0] is unused
+    mutable std::vector<std::string> files_;
+};
+
+/**
+ * \brief Mixin that gives a volume a lazily created VolumePyramid, \see HistogramSupplier.
+ *
+ * The pyramid refers to the volume that owns it, copies therefore start without a pyramid and
+ * create their own on first use.
+ */
+class IVW_CORE_API VolumePyramidSupplier {
+public:
+    VolumePyramidSupplier() = default;
+    VolumePyramidSupplier(const VolumePyramidSupplier& rhs);
+    VolumePyramidSupplier& operator=(const VolumePyramidSupplier& that);
+    virtual ~VolumePyramidSupplier() = default;
+
+    bool hasPyramid() const;
+
+protected:
+    const VolumePyramid& getPyramid(const Volume& volume) const;
+    /**
+     * Drop all levels, needed when the dimensions of the volume change.
+     */
+    void resetPyramid();
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::unique_ptr<VolumePyramid> pyramid_;
+};
+
+namespace util {
+
+/**
+ * Halve the resolution of \p in using a 2x2x2 box filter. Odd dimensions are rounded up by
+ * repeating the last voxel, dimensions of size one are kept. Integer formats are rounded to
+ * nearest. Integers up to 32 bits are summed in 64-bit integers, 64-bit integers are averaged
+ * exactly by summing quotients and remainders separately, other formats are summed in double
+ * precision.
+ * @see VolumePyramid
+ */
+IVW_CORE_API std::shared_ptr<VolumeRAM> volumeSubSample2x(const VolumeRAM* in);
+
+/**
+ * Level \p level of the pyramid of \p volume, where level 0 is \p volume itself.
+ * @throws RangeException if \p level >= getNumberOfLevels()
+ */
+IVW_CORE_API std::shared_ptr<const Volume> getVolumePyramidLevel(
+    std::shared_ptr<const Volume> volume, size_t level);
+
+/**
+ * The finest level of the pyramid of \p volume with at most \p maxVoxels voxels, i.e. \p volume
+ * itself if it is small enough, or the coarsest level if no level fits.
+ */
+IVW_CORE_API std::shared_ptr<const Volume> getVolumeWithMaxVoxels(
+    std::shared_ptr<const Volume> volume, size_t maxVoxels);
+
+}  // namespace util
+
+}  // namespace inviwo
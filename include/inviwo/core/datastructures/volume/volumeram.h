@@ -32,6 +32,7 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/datastructures/volume/volumerepresentation.h>
 #include <inviwo/core/datastructures/histogram.h>
+#include <inviwo/core/datastructures/minmaxcache.h>
 #include <inviwo/core/util/glm.h>
 #include <inviwo/core/util/formats.h>
 #include <inviwo/core/util/formatdispatching.h>
@@ -97,6 +98,12 @@ public:
 
     virtual std::type_index getTypeIndex() const override final;
 
+    /**
+     * Cached component-wise min and max values of the data, cleared by all non-const functions
+     * that give access to the data. \see util::volumeMinMax
+     */
+    MinMaxCache& getMinMaxCache() const { return minMax_; }
+
     /**
      * Dispatch functionality to retrieve the actual underlaying VolumeRamPrecision.
      * The dispatcher takes a generic lambda as argument. Code will be instantiated for all the
@@ -151,6 +158,9 @@ public:
     template <typename Result, template <class> class Predicate = dispatching::filter::All,
               typename Callable, typename... Args>
     auto dispatch(Callable&& callable, Args&&... args) const -> Result;
+
+protected:
+    mutable MinMaxCache minMax_;
 };
 
 class Volume;
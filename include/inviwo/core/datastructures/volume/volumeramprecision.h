@@ -30,6 +30,7 @@
 #pragma once
 
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/ramallocation.h>
 #include <inviwo/core/util/glm.h>
 #include <inviwo/core/util/stdextensions.h>
 
@@ -47,10 +48,28 @@ public:
                                 const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                                 InterpolationType interpolation = InterpolationType::Linear,
                                 const Wrapping3D& wrapping = wrapping3d::clampAll);
+    /**
+     * Allocate the data according to \p allocation, see RAMAllocation. All policies except
+     * RAMAllocation::Zeroed leave the data uninitialized. The policy is also used when the
+     * dimensions change.
+     */
+    VolumeRAMPrecision(size3_t dimensions, RAMAllocation allocation,
+                       const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                       InterpolationType interpolation = InterpolationType::Linear,
+                       const Wrapping3D& wrapping = wrapping3d::clampAll);
     VolumeRAMPrecision(T* data, size3_t dimensions,
                        const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                        InterpolationType interpolation = InterpolationType::Linear,
                        const Wrapping3D& wrapping = wrapping3d::clampAll);
+    /**
+     * Use memory that is owned by \p dataOwner, for example a memory mapped file. The volume
+     * never deletes \p data, it keeps \p dataOwner alive for as long as it uses \p data
+     * instead. Copies of the volume allocate their own memory.
+     */
+    VolumeRAMPrecision(T* data, std::shared_ptr<void> dataOwner, size3_t dimensions,
+                       const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                       InterpolationType interpolation = InterpolationType::Linear,
+                       const Wrapping3D& wrapping = wrapping3d::clampAll);
     VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs);
     VolumeRAMPrecision<T>& operator=(const VolumeRAMPrecision<T>& that);
     virtual VolumeRAMPrecision<T>* clone() const override;
@@ -67,6 +86,10 @@ public:
 
     virtual void setData(void* data, size3_t dimensions) override;
 
+    /**
+     * Give up ownership of the data, the caller has to delete[] getData(). Data kept alive by a
+     * dataOwner or allocated using a RAMAllocation policy is first copied to memory from new[].
+     */
     virtual void removeDataOwnership() override;
 
     virtual const size3_t& getDimensions() const override;
@@ -108,13 +131,19 @@ public:
 
     virtual size_t getNumberOfBytes() const override;
 
+    RAMAllocation getAllocation() const;
+
 private:
+    void allocate(size3_t dimensions);
+
     size3_t dimensions_;
     bool ownsDataPtr_;
     std::unique_ptr<T[]> data_;
+    std::shared_ptr<void> dataOwner_;  // keeps external memory alive, see constructor
     SwizzleMask swizzleMask_;
     InterpolationType interpolation_;
     Wrapping3D wrapping_;
+    RAMAllocation allocation_;
 };
 
 /**
@@ -132,6 +161,38 @@ IVW_CORE_API std::shared_ptr<VolumeRAM> createVolumeRAM(
     InterpolationType interpolation = InterpolationType::Linear,
     const Wrapping3D& wrapping = wrapping3d::clampAll);
 
+/**
+ * Factory for volumes using external memory.
+ * Creates an VolumeRAM with data type specified by format that uses the memory at dataPtr without
+ * taking ownership of it. The memory must stay valid as long as dataOwner is alive.
+ *
+ * @param dimensions of volume to create.
+ * @param format of volume to create.
+ * @param dataPtr pointer to the data, suitably aligned for the format.
+ * @param dataOwner object owning the memory at dataPtr, kept alive by the volume.
+ * @return nullptr if no valid format was specified.
+ * @see VolumeRAMPrecision
+ */
+IVW_CORE_API std::shared_ptr<VolumeRAM> createVolumeRAM(
+    const size3_t& dimensions, const DataFormatBase* format, void* dataPtr,
+    std::shared_ptr<void> dataOwner, const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+    InterpolationType interpolation = InterpolationType::Linear,
+    const Wrapping3D& wrapping = wrapping3d::clampAll);
+
+/**
+ * Factory for volumes with a specific allocation policy, see RAMAllocation.
+ *
+ * @param dimensions of volume to create.
+ * @param format of volume to create.
+ * @param allocation how to allocate the data.
+ * @return nullptr if no valid format was specified.
+ */
+IVW_CORE_API std::shared_ptr<VolumeRAM> createVolumeRAM(
+    const size3_t& dimensions, const DataFormatBase* format, RAMAllocation allocation,
+    const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+    InterpolationType interpolation = InterpolationType::Linear,
+    const Wrapping3D& wrapping = wrapping3d::clampAll);
+
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions, const SwizzleMask& swizzleMask,
                                           InterpolationType interpolation,
@@ -142,7 +203,24 @@ VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions, const SwizzleMask&
     , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z]())
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
-    , wrapping_{wrapping} {}
+    , wrapping_{wrapping}
+    , allocation_{RAMAllocation::Zeroed} {}
+
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions, RAMAllocation allocation,
+                                          const SwizzleMask& swizzleMask,
+                                          InterpolationType interpolation,
+                                          const Wrapping3D& wrapping)
+    : VolumeRAM(DataFormat<T>::get())
+    , dimensions_(0)
+    , ownsDataPtr_(true)
+    , data_()
+    , swizzleMask_(swizzleMask)
+    , interpolation_{interpolation}
+    , wrapping_{wrapping}
+    , allocation_{allocation} {
+    allocate(dimensions);
+}
 
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions,
@@ -155,17 +233,37 @@ VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions,
     , data_(data ? data : new T[dimensions_.x * dimensions_.y * dimensions_.z]())
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
-    , wrapping_{wrapping} {}
+    , wrapping_{wrapping}
+    , allocation_{RAMAllocation::Zeroed} {}
+
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, std::shared_ptr<void> dataOwner,
+                                          size3_t dimensions, const SwizzleMask& swizzleMask,
+                                          InterpolationType interpolation,
+                                          const Wrapping3D& wrapping)
+    : VolumeRAM(DataFormat<T>::get())
+    , dimensions_(dimensions)
+    , ownsDataPtr_(false)
+    , data_(data)
+    , dataOwner_(std::move(dataOwner))
+    , swizzleMask_(swizzleMask)
+    , interpolation_{interpolation}
+    , wrapping_{wrapping}
+    , allocation_{RAMAllocation::Zeroed} {}
 
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs)
     : VolumeRAM(rhs)
     , dimensions_(rhs.dimensions_)
     , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z])
+    , data_(rhs.allocation_ == RAMAllocation::Zeroed
+                ? new T[dimensions_.x * dimensions_.y * dimensions_.z]
+                : nullptr)
     , swizzleMask_(rhs.swizzleMask_)
     , interpolation_{rhs.interpolation_}
-    , wrapping_{rhs.wrapping_} {
+    , wrapping_{rhs.wrapping_}
+    , allocation_{rhs.allocation_} {
+    if (!data_) allocate(dimensions_);
     std::memcpy(data_.get(), rhs.data_.get(),
                 dimensions_.x * dimensions_.y * dimensions_.z * sizeof(T));
 }
@@ -174,12 +272,9 @@ template <typename T>
 VolumeRAMPrecision<T>& VolumeRAMPrecision<T>::operator=(const VolumeRAMPrecision<T>& that) {
     if (this != &that) {
         VolumeRAM::operator=(that);
-        auto dim = that.dimensions_;
-        auto data = std::make_unique<T[]>(dim.x * dim.y * dim.z);
-        std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * dim.z * sizeof(T));
-        data_.swap(data);
-        std::swap(dim, dimensions_);
-        ownsDataPtr_ = true;
+        allocation_ = that.allocation_;
+        allocate(that.dimensions_);
+        std::memcpy(data_.get(), that.data_.get(), getNumberOfBytes());
         swizzleMask_ = that.swizzleMask_;
         interpolation_ = that.interpolation_;
         wrapping_ = that.wrapping_;
@@ -204,11 +299,13 @@ const T* inviwo::VolumeRAMPrecision<T>::getDataTyped() const {
 
 template <typename T>
 T* inviwo::VolumeRAMPrecision<T>::getDataTyped() {
+    minMax_.clear();
     return data_.get();
 }
 
 template <typename T>
 void* VolumeRAMPrecision<T>::getData() {
+    minMax_.clear();
     return data_.get();
 }
 template <typename T>
@@ -218,6 +315,7 @@ const void* VolumeRAMPrecision<T>::getData() const {
 
 template <typename T>
 void* VolumeRAMPrecision<T>::getData(size_t pos) {
+    minMax_.clear();
     return data_.get() + pos;
 }
 
@@ -228,16 +326,26 @@ const void* VolumeRAMPrecision<T>::getData(size_t pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setData(void* d, size3_t dimensions) {
+    minMax_.clear();
     std::unique_ptr<T[]> data(static_cast<T*>(d));
     data_.swap(data);
     std::swap(dimensions_, dimensions);
 
     if (!ownsDataPtr_) data.release();
     ownsDataPtr_ = true;
+    dataOwner_.reset();
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::removeDataOwnership() {
+    if (dataOwner_) {
+        const size_t size = dimensions_.x * dimensions_.y * dimensions_.z;
+        std::unique_ptr<T[]> data(new T[size]);
+        std::memcpy(data.get(), data_.get(), size * sizeof(T));
+        data_.release();
+        data_ = std::move(data);
+        dataOwner_.reset();
+    }
     ownsDataPtr_ = false;
 }
 
@@ -253,13 +361,31 @@ size_t VolumeRAMPrecision<T>::getNumberOfBytes() const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setDimensions(size3_t dimensions) {
-    if (dimensions_ != dimensions) {
-        auto data = std::make_unique<T[]>(dimensions.x * dimensions.y * dimensions.z);
-        data_.swap(data);
-        dimensions_ = dimensions;
-        if (!ownsDataPtr_) data.release();
-        ownsDataPtr_ = true;
+    minMax_.clear();
+    if (dimensions_ != dimensions) allocate(dimensions);
+}
+
+template <typename T>
+void VolumeRAMPrecision<T>::allocate(size3_t dimensions) {
+    const size_t size = dimensions.x * dimensions.y * dimensions.z;
+    std::unique_ptr<T[]> data;
+    std::shared_ptr<void> owner;
+    if (allocation_ == RAMAllocation::Zeroed) {
+        data.reset(new T[size]());
+    } else {
+        owner = util::allocateRAM(size * sizeof(T), allocation_);
+        data.reset(static_cast<T*>(owner.get()));
     }
+    data_.swap(data);
+    if (!ownsDataPtr_) data.release();
+    ownsDataPtr_ = !owner;
+    dataOwner_ = std::move(owner);
+    dimensions_ = dimensions;
+}
+
+template <typename T>
+RAMAllocation VolumeRAMPrecision<T>::getAllocation() const {
+    return allocation_;
 }
 
 template <typename T>
@@ -314,21 +440,25 @@ dvec4 VolumeRAMPrecision<T>::getAsDVec4(const size3_t& pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDouble(const size3_t& pos, double val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec2(const size3_t& pos, dvec2 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec3(const size3_t& pos, dvec3 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec4(const size3_t& pos, dvec4 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
@@ -354,21 +484,25 @@ dvec4 VolumeRAMPrecision<T>::getAsNormalizedDVec4(const size3_t& pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDouble(const size3_t& pos, double val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec2(const size3_t& pos, dvec2 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec3(const size3_t& pos, dvec3 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec4(const size3_t& pos, dvec4 val) {
+    minMax_.clear();
     data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
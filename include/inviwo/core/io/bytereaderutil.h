@@ -36,8 +36,23 @@ namespace inviwo {
 
 namespace util {
 
+/**
+ * Read \p bytes bytes at \p offset of \p file into \p dest. If the data is not little endian
+ * the byte order of each element of \p elementSize bytes is reversed. For multi-component
+ * formats \p elementSize should be the size of a single component.
+ */
 void IVW_CORE_API readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
                                       bool littleEndian, size_t elementSize, void* dest);
+
+/**
+ * Reverse the byte order of each element of \p elementSize bytes in \p data, in place. Elements
+ * of 2, 4 and 8 bytes are swapped a whole word at a time, in loops the compiler can vectorize.
+ * @param data pointer to the elements, does not need to be aligned
+ * @param bytes total number of bytes, a multiple of \p elementSize
+ * @param elementSize size of each element in bytes
+ */
+void IVW_CORE_API byteSwap(void* data, size_t bytes, size_t elementSize);
+
 }  // namespace util
 
 }  // namespace inviwo
@@ -0,0 +1,108 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <cstddef>
+#include <string>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * \class MemoryMappedFile
+ * \brief RAII interface for a memory mapping of a file, or of a part of it.
+ *
+ * The operating system pages the data in on demand and shares it with the file cache, so large
+ * files can be read without first copying them into a heap allocation. The file itself is never
+ * modified.
+ */
+class IVW_CORE_API MemoryMappedFile {
+public:
+    enum class Access {
+        ReadOnly,     ///< The mapped memory must not be written to
+        CopyOnWrite,  ///< Written pages are copied into private memory, the file is unchanged
+    };
+
+    /**
+     * Map \p length bytes of \p filename starting at byte \p offset. A length of zero maps the
+     * remainder of the file. The offset does not have to be aligned to the page size.
+     * @throws FileException if the file cannot be opened or mapped or if the requested range is
+     *   not inside the file
+     */
+    explicit MemoryMappedFile(const std::string& filename, size_t offset = 0, size_t length = 0,
+                              Access access = Access::ReadOnly);
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    MemoryMappedFile(MemoryMappedFile&& rhs) noexcept;
+    MemoryMappedFile& operator=(MemoryMappedFile&& rhs) noexcept;
+
+    ~MemoryMappedFile();
+
+    const std::string& getFileName() const;
+
+    Access getAccess() const;
+
+    /**
+     * Pointer to the first requested byte, nullptr if the mapped range is empty.
+     */
+    const char* data() const;
+    /**
+     * Writable pointer to the first requested byte, only valid with Access::CopyOnWrite.
+     */
+    char* data();
+    size_t size() const;
+    bool empty() const;
+
+    const char* begin() const;
+    const char* end() const;
+
+private:
+    void cleanup();
+
+    std::string filename_;
+    Access access_;
+    void* mapping_;  // start of the mapped region, aligned to the allocation granularity
+    size_t mappedSize_;
+    char* data_;
+    size_t size_;
+#ifdef WIN32
+    void* file_;
+    void* fileMapping_;
+#endif
+};
+
+}  // namespace util
+
+}  // namespace inviwo
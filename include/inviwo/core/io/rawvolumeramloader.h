@@ -35,19 +35,27 @@
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/datastructures/diskrepresentation.h>
 #include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
 
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace inviwo {
 
+namespace util {
+class MemoryMappedFile;
+}
+
 /**
  * \class RawVolumeRAMLoader
  * \brief A loader of raw files. Used to create VolumeRAM representations.
  * This class us used by the DatVolumeSequenceReader, IvfVolumeReader and RawVolumeReader.
+ * It can also read parts of the volume, which VolumeBricked uses to load bricks on demand.
  */
 
-class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                                         public VolumeRegionLoader {
 public:
     RawVolumeRAMLoader(const std::string& rawFile, size_t offset, bool littleEndian);
     virtual RawVolumeRAMLoader* clone() const override;
@@ -56,10 +64,21 @@ public:
     virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
                                       const VolumeRepresentation& src) const override;
 
+    virtual void readRegion(const VolumeRepresentation& src, size3_t offset, size3_t extent,
+                            void* dest) const override;
+
 private:
     std::string rawFile_;
     size_t offset_;
     bool littleEndian_;
+
+    // Read-only mapping of the file used by readRegion, created on first use and shared between
+    // clones of the loader
+    struct Mapping {
+        std::mutex mutex;
+        std::shared_ptr<const util::MemoryMappedFile> file;
+    };
+    std::shared_ptr<Mapping> mapping_;
 };
 
 }  // namespace inviwo
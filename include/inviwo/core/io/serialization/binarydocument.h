@@ -0,0 +1,77 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <iosfwd>
+
+namespace ticpp {
+class Document;
+}  // namespace ticpp
+
+namespace inviwo {
+
+using TxDocument = ticpp::Document;
+
+namespace util {
+
+/**
+ * \brief Writes \p doc to \p stream using a compact binary encoding.
+ *
+ * The binary encoding is an alternative to xml text for in-memory snapshots like undo states and
+ * clipboard content, where the document is never read by a human. All element names, attribute
+ * keys and values are stored once in a string table and referenced by index. The nodes are
+ * length-prefixed, so reading the document back requires no text parsing or entity decoding.
+ * Reading the document back yields the same xml tree as the text format would.
+ *
+ * Note that this only replaces the xml text. The Serializer still builds the document tree and
+ * converts all values to strings, and the Deserializer reads them from the tree as before.
+ *
+ * @see readBinaryDocument, isBinaryDocument
+ * @throws SerializationException if the document contains nodes that can not be encoded
+ */
+IVW_CORE_API void writeBinaryDocument(const TxDocument& doc, std::ostream& stream);
+
+/**
+ * \brief Reads a document written by writeBinaryDocument from \p stream into \p doc.
+ * @throws SerializationException if the stream does not contain a valid binary document
+ */
+IVW_CORE_API void readBinaryDocument(std::istream& stream, TxDocument& doc);
+
+/**
+ * \brief Checks if the next byte in \p stream starts a binary document, without extracting
+ * anything from the stream.
+ */
+IVW_CORE_API bool isBinaryDocument(std::istream& stream);
+
+}  // namespace util
+
+}  // namespace inviwo
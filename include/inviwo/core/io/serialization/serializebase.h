@@ -77,6 +77,14 @@ private:
 
 enum class SerializationTarget { Node, Attribute };
 
+/**
+ * Encoding of a serialized document. Xml is human readable and is used for everything that is
+ * written to disk. Binary is a compact encoding of the same document tree that is much faster to
+ * read back, intended for in-memory snapshots like undo states and the clipboard. The
+ * Deserializer detects the encoding of a stream automatically. \see util::writeBinaryDocument
+ */
+enum class SerializationFormat { Xml, Binary };
+
 class NodeSwitch;
 class Serializable;
 
@@ -112,7 +120,7 @@ public:
      * and de-serializer. Some of them are reference data manager,
      * (ticpp::Node) node switch and factory registration.
      *
-     * @param stream containing all xml data (for reading).
+     * @param stream containing all xml or binary data (for reading).
      * @param path A path that will be used to decode the location of data during deserialization.
      * @param allowReference disables or enables reference management schemes.
      */
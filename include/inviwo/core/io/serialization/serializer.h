@@ -80,6 +80,15 @@ public:
      * @throws SerializationException
      */
     virtual void writeFile(std::ostream& stream, bool format = false);
+    /**
+     * \brief Writes serialized data to stream using the given encoding.
+     *
+     * @param stream Stream to be written to.
+     * @param format SerializationFormat::Xml writes unformatted xml, SerializationFormat::Binary
+     * the compact binary encoding.
+     * @throws SerializationException
+     */
+    void writeFile(std::ostream& stream, SerializationFormat format);
 
     // std containers
     template <typename T>
@@ -46,6 +46,7 @@ using TxNode = ticpp::Node;
 using TxException = ticpp::Exception;
 using TxDeclaration = ticpp::Declaration;
 using TxComment = ticpp::Comment;
+using TxText = ticpp::Text;
 using TxAttribute = ticpp::Attribute;
 using TxEIt = ticpp::Iterator<TxElement>;
 using TxAIt = ticpp::Iterator<TxAttribute>;
@@ -34,6 +34,7 @@
 #include <inviwo/core/links/propertylink.h>
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace inviwo {
@@ -78,9 +79,26 @@ private:
         const PropertyConverter* converter_;
     };
 
+    struct SecondaryCacheEntry {
+        std::vector<Link> links;
+        // All properties whose outgoing links were followed to find the links. Adding or
+        // removing a link from any of them invalidates the entry.
+        std::vector<Property*> followed;
+    };
+
+    // State used while building a secondary cache entry
+    struct Traversal {
+        std::vector<Link> links;
+        std::unordered_set<Property*> linked;     // the src_ and dst_ of all links
+        std::unordered_set<Property*> followed;   // properties whose outgoing links were followed
+        std::unordered_set<Property*> completed;  // followed properties that are done
+    };
+
     // Cache helpers
-    std::vector<Link>& addToSecondaryCache(Property* property);
-    void secondaryCacheHelper(std::vector<Link>& links, Property* src, Property* dst);
+    SecondaryCacheEntry& addToSecondaryCache(Property* property);
+    void secondaryCacheHelper(Traversal& traversal, Property* src, Property* dst);
+    void followLinks(Traversal& traversal, Property* src);
+    void invalidateSecondaryCache(Property* src);
     std::vector<Link>& getTriggerdLinksForProperty(Property* property);
 
     ProcessorNetwork* network_;
@@ -90,29 +108,31 @@ private:
     std::unordered_map<Property*, std::vector<Property*>> propertyLinkPrimaryCache_;
     // The secondary link cache is a map with all source properties and a vector of ALL the
     // properties that they link to. Directly or indirectly.
-    std::unordered_map<Property*, std::vector<Link>> propertyLinkSecondaryCache_;
+    std::unordered_map<Property*, SecondaryCacheEntry> propertyLinkSecondaryCache_;
+    // For each followed property the sources of the secondary cache entries that depend on it
+    std::unordered_map<Property*, std::unordered_set<Property*>> secondaryCacheDependents_;
     // A cache of all links between two processors.
     ProcessorLinkMap processorLinksCache_;
 
     // Used to make sure we don't end up in circular links
-    std::vector<Property*> visited_;
+    std::unordered_set<Property*> visited_;
     struct VisitedHelper {
-        VisitedHelper(std::vector<Property*>& visited, std::vector<Link>& toVisit)
+        VisitedHelper(std::unordered_set<Property*>& visited, std::vector<Link>& toVisit)
             : visited_(visited), toVisit_(toVisit) {
             for (auto& link : toVisit_) {
-                util::push_back_unique(visited_, link.src_);
-                util::push_back_unique(visited_, link.dst_);
+                visited_.insert(link.src_);
+                visited_.insert(link.dst_);
             }
         }
         ~VisitedHelper() {
             for (auto& link : toVisit_) {
-                util::erase_remove(visited_, link.src_);
-                util::erase_remove(visited_, link.dst_);
+                visited_.erase(link.src_);
+                visited_.erase(link.dst_);
             }
         }
 
     private:
-        std::vector<Property*>& visited_;
+        std::unordered_set<Property*>& visited_;
         std::vector<Link>& toVisit_;
     };
 };
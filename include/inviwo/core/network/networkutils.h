@@ -32,6 +32,7 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/io/serialization/serializebase.h>
 #include <inviwo/core/util/stdextensions.h>
 
 namespace inviwo {
@@ -208,7 +209,14 @@ IVW_CORE_API void offsetPosition(const std::vector<Processor*>& processors, ivec
 IVW_CORE_API void setSelected(const std::vector<Processor*>& processors, bool selected);
 
 IVW_CORE_API void serializeSelected(ProcessorNetwork* network, std::ostream& os,
-                                    const std::string& refPath);
+                                    const std::string& refPath,
+                                    SerializationFormat format = SerializationFormat::Xml);
+
+/**
+ * Serialize the selected processors into \p serializer, the same serializer can then be written
+ * to several streams and formats.
+ */
+IVW_CORE_API void serializeSelected(ProcessorNetwork* network, Serializer& serializer);
 
 // return the appended processors.
 IVW_CORE_API std::vector<Processor*> appendDeserialized(ProcessorNetwork* network, std::istream& is,
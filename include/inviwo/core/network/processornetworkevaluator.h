@@ -35,11 +35,25 @@
 #include <inviwo/core/network/processornetworkevaluationobserver.h>
 #include <inviwo/core/network/evaluationerrorhandler.h>
 
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace inviwo {
 
 class Processor;
 class ProcessorNetwork;
 
+/**
+ * \class ProcessorNetworkEvaluator
+ * Evaluates the processors of a ProcessorNetwork. The evaluator keeps a topological order of all
+ * processors of the network that is updated incrementally when processors and connections are
+ * added or removed. Only adding a connection that goes against the current order requires any
+ * reordering, and then only of the processors in between the two connected processors.
+ * It also keeps track of the invalid processors, so that an evaluation only needs to visit those
+ * instead of all processors of the network.
+ */
 class IVW_CORE_API ProcessorNetworkEvaluator : public ProcessorNetworkObserver,
                                                public ProcessorObserver,
                                                public ProcessorNetworkEvaluationObservable {
@@ -50,6 +64,17 @@ public:
     virtual ~ProcessorNetworkEvaluator() = default;
     void setExceptionHandler(EvaluationErrorHandler handler);
 
+    /**
+     * Enable or disable concurrent evaluation. When enabled, processors that are invalid and
+     * ready, and that return true from Processor::supportsConcurrentProcessing, are processed on
+     * the thread pool as soon as all their predecessors are done. Independent branches of the
+     * network can then be processed at the same time. All other processors are processed on the
+     * calling thread, in topological order, while no concurrent processing is running.
+     * Disabled by default.
+     */
+    void setConcurrentEvaluation(bool enable);
+    bool getConcurrentEvaluation() const;
+
 private:
     // ProcessorNetworkObserver overrides
     virtual void onProcessorNetworkEvaluateRequest() override;
@@ -62,14 +87,38 @@ private:
     // ProcessorObserver overrides
     virtual void onProcessorSinkChanged(Processor*) override;
     virtual void onProcessorActiveConnectionsChanged(Processor*) override;
+    virtual void onProcessorInvalidationEnd(Processor*) override;
+
+    void addToOrder(Processor* processor);
+    void removeFromOrder(Processor* processor);
+    void updateOrder(Processor* from, Processor* to);
+    void updateFilter();
+    std::vector<Processor*> getInvalidProcessors();
 
     void requestEvaluate();
     void evaluate();
+    void evaluateConcurrent(const std::vector<Processor*>& processors);
+    void evaluateProcessor(Processor* processor);
+    bool prepareProcess(Processor* processor);
+    void finishProcess(Processor* processor);
 
     ProcessorNetwork* processorNetwork_;
-    // the sorted list of processors obtained through topological sorting
-    std::vector<Processor*> processorsSorted_;
+    // Topological order of all processors in the network, removed processors are left as
+    // nullptr until enough of them have accumulated.
+    std::vector<Processor*> order_;
+    std::unordered_map<Processor*, size_t> position_;
+    size_t removed_;
+    // Processors that have an active path to a sink, only these are evaluated.
+    std::unordered_set<Processor*> filtered_;
+    bool filterDirty_;
+    // Processors that have been invalidated since they were last evaluated.
+    std::unordered_set<Processor*> invalid_;
+    // Positions of processors left to visit in the current evaluation.
+    std::set<size_t> pending_;
+    bool evaluating_;
+    size_t current_;
     bool evaulationQueued_;
+    bool concurrentEvaluation_;
     EvaluationErrorHandler exceptionHandler_;
 };
 
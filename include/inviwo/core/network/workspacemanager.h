@@ -91,7 +91,8 @@ public:
      *      The same refPath should be given when loading. Most often this should be the path to the
      *      saved file.
      * \param exceptionHandler A callback for handling errors.
-     * \param mode to indicate if we are saving to disk or undo-stack
+     * \param mode to indicate if we are saving to disk or undo-stack. Undo states are written
+     *      in the binary SerializationFormat, everything else as formatted xml.
      */
     void save(std::ostream& stream, const std::string& refPath,
               const ExceptionHandler& exceptionHandler = StandardExceptionHandler(),
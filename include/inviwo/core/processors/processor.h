@@ -282,6 +282,17 @@ public:
      */
     virtual void doIfNotReady() {}
 
+    /**
+     * Return true if process() can be called on a worker thread concurrently with other
+     * processors. This is only used when concurrent evaluation is enabled in the
+     * ProcessorNetworkEvaluator. A processor that opts in must only read from its inports and
+     * properties and write to its outports in process(), and must not use any rendering context.
+     * initializeResources(), inport callbacks and all observer notifications are still done on
+     * the main thread. The default is false.
+     * @see ProcessorNetworkEvaluator::setConcurrentEvaluation
+     */
+    virtual bool supportsConcurrentProcessing() const { return false; }
+
     /**
      * Called by the network after Processor::process has been called.
      * This will set the following to valid
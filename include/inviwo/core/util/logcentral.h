@@ -34,8 +34,13 @@
 #include <inviwo/core/util/exception.h>
 #include <inviwo/core/util/stringconversion.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace inviwo {
@@ -46,6 +51,12 @@ enum class LogLevel : int { Info, Warn, Error };
 enum class LogVerbosity : int { Info, Warn, Error, None };
 enum class LogAudience : int { User, Developer };
 enum class MessageBreakLevel : int { Off, Error, Warn, Info };
+/**
+ * What to do when a message is logged while the queue of an asynchronous LogCentral is full.
+ * Block: Wait for the drain thread to make room, no message is lost.
+ * Drop: Discard the message. The number of discarded messages is reported by the drain thread.
+ */
+enum class LogOverflowPolicy : int { Block, Drop };
 
 IVW_CORE_API bool operator==(const LogLevel& lhs, const LogVerbosity& rhs);
 IVW_CORE_API bool operator!=(const LogLevel& lhs, const LogVerbosity& rhs);
@@ -110,13 +121,14 @@ std::basic_ostream<Elem, Traits>& operator<<(std::basic_ostream<Elem, Traits>& s
     return ss;
 }
 
-#define LogSpecial(logger, logLevel, message)                                            \
-    {                                                                                    \
-        std::ostringstream stream__;                                                     \
-        stream__ << message;                                                             \
-        logger->log(inviwo::parseTypeIdName(std::string(typeid(this).name())), logLevel, \
-                    inviwo::LogAudience::Developer, __FILE__, __FUNCTION__, __LINE__,    \
-                    stream__.str());                                                     \
+#define LogSpecial(logger, logLevel, message)                                                   \
+    {                                                                                           \
+        static const std::string source__ =                                                     \
+            inviwo::parseTypeIdName(std::string(typeid(this).name()));                          \
+        std::ostringstream stream__;                                                            \
+        stream__ << message;                                                                    \
+        logger->log(source__, logLevel, inviwo::LogAudience::Developer, __FILE__, __FUNCTION__, \
+                    __LINE__, stream__.str());                                                  \
     }
 
 #define LogCustomSpecial(logger, logLevel, source, message)                                   \
@@ -191,7 +203,7 @@ public:
 class IVW_CORE_API LogCentral : public Singleton<LogCentral>, public Logger {
 public:
     LogCentral();
-    virtual ~LogCentral() = default;
+    virtual ~LogCentral();
 
     void setVerbosity(LogVerbosity verbosity);
     LogVerbosity getVerbosity();
@@ -223,14 +235,60 @@ public:
     void setMessageBreakLevel(MessageBreakLevel level);
     MessageBreakLevel getMessageBreakLevel() const;
 
+    /**
+     * \brief Deliver messages to the registered loggers from a background thread.
+     * In asynchronous mode logging only pushes the formatted message onto a bounded lock-free
+     * queue, and a drain thread calls the loggers. Stack traces and message breaks are still
+     * handled on the calling thread. Processor messages and assertions are delivered on the
+     * calling thread after all queued messages, since they refer to objects owned by the caller.
+     * Disabling asynchronous mode delivers all queued messages and stops the drain thread.
+     * @param async enable or disable asynchronous mode.
+     * @param capacity number of messages the queue can hold, rounded up to a power of two. The
+     *        capacity is fixed the first time asynchronous mode is enabled.
+     * @param overflow what to do when the queue is full.
+     */
+    void setAsync(bool async, size_t capacity = 4096,
+                  LogOverflowPolicy overflow = LogOverflowPolicy::Block);
+    bool isAsync() const;
+
+    /**
+     * \brief Deliver all queued messages on the calling thread.
+     * Does nothing when asynchronous mode has never been enabled.
+     */
+    void flush();
+
 private:
     friend Singleton<LogCentral>;
     static LogCentral* instance_;
 
+    struct Record;
+    class RecordQueue;
+
+    void deliver(Record& record);
+    bool enqueue(Record& record);
+    void drain();
+    void drainLoop();
+    template <typename Callback>
+    void forEachLogger(Callback&& callback);
+
     LogVerbosity logVerbosity_;
 #include <warn/push>
 #include <warn/ignore/dll-interface>
+    std::recursive_mutex loggersMutex_;
     std::vector<std::weak_ptr<Logger>> loggers_;
+
+    std::unique_ptr<RecordQueue> queue_;  // created the first time async mode is enabled
+    std::atomic<RecordQueue*> queuePtr_{nullptr};
+    std::atomic<bool> async_{false};
+    std::atomic<LogOverflowPolicy> overflow_{LogOverflowPolicy::Block};
+    std::atomic<size_t> dropped_{0};
+    std::mutex asyncMutex_;  // guards setAsync
+    std::mutex drainMutex_;  // held by whoever consumes the queue
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> sleeping_{false};
+    bool stop_ = false;
+    std::thread thread_;
 #include <warn/pop>
     bool logStacktrace_ = false;
     MessageBreakLevel breakLevel_ = MessageBreakLevel::Off;
@@ -34,6 +34,7 @@
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
+#include <inviwo/core/util/logcentral.h>
 
 namespace inviwo {
 
@@ -51,12 +52,15 @@ public:
     StringProperty workspaceAuthor_;
     TemplateOptionProperty<UsageMode> applicationUsageMode_;
     IntSizeTProperty poolSize_;
+    BoolProperty concurrentEvaluation_;
     BoolProperty enablePortInspectors_;
     IntProperty portInspectorSize_;
     BoolProperty enableTouchProperty_;
     BoolProperty enablePickingProperty_;
     BoolProperty enableSoundProperty_;
     BoolProperty logStackTraceProperty_;
+    BoolProperty asyncLogging_;
+    TemplateOptionProperty<LogOverflowPolicy> logOverflow_;
     BoolProperty runtimeModuleReloading_;
     BoolProperty enableResourceManager_;
     TemplateOptionProperty<MessageBreakLevel> breakOnMessage_;
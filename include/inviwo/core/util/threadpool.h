@@ -61,7 +61,8 @@
 #include <warn/push>
 #include <warn/ignore/all>
 #include <vector>
-#include <queue>
+#include <deque>
+#include <array>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -70,12 +71,99 @@
 #include <functional>
 #include <stdexcept>
 #include <atomic>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <tuple>
 #include <warn/pop>
 
 namespace inviwo {
 
+/**
+ * A work-stealing thread pool. Every worker owns a set of deques, one per Priority. Tasks
+ * enqueued from a worker thread go into that worker's own deque and are executed in LIFO order
+ * by the owner. Tasks enqueued from other threads are distributed round-robin over the deques.
+ * Idle workers steal the oldest tasks from the other deques, starting from the highest priority.
+ * Small tasks are stored inline in a ThreadPool::Task without any additional heap allocation.
+ *
+ * Running tasks can fork and join child tasks using a ThreadPool::TaskGroup.
+ */
 class IVW_CORE_API ThreadPool {
 public:
+    enum class Priority { High = 0, Normal = 1, Low = 2 };
+    static constexpr size_t nPriorities = 3;
+
+    /**
+     * Move-only type erased `void()` callable with an inline buffer for small functors.
+     * Functors that do not fit into the buffer are allocated on the heap.
+     */
+    class Task {
+    public:
+        static constexpr size_t bufferSize = 6 * sizeof(void*);
+
+        Task() = default;
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+        Task(F&& f);
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task(Task&& rhs) noexcept;
+        Task& operator=(Task&& rhs) noexcept;
+        ~Task();
+
+        void operator()() { ops_->invoke(&buffer_); }
+        explicit operator bool() const { return ops_ != nullptr; }
+
+    private:
+        struct Ops {
+            void (*invoke)(void*);
+            void (*move)(void* dst, void* src) noexcept;
+            void (*destroy)(void*) noexcept;
+        };
+        template <typename F>
+        static constexpr bool isInline() {
+            return sizeof(F) <= bufferSize && alignof(F) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible_v<F>;
+        }
+        template <typename F>
+        static const Ops* inlineOps();
+        template <typename F>
+        static const Ops* heapOps();
+
+        std::aligned_storage_t<bufferSize, alignof(std::max_align_t)> buffer_;
+        const Ops* ops_ = nullptr;
+    };
+
+    /**
+     * Fork/join helper. Tasks added with run() are executed on the pool, wait() blocks until all
+     * of them are done. If wait() is called from a worker thread the worker will execute other
+     * pending tasks while waiting, hence it is safe to fork and join from within a running task.
+     * The first exception thrown by any of the tasks is rethrown from wait().
+     * The destructor will wait for any remaining tasks but discards exceptions.
+     */
+    class IVW_CORE_API TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool);
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        ~TaskGroup();
+
+        template <typename F>
+        void run(F&& f, Priority priority = Priority::Normal);
+        void wait();
+
+    private:
+        void finish(std::exception_ptr e);
+        void waitForTasks();
+
+        ThreadPool& pool_;
+        size_t pending_;
+        std::exception_ptr exception_;
+        std::mutex mutex_;
+        std::condition_variable done_;
+    };
+
     ThreadPool(size_t threads, std::function<void()> onThreadStart = []() {},
                std::function<void()> onThreadStop = []() {});
     ~ThreadPool();
@@ -87,16 +175,33 @@ public:
     template <class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
 
+    /**
+     * Enqueue function f with arguments args using the given priority.
+     * The function f may throw exceptions.
+     * @return a future to the result of f
+     */
+    template <class F, class... Args>
+    auto enqueue(Priority priority, F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<F, Args...>>;
+
     /**
      * Enqueue a plain functor. The functor may not throw exceptions.
      */
-    void enqueueRaw(std::function<void()> f);
+    void enqueueRaw(Task task, Priority priority = Priority::Normal);
 
     size_t trySetSize(size_t size);
     size_t getSize() const;
 
+    /**
+     * The number of tasks waiting to be executed.
+     */
     size_t getQueueSize();
 
+    /**
+     * Returns true if called from one of the worker threads of this pool.
+     */
+    bool isWorkerThread() const;
+
 private:
     enum class State {
         Free,     //< Worker is waiting for tasks.
@@ -106,8 +211,24 @@ private:
         Done      //< Worker is waiting to be joined.
     };
 
+    /**
+     * One deque per priority. The owner pushes and pops at the back, other threads push external
+     * tasks at the front and steal from the front. Unless told to wait, steal gives up on a queue
+     * that is locked by another thread.
+     */
+    struct WorkQueue {
+        bool pop(Task& task, Priority priority);
+        bool steal(Task& task, Priority priority, bool wait);
+        void push(Task&& task, Priority priority, bool local);
+
+        std::mutex mutex;
+        std::array<std::deque<Task>, nPriorities> tasks;
+        std::array<std::atomic<size_t>, nPriorities> sizes{};
+        std::atomic<bool> owned{false};
+    };
+
     struct Worker {
-        Worker(ThreadPool& pool);
+        Worker(ThreadPool& pool, WorkQueue& queue);
         Worker(const Worker&) = delete;
         Worker(Worker&& rhs) = delete;
         Worker& operator=(const Worker&) = delete;
@@ -115,16 +236,34 @@ private:
         ~Worker();
 
         std::atomic<State> state;  //< State of the worker
+        WorkQueue& queue;
         std::thread thread;
     };
+
+    void push(Task&& task, Priority priority);
+    bool tryPop(WorkQueue* own, Task& task);
+    bool runPendingTask();
+    WorkQueue& acquireQueue();
+    void notifyOne();
+    void notifyAll();
+
+    // The work queues are only ever appended to and never moved or deleted while the pool is
+    // alive, so that stealing workers can safely iterate over them without locking.
+    static constexpr size_t maxQueues = 256;
+    std::array<std::atomic<WorkQueue*>, maxQueues> queues_{};
+    std::vector<std::unique_ptr<WorkQueue>> ownedQueues_;
+    std::atomic<size_t> nQueues_{0};
+    std::atomic<size_t> nextQueue_{0};
+
     // need to keep track of threads so we can join them
     std::vector<std::unique_ptr<Worker>> workers;
 
-    // the task queue
-    std::queue<std::function<void()>> tasks;
+    // number of tasks in all the queues
+    std::atomic<size_t> pending_{0};
 
-    // synchronization
-    std::mutex queue_mutex;
+    // synchronization for idle workers
+    std::atomic<size_t> sleeping_{0};
+    std::mutex sleep_mutex;
     std::condition_variable condition;
 
     // Thread start end exit actions
@@ -132,23 +271,103 @@ private:
     std::function<void()> onThreadStop_;
 };
 
+template <typename F, typename>
+ThreadPool::Task::Task(F&& f) {
+    using Fun = std::decay_t<F>;
+    if constexpr (isInline<Fun>()) {
+        ::new (static_cast<void*>(&buffer_)) Fun(std::forward<F>(f));
+        ops_ = inlineOps<Fun>();
+    } else {
+        ::new (static_cast<void*>(&buffer_)) Fun*(new Fun(std::forward<F>(f)));
+        ops_ = heapOps<Fun>();
+    }
+}
+
+template <typename F>
+auto ThreadPool::Task::inlineOps() -> const Ops* {
+    static constexpr Ops ops{
+        [](void* self) { (*std::launder(static_cast<F*>(self)))(); },
+        [](void* dst, void* src) noexcept {
+            auto from = std::launder(static_cast<F*>(src));
+            ::new (dst) F(std::move(*from));
+            from->~F();
+        },
+        [](void* self) noexcept { std::launder(static_cast<F*>(self))->~F(); }};
+    return &ops;
+}
+
+template <typename F>
+auto ThreadPool::Task::heapOps() -> const Ops* {
+    static constexpr Ops ops{
+        [](void* self) { (**std::launder(static_cast<F**>(self)))(); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) F*(*std::launder(static_cast<F**>(src)));
+        },
+        [](void* self) noexcept { delete *std::launder(static_cast<F**>(self)); }};
+    return &ops;
+}
+
+inline ThreadPool::Task::Task(Task&& rhs) noexcept : ops_{rhs.ops_} {
+    if (ops_) {
+        ops_->move(&buffer_, &rhs.buffer_);
+        rhs.ops_ = nullptr;
+    }
+}
+
+inline ThreadPool::Task& ThreadPool::Task::operator=(Task&& rhs) noexcept {
+    if (this != &rhs) {
+        if (ops_) ops_->destroy(&buffer_);
+        ops_ = rhs.ops_;
+        if (ops_) {
+            ops_->move(&buffer_, &rhs.buffer_);
+            rhs.ops_ = nullptr;
+        }
+    }
+    return *this;
+}
+
+inline ThreadPool::Task::~Task() {
+    if (ops_) ops_->destroy(&buffer_);
+}
+
+template <typename F>
+void ThreadPool::TaskGroup::run(F&& f, Priority priority) {
+    {
+        std::scoped_lock lock{mutex_};
+        ++pending_;
+    }
+    pool_.enqueueRaw(Task{[this, fun = std::forward<F>(f)]() mutable {
+                         std::exception_ptr e;
+                         try {
+                             fun();
+                         } catch (...) {
+                             e = std::current_exception();
+                         }
+                         finish(e);
+                     }},
+                     priority);
+}
+
 // add new work item to the pool
 template <class F, class... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
-    using return_type = std::invoke_result_t<F, Args...>;
+    return enqueue(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+}
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+template <class F, class... Args>
+auto ThreadPool::enqueue(Priority priority, F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
 
-    std::future<return_type> res = task->get_future();
+    // The packaged_task only holds a pointer to its shared state, it will always fit inline in
+    // the Task so this only allocates the shared state of the future.
+    std::packaged_task<return_type()> task{
+        [fun = std::forward<F>(f), tup = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+            return std::apply(fun, tup);
+        }};
 
-    if (workers.empty()) {
-        (*task)();  // No worker threads, just run the task.
-    } else {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace([task]() { (*task)(); });
-    }
-    condition.notify_one();
+    std::future<return_type> res = task.get_future();
+    enqueueRaw(Task{std::move(task)}, priority);
     return res;
 }
 
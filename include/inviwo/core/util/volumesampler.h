@@ -35,17 +35,80 @@
 #include <inviwo/core/util/interpolation.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
 
 #include <inviwo/core/util/spatialsampler.h>
+#include <inviwo/core/util/glm.h>
+
+#include <tcb/span.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace inviwo {
 
+namespace detail {
+
+/**
+ * Typed trilinear sampling in data space of the raw voxel data of a VolumeRAMPrecision<T>.
+ * Voxel indices are clamped to the volume and values converted as VolumeRAM::getAsDVec4 and
+ * friends do, hence the result is identical to sampling through the virtual VolumeRAM accessors.
+ */
+template <unsigned int DataDims, typename T>
+void volumeDoubleSamplerBatch(const void* rawData, const size3_t& dims,
+                              util::span<const dvec3> positions,
+                              util::span<Vector<DataDims, double>> result) {
+    using Out = Vector<DataDims, double>;
+    const T* data = static_cast<const T*>(rawData);
+    const dvec3 scale{dims - size3_t(1)};
+    const size3_t maxIndex{dims - size3_t(1)};
+    const size_t strideY = dims.x;
+    const size_t strideZ = dims.x * dims.y;
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const dvec3& pos = positions[i];
+        if (glm::any(glm::lessThan(pos, dvec3(0.0))) ||
+            glm::any(glm::greaterThan(pos, dvec3(1.0)))) {
+            result[i] = Out(0.0);
+            continue;
+        }
+        const dvec3 samplePos = pos * scale;
+        const size3_t indexPos = size3_t(samplePos);
+        const dvec3 interpolants = samplePos - dvec3(indexPos);
+
+        const size_t x0 = std::min(indexPos.x, maxIndex.x);
+        const size_t x1 = std::min(indexPos.x + 1, maxIndex.x);
+        const size_t y0 = std::min(indexPos.y, maxIndex.y) * strideY;
+        const size_t y1 = std::min(indexPos.y + 1, maxIndex.y) * strideY;
+        const size_t z0 = std::min(indexPos.z, maxIndex.z) * strideZ;
+        const size_t z1 = std::min(indexPos.z + 1, maxIndex.z) * strideZ;
+
+        const Out samples[8] = {util::glm_convert<Out>(data[x0 + y0 + z0]),
+                                util::glm_convert<Out>(data[x1 + y0 + z0]),
+                                util::glm_convert<Out>(data[x0 + y1 + z0]),
+                                util::glm_convert<Out>(data[x1 + y1 + z0]),
+                                util::glm_convert<Out>(data[x0 + y0 + z1]),
+                                util::glm_convert<Out>(data[x1 + y0 + z1]),
+                                util::glm_convert<Out>(data[x0 + y1 + z1]),
+                                util::glm_convert<Out>(data[x1 + y1 + z1])};
+
+        result[i] = Interpolation<Out>::trilinear(samples, interpolants);
+    }
+}
+
+}  // namespace detail
+
 /**
  * \class VolumeDoubleSampler
+ * Trilinear sampling of a Volume returning doubles. The concrete VolumeRAMPrecision<T> is
+ * determined once at construction, sampling then reads the typed voxel data directly without any
+ * virtual calls. For sampling many positions at once use the batch version of sample().
  */
 template <unsigned int DataDims>
 class VolumeDoubleSampler : public SpatialSampler<3, DataDims, double> {
 public:
+    using ReturnType = Vector<DataDims, double>;
+
     VolumeDoubleSampler(std::shared_ptr<const Volume> vol,
                         CoordinateSpace space = CoordinateSpace::Data);
     VolumeDoubleSampler(const Volume &vol, CoordinateSpace space = CoordinateSpace::Data);
@@ -53,15 +116,27 @@ public:
 
     VolumeDoubleSampler &operator=(const VolumeDoubleSampler &) = default;
 
+    using SpatialSampler<3, DataDims, double>::sample;
+
+    /**
+     * Sample all positions, given in the coordinate space of the sampler, into result.
+     * Equivalent to calling sample(positions[i]) for each position, but without any virtual calls.
+     * Positions outside of [0,1] in data space give zero, regardless of withinBoundsDataSpace.
+     * @pre result.size() >= positions.size()
+     */
+    void sample(util::span<const dvec3> positions, util::span<ReturnType> result) const;
+
     virtual Vector<DataDims, double> sampleDataSpace(const dvec3 &pos) const override;
     virtual bool withinBoundsDataSpace(const dvec3 &pos) const override;
 
 protected:
-    Vector<DataDims, double> getVoxel(const size3_t &pos) const;
+    using BatchFunction = void (*)(const void *, const size3_t &, util::span<const dvec3>,
+                                   util::span<ReturnType>);
 
     std::shared_ptr<const Volume> volume_;
-    const VolumeRAM *ram_;
     size3_t dims_;
+    const void *data_;
+    BatchFunction batch_;
 };
 
 using VolumeSampler = VolumeDoubleSampler<4>;
@@ -76,54 +151,40 @@ VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(std::shared_ptr<const Volume>
 template <unsigned int DataDims>
 VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(const Volume &vol, CoordinateSpace space)
     : SpatialSampler<3, DataDims, double>(vol, space)
-    , ram_(vol.getRepresentation<VolumeRAM>())
-    , dims_(vol.getDimensions()) {}
+    , dims_(vol.getDimensions())
+    , data_(vol.getRepresentation<VolumeRAM>()->getData())
+    , batch_(vol.getRepresentation<VolumeRAM>()->dispatch<BatchFunction>(
+          [](auto vrprecision) -> BatchFunction {
+              using ValueType = util::PrecisionValueType<decltype(vrprecision)>;
+              return &detail::volumeDoubleSamplerBatch<DataDims, ValueType>;
+          })) {}
+
+template <unsigned int DataDims>
+void VolumeDoubleSampler<DataDims>::sample(util::span<const dvec3> positions,
+                                           util::span<ReturnType> result) const {
+    if (this->space_ == CoordinateSpace::Data) {
+        batch_(data_, dims_, positions, result.first(positions.size()));
+    } else {
+        std::vector<dvec3> dataPositions(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const auto p = this->transform_ * dvec4(positions[i], 1.0);
+            dataPositions[i] = dvec3(p) / p.w;
+        }
+        batch_(data_, dims_, dataPositions, result.first(positions.size()));
+    }
+}
 
 template <unsigned int DataDims>
 Vector<DataDims, double> VolumeDoubleSampler<DataDims>::sampleDataSpace(const dvec3 &pos) const {
     if (!withinBoundsDataSpace(pos)) {
         return Vector<DataDims, double>(0.0);
     }
-    const dvec3 samplePos = pos * dvec3(dims_ - size3_t(1));
-    const size3_t indexPos = size3_t(samplePos);
-    const dvec3 interpolants = samplePos - dvec3(indexPos);
-
-    Vector<DataDims, double> samples[8];
-    samples[0] = getVoxel(indexPos);
-    samples[1] = getVoxel(indexPos + size3_t(1, 0, 0));
-    samples[2] = getVoxel(indexPos + size3_t(0, 1, 0));
-    samples[3] = getVoxel(indexPos + size3_t(1, 1, 0));
-
-    samples[4] = getVoxel(indexPos + size3_t(0, 0, 1));
-    samples[5] = getVoxel(indexPos + size3_t(1, 0, 1));
-    samples[6] = getVoxel(indexPos + size3_t(0, 1, 1));
-    samples[7] = getVoxel(indexPos + size3_t(1, 1, 1));
-
-    return Interpolation<Vector<DataDims, double>>::trilinear(samples, interpolants);
-}
-
-template <>
-inline Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const {
-    const auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDouble(p);
-}
-
-template <>
-inline Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const {
-    const auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec2(p);
-}
-
-template <>
-inline Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const {
-    const auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec3(p);
-}
-
-template <>
-inline Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const {
-    const auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec4(p);
+    // Derived samplers may accept positions outside of [0,1], sample those at the border
+    const dvec3 samplePos = glm::clamp(pos, dvec3(0.0), dvec3(1.0));
+    ReturnType result;
+    batch_(data_, dims_, util::span<const dvec3>(&samplePos, 1),
+           util::span<ReturnType>(&result, 1));
+    return result;
 }
 
 template <unsigned int DataDims>
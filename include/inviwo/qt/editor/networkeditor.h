@@ -92,8 +92,12 @@ public:
     NetworkEditor(InviwoMainWindow* mainwindow);
     virtual ~NetworkEditor() = default;
 
-    QByteArray copy() const;
-    QByteArray cut();
+    /**
+     * Serialize the selected processors. The returned mime data holds the binary serialization
+     * under getBinaryMimeTag(), and xml under getMimeTag() and as plain text.
+     */
+    std::unique_ptr<QMimeData> copy() const;
+    std::unique_ptr<QMimeData> cut();
     void paste(QByteArray data);
     void append(std::istream& is, const std::string& refPath = "");
     void selectAll();
@@ -141,6 +145,7 @@ public:
     QRectF getProcessorsBoundingRect() const;
 
     static std::string getMimeTag();
+    static std::string getBinaryMimeTag();
     void resetAllTimeMeasurements();
 
     void showLinkDialog(Processor* processor1, Processor* processor2);
@@ -39,6 +39,7 @@
 #include <modules/animation/datastructures/animationtime.h>
 #include <modules/animation/datastructures/animationstate.h>
 #include <modules/animation/animationcontrollerobserver.h>
+#include <modules/animation/frameexportqueue.h>
 
 #include <inviwo/core/properties/buttonproperty.h>
 #include <inviwo/core/properties/compositeproperty.h>
@@ -124,6 +125,7 @@ public:
     StringProperty renderBaseName;
     OptionPropertyString renderImageExtension;
     IntProperty renderNumFrames;
+    IntProperty renderExportQueueSize;
     ButtonProperty renderAction;
     ButtonProperty renderActionStop;
 
@@ -179,10 +181,15 @@ protected:
         std::string baseFileName;
         std::vector<RenderCanvasSize> origCanvasSettings;
         std::string canvasIndicator;
+        std::shared_ptr<const DataWriterType<Layer>> writer;
+        Clock::duration renderTime{0};
     };
 
     /// State needed during rendering
     RenderState renderState_;
+
+    /// Encodes and writes the rendered frames in the background
+    FrameExportQueue exportQueue_;
 };
 
 }  // namespace animation
@@ -0,0 +1,139 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/animation/animationmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/io/datawriter.h>
+#include <inviwo/core/util/clock.h>
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+class InviwoApplication;
+class Layer;
+class ThreadPool;
+
+namespace animation {
+
+/**
+ * \brief A bounded queue of images to encode and write to disk in the background.
+ *
+ * push() copies the LayerRAM representation of the layer on the calling thread, the encoding and
+ * writing of the copy is then done on the thread pool while the caller continues, for example
+ * with rendering the next frame of an animation. At most getCapacity() images are in flight at
+ * the same time. A caller that should not block can check isFull() before pushing, otherwise
+ * push() waits for the oldest image to be written.
+ *
+ * The time spent on each stage is recorded per frame, see getTimings().
+ */
+class IVW_MODULE_ANIMATION_API FrameExportQueue {
+public:
+    struct FrameTimings {
+        std::string path;
+        Clock::duration render{0};  ///< As reported by the caller of push()
+        Clock::duration copy{0};    ///< Copying the layer into a LayerRAM on the calling thread
+        Clock::duration encode{0};  ///< Encoding the image into the file format
+        Clock::duration write{0};   ///< Writing the encoded image to disk
+        std::string error;          ///< Empty if the frame was written successfully
+    };
+
+    /**
+     * Uses the thread pool of \p app
+     */
+    FrameExportQueue(size_t capacity, InviwoApplication* app);
+    FrameExportQueue(size_t capacity, ThreadPool& pool);
+    FrameExportQueue(const FrameExportQueue&) = delete;
+    FrameExportQueue& operator=(const FrameExportQueue&) = delete;
+    /**
+     * Waits for all pending frames to be written
+     */
+    ~FrameExportQueue();
+
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+
+    /**
+     * Collects the images that have been written and returns true if there are still
+     * getCapacity() images pending.
+     */
+    bool isFull();
+
+    /**
+     * Copies \p layer and queues it for writing to \p path using \p writer. The extension of
+     * \p path is used to select the file format of writers supporting several formats. If the
+     * queue is full, waits for the oldest pending image to be written first.
+     * @param layer the image to write
+     * @param path the file to write to, will be overwritten if it exists
+     * @param writer writer to encode the image with, will be called from the thread pool
+     * @param renderTime time spent on rendering the frame, for the statistics only
+     */
+    void push(const Layer& layer, const std::string& path,
+              std::shared_ptr<const DataWriterType<Layer>> writer,
+              Clock::duration renderTime = Clock::duration{0});
+
+    /**
+     * Blocks until all pending frames have been written
+     */
+    void wait();
+
+    /**
+     * The timings of all written frames, in the order they were pushed. Frames that are still
+     * pending are not included.
+     */
+    const std::vector<FrameTimings>& getTimings() const;
+    void clearTimings();
+
+    /**
+     * Logs the total and average time spent on rendering, copying, encoding, and writing
+     * of the written frames.
+     */
+    void logSummary() const;
+
+private:
+    void collect(bool block);
+    // Collect the oldest pending image, returns false if there is none or it is not done and
+    // block is false
+    bool collectFront(bool block);
+
+    size_t capacity_;
+    ThreadPool& pool_;
+    std::deque<std::future<FrameTimings>> pending_;
+    std::vector<FrameTimings> timings_;
+};
+
+}  // namespace animation
+
+}  // namespace inviwo
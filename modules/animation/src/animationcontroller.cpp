@@ -93,6 +93,8 @@ AnimationController::AnimationController(Animation& animation, InviwoApplication
           }())
     , renderNumFrames("RenderNumFrames", "# Frames", 100, 2, 1000000, 1,
                       InvalidationLevel::InvalidOutput, PropertySemantics::Text)
+    , renderExportQueueSize("RenderExportQueueSize", "Frames in Flight", 4, 1, 64, 1,
+                            InvalidationLevel::InvalidOutput, PropertySemantics::Text)
     , renderAction("RenderAction", "Render")
     , renderActionStop("RenderActionStop", "Stop")
     , controlOptions("ControlOptions", "Control Track")
@@ -107,7 +109,8 @@ AnimationController::AnimationController(Animation& animation, InviwoApplication
                      tickRender();
                  else
                      tick();
-             }} {
+             }}
+    , exportQueue_{static_cast<size_t>(renderExportQueueSize.get()), app} {
 
     // Play Settings
     playWindowMode.onChange([&]() { playWindow.setVisible(playWindowMode.get() == 1); });
@@ -143,6 +146,7 @@ AnimationController::AnimationController(Animation& animation, InviwoApplication
     renderOptions.addProperty(renderAspectRatio);
     renderOptions.addProperty(renderSize);
     renderOptions.addProperty(renderNumFrames);
+    renderOptions.addProperty(renderExportQueueSize);
     renderOptions.addProperty(renderLocation);
     renderOptions.addProperty(renderBaseName);
     renderOptions.addProperty(renderImageExtension);
@@ -225,6 +229,20 @@ void AnimationController::render() {
     if (renderState_.numFrames < 2) renderState_.numFrames = 2;
     renderState_.currentFrame = -1;  // first run, see below in tickRender()
     renderState_.baseFileName = renderLocation.get() + "/" + renderBaseName.get();
+    renderState_.renderTime = Clock::duration{0};
+
+    // The frames are encoded and written on the thread pool by the export queue
+    const auto ext = FileExtension::createFileExtensionFromString(renderImageExtension.get());
+    auto writer = app_->getDataWriterFactory()->getWriterForTypeAndExtension<Layer>(ext);
+    if (!writer) {
+        LogErrorCustom("AnimationController",
+                       "Could not find a writer for the file extension \"" << ext << "\"");
+        return;
+    }
+    writer->setOverwrite(true);
+    renderState_.writer = std::move(writer);
+    exportQueue_.setCapacity(static_cast<size_t>(renderExportQueueSize.get()));
+
     // - digits of the frame counter
     renderState_.digits = 0;
     int number(renderState_.numFrames - 1);
@@ -315,6 +333,12 @@ void AnimationController::afterRender() {
     renderActionStop.setVisible(false);
     renderAction.setVisible(true);
 
+    // Finish writing the rendered frames
+    exportQueue_.wait();
+    exportQueue_.logSummary();
+    exportQueue_.clearTimings();
+    renderState_.writer.reset();
+
     // Restore original state of Canvases
     auto network = app_->getProcessorNetwork();
     NetworkLock lock(network);
@@ -420,13 +444,30 @@ void AnimationController::tickRender() {
     // system to a proper state
     // - generate filename pattern
     if (renderState_.currentFrame >= 0) {
+        // - wait with the next frame until an earlier one has been written, the canvases keep
+        //   the current frame until then. Each canvas takes one slot in the queue, if there are
+        //   more canvases than free slots push() blocks until earlier images are written.
+        if (exportQueue_.isFull()) return;
+
         std::stringstream fileNamePattern;
         fileNamePattern << renderBaseName.get() << renderState_.canvasIndicator << std::setfill('0')
                         << std::setw(renderState_.digits) << renderState_.currentFrame;
         auto ext = FileExtension::createFileExtensionFromString(renderImageExtension.get());
-        // - save active canvases
-        util::saveAllCanvases(app_->getProcessorNetwork(), renderLocation.get(),
-                              fileNamePattern.str(), ext.extension_, true);
+        // - queue the active canvases for export
+        for (auto canvas : app_->getProcessorNetwork()->getProcessorsByType<CanvasProcessor>()) {
+            if (!canvas->isSink()) continue;
+            const auto layer = canvas->getVisibleLayer();
+            if (!canvas->isValid() || !canvas->isReady() || !layer) {
+                LogErrorCustom("AnimationController", "Canvas \""
+                                                          << canvas->getDisplayName()
+                                                          << "\" is not ready, no image saved");
+                continue;
+            }
+            auto fileName = fileNamePattern.str();
+            replaceInString(fileName, "UPN", canvas->getIdentifier());
+            exportQueue_.push(*layer, renderLocation.get() + "/" + fileName + "." + ext.extension_,
+                              renderState_.writer, renderState_.renderTime);
+        }
     }
 
     // Next!
@@ -446,8 +487,11 @@ void AnimationController::tickRender() {
         newTime += progress * (renderState_.lastTime - renderState_.firstTime);
     }
 
-    // Evaluate animation
+    // Evaluate animation, the network is evaluated when the lock in eval is released
+    Clock clock;
     eval(currentTime_, newTime);
+    clock.stop();
+    renderState_.renderTime = clock.getElapsedTime();
 }
 
 void AnimationController::eval(Seconds oldTime, Seconds newTime) {
@@ -0,0 +1,166 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/animation/frameexportqueue.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/util/threadpool.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace inviwo {
+
+namespace animation {
+
+FrameExportQueue::FrameExportQueue(size_t capacity, InviwoApplication* app)
+    : FrameExportQueue(capacity, app->getThreadPool()) {}
+
+FrameExportQueue::FrameExportQueue(size_t capacity, ThreadPool& pool)
+    : capacity_{std::max(capacity, size_t{1})}, pool_{pool} {}
+
+FrameExportQueue::~FrameExportQueue() { wait(); }
+
+void FrameExportQueue::setCapacity(size_t capacity) { capacity_ = std::max(capacity, size_t{1}); }
+
+size_t FrameExportQueue::getCapacity() const { return capacity_; }
+
+bool FrameExportQueue::isFull() {
+    collect(false);
+    return pending_.size() >= capacity_;
+}
+
+void FrameExportQueue::push(const Layer& layer, const std::string& path,
+                            std::shared_ptr<const DataWriterType<Layer>> writer,
+                            Clock::duration renderTime) {
+    collect(false);
+    while (pending_.size() >= capacity_) collectFront(true);
+
+    FrameTimings timings;
+    timings.path = path;
+    timings.render = renderTime;
+
+    // The copy has to be made here, the layer will be overwritten by the next frame and the
+    // download of a GL representation needs the context of the calling thread
+    Clock clock;
+    auto ram = std::shared_ptr<LayerRAM>(layer.getRepresentation<LayerRAM>()->clone());
+    auto copy = std::make_shared<const Layer>(ram);
+    clock.stop();
+    timings.copy = clock.getElapsedTime();
+
+    pending_.push_back(pool_.enqueue([copy, writer, timings]() mutable -> FrameTimings {
+        try {
+            Clock clock;
+            const auto buffer =
+                writer->writeDataToBuffer(copy.get(), filesystem::getFileExtension(timings.path));
+            clock.stop();
+            timings.encode = clock.getElapsedTime();
+
+            clock.reset();
+            clock.start();
+            if (buffer) {
+                auto file = filesystem::ofstream(timings.path, std::ios::out | std::ios::binary);
+                file.write(reinterpret_cast<const char*>(buffer->data()), buffer->size());
+                if (!file) {
+                    throw Exception("Could not write to file: " + timings.path,
+                                    IVW_CONTEXT_CUSTOM("FrameExportQueue"));
+                }
+            } else {
+                // The writer can not encode into memory, let it do both encoding and writing
+                writer->writeData(copy.get(), timings.path);
+            }
+            clock.stop();
+            timings.write = clock.getElapsedTime();
+        } catch (const Exception& e) {
+            timings.error = e.getMessage();
+        } catch (const std::exception& e) {
+            timings.error = e.what();
+        }
+        return timings;
+    }));
+}
+
+void FrameExportQueue::wait() { collect(true); }
+
+const std::vector<FrameExportQueue::FrameTimings>& FrameExportQueue::getTimings() const {
+    return timings_;
+}
+
+void FrameExportQueue::clearTimings() { timings_.clear(); }
+
+void FrameExportQueue::collect(bool block) {
+    // Frames are collected in the order they were pushed, so a finished frame might have to wait
+    // for an earlier one. That is fine since isFull() only needs a bound on the pending frames.
+    while (collectFront(block)) {
+    }
+}
+
+bool FrameExportQueue::collectFront(bool block) {
+    if (pending_.empty()) return false;
+    auto& front = pending_.front();
+    if (!block && front.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    auto timings = front.get();
+    pending_.pop_front();
+    if (!timings.error.empty()) {
+        LogErrorCustom("FrameExportQueue",
+                       "Could not export \"" << timings.path << "\": " << timings.error);
+    }
+    timings_.push_back(std::move(timings));
+    return true;
+}
+
+void FrameExportQueue::logSummary() const {
+    if (timings_.empty()) return;
+
+    FrameTimings total;
+    for (const auto& t : timings_) {
+        total.render += t.render;
+        total.copy += t.copy;
+        total.encode += t.encode;
+        total.write += t.write;
+    }
+    const auto n = static_cast<Clock::duration::rep>(timings_.size());
+    const auto line = [&](const std::string& stage, Clock::duration duration) {
+        return "\n    " + stage + durationToString(duration) + " (" +
+               durationToString(duration / n) + " per frame)";
+    };
+    LogInfoCustom("FrameExportQueue",
+                  "Exported " << timings_.size() << " frames" << line("Render: ", total.render)
+                              << line("Copy:   ", total.copy) << line("Encode: ", total.encode)
+                              << line("Write:  ", total.write));
+}
+
+}  // namespace animation
+
+}  // namespace inviwo
@@ -0,0 +1,172 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/animation/frameexportqueue.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/util/threadpool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace inviwo {
+namespace animation {
+
+namespace {
+
+/**
+ * Records the first pixel of each written image instead of writing any files. Paths containing
+ * "fail" throw, and each write takes a few milliseconds to let the frames overlap. Writes are
+ * held back while the gate is locked exclusively.
+ */
+class StubWriter : public DataWriterType<Layer> {
+public:
+    struct State {
+        std::mutex mutex;
+        std::map<std::string, float> written;
+        std::atomic<int> active{0};
+        std::atomic<int> maxActive{0};
+        std::shared_mutex gate;
+    };
+
+    StubWriter() : state{std::make_shared<State>()} {}
+    virtual StubWriter* clone() const override { return new StubWriter(*this); }
+
+    virtual void writeData(const Layer* data, const std::string filePath) const override {
+        std::shared_lock gate{state->gate};
+        const auto active = ++state->active;
+        for (auto max = state->maxActive.load(); active > max;) {
+            if (state->maxActive.compare_exchange_weak(max, active)) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        --state->active;
+
+        if (filePath.find("fail") != std::string::npos) {
+            throw Exception("Stub failure for " + filePath, IVW_CONTEXT);
+        }
+        const auto ram = static_cast<const LayerRAMPrecision<float>*>(
+            data->getRepresentation<LayerRAM>());
+        std::scoped_lock lock{state->mutex};
+        state->written[filePath] = ram->getDataTyped()[0];
+    }
+
+    std::shared_ptr<State> state;
+};
+
+struct FrameExportQueueTest : ::testing::Test {
+    FrameExportQueueTest()
+        : ram{std::make_shared<LayerRAMPrecision<float>>(size2_t{4, 4})}
+        , layer{ram}
+        , writer{std::make_shared<StubWriter>()} {}
+
+    void setPixel(float value) { ram->getDataTyped()[0] = value; }
+
+    ThreadPool pool{4};
+    std::shared_ptr<LayerRAMPrecision<float>> ram;
+    Layer layer;
+    std::shared_ptr<StubWriter> writer;
+};
+
+}  // namespace
+
+TEST_F(FrameExportQueueTest, order) {
+    FrameExportQueue queue(3, pool);
+    for (int i = 0; i < 20; ++i) {
+        setPixel(static_cast<float>(i));
+        queue.push(layer, "frame" + std::to_string(i) + ".png", writer);
+    }
+    queue.wait();
+
+    const auto& timings = queue.getTimings();
+    ASSERT_EQ(size_t{20}, timings.size());
+    for (int i = 0; i < 20; ++i) {
+        const auto path = "frame" + std::to_string(i) + ".png";
+        EXPECT_EQ(path, timings[i].path);
+        EXPECT_TRUE(timings[i].error.empty());
+        // Each frame is written from a copy made at push
+        EXPECT_EQ(static_cast<float>(i), writer->state->written.at(path));
+    }
+    EXPECT_LE(writer->state->maxActive.load(), 3);
+}
+
+TEST_F(FrameExportQueueTest, errors) {
+    FrameExportQueue queue(2, pool);
+    queue.push(layer, "first.png", writer);
+    queue.push(layer, "fail.png", writer);
+    queue.push(layer, "last.png", writer);
+    queue.wait();
+
+    const auto& timings = queue.getTimings();
+    ASSERT_EQ(size_t{3}, timings.size());
+    EXPECT_TRUE(timings[0].error.empty());
+    EXPECT_NE(std::string::npos, timings[1].error.find("fail.png"));
+    EXPECT_TRUE(timings[2].error.empty());
+    EXPECT_EQ(size_t{2}, writer->state->written.size());
+
+    queue.clearTimings();
+    EXPECT_TRUE(queue.getTimings().empty());
+}
+
+TEST_F(FrameExportQueueTest, waitAndCapacity) {
+    FrameExportQueue queue(2, pool);
+    EXPECT_FALSE(queue.isFull());
+    {
+        std::unique_lock gate{writer->state->gate};
+        queue.push(layer, "a.png", writer);
+        EXPECT_FALSE(queue.isFull());
+        queue.push(layer, "b.png", writer);
+        EXPECT_TRUE(queue.isFull());
+        EXPECT_TRUE(queue.getTimings().empty());
+    }
+    queue.wait();
+    EXPECT_FALSE(queue.isFull());
+    EXPECT_EQ(size_t{2}, queue.getTimings().size());
+    EXPECT_EQ(size_t{2}, writer->state->written.size());
+
+    // Pushing to a full queue waits for the oldest image, so at most one write is in flight
+    writer->state->maxActive = 0;
+    queue.setCapacity(1);
+    for (int i = 0; i < 5; ++i) queue.push(layer, "c" + std::to_string(i) + ".png", writer);
+    queue.wait();
+    EXPECT_EQ(size_t{7}, queue.getTimings().size());
+    EXPECT_EQ(1, writer->state->maxActive.load());
+}
+
+}  // namespace animation
+}  // namespace inviwo
@@ -34,6 +34,13 @@
 #include <inviwo/core/common/inviwo.h>
 #include <modules/base/algorithm/algorithmoptions.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
 namespace inviwo {
 
 class VolumeRAM;
@@ -66,49 +73,89 @@ IVW_MODULE_BASE_API std::pair<dvec4, dvec4> bufferMinMax(
 
 namespace detail {
 
-// Specialization for double, float, half
-template <typename ValueType,
-          typename std::enable_if<util::is_floating_point<ValueType>::value, int>::type = 0>
-std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
-                                   IgnoreSpecialValues ignore = IgnoreSpecialValues::No) {
-    using Res = std::pair<ValueType, ValueType>;
-    Res minmax{DataFormat<ValueType>::max(), DataFormat<ValueType>::lowest()};
-
-    if (ignore == IgnoreSpecialValues::Yes) {
-        minmax = std::accumulate(
-            data, data + size, minmax, [](const Res& mm, const ValueType& v) -> Res {
-                Res res(mm);
-                for (size_t i = 0; i < util::flat_extent<ValueType>::value; ++i) {
-                    if (util::isfinite(util::glmcomp(v, i))) {
-                        util::glmcomp(res.first, i) =
-                            std::min(util::glmcomp(mm.first, i), util::glmcomp(v, i));
-                        util::glmcomp(res.second, i) =
-                            std::max(util::glmcomp(mm.second, i), util::glmcomp(v, i));
-                    }
-                }
-                return res;
-            });
+template <typename T>
+bool isFiniteComponent(T v) {
+    if constexpr (std::is_floating_point<T>::value) {
+        // false for both infinity and NaN, and unlike std::isfinite it vectorizes
+        return std::abs(v) <= std::numeric_limits<T>::max();
     } else {
-        minmax = std::accumulate(data, data + size, minmax,
-                                 [](const Res& mm, const ValueType& v) -> Res {
-                                     return {glm::min(mm.first, v), glm::max(mm.second, v)};
-                                 });
+        return util::isfinite(v);
     }
+}
 
-    return {util::glm_convert<dvec4>(minmax.first), util::glm_convert<dvec4>(minmax.second)};
+/**
+ * Component-wise minimum and maximum of \p size values. The values are treated as a flat array
+ * of components with one accumulator per position in a block of `lanes` components, which lets
+ * the compiler vectorize the inner loop. Since `lanes` is a multiple of the number of
+ * components, accumulator `j` always sees component `j % N`.
+ */
+template <typename ValueType, bool ignoreSpecialValues>
+std::pair<ValueType, ValueType> dataMinMaxBlock(const ValueType* data, size_t size) {
+    using Comp = typename util::value_type<ValueType>::type;
+    constexpr size_t N = util::flat_extent<ValueType>::value;
+    constexpr size_t lanes = 16 * N;
+
+    std::array<Comp, lanes> mins;
+    std::array<Comp, lanes> maxs;
+    mins.fill(DataFormat<Comp>::max());
+    maxs.fill(DataFormat<Comp>::lowest());
+
+    const auto update = [&](size_t j, Comp v) {
+        // Written as selects rather than std::min/max to vectorize, NaNs never replace a value.
+        if constexpr (ignoreSpecialValues) {
+            const bool finite = isFiniteComponent(v);
+            const Comp lo = finite ? v : DataFormat<Comp>::max();
+            const Comp hi = finite ? v : DataFormat<Comp>::lowest();
+            mins[j] = lo < mins[j] ? lo : mins[j];
+            maxs[j] = maxs[j] < hi ? hi : maxs[j];
+        } else {
+            mins[j] = v < mins[j] ? v : mins[j];
+            maxs[j] = maxs[j] < v ? v : maxs[j];
+        }
+    };
+
+    const Comp* comps = reinterpret_cast<const Comp*>(data);
+    const size_t count = size * N;
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        for (size_t j = 0; j < lanes; ++j) update(j, comps[i + j]);
+    }
+    for (size_t j = 0; i + j < count; ++j) update(j, comps[i + j]);
+
+    std::pair<ValueType, ValueType> minmax{DataFormat<ValueType>::max(),
+                                           DataFormat<ValueType>::lowest()};
+    for (size_t j = 0; j < lanes; ++j) {
+        auto& min = util::glmcomp(minmax.first, j % N);
+        auto& max = util::glmcomp(minmax.second, j % N);
+        min = mins[j] < min ? mins[j] : min;
+        max = max < maxs[j] ? maxs[j] : max;
+    }
+    return minmax;
 }
-// Specialization for integer types. They do not have special values
-template <typename ValueType,
-          typename std::enable_if<!util::is_floating_point<ValueType>::value, int>::type = 0>
-std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
-                                   IgnoreSpecialValues = IgnoreSpecialValues::No) {
-    using Res = std::pair<ValueType, ValueType>;
-    Res minmax{DataFormat<ValueType>::max(), DataFormat<ValueType>::lowest()};
-    minmax =
-        std::accumulate(data, data + size, minmax, [](const Res& mm, const ValueType& v) -> Res {
-            return {glm::min(mm.first, v), glm::max(mm.second, v)};
-        });
 
+/**
+ * Splits the data into chunks that are processed in parallel if OpenMP is available.
+ */
+template <typename ValueType, bool ignoreSpecialValues>
+std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size) {
+    constexpr size_t chunkSize = size_t{1} << 18;
+    const size_t chunks = std::max(size_t{1}, (size + chunkSize - 1) / chunkSize);
+
+    std::vector<std::pair<ValueType, ValueType>> results(chunks);
+#pragma omp parallel for
+    for (long long c_ = 0; c_ < static_cast<long long>(chunks); ++c_) {
+        const size_t c = static_cast<size_t>(c_);  // OpenMP need signed integral type.
+        const size_t begin = c * chunkSize;
+        const size_t end = std::min(size, begin + chunkSize);
+        results[c] = dataMinMaxBlock<ValueType, ignoreSpecialValues>(
+            data + begin, end > begin ? end - begin : 0);
+    }
+
+    auto minmax = results.front();
+    for (size_t c = 1; c < chunks; ++c) {
+        minmax.first = glm::min(minmax.first, results[c].first);
+        minmax.second = glm::max(minmax.second, results[c].second);
+    }
     return {util::glm_convert<dvec4>(minmax.first), util::glm_convert<dvec4>(minmax.second)};
 }
 
@@ -125,7 +172,13 @@ std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
 template <typename ValueType>
 std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
                                    IgnoreSpecialValues ignore = IgnoreSpecialValues::No) {
-    return detail::dataMinMax<ValueType>(data, size, ignore);
+    // Integer types do not have special values
+    if constexpr (util::is_floating_point<ValueType>::value) {
+        if (ignore == IgnoreSpecialValues::Yes) {
+            return detail::dataMinMax<ValueType, true>(data, size);
+        }
+    }
+    return detail::dataMinMax<ValueType, false>(data, size);
 }
 
 }  // namespace util
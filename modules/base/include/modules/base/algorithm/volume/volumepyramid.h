@@ -0,0 +1,68 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/base/basemoduledefine.h>
+
+#include <string>
+
+namespace inviwo {
+
+class Volume;
+
+namespace util {
+
+/**
+ * Get the directory where the pyramid of \p volume is stored by default, i.e. next to the file
+ * given by the "filename" meta data of the volume. Returns an empty string if the volume has no
+ * such meta data.
+ * @see VolumePyramid
+ */
+IVW_MODULE_BASE_API std::string getVolumePyramidDirectory(const Volume& volume);
+
+/**
+ * Write all created levels of the pyramid of \p volume to \p directory as level1.ivf,
+ * level2.ivf, ... Levels that were loaded from or already saved to the same files are skipped.
+ * @throws DataWriterException if the files can not be written
+ */
+IVW_MODULE_BASE_API void saveVolumePyramid(const Volume& volume, const std::string& directory);
+
+/**
+ * Load the levels found in \p directory into the pyramid of \p volume. Only levels that match the
+ * volume and are newer than \p sourceFile, if given, are used. The voxel data is read when a
+ * level is first used.
+ * @return the number of loaded levels
+ */
+IVW_MODULE_BASE_API size_t loadVolumePyramid(const Volume& volume, const std::string& directory,
+                                             const std::string& sourceFile = "");
+
+}  // namespace util
+
+}  // namespace inviwo
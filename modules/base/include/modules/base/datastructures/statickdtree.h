@@ -0,0 +1,318 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/util/glm.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \ingroup datastructures
+ * \brief A balanced KD-tree over a fixed set of points
+ *
+ * In contrast to KDTree, which links heap allocated nodes and is built by inserting one point at
+ * a time, the tree is built once from all points and stored implicitly in flat arrays. Each
+ * internal node splits its range of points at the median along the dimension of largest extent;
+ * the children of node `i` are nodes `2i + 1` and `2i + 2`. Points end up in buckets of at most
+ * `leafSize` points, stored contiguously in tree order. Building takes O(n log n), the levels of
+ * the tree are partitioned in parallel.
+ *
+ * Queries return the index of the points in the input vector together with the squared distance
+ * to the query point. The batched queries process the query points in parallel.
+ */
+template <unsigned int N, typename P = double>
+class StaticKDTree {
+public:
+    using Point = Vector<N, P>;
+
+    struct Neighbor {
+        size_t index;  //!< index of the point in the input vector
+        P sqDist;      //!< squared distance to the query point
+    };
+
+    StaticKDTree() = default;
+    explicit StaticKDTree(const std::vector<Point>& points, size_t leafSize = 16);
+
+    size_t size() const { return points_.size(); }
+    bool empty() const { return points_.empty(); }
+    size_t getLeafSize() const { return leafSize_; }
+    /**
+     * Number of levels of internal nodes, all leaves are at this depth
+     */
+    size_t depth() const { return depth_; }
+
+    /**
+     * The point closest to \p query, or std::nullopt if the tree is empty
+     */
+    std::optional<Neighbor> nearest(const Point& query) const;
+
+    /**
+     * The \p k points closest to \p query, sorted by increasing distance. Fewer than \p k points
+     * are returned if the tree holds less points.
+     */
+    std::vector<Neighbor> knn(const Point& query, size_t k) const;
+
+    /**
+     * All points within \p radius of \p query, sorted by increasing distance.
+     */
+    std::vector<Neighbor> radius(const Point& query, P radius) const;
+
+    /**
+     * The \p k nearest points of each query point, evaluated in parallel. With `m = min(k,
+     * size())` the result holds `m` neighbors per query, `result[q * m + i]` being the i:th
+     * nearest point of `queries[q]`.
+     */
+    std::vector<Neighbor> knn(const std::vector<Point>& queries, size_t k) const;
+
+    /**
+     * All points within \p radius of each query point, evaluated in parallel. `result[q]` holds
+     * the points around `queries[q]` sorted by increasing distance.
+     */
+    std::vector<std::vector<Neighbor>> radius(const std::vector<Point>& queries, P radius) const;
+
+private:
+    static P sqDist(const Point& a, const Point& b) {
+        const auto d = a - b;
+        return glm::dot(d, d);
+    }
+    static bool closer(const Neighbor& a, const Neighbor& b) {
+        return a.sqDist < b.sqDist || (a.sqDist == b.sqDist && a.index < b.index);
+    }
+
+    void knnSearch(size_t node, size_t level, size_t begin, size_t end, const Point& query,
+                   size_t k, Neighbor* heap, size_t& count) const;
+    void radiusSearch(size_t node, size_t level, size_t begin, size_t end, const Point& query,
+                      P sqRadius, std::vector<Neighbor>& result) const;
+    void knnQuery(const Point& query, size_t k, Neighbor* result) const;
+
+    size_t leafSize_ = 16;
+    size_t depth_ = 0;
+    std::vector<Point> points_;    // points in tree order
+    std::vector<size_t> indices_;  // input index of each point in tree order
+    std::vector<P> splitValues_;   // split position of each internal node
+    std::vector<unsigned char> splitDims_;  // split dimension of each internal node
+};
+
+template <unsigned int N, typename P>
+StaticKDTree<N, P>::StaticKDTree(const std::vector<Point>& points, size_t leafSize)
+    : leafSize_{std::max(leafSize, size_t{1})} {
+    const size_t size = points.size();
+    while (((size + (size_t{1} << depth_) - 1) >> depth_) > leafSize_) ++depth_;
+
+    struct Entry {
+        Point pos;
+        size_t index;
+    };
+    std::vector<Entry> entries(size);
+    for (size_t i = 0; i < size; ++i) entries[i] = {points[i], i};
+
+    const size_t internalNodes = (size_t{1} << depth_) - 1;
+    splitValues_.resize(internalNodes);
+    splitDims_.resize(internalNodes);
+
+    // Partition one level at a time, the nodes of a level cover disjoint ranges
+    std::vector<std::pair<size_t, size_t>> ranges{{0, size}};
+    std::vector<std::pair<size_t, size_t>> next;
+    for (size_t level = 0; level < depth_; ++level) {
+        const size_t first = (size_t{1} << level) - 1;
+        next.resize(2 * ranges.size());
+
+#pragma omp parallel for
+        for (long long k_ = 0; k_ < static_cast<long long>(ranges.size()); ++k_) {
+            const size_t k = static_cast<size_t>(k_);  // OpenMP need signed integral type.
+            const auto [begin, end] = ranges[k];
+            const size_t mid = begin + (end - begin) / 2;
+
+            Point lo = entries[begin].pos;
+            Point hi = lo;
+            for (size_t i = begin + 1; i < end; ++i) {
+                lo = glm::min(lo, entries[i].pos);
+                hi = glm::max(hi, entries[i].pos);
+            }
+            const auto extent = hi - lo;
+            unsigned int dim = 0;
+            for (unsigned int d = 1; d < N; ++d) {
+                if (extent[d] > extent[dim]) dim = d;
+            }
+
+            std::nth_element(entries.begin() + begin, entries.begin() + mid,
+                             entries.begin() + end, [dim](const Entry& a, const Entry& b) {
+                                 return a.pos[dim] < b.pos[dim];
+                             });
+
+            splitValues_[first + k] = entries[mid].pos[dim];
+            splitDims_[first + k] = static_cast<unsigned char>(dim);
+            next[2 * k] = {begin, mid};
+            next[2 * k + 1] = {mid, end};
+        }
+        std::swap(ranges, next);
+    }
+
+    points_.resize(size);
+    indices_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        points_[i] = entries[i].pos;
+        indices_[i] = entries[i].index;
+    }
+}
+
+template <unsigned int N, typename P>
+void StaticKDTree<N, P>::knnSearch(size_t node, size_t level, size_t begin, size_t end,
+                                   const Point& query, size_t k, Neighbor* heap,
+                                   size_t& count) const {
+    if (level == depth_) {
+        // heap is a max-heap on distance, the front is the furthest of the current neighbors
+        for (size_t i = begin; i < end; ++i) {
+            const Neighbor candidate{indices_[i], sqDist(points_[i], query)};
+            if (count < k) {
+                heap[count++] = candidate;
+                std::push_heap(heap, heap + count, closer);
+            } else if (closer(candidate, heap[0])) {
+                std::pop_heap(heap, heap + count, closer);
+                heap[count - 1] = candidate;
+                std::push_heap(heap, heap + count, closer);
+            }
+        }
+        return;
+    }
+
+    const size_t mid = begin + (end - begin) / 2;
+    const P diff = query[splitDims_[node]] - splitValues_[node];
+    if (diff < 0) {
+        knnSearch(2 * node + 1, level + 1, begin, mid, query, k, heap, count);
+        if (count < k || diff * diff <= heap[0].sqDist) {
+            knnSearch(2 * node + 2, level + 1, mid, end, query, k, heap, count);
+        }
+    } else {
+        knnSearch(2 * node + 2, level + 1, mid, end, query, k, heap, count);
+        if (count < k || diff * diff <= heap[0].sqDist) {
+            knnSearch(2 * node + 1, level + 1, begin, mid, query, k, heap, count);
+        }
+    }
+}
+
+template <unsigned int N, typename P>
+void StaticKDTree<N, P>::radiusSearch(size_t node, size_t level, size_t begin, size_t end,
+                                      const Point& query, P sqRadius,
+                                      std::vector<Neighbor>& result) const {
+    if (level == depth_) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto dist = sqDist(points_[i], query);
+            if (dist <= sqRadius) result.push_back({indices_[i], dist});
+        }
+        return;
+    }
+
+    const size_t mid = begin + (end - begin) / 2;
+    const P diff = query[splitDims_[node]] - splitValues_[node];
+    if (diff <= 0 || diff * diff <= sqRadius) {
+        radiusSearch(2 * node + 1, level + 1, begin, mid, query, sqRadius, result);
+    }
+    if (diff >= 0 || diff * diff <= sqRadius) {
+        radiusSearch(2 * node + 2, level + 1, mid, end, query, sqRadius, result);
+    }
+}
+
+template <unsigned int N, typename P>
+void StaticKDTree<N, P>::knnQuery(const Point& query, size_t k, Neighbor* result) const {
+    size_t count = 0;
+    knnSearch(0, 0, 0, size(), query, k, result, count);
+    std::sort_heap(result, result + count, closer);
+}
+
+template <unsigned int N, typename P>
+auto StaticKDTree<N, P>::nearest(const Point& query) const -> std::optional<Neighbor> {
+    if (empty()) return std::nullopt;
+    Neighbor result{};
+    knnQuery(query, 1, &result);
+    return result;
+}
+
+template <unsigned int N, typename P>
+auto StaticKDTree<N, P>::knn(const Point& query, size_t k) const -> std::vector<Neighbor> {
+    std::vector<Neighbor> result(std::min(k, size()));
+    if (!result.empty()) knnQuery(query, result.size(), result.data());
+    return result;
+}
+
+template <unsigned int N, typename P>
+auto StaticKDTree<N, P>::radius(const Point& query, P radius) const -> std::vector<Neighbor> {
+    std::vector<Neighbor> result;
+    if (empty()) return result;
+    radiusSearch(0, 0, 0, size(), query, radius * radius, result);
+    std::sort(result.begin(), result.end(), closer);
+    return result;
+}
+
+template <unsigned int N, typename P>
+auto StaticKDTree<N, P>::knn(const std::vector<Point>& queries, size_t k) const
+    -> std::vector<Neighbor> {
+    const size_t m = std::min(k, size());
+    std::vector<Neighbor> result(queries.size() * m);
+    if (m == 0) return result;
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (long long q_ = 0; q_ < static_cast<long long>(queries.size()); ++q_) {
+        const size_t q = static_cast<size_t>(q_);  // OpenMP need signed integral type.
+        knnQuery(queries[q], m, result.data() + q * m);
+    }
+    return result;
+}
+
+template <unsigned int N, typename P>
+auto StaticKDTree<N, P>::radius(const std::vector<Point>& queries, P radius) const
+    -> std::vector<std::vector<Neighbor>> {
+    std::vector<std::vector<Neighbor>> result(queries.size());
+    if (empty()) return result;
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (long long q_ = 0; q_ < static_cast<long long>(queries.size()); ++q_) {
+        const size_t q = static_cast<size_t>(q_);  // OpenMP need signed integral type.
+        radiusSearch(0, 0, 0, size(), queries[q], radius * radius, result[q]);
+        std::sort(result[q].begin(), result[q].end(), closer);
+    }
+    return result;
+}
+
+template <typename P = double>
+using StaticK2DTree = StaticKDTree<2, P>;
+template <typename P = double>
+using StaticK3DTree = StaticKDTree<3, P>;
+template <typename P = double>
+using StaticK4DTree = StaticKDTree<4, P>;
+
+}  // namespace inviwo
@@ -37,6 +37,7 @@
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <modules/base/algorithm/volume/volumeramsubsample.h>
+#include <modules/base/algorithm/volume/volumepyramid.h>
 #include <inviwo/core/processors/activityindicator.h>
 
 namespace inviwo {
@@ -55,6 +56,12 @@ namespace inviwo {
  * ### Properties
  *   * __Enable Operation__ ...
  *   * __Factors__ ...
+ *   * __Use Volume Pyramid__ Serve equal power of two factors from the VolumePyramid of the
+ *     input volume, which is shared with everyone else using the volume. The levels are halved
+ *     repeatedly with dimensions (d + 1) / 2 and rounding at each level, so the result can differ
+ *     slightly from the direct subsampling.
+ *   * __Store Levels Next to Source__ If set, the levels of the pyramid are saved next to the
+ *     source file of the volume and loaded from there the next time.
  *
  */
 class IVW_MODULE_BASE_API VolumeSubsample : public PoolProcessor {
@@ -69,6 +76,7 @@ protected:
     virtual void process() override;
 
     static std::shared_ptr<Volume> subsample(std::shared_ptr<const Volume> volume, size3_t f);
+    void pyramidLevel(size_t level);
 
 private:
     VolumeInport inport_;
@@ -76,6 +84,8 @@ private:
 
     BoolProperty enabled_;
     IntVec3Property subSampleFactors_;
+    BoolProperty usePyramid_;
+    BoolProperty persistLevels_;
 };
 }  // namespace inviwo
 
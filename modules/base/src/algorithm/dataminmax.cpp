@@ -30,25 +30,40 @@
 #include <modules/base/algorithm/dataminmax.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/datastructures/image/layer.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferramprecision.h>
 
+#include <limits>
+
 namespace inviwo {
 
 std::pair<dvec4, dvec4> util::volumeMinMax(const VolumeRAM* volume, IgnoreSpecialValues ignore) {
-    return volume->dispatch<std::pair<dvec4, dvec4>>([&ignore](auto vr) -> std::pair<dvec4, dvec4> {
-        const auto dim = vr->getDimensions();
-        return dataMinMax(vr->getDataTyped(), dim.x * dim.y * dim.z, ignore);
-    });
+    const bool ignoreSpecial = ignore == IgnoreSpecialValues::Yes;
+    if (auto cached = volume->getMinMaxCache().get(ignoreSpecial)) return *cached;
+
+    auto minmax =
+        volume->dispatch<std::pair<dvec4, dvec4>>([&ignore](auto vr) -> std::pair<dvec4, dvec4> {
+            const auto dim = vr->getDimensions();
+            return dataMinMax(vr->getDataTyped(), dim.x * dim.y * dim.z, ignore);
+        });
+    volume->getMinMaxCache().set(ignoreSpecial, minmax);
+    return minmax;
 }
 
 std::pair<dvec4, dvec4> util::layerMinMax(const LayerRAM* layer, IgnoreSpecialValues ignore) {
-    return layer->dispatch<std::pair<dvec4, dvec4>>([&ignore](auto lr) -> std::pair<dvec4, dvec4> {
-        const auto dim = lr->getDimensions();
-        return dataMinMax(lr->getDataTyped(), dim.x * dim.y, ignore);
-    });
+    const bool ignoreSpecial = ignore == IgnoreSpecialValues::Yes;
+    if (auto cached = layer->getMinMaxCache().get(ignoreSpecial)) return *cached;
+
+    auto minmax =
+        layer->dispatch<std::pair<dvec4, dvec4>>([&ignore](auto lr) -> std::pair<dvec4, dvec4> {
+            const auto dim = lr->getDimensions();
+            return dataMinMax(lr->getDataTyped(), dim.x * dim.y, ignore);
+        });
+    layer->getMinMaxCache().set(ignoreSpecial, minmax);
+    return minmax;
 }
 
 std::pair<dvec4, dvec4> util::bufferMinMax(const BufferRAM* buffer, IgnoreSpecialValues ignore) {
@@ -58,6 +73,17 @@ std::pair<dvec4, dvec4> util::bufferMinMax(const BufferRAM* buffer, IgnoreSpecia
 }
 
 std::pair<dvec4, dvec4> util::volumeMinMax(const Volume* volume, IgnoreSpecialValues ignore) {
+    // go brick by brick to avoid loading all of the volume if it is only on disk
+    if (auto bricked = util::getBrickedRepresentation(*volume)) {
+        std::pair<dvec4, dvec4> minmax{dvec4{std::numeric_limits<double>::max()},
+                                       dvec4{std::numeric_limits<double>::lowest()}};
+        bricked->forEachBrick([&](const VolumeRAM& brick, size3_t) {
+            const auto brickMinMax = util::volumeMinMax(&brick, ignore);
+            minmax.first = glm::min(minmax.first, brickMinMax.first);
+            minmax.second = glm::max(minmax.second, brickMinMax.second);
+        });
+        return minmax;
+    }
     return util::volumeMinMax(volume->getRepresentation<VolumeRAM>(), ignore);
 }
 
@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/volume/volumepyramid.h>
+#include <modules/base/io/ivfvolumereader.h>
+#include <modules/base/io/ivfvolumewriter.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/metadata/metadata.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/logcentral.h>
+
+#include <ctime>
+
+namespace inviwo {
+
+namespace {
+
+std::string levelFile(const std::string& directory, size_t level) {
+    return directory + "/level" + std::to_string(level) + ".ivf";
+}
+
+}  // namespace
+
+std::string util::getVolumePyramidDirectory(const Volume& volume) {
+    if (auto filename = volume.getMetaData<StringMetaData>("filename")) {
+        return filename->get() + ".pyramid";
+    }
+    return "";
+}
+
+void util::saveVolumePyramid(const Volume& volume, const std::string& directory) {
+    if (!volume.hasPyramid()) return;
+    const auto& pyramid = volume.getPyramid();
+
+    filesystem::createDirectoryRecursively(directory);
+    IvfVolumeWriter writer;
+    writer.setOverwrite(true);
+
+    for (size_t level = 1; level < pyramid.getNumberOfLevels(); ++level) {
+        const auto file = levelFile(directory, level);
+        // levels that were loaded from or saved to the file are already there
+        if (!pyramid.hasLevel(level) || pyramid.getLevelFile(level) == file) continue;
+        writer.writeData(pyramid.getLevel(level).get(), file);
+        pyramid.setLevelFile(level, file);
+    }
+}
+
+size_t util::loadVolumePyramid(const Volume& volume, const std::string& directory,
+                               const std::string& sourceFile) {
+    const auto sourceTime = sourceFile.empty() ? std::time_t{0}
+                                               : filesystem::fileModificationTime(sourceFile);
+    const auto& pyramid = volume.getPyramid();
+    IvfVolumeReader reader;
+    size_t loaded = 0;
+    for (size_t level = 1; level < pyramid.getNumberOfLevels(); ++level) {
+        const auto file = levelFile(directory, level);
+        if (pyramid.hasLevel(level) || !filesystem::fileExists(file)) continue;
+        if (filesystem::fileModificationTime(file) < sourceTime) continue;
+
+        try {
+            auto levelVolume = reader.readData(file);
+            if (levelVolume->getDimensions() != pyramid.getLevelDimensions(level) ||
+                levelVolume->getDataFormat() != volume.getDataFormat()) {
+                continue;
+            }
+            if (pyramid.setLevel(level, levelVolume, file)) ++loaded;
+        } catch (const Exception& e) {
+            LogWarnCustom("VolumePyramid",
+                          "Could not load pyramid level " << file << ": " << e.getMessage());
+        }
+    }
+    return loaded;
+}
+
+}  // namespace inviwo
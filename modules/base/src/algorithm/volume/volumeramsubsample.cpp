@@ -47,7 +47,8 @@ std::shared_ptr<VolumeRAM> util::volumeSubSample(const VolumeRAM* volume, size3_
             const size3_t destDims{srcDims / f};
 
             // allocate space
-            auto destVol = std::make_shared<VolumeRAMPrecision<ValueType>>(destDims);
+            auto destVol = std::make_shared<VolumeRAMPrecision<ValueType>>(
+                destDims, RAMAllocation::Uninitialized);
 
             // get data pointers
             const auto src = srcVol->getDataTyped();
@@ -34,6 +34,7 @@
 
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/datastructures/image/imageram.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 
@@ -135,12 +136,27 @@ void VolumeSlice::process() {
             break;
     }
 
+    const auto axis = static_cast<CartesianCoordinateAxis>(sliceAlongAxis_.get());
+    auto slice = static_cast<size_t>(sliceNumber_.get() - 1);
+
+    // If the volume is on disk, only load the one voxel thick slab containing the slice
+    std::shared_ptr<const VolumeRAM> ram;
+    if (auto bricked = util::getBrickedRepresentation(*vol)) {
+        const auto axisIndex = static_cast<size_t>(axis);
+        size3_t offset{0};
+        size3_t extent{dims};
+        offset[axisIndex] = glm::clamp(slice, size_t{0}, dims[axisIndex] - 1);
+        extent[axisIndex] = 1;
+        ram = bricked->getRegion(offset, extent);
+        slice = 0;
+    } else {
+        ram = std::shared_ptr<const VolumeRAM>(vol, vol->getRepresentation<VolumeRAM>());
+    }
+
     auto image =
-        vol->getRepresentation<VolumeRAM>()
+        ram
             ->dispatch<std::shared_ptr<Image>, dispatching::filter::All>(
-                [axis = static_cast<CartesianCoordinateAxis>(sliceAlongAxis_.get()),
-                 slice = static_cast<size_t>(sliceNumber_.get() - 1),
-                 &cache = imageCache_](const auto vrprecision) {
+                [axis, slice, &cache = imageCache_](const auto vrprecision) {
                     using T = util::PrecisionValueType<decltype(vrprecision)>;
 
                     const T* voldata = vrprecision->getDataTyped();
@@ -31,6 +31,8 @@
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumepyramid.h>
+#include <inviwo/core/metadata/metadata.h>
 
 namespace inviwo {
 
@@ -48,13 +50,19 @@ VolumeSubsample::VolumeSubsample()
     , inport_("inputVolume")
     , outport_("outputVolume")
     , enabled_("enabled", "Enable Operation", true)
-    , subSampleFactors_("subSampleFactors", "Factors", ivec3(1), ivec3(1), ivec3(8)) {
+    , subSampleFactors_("subSampleFactors", "Factors", ivec3(1), ivec3(1), ivec3(8))
+    , usePyramid_("usePyramid", "Use Volume Pyramid", true)
+    , persistLevels_("persistLevels", "Store Levels Next to Source", false) {
 
     addPort(inport_);
     addPort(outport_);
 
     addProperty(enabled_);
     addProperty(subSampleFactors_);
+    addProperty(usePyramid_);
+    addProperty(persistLevels_);
+
+    persistLevels_.visibilityDependsOn(usePyramid_, [](const auto& p) { return p.get(); });
 }
 
 void VolumeSubsample::process() {
@@ -63,6 +71,15 @@ void VolumeSubsample::process() {
                  inport_.getData()->getDimensions());
 
     if (enabled_ && factors != size3_t(1, 1, 1)) {
+        // equal power of two factors are levels of the pyramid
+        if (usePyramid_ && factors.x == factors.y && factors.x == factors.z &&
+            (factors.x & (factors.x - 1)) == 0) {
+            size_t level = 0;
+            for (auto f = factors.x; f > 1; f /= 2) ++level;
+            pyramidLevel(level);
+            return;
+        }
+
         outport_.clear();
         dispatchOne([volume = inport_.getData(),
                      f = subSampleFactors_.get()]() { return subsample(volume, f); },
@@ -75,6 +92,43 @@ void VolumeSubsample::process() {
     }
 }
 
+void VolumeSubsample::pyramidLevel(size_t level) {
+    const auto& volume = inport_.getData();
+    const auto& pyramid = volume->getPyramid();
+
+    level = std::min(level, pyramid.getNumberOfLevels() - 1);
+    if (pyramid.hasLevel(level)) {
+        outport_.setData(util::getVolumePyramidLevel(volume, level));
+        return;
+    }
+
+    const auto directory =
+        persistLevels_.get() ? util::getVolumePyramidDirectory(*volume) : std::string{};
+
+    outport_.clear();
+    dispatchOne(
+        [volume, level, directory]() {
+            if (!directory.empty()) {
+                util::loadVolumePyramid(*volume, directory,
+                                        volume->getMetaData<StringMetaData>("filename")->get());
+            }
+            auto result = util::getVolumePyramidLevel(volume, level);
+            if (!directory.empty()) {
+                try {
+                    util::saveVolumePyramid(*volume, directory);
+                } catch (const Exception& e) {
+                    LogWarnCustom("VolumeSubsample", "Could not save pyramid levels to "
+                                                         << directory << ": " << e.getMessage());
+                }
+            }
+            return result;
+        },
+        [this](std::shared_ptr<const Volume> result) {
+            outport_.setData(result);
+            newResults();
+        });
+}
+
 std::shared_ptr<Volume> VolumeSubsample::subsample(std::shared_ptr<const Volume> volume,
                                                    size3_t f) {
     auto vol = volume->getRepresentation<VolumeRAM>();
@@ -30,6 +30,7 @@
 #include <modules/base/processors/volumesubset.h>
 #include <modules/base/algorithm/volume/volumeramsubset.h>
 #include <inviwo/core/network/networklock.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <glm/gtx/vector_angle.hpp>
 
 namespace inviwo {
@@ -88,14 +89,21 @@ VolumeSubset::~VolumeSubset() = default;
 
 void VolumeSubset::process() {
     if (enabled_.get()) {
-        const auto vol = inport_.getData()->getRepresentation<VolumeRAM>();
         const size3_t offset{rangeX_.get().x, rangeY_.get().x, rangeZ_.get().x};
         const size3_t dim = size3_t{rangeX_.get().y, rangeY_.get().y, rangeZ_.get().y} - offset;
 
         if (dim == dims_)
             outport_.setData(inport_.getData());
         else {
-            auto volume = std::make_shared<Volume>(VolumeRAMSubSet::apply(vol, dim, offset));
+            // only load the bricks covering the subset if the volume is on disk
+            auto subset = [&]() -> std::shared_ptr<VolumeRAM> {
+                if (auto bricked = util::getBrickedRepresentation(*inport_.getData())) {
+                    return bricked->getRegion(offset, dim);
+                }
+                return VolumeRAMSubSet::apply(inport_.getData()->getRepresentation<VolumeRAM>(),
+                                              dim, offset);
+            }();
+            auto volume = std::make_shared<Volume>(subset);
             // pass meta data on
             volume->copyMetaDataFrom(*inport_.getData());
             volume->dataMap_ = inport_.getData()->dataMap_;
@@ -37,9 +37,13 @@
 #include <modules/base/algorithm/volume/marchingcubes.h>
 #include <modules/base/algorithm/volume/marchingcubesopt.h>
 
+#include <modules/base/datastructures/kdtree.h>
+#include <modules/base/datastructures/statickdtree.h>
+
 #include <benchmark/benchmark.h>
 
 #include <cmath>
+#include <random>
 
 #include <warn/push>
 #include <warn/ignore/unused-function>
@@ -136,6 +140,61 @@ static void MiniNew(benchmark::State& state) {
         static_cast<double>(state.range(0) * state.range(0) * state.range(0));
 }
 
+static std::vector<vec3> randomPoints(size_t size, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<vec3> points(size);
+    for (auto& p : points) p = vec3{dist(gen), dist(gen), dist(gen)};
+    return points;
+}
+
+static void KDTreeBuildOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    for (auto _ : state) {
+        K3DTree<size_t, float> tree;
+        for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+        benchmark::DoNotOptimize(tree.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void KDTreeBuildNew(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    for (auto _ : state) {
+        StaticK3DTree<float> tree{points};
+        benchmark::DoNotOptimize(tree.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void KDTreeKnnOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(10000, 1);
+    K3DTree<size_t, float> tree;
+    for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+
+    for (auto _ : state) {
+        for (const auto& q : queries) benchmark::DoNotOptimize(tree.findNNearest(q, 8));
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void KDTreeKnnNew(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(10000, 1);
+    StaticK3DTree<float> tree{points};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tree.knn(queries, 8));
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(KDTreeBuildOld)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(KDTreeBuildNew)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(KDTreeKnnOld)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(KDTreeKnnNew)->RangeMultiplier(10)->Range(1000, 1000000);
+
 BENCHMARK(SphereOld)->RangeMultiplier(2)->Range(8, 8 << 5);
 BENCHMARK(SphereNew)->RangeMultiplier(2)->Range(8, 8 << 6);
 
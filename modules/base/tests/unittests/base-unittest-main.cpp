@@ -35,6 +35,9 @@
 #endif
 
 #include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/util/logcentral.h>
 #include <inviwo/testutil/configurablegtesteventlistener.h>
 
 #include <inviwo/core/datastructures/representationutil.h>
@@ -51,6 +54,15 @@ int main(int argc, char** argv) {
     RepresentationFactoryManager rfm;
     util::registerCoreRepresentations(rfm);
 
+    // Reading ivf files, as done when loading volume pyramids, needs the meta data factory
+    inviwo::LogCentral::init();
+    InviwoApplication app(argc, argv, "Inviwo-Unittests-Base");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        app.registerModules(std::move(modules));
+    }
+
     int ret = -1;
     {
 
@@ -0,0 +1,112 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::pair<T, T> naiveMinMax(const std::vector<T>& data, bool ignoreSpecial) {
+    std::pair<T, T> minmax{std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()};
+    for (auto v : data) {
+        if (ignoreSpecial && !std::isfinite(v)) continue;
+        if (v < minmax.first) minmax.first = v;
+        if (minmax.second < v) minmax.second = v;
+    }
+    return minmax;
+}
+
+}  // namespace
+
+TEST(DataMinMax, scalars) {
+    std::mt19937 gen(4);
+    std::normal_distribution<float> dist(0.0f, 100.0f);
+    // sizes around the block and chunk boundaries
+    for (size_t size : {size_t{1}, size_t{15}, size_t{17}, size_t{1000}, size_t{262145}}) {
+        std::vector<float> data(size);
+        for (auto& v : data) v = dist(gen);
+        data[size / 2] = std::numeric_limits<float>::infinity();
+        data[size - 1] = std::numeric_limits<float>::quiet_NaN();
+
+        for (auto ignore : {IgnoreSpecialValues::No, IgnoreSpecialValues::Yes}) {
+            const auto expected = naiveMinMax(data, ignore == IgnoreSpecialValues::Yes);
+            const auto minmax = util::dataMinMax(data.data(), data.size(), ignore);
+            EXPECT_EQ(expected.first, minmax.first.x) << "size " << size;
+            EXPECT_EQ(expected.second, minmax.second.x) << "size " << size;
+        }
+
+        std::vector<std::int16_t> ints(size);
+        for (auto& v : ints) v = static_cast<std::int16_t>(dist(gen));
+        const auto expected = naiveMinMax(ints, false);
+        const auto minmax = util::dataMinMax(ints.data(), ints.size());
+        EXPECT_EQ(expected.first, minmax.first.x);
+        EXPECT_EQ(expected.second, minmax.second.x);
+    }
+}
+
+TEST(DataMinMax, vectors) {
+    std::vector<vec3> data;
+    for (int i = 0; i < 1001; ++i) {
+        data.emplace_back(static_cast<float>(i), static_cast<float>(-i), static_cast<float>(i % 7));
+    }
+    const auto minmax = util::dataMinMax(data.data(), data.size());
+    EXPECT_EQ(dvec4(0.0, -1000.0, 0.0, 0.0), minmax.first);
+    EXPECT_EQ(dvec4(1000.0, 0.0, 6.0, 0.0), minmax.second);
+}
+
+TEST(DataMinMax, cachedOnRepresentation) {
+    VolumeRAMPrecision<float> ram(size3_t{4, 4, 4});
+    ram.getDataTyped()[3] = 5.0f;
+    EXPECT_EQ(5.0, util::volumeMinMax(&ram).second.x);
+    EXPECT_TRUE(ram.getMinMaxCache().get(false));
+
+    const VolumeRAM* constRam = &ram;
+    EXPECT_EQ(5.0, util::volumeMinMax(constRam).second.x);
+
+    // write access clears the cache
+    ram.setFromDouble(size3_t{1, 1, 1}, 7.0);
+    EXPECT_FALSE(ram.getMinMaxCache().get(false));
+    EXPECT_EQ(7.0, util::volumeMinMax(&ram).second.x);
+}
+
+}  // namespace inviwo
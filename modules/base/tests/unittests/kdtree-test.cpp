@@ -33,6 +33,10 @@
 #include <warn/pop>
 
 #include <modules/base/datastructures/kdtree.h>
+#include <modules/base/datastructures/statickdtree.h>
+
+#include <algorithm>
+#include <random>
 
 namespace inviwo {
 
@@ -133,4 +137,118 @@ TEST(KDTreeTests, findNClosests) {
     EXPECT_EQ(n100.size(), 100);
 }
 
+namespace {
+
+std::vector<glm::vec3> randomPoints(size_t size, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<glm::vec3> points(size);
+    for (auto& p : points) p = glm::vec3{dist(gen), dist(gen), dist(gen)};
+    return points;
+}
+
+std::vector<StaticK3DTree<float>::Neighbor> bruteForce(const std::vector<glm::vec3>& points,
+                                                        const glm::vec3& query) {
+    std::vector<StaticK3DTree<float>::Neighbor> result;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto d = points[i] - query;
+        result.push_back({i, glm::dot(d, d)});
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.sqDist < b.sqDist || (a.sqDist == b.sqDist && a.index < b.index);
+    });
+    return result;
+}
+
+}  // namespace
+
+TEST(StaticKDTreeTests, empty) {
+    StaticK3DTree<float> tree{std::vector<glm::vec3>{}};
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(tree.nearest(glm::vec3{0.0f}).has_value());
+    EXPECT_TRUE(tree.knn(glm::vec3{0.0f}, 3).empty());
+    EXPECT_TRUE(tree.radius(glm::vec3{0.0f}, 1.0f).empty());
+}
+
+TEST(StaticKDTreeTests, knnMatchesBruteForce) {
+    const auto points = randomPoints(1000, 0);
+    const auto queries = randomPoints(50, 1);
+
+    for (size_t leafSize : {1, 7, 16, 2000}) {
+        StaticK3DTree<float> tree{points, leafSize};
+        EXPECT_EQ(tree.size(), points.size());
+
+        for (const auto& q : queries) {
+            const auto expected = bruteForce(points, q);
+            const auto nearest = tree.nearest(q);
+            ASSERT_TRUE(nearest.has_value());
+            EXPECT_EQ(nearest->index, expected.front().index);
+
+            const auto result = tree.knn(q, 10);
+            ASSERT_EQ(result.size(), 10);
+            for (size_t i = 0; i < result.size(); ++i) {
+                EXPECT_EQ(result[i].index, expected[i].index);
+                EXPECT_EQ(result[i].sqDist, expected[i].sqDist);
+            }
+        }
+    }
+}
+
+TEST(StaticKDTreeTests, radiusMatchesBruteForce) {
+    const auto points = randomPoints(1000, 2);
+    const auto queries = randomPoints(50, 3);
+    StaticK3DTree<float> tree{points, 8};
+
+    const float r = 0.1f;
+    for (const auto& q : queries) {
+        auto expected = bruteForce(points, q);
+        expected.erase(std::find_if(expected.begin(), expected.end(),
+                                    [&](const auto& n) { return n.sqDist > r * r; }),
+                       expected.end());
+
+        const auto result = tree.radius(q, r);
+        ASSERT_EQ(result.size(), expected.size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            EXPECT_EQ(result[i].index, expected[i].index);
+        }
+    }
+}
+
+TEST(StaticKDTreeTests, batchedQueries) {
+    const auto points = randomPoints(500, 4);
+    const auto queries = randomPoints(200, 5);
+    StaticK3DTree<float> tree{points};
+
+    const size_t k = 5;
+    const auto knn = tree.knn(queries, k);
+    ASSERT_EQ(knn.size(), queries.size() * k);
+    const auto radius = tree.radius(queries, 0.15f);
+    ASSERT_EQ(radius.size(), queries.size());
+
+    for (size_t q = 0; q < queries.size(); ++q) {
+        const auto single = tree.knn(queries[q], k);
+        for (size_t i = 0; i < k; ++i) EXPECT_EQ(knn[q * k + i].index, single[i].index);
+
+        const auto singleRadius = tree.radius(queries[q], 0.15f);
+        ASSERT_EQ(radius[q].size(), singleRadius.size());
+        for (size_t i = 0; i < singleRadius.size(); ++i) {
+            EXPECT_EQ(radius[q][i].index, singleRadius[i].index);
+        }
+    }
+
+    // k is clamped to the number of points
+    EXPECT_EQ(tree.knn(queries, 1000).size(), queries.size() * points.size());
+}
+
+TEST(StaticKDTreeTests, duplicatePoints) {
+    std::vector<glm::vec3> points(100, glm::vec3{0.5f});
+    points.push_back(glm::vec3{0.0f});
+    StaticK3DTree<float> tree{points, 4};
+
+    const auto nearest = tree.nearest(glm::vec3{0.1f});
+    ASSERT_TRUE(nearest.has_value());
+    EXPECT_EQ(nearest->index, 100);
+    EXPECT_EQ(tree.radius(glm::vec3{0.5f}, 0.0f).size(), 100);
+}
+
 }  // namespace inviwo
\ No newline at end of file
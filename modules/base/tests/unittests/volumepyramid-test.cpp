@@ -0,0 +1,227 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/volumepyramid.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumepyramid.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/metadata/metadata.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+
+namespace inviwo {
+
+TEST(VolumeSubSample2x, integerRounding) {
+    VolumeRAMPrecision<std::uint8_t> ram(size3_t{2, 2, 2});
+    const std::uint8_t values[] = {0, 1, 1, 1, 1, 0, 0, 0};  // sum 4, average 0.5
+    std::copy(std::begin(values), std::end(values), ram.getDataTyped());
+
+    auto half =
+        std::dynamic_pointer_cast<VolumeRAMPrecision<std::uint8_t>>(util::volumeSubSample2x(&ram));
+    ASSERT_TRUE(half);
+    EXPECT_EQ(size3_t(1, 1, 1), half->getDimensions());
+    EXPECT_EQ(1, half->getDataTyped()[0]);
+
+    VolumeRAMPrecision<std::int16_t> signedRam(size3_t{2, 2, 2});
+    std::fill_n(signedRam.getDataTyped(), 8, std::int16_t{-3});
+    signedRam.getDataTyped()[0] = 30000;
+    signedRam.getDataTyped()[1] = 30000;
+    auto signedHalf = std::dynamic_pointer_cast<VolumeRAMPrecision<std::int16_t>>(
+        util::volumeSubSample2x(&signedRam));
+    ASSERT_TRUE(signedHalf);
+    // (60000 - 18) / 8 = 7497.75, no overflow in the accumulator
+    EXPECT_EQ(7498, signedHalf->getDataTyped()[0]);
+}
+
+TEST(VolumeSubSample2x, integerOverflow) {
+    using limits64 = std::numeric_limits<std::int64_t>;
+    VolumeRAMPrecision<std::int64_t> ram(size3_t{2, 2, 2});
+    auto data = ram.getDataTyped();
+    std::fill_n(data, 4, limits64::lowest());
+    std::fill_n(data + 4, 4, limits64::max());
+    auto half =
+        std::dynamic_pointer_cast<VolumeRAMPrecision<std::int64_t>>(util::volumeSubSample2x(&ram));
+    ASSERT_TRUE(half);
+    // the sum is -4, i.e. an average of -0.5 which is rounded away from zero
+    EXPECT_EQ(-1, half->getDataTyped()[0]);
+
+    std::fill_n(data, 8, limits64::max());
+    half =
+        std::dynamic_pointer_cast<VolumeRAMPrecision<std::int64_t>>(util::volumeSubSample2x(&ram));
+    EXPECT_EQ(limits64::max(), half->getDataTyped()[0]);
+
+    std::fill_n(data, 8, limits64::lowest());
+    half =
+        std::dynamic_pointer_cast<VolumeRAMPrecision<std::int64_t>>(util::volumeSubSample2x(&ram));
+    EXPECT_EQ(limits64::lowest(), half->getDataTyped()[0]);
+
+    VolumeRAMPrecision<std::uint64_t> unsignedRam(size3_t{2, 2, 2});
+    std::fill_n(unsignedRam.getDataTyped(), 8, std::numeric_limits<std::uint64_t>::max());
+    auto unsignedHalf = std::dynamic_pointer_cast<VolumeRAMPrecision<std::uint64_t>>(
+        util::volumeSubSample2x(&unsignedRam));
+    ASSERT_TRUE(unsignedHalf);
+    EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(), unsignedHalf->getDataTyped()[0]);
+}
+
+TEST(VolumeSubSample2x, oddDimensions) {
+    VolumeRAMPrecision<float> ram(size3_t{3, 1, 1});
+    ram.getDataTyped()[0] = 1.0f;
+    ram.getDataTyped()[1] = 3.0f;
+    ram.getDataTyped()[2] = 5.0f;
+
+    auto half = std::dynamic_pointer_cast<VolumeRAMPrecision<float>>(util::volumeSubSample2x(&ram));
+    ASSERT_TRUE(half);
+    ASSERT_EQ(size3_t(2, 1, 1), half->getDimensions());
+    EXPECT_FLOAT_EQ(2.0f, half->getDataTyped()[0]);
+    // the last voxel is repeated
+    EXPECT_FLOAT_EQ(5.0f, half->getDataTyped()[1]);
+}
+
+namespace {
+
+std::shared_ptr<Volume> makeVolume(size3_t dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<std::uint16_t>>(dims);
+    auto data = ram->getDataTyped();
+    std::iota(data, data + glm::compMul(dims), std::uint16_t{0});
+    return std::make_shared<Volume>(ram);
+}
+
+}  // namespace
+
+TEST(VolumePyramid, levels) {
+    std::shared_ptr<const Volume> volume = makeVolume(size3_t{8, 5, 2});
+
+    const auto& pyramid = volume->getPyramid();
+    EXPECT_EQ(volume.get(), &pyramid.getVolume());
+    ASSERT_EQ(4, pyramid.getNumberOfLevels());
+    EXPECT_EQ(size3_t(4, 3, 1), pyramid.getLevelDimensions(1));
+    EXPECT_EQ(size3_t(2, 2, 1), pyramid.getLevelDimensions(2));
+    EXPECT_EQ(size3_t(1, 1, 1), pyramid.getLevelDimensions(3));
+
+    EXPECT_EQ(0, pyramid.getLevelFor(80));
+    EXPECT_EQ(1, pyramid.getLevelFor(79));
+    EXPECT_EQ(3, pyramid.getLevelFor(0));
+
+    EXPECT_EQ(volume, util::getVolumePyramidLevel(volume, 0));
+    EXPECT_EQ(volume, util::getVolumeWithMaxVoxels(volume, 80));
+    EXPECT_TRUE(pyramid.hasLevel(0));
+    EXPECT_FALSE(pyramid.hasLevel(2));
+
+    auto level2 = util::getVolumeWithMaxVoxels(volume, 4);
+    EXPECT_TRUE(pyramid.hasLevel(1));
+    EXPECT_TRUE(pyramid.hasLevel(2));
+    EXPECT_FALSE(pyramid.hasLevel(3));
+    EXPECT_EQ(level2, pyramid.getLevel(2));
+    EXPECT_EQ(level2, util::getVolumePyramidLevel(volume, 2));
+    EXPECT_EQ(size3_t(2, 2, 1), level2->getDimensions());
+    EXPECT_TRUE(volume->getModelMatrix() == level2->getModelMatrix());
+    // the pyramid is kept by the volume
+    EXPECT_EQ(&pyramid, &volume->getPyramid());
+
+    EXPECT_THROW(pyramid.getLevel(0), RangeException);
+    EXPECT_THROW(pyramid.getLevel(4), RangeException);
+}
+
+TEST(VolumePyramid, copyAndResize) {
+    auto volume = makeVolume(size3_t{4, 4, 4});
+    EXPECT_FALSE(volume->hasPyramid());
+    const auto level1 = volume->getPyramid().getLevel(1);
+    EXPECT_TRUE(volume->hasPyramid());
+
+    // a copy gets its own pyramid, referring to the copy
+    std::unique_ptr<Volume> copy{volume->clone()};
+    EXPECT_FALSE(copy->hasPyramid());
+    EXPECT_EQ(copy.get(), &copy->getPyramid().getVolume());
+    EXPECT_FALSE(copy->getPyramid().hasLevel(1));
+
+    volume->setDimensions(size3_t{8, 8, 8});
+    EXPECT_FALSE(volume->hasPyramid());
+    EXPECT_EQ(size3_t(4, 4, 4), volume->getPyramid().getLevelDimensions(1));
+    EXPECT_FALSE(volume->getPyramid().hasLevel(1));
+}
+
+TEST(VolumePyramid, saveAndLoad) {
+    const auto dir = std::filesystem::temp_directory_path() / "inviwo-volumepyramid-test";
+    std::filesystem::remove_all(dir);
+    const auto source = (dir / "volume.dat").generic_string();
+
+    auto volume = makeVolume(size3_t{8, 5, 2});
+    volume->setMetaData<StringMetaData>("filename", source);
+    const auto pyramidDir = util::getVolumePyramidDirectory(*volume);
+    EXPECT_EQ(source + ".pyramid", pyramidDir);
+    EXPECT_EQ("", util::getVolumePyramidDirectory(*makeVolume(size3_t{2, 2, 2})));
+
+    // nothing to save before the pyramid is used
+    util::saveVolumePyramid(*volume, pyramidDir);
+    EXPECT_FALSE(filesystem::fileExists(pyramidDir + "/level1.ivf"));
+
+    volume->getPyramid().getLevel(2);
+    util::saveVolumePyramid(*volume, pyramidDir);
+    EXPECT_TRUE(filesystem::fileExists(pyramidDir + "/level1.ivf"));
+    EXPECT_TRUE(filesystem::fileExists(pyramidDir + "/level2.ivf"));
+    EXPECT_FALSE(filesystem::fileExists(pyramidDir + "/level3.ivf"));
+    EXPECT_EQ(pyramidDir + "/level2.ivf", volume->getPyramid().getLevelFile(2));
+
+    auto loaded = makeVolume(size3_t{8, 5, 2});
+    EXPECT_EQ(2, util::loadVolumePyramid(*loaded, pyramidDir));
+    const auto& pyramid = loaded->getPyramid();
+    EXPECT_TRUE(pyramid.hasLevel(1));
+    EXPECT_TRUE(pyramid.hasLevel(2));
+    EXPECT_FALSE(pyramid.hasLevel(3));
+    EXPECT_EQ(pyramidDir + "/level1.ivf", pyramid.getLevelFile(1));
+
+    for (size_t level : {1, 2}) {
+        const auto expected = volume->getPyramid().getLevel(level)->getRepresentation<VolumeRAM>();
+        const auto actual = pyramid.getLevel(level)->getRepresentation<VolumeRAM>();
+        ASSERT_EQ(expected->getDimensions(), actual->getDimensions());
+        ASSERT_EQ(expected->getDataFormat(), actual->getDataFormat());
+        const auto bytes = glm::compMul(expected->getDimensions()) *
+                           expected->getDataFormat()->getSize();
+        EXPECT_TRUE(std::equal(static_cast<const char*>(expected->getData()),
+                               static_cast<const char*>(expected->getData()) + bytes,
+                               static_cast<const char*>(actual->getData())));
+    }
+
+    // levels that already exist are not loaded again, and levels of another size are ignored
+    EXPECT_EQ(0, util::loadVolumePyramid(*loaded, pyramidDir));
+    EXPECT_EQ(0, util::loadVolumePyramid(*makeVolume(size3_t{6, 5, 2}), pyramidDir));
+
+    std::filesystem::remove_all(dir);
+}
+
+}  // namespace inviwo
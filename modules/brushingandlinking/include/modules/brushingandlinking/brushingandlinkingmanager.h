@@ -30,11 +30,10 @@
 #pragma once
 
 #include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <modules/brushingandlinking/datastructures/bitset.h>
 #include <modules/brushingandlinking/datastructures/indexlist.h>
 #include <inviwo/core/properties/invalidationlevel.h>
 
-#include <unordered_set>
-
 namespace inviwo {
 
 class BrushingAndLinkingInport;
@@ -65,23 +64,22 @@ public:
 
     bool isColumnSelected(size_t column) const;
 
-    void setSelected(const BrushingAndLinkingInport* src, const std::unordered_set<size_t>& idx);
+    void setSelected(const BrushingAndLinkingInport* src, const BitSet& idx);
     void clearSelected();
 
-    void setFiltered(const BrushingAndLinkingInport* src, const std::unordered_set<size_t>& idx);
+    void setFiltered(const BrushingAndLinkingInport* src, const BitSet& idx);
     void clearFiltered();
 
-    void setSelectedColumn(const BrushingAndLinkingInport* src,
-                           const std::unordered_set<size_t>& columnIndices);
+    void setSelectedColumn(const BrushingAndLinkingInport* src, const BitSet& columnIndices);
     void clearColumns();
 
-    const std::unordered_set<size_t>& getSelectedIndices() const;
-    const std::unordered_set<size_t>& getFilteredIndices() const;
-    const std::unordered_set<size_t>& getSelectedColumns() const;
+    const BitSet& getSelectedIndices() const;
+    const BitSet& getFilteredIndices() const;
+    const BitSet& getSelectedColumns() const;
 
 private:
-    std::unordered_set<size_t> selected_;
-    std::unordered_set<size_t> selectedColumns_;
+    BitSet selected_;
+    BitSet selectedColumns_;
     IndexList filtered_;  // Use IndexList to be able to remove filtered rows on port disconnection
     std::shared_ptr<std::function<void()>> onFilteringChangeCallback_;
 
@@ -92,7 +90,7 @@ private:
 inline bool BrushingAndLinkingManager::isFiltered(size_t idx) const { return filtered_.has(idx); }
 
 inline bool BrushingAndLinkingManager::isSelected(size_t idx) const {
-    return selected_.find(idx) != selected_.end();
+    return selected_.containsIndex(idx);
 }
 
 }  // namespace inviwo
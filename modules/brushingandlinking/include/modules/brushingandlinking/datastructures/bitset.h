@@ -0,0 +1,277 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace inviwo {
+
+/**
+ * \class BitSet
+ * \brief Compressed set of 32-bit indices, used for selected, filtered and column indices in
+ * brushing and linking.
+ *
+ * The indices are split, in the style of Roaring bitmaps, into containers holding all values
+ * which share their upper 16 bits. Sparse containers store a sorted array of the lower 16 bits,
+ * containers with more than 4096 values a bitmap of 2^16 bits. Unions, intersections and
+ * differences work on whole containers by merging sorted arrays or combining bitmap words.
+ * Iteration is always in increasing order.
+ */
+class IVW_MODULE_BRUSHINGANDLINKING_API BitSet {
+public:
+    class const_iterator;
+    using value_type = std::uint32_t;
+    using iterator = const_iterator;
+
+    BitSet() = default;
+    BitSet(std::initializer_list<std::uint32_t> values);
+    template <typename InputIt>
+    BitSet(InputIt begin, InputIt end);
+
+    bool empty() const;
+    /**
+     * Number of indices in the set
+     */
+    size_t size() const;
+    bool contains(std::uint32_t value) const;
+    /**
+     * Same as contains for a size_t index, indices that do not fit in 32 bits are never contained.
+     */
+    bool containsIndex(size_t index) const;
+
+    void add(std::uint32_t value);
+    template <typename InputIt>
+    void add(InputIt begin, InputIt end);
+    /**
+     * Add all indices in [begin, end)
+     */
+    void addRange(std::uint32_t begin, std::uint32_t end);
+    void remove(std::uint32_t value);
+    void clear();
+
+    /**
+     * Smallest and largest index in the set, the set must not be empty.
+     */
+    std::uint32_t min() const;
+    std::uint32_t max() const;
+
+    BitSet& operator|=(const BitSet& rhs);
+    BitSet& operator&=(const BitSet& rhs);
+    BitSet& operator-=(const BitSet& rhs);
+
+    /**
+     * Union of all \p sets. Faster than combining them one by one since each container of the
+     * result is built only once.
+     */
+    static BitSet unionOf(const std::vector<const BitSet*>& sets);
+
+    bool operator==(const BitSet& rhs) const;
+    bool operator!=(const BitSet& rhs) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /**
+     * Call \p callback with each index in increasing order.
+     */
+    template <typename Callback>
+    void forEach(Callback callback) const;
+
+    /**
+     * Call \p callback with the first and the last index of each run of consecutive indices, in
+     * increasing order. Both indices are part of the run.
+     */
+    template <typename Callback>
+    void forEachRange(Callback callback) const;
+
+    std::vector<std::uint32_t> toVector() const;
+
+    /**
+     * Approximate memory used by the set
+     */
+    size_t getSizeInBytes() const;
+
+    class IVW_MODULE_BRUSHINGANDLINKING_API const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::uint32_t*;
+        using reference = std::uint32_t;
+
+        const_iterator() = default;
+
+        reference operator*() const { return value_; }
+        const_iterator& operator++();
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator& rhs) const {
+            return container_ == rhs.container_ && pos_ == rhs.pos_;
+        }
+        bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        friend BitSet;
+        const_iterator(const BitSet* set, size_t container);
+        void settle();
+
+        const BitSet* set_ = nullptr;
+        size_t container_ = 0;
+        std::uint32_t pos_ = 0;  // array index or bit index inside the container
+        std::uint32_t value_ = 0;
+    };
+
+private:
+    static constexpr std::uint32_t maxArraySize = 4096;
+    static constexpr size_t bitmapWords = (1 << 16) / 64;
+
+    struct Container {
+        std::uint16_t key = 0;
+        std::uint32_t cardinality = 0;
+        std::vector<std::uint16_t> array;   // sorted, used if cardinality <= maxArraySize
+        std::vector<std::uint64_t> bitmap;  // bitmapWords words, used otherwise
+
+        bool isBitmap() const { return !bitmap.empty(); }
+        bool operator==(const Container& rhs) const {
+            return key == rhs.key && cardinality == rhs.cardinality && array == rhs.array &&
+                   bitmap == rhs.bitmap;
+        }
+    };
+
+    static int countTrailingZeros(std::uint64_t word);
+
+    Container* find(std::uint16_t key);
+    const Container* find(std::uint16_t key) const;
+    Container& findOrInsert(std::uint16_t key);
+
+    std::vector<Container> containers_;  // sorted by key
+};
+
+template <typename InputIt>
+BitSet::BitSet(InputIt begin, InputIt end) {
+    add(begin, end);
+}
+
+template <typename InputIt>
+void BitSet::add(InputIt begin, InputIt end) {
+    for (auto it = begin; it != end; ++it) {
+        add(static_cast<std::uint32_t>(*it));
+    }
+}
+
+inline bool BitSet::containsIndex(size_t index) const {
+    return index <= std::numeric_limits<std::uint32_t>::max() &&
+           contains(static_cast<std::uint32_t>(index));
+}
+
+inline int BitSet::countTrailingZeros(std::uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+template <typename Callback>
+void BitSet::forEach(Callback callback) const {
+    for (const auto& c : containers_) {
+        const std::uint32_t high = std::uint32_t{c.key} << 16;
+        if (c.isBitmap()) {
+            for (size_t i = 0; i < bitmapWords; ++i) {
+                auto word = c.bitmap[i];
+                while (word != 0) {
+                    const auto bit = countTrailingZeros(word);
+                    callback(high | static_cast<std::uint32_t>(i * 64 + bit));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (auto low : c.array) callback(high | low);
+        }
+    }
+}
+
+template <typename Callback>
+void BitSet::forEachRange(Callback callback) const {
+    if (containers_.empty()) return;
+
+    // The current run is [begin, end), in 64 bit since end can be past the largest index
+    std::uint64_t begin = min();
+    std::uint64_t end = begin;
+    const auto extend = [&](std::uint64_t first, std::uint64_t last) {
+        if (first != end) {
+            callback(static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end - 1));
+            begin = first;
+        }
+        end = last;
+    };
+    for (const auto& c : containers_) {
+        const std::uint64_t high = std::uint64_t{c.key} << 16;
+        if (c.isBitmap()) {
+            for (size_t i = 0; i < bitmapWords; ++i) {
+                auto word = c.bitmap[i];
+                const auto base = high + i * 64;
+                if (word == ~std::uint64_t{0}) {
+                    extend(base, base + 64);
+                    continue;
+                }
+                while (word != 0) {
+                    // find the next run of ones in the word
+                    const auto first = countTrailingZeros(word);
+                    const auto rest = ~(word | ((std::uint64_t{1} << first) - 1));
+                    const auto last = rest == 0 ? 64 : countTrailingZeros(rest);
+                    extend(base + first, base + last);
+                    word = last == 64 ? 0 : word & ~((std::uint64_t{1} << last) - 1);
+                }
+            }
+        } else {
+            for (auto low : c.array) extend(high + low, high + low + 1);
+        }
+    }
+    callback(static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end - 1));
+}
+
+inline BitSet operator|(BitSet lhs, const BitSet& rhs) { return lhs |= rhs; }
+inline BitSet operator&(BitSet lhs, const BitSet& rhs) { return lhs &= rhs; }
+inline BitSet operator-(BitSet lhs, const BitSet& rhs) { return lhs -= rhs; }
+
+}  // namespace inviwo
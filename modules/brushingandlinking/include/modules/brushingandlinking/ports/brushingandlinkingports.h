@@ -49,26 +49,26 @@ public:
     BrushingAndLinkingInport(std::string identifier);
     virtual ~BrushingAndLinkingInport() = default;
 
-    void sendFilterEvent(const std::unordered_set<size_t> &indices);
+    void sendFilterEvent(const BitSet &indices);
 
-    void sendSelectionEvent(const std::unordered_set<size_t> &indices);
+    void sendSelectionEvent(const BitSet &indices);
 
-    void sendColumnSelectionEvent(const std::unordered_set<size_t> &indices);
+    void sendColumnSelectionEvent(const BitSet &indices);
 
     bool isFiltered(size_t idx) const;
     bool isSelected(size_t idx) const;
 
     bool isColumnSelected(size_t idx) const;
 
-    const std::unordered_set<size_t> &getSelectedIndices() const;
-    const std::unordered_set<size_t> &getFilteredIndices() const;
-    const std::unordered_set<size_t> &getSelectedColumns() const;
+    const BitSet &getSelectedIndices() const;
+    const BitSet &getFilteredIndices() const;
+    const BitSet &getSelectedColumns() const;
 
     virtual std::string getClassIdentifier() const override;
 
-    std::unordered_set<size_t> filterCache_;
-    std::unordered_set<size_t> selectionCache_;
-    std::unordered_set<size_t> selectionColumnCache_;
+    BitSet filterCache_;
+    BitSet selectionCache_;
+    BitSet selectionColumnCache_;
 };
 
 class IVW_MODULE_BRUSHINGANDLINKING_API BrushingAndLinkingOutport
@@ -111,7 +111,7 @@ inline bool BrushingAndLinkingInport::isFiltered(size_t idx) const {
     if (isConnected()) {
         return getData()->isFiltered(idx);
     } else {
-        return filterCache_.find(idx) != filterCache_.end();
+        return filterCache_.containsIndex(idx);
     }
 }
 
@@ -119,7 +119,7 @@ inline bool BrushingAndLinkingInport::isSelected(size_t idx) const {
     if (isConnected()) {
         return getData()->isSelected(idx);
     } else {
-        return selectionCache_.find(idx) != selectionCache_.end();
+        return selectionCache_.containsIndex(idx);
     }
 }
 
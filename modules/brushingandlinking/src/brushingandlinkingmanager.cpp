@@ -57,11 +57,11 @@ void BrushingAndLinkingManager::remove(const BrushingAndLinkingInport* src) {
 }
 
 bool BrushingAndLinkingManager::isColumnSelected(size_t idx) const {
-    return selectedColumns_.find(idx) != selectedColumns_.end();
+    return selectedColumns_.containsIndex(idx);
 }
 
 void BrushingAndLinkingManager::setSelected(const BrushingAndLinkingInport*,
-                                            const std::unordered_set<size_t>& indices) {
+                                            const BitSet& indices) {
     selected_ = indices;
     owner_->invalidate(invalidationLevel_);
 }
@@ -72,14 +72,14 @@ void BrushingAndLinkingManager::clearSelected() {
 }
 
 void BrushingAndLinkingManager::setFiltered(const BrushingAndLinkingInport* src,
-                                            const std::unordered_set<size_t>& indices) {
+                                            const BitSet& indices) {
     filtered_.set(src, indices);
 }
 
 void BrushingAndLinkingManager::clearFiltered() { filtered_.clear(); }
 
 void BrushingAndLinkingManager::setSelectedColumn(const BrushingAndLinkingInport*,
-                                                  const std::unordered_set<size_t>& indices) {
+                                                  const BitSet& indices) {
     selectedColumns_ = indices;
     owner_->invalidate(invalidationLevel_);
 }
@@ -89,15 +89,13 @@ void BrushingAndLinkingManager::clearColumns() {
     owner_->invalidate(invalidationLevel_);
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getSelectedIndices() const {
-    return selected_;
-}
+const BitSet& BrushingAndLinkingManager::getSelectedIndices() const { return selected_; }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getFilteredIndices() const {
+const BitSet& BrushingAndLinkingManager::getFilteredIndices() const {
     return filtered_.getIndices();
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getSelectedColumns() const {
+const BitSet& BrushingAndLinkingManager::getSelectedColumns() const {
     return selectedColumns_;
 }
 
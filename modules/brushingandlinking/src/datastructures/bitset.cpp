@@ -0,0 +1,439 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/brushingandlinking/datastructures/bitset.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace inviwo {
+
+namespace {
+
+int popCount(std::uint64_t word) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+std::uint32_t popCount(const std::vector<std::uint64_t>& bitmap) {
+    std::uint32_t count = 0;
+    for (auto word : bitmap) count += popCount(word);
+    return count;
+}
+
+bool testBit(const std::vector<std::uint64_t>& bitmap, std::uint16_t low) {
+    return (bitmap[low >> 6] >> (low & 63)) & 1;
+}
+
+void setBit(std::vector<std::uint64_t>& bitmap, std::uint16_t low) {
+    bitmap[low >> 6] |= std::uint64_t{1} << (low & 63);
+}
+
+}  // namespace
+
+BitSet::BitSet(std::initializer_list<std::uint32_t> values) { add(values.begin(), values.end()); }
+
+bool BitSet::empty() const { return containers_.empty(); }
+
+size_t BitSet::size() const {
+    size_t size = 0;
+    for (const auto& c : containers_) size += c.cardinality;
+    return size;
+}
+
+BitSet::Container* BitSet::find(std::uint16_t key) {
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, std::uint16_t k) { return c.key < k; });
+    return it != containers_.end() && it->key == key ? &*it : nullptr;
+}
+
+const BitSet::Container* BitSet::find(std::uint16_t key) const {
+    return const_cast<BitSet*>(this)->find(key);
+}
+
+BitSet::Container& BitSet::findOrInsert(std::uint16_t key) {
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, std::uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) {
+        it = containers_.insert(it, Container{});
+        it->key = key;
+    }
+    return *it;
+}
+
+namespace {
+
+template <typename Container>
+void toBitmap(Container& c) {
+    c.bitmap.assign((1 << 16) / 64, 0);
+    for (auto low : c.array) setBit(c.bitmap, low);
+    c.array = {};
+}
+
+template <typename Container>
+void toArray(Container& c) {
+    c.array.clear();
+    c.array.reserve(c.cardinality);
+    for (size_t i = 0; i < c.bitmap.size(); ++i) {
+        auto word = c.bitmap[i];
+        while (word != 0) {
+            const auto bit = i * 64 + popCount((word & (~word + 1)) - 1);
+            c.array.push_back(static_cast<std::uint16_t>(bit));
+            word &= word - 1;
+        }
+    }
+    c.bitmap = {};
+}
+
+// Use an array for at most maxArraySize values, a bitmap otherwise. This keeps the
+// representation of a given set unique.
+template <typename Container>
+void normalize(Container& c, std::uint32_t maxArraySize) {
+    if (c.isBitmap() && c.cardinality <= maxArraySize) {
+        toArray(c);
+    } else if (!c.isBitmap() && c.cardinality > maxArraySize) {
+        toBitmap(c);
+    }
+}
+
+}  // namespace
+
+bool BitSet::contains(std::uint32_t value) const {
+    const auto* c = find(static_cast<std::uint16_t>(value >> 16));
+    if (!c) return false;
+    const auto low = static_cast<std::uint16_t>(value & 0xFFFF);
+    if (c->isBitmap()) {
+        return testBit(c->bitmap, low);
+    } else {
+        return std::binary_search(c->array.begin(), c->array.end(), low);
+    }
+}
+
+void BitSet::add(std::uint32_t value) {
+    auto& c = findOrInsert(static_cast<std::uint16_t>(value >> 16));
+    const auto low = static_cast<std::uint16_t>(value & 0xFFFF);
+    if (c.isBitmap()) {
+        if (!testBit(c.bitmap, low)) {
+            setBit(c.bitmap, low);
+            ++c.cardinality;
+        }
+    } else {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it == c.array.end() || *it != low) {
+            c.array.insert(it, low);
+            ++c.cardinality;
+            normalize(c, maxArraySize);
+        }
+    }
+}
+
+void BitSet::addRange(std::uint32_t begin, std::uint32_t end) {
+    if (begin >= end) return;
+    const std::uint32_t last = end - 1;
+    for (std::uint32_t key = begin >> 16; key <= (last >> 16); ++key) {
+        auto& c = findOrInsert(static_cast<std::uint16_t>(key));
+        const std::uint32_t first = key == (begin >> 16) ? begin & 0xFFFF : 0;
+        const std::uint32_t stop = key == (last >> 16) ? (last & 0xFFFF) + 1 : 1 << 16;
+
+        if (!c.isBitmap() && c.cardinality + (stop - first) <= maxArraySize) {
+            std::vector<std::uint16_t> range(stop - first);
+            std::iota(range.begin(), range.end(), static_cast<std::uint16_t>(first));
+            std::vector<std::uint16_t> merged;
+            merged.reserve(c.array.size() + range.size());
+            std::set_union(c.array.begin(), c.array.end(), range.begin(), range.end(),
+                           std::back_inserter(merged));
+            c.array = std::move(merged);
+            c.cardinality = static_cast<std::uint32_t>(c.array.size());
+        } else {
+            if (!c.isBitmap()) toBitmap(c);
+            for (std::uint32_t i = first; i < stop;) {
+                if ((i & 63) == 0 && i + 64 <= stop) {
+                    c.bitmap[i >> 6] = ~std::uint64_t{0};
+                    i += 64;
+                } else {
+                    setBit(c.bitmap, static_cast<std::uint16_t>(i));
+                    ++i;
+                }
+            }
+            c.cardinality = popCount(c.bitmap);
+            normalize(c, maxArraySize);
+        }
+    }
+}
+
+void BitSet::remove(std::uint32_t value) {
+    const auto key = static_cast<std::uint16_t>(value >> 16);
+    auto* c = find(key);
+    if (!c) return;
+    const auto low = static_cast<std::uint16_t>(value & 0xFFFF);
+    if (c->isBitmap()) {
+        if (!testBit(c->bitmap, low)) return;
+        c->bitmap[low >> 6] &= ~(std::uint64_t{1} << (low & 63));
+        --c->cardinality;
+        normalize(*c, maxArraySize);
+    } else {
+        auto it = std::lower_bound(c->array.begin(), c->array.end(), low);
+        if (it == c->array.end() || *it != low) return;
+        c->array.erase(it);
+        --c->cardinality;
+    }
+    if (c->cardinality == 0) {
+        containers_.erase(containers_.begin() + (c - containers_.data()));
+    }
+}
+
+void BitSet::clear() { containers_.clear(); }
+
+std::uint32_t BitSet::min() const { return *begin(); }
+
+std::uint32_t BitSet::max() const {
+    const auto& c = containers_.back();
+    const std::uint32_t high = std::uint32_t{c.key} << 16;
+    if (c.isBitmap()) {
+        for (size_t i = bitmapWords; i-- > 0;) {
+            if (const auto word = c.bitmap[i]) {
+                int bit = 63;
+                while (((word >> bit) & 1) == 0) --bit;
+                return high | static_cast<std::uint32_t>(i * 64 + bit);
+            }
+        }
+    }
+    return high | c.array.back();
+}
+
+BitSet& BitSet::operator|=(const BitSet& rhs) {
+    if (this == &rhs || rhs.empty()) return *this;
+    *this = unionOf({this, &rhs});
+    return *this;
+}
+
+BitSet& BitSet::operator&=(const BitSet& rhs) {
+    if (this == &rhs) return *this;
+
+    std::vector<Container> result;
+    auto it = rhs.containers_.begin();
+    for (auto& a : containers_) {
+        while (it != rhs.containers_.end() && it->key < a.key) ++it;
+        if (it == rhs.containers_.end()) break;
+        if (it->key != a.key) continue;
+        const auto& b = *it;
+
+        if (a.isBitmap() && b.isBitmap()) {
+            for (size_t i = 0; i < bitmapWords; ++i) a.bitmap[i] &= b.bitmap[i];
+            a.cardinality = popCount(a.bitmap);
+        } else if (a.isBitmap()) {
+            std::vector<std::uint16_t> array;
+            std::copy_if(b.array.begin(), b.array.end(), std::back_inserter(array),
+                         [&](std::uint16_t low) { return testBit(a.bitmap, low); });
+            a.bitmap = {};
+            a.array = std::move(array);
+            a.cardinality = static_cast<std::uint32_t>(a.array.size());
+        } else {
+            a.array.erase(std::remove_if(a.array.begin(), a.array.end(),
+                                         [&](std::uint16_t low) {
+                                             return b.isBitmap()
+                                                        ? !testBit(b.bitmap, low)
+                                                        : !std::binary_search(b.array.begin(),
+                                                                              b.array.end(), low);
+                                         }),
+                          a.array.end());
+            a.cardinality = static_cast<std::uint32_t>(a.array.size());
+        }
+        normalize(a, maxArraySize);
+        if (a.cardinality != 0) result.push_back(std::move(a));
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+BitSet& BitSet::operator-=(const BitSet& rhs) {
+    if (this == &rhs) {
+        clear();
+        return *this;
+    }
+
+    auto it = rhs.containers_.begin();
+    for (auto& a : containers_) {
+        while (it != rhs.containers_.end() && it->key < a.key) ++it;
+        if (it == rhs.containers_.end()) break;
+        if (it->key != a.key) continue;
+        const auto& b = *it;
+
+        if (a.isBitmap() && b.isBitmap()) {
+            for (size_t i = 0; i < bitmapWords; ++i) a.bitmap[i] &= ~b.bitmap[i];
+            a.cardinality = popCount(a.bitmap);
+        } else if (a.isBitmap()) {
+            for (auto low : b.array) {
+                a.bitmap[low >> 6] &= ~(std::uint64_t{1} << (low & 63));
+            }
+            a.cardinality = popCount(a.bitmap);
+        } else {
+            a.array.erase(std::remove_if(a.array.begin(), a.array.end(),
+                                         [&](std::uint16_t low) {
+                                             return b.isBitmap()
+                                                        ? testBit(b.bitmap, low)
+                                                        : std::binary_search(b.array.begin(),
+                                                                             b.array.end(), low);
+                                         }),
+                          a.array.end());
+            a.cardinality = static_cast<std::uint32_t>(a.array.size());
+        }
+        normalize(a, maxArraySize);
+    }
+    containers_.erase(std::remove_if(containers_.begin(), containers_.end(),
+                                     [](const Container& c) { return c.cardinality == 0; }),
+                      containers_.end());
+    return *this;
+}
+
+BitSet BitSet::unionOf(const std::vector<const BitSet*>& sets) {
+    // Containers of all sets ordered by key, each key is then merged once
+    std::vector<const Container*> all;
+    for (auto set : sets) {
+        for (const auto& c : set->containers_) all.push_back(&c);
+    }
+    std::stable_sort(all.begin(), all.end(),
+                     [](const Container* a, const Container* b) { return a->key < b->key; });
+
+    BitSet result;
+    for (auto first = all.begin(); first != all.end();) {
+        const auto last = std::find_if(first, all.end(), [&](const Container* c) {
+            return c->key != (*first)->key;
+        });
+
+        Container c;
+        c.key = (*first)->key;
+        if (last - first == 1) {
+            c = **first;
+        } else {
+            size_t total = 0;
+            bool anyBitmap = false;
+            for (auto it = first; it != last; ++it) {
+                total += (*it)->cardinality;
+                anyBitmap |= (*it)->isBitmap();
+            }
+            if (!anyBitmap && total <= maxArraySize) {
+                for (auto it = first; it != last; ++it) {
+                    std::vector<std::uint16_t> merged;
+                    merged.reserve(c.array.size() + (*it)->array.size());
+                    std::set_union(c.array.begin(), c.array.end(), (*it)->array.begin(),
+                                   (*it)->array.end(), std::back_inserter(merged));
+                    c.array = std::move(merged);
+                }
+                c.cardinality = static_cast<std::uint32_t>(c.array.size());
+            } else {
+                c.bitmap.assign(bitmapWords, 0);
+                for (auto it = first; it != last; ++it) {
+                    if ((*it)->isBitmap()) {
+                        for (size_t i = 0; i < bitmapWords; ++i) c.bitmap[i] |= (*it)->bitmap[i];
+                    } else {
+                        for (auto low : (*it)->array) setBit(c.bitmap, low);
+                    }
+                }
+                c.cardinality = popCount(c.bitmap);
+                normalize(c, maxArraySize);
+            }
+        }
+        result.containers_.push_back(std::move(c));
+        first = last;
+    }
+    return result;
+}
+
+bool BitSet::operator==(const BitSet& rhs) const { return containers_ == rhs.containers_; }
+
+bool BitSet::operator!=(const BitSet& rhs) const { return !(*this == rhs); }
+
+BitSet::const_iterator BitSet::begin() const { return const_iterator(this, 0); }
+
+BitSet::const_iterator BitSet::end() const { return const_iterator(this, containers_.size()); }
+
+std::vector<std::uint32_t> BitSet::toVector() const {
+    std::vector<std::uint32_t> result;
+    result.reserve(size());
+    forEach([&](std::uint32_t value) { result.push_back(value); });
+    return result;
+}
+
+size_t BitSet::getSizeInBytes() const {
+    size_t bytes = sizeof(BitSet) + containers_.capacity() * sizeof(Container);
+    for (const auto& c : containers_) {
+        bytes += c.array.capacity() * sizeof(std::uint16_t);
+        bytes += c.bitmap.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+}
+
+BitSet::const_iterator::const_iterator(const BitSet* set, size_t container)
+    : set_{set}, container_{container} {
+    settle();
+}
+
+BitSet::const_iterator& BitSet::const_iterator::operator++() {
+    ++pos_;
+    settle();
+    return *this;
+}
+
+BitSet::const_iterator BitSet::const_iterator::operator++(int) {
+    auto tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+void BitSet::const_iterator::settle() {
+    // move forward to the next value, starting at the current position
+    const auto& containers = set_->containers_;
+    while (container_ < containers.size()) {
+        const auto& c = containers[container_];
+        const std::uint32_t high = std::uint32_t{c.key} << 16;
+        if (c.isBitmap()) {
+            while (pos_ < (1u << 16)) {
+                const auto word = c.bitmap[pos_ >> 6] >> (pos_ & 63);
+                if (word != 0) {
+                    pos_ += countTrailingZeros(word);
+                    value_ = high | pos_;
+                    return;
+                }
+                pos_ = (pos_ | 63) + 1;
+            }
+        } else if (pos_ < c.array.size()) {
+            value_ = high | c.array[pos_];
+            return;
+        }
+        ++container_;
+        pos_ = 0;
+    }
+}
+
+}  // namespace inviwo
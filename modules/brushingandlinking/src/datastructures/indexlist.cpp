@@ -34,8 +34,7 @@ namespace inviwo {
 
 size_t IndexList::getSize() const { return indices_.size(); }
 
-void IndexList::set(const BrushingAndLinkingInport *src,
-                    const std::unordered_set<size_t> &indices) {
+void IndexList::set(const BrushingAndLinkingInport *src, const BitSet &indices) {
     indicesBySource_[src] = indices;
     update();
 }
@@ -50,18 +49,17 @@ std::shared_ptr<std::function<void()>> IndexList::onChange(std::function<void()>
 }
 
 void IndexList::update() {
-    indices_.clear();
-
-    using T = std::unordered_map<const BrushingAndLinkingInport *,
-                                 std::unordered_set<size_t>>::value_type;
+    using T = std::unordered_map<const BrushingAndLinkingInport *, BitSet>::value_type;
     util::map_erase_remove_if(indicesBySource_, [](const T &p) {
         return !p.first->isConnected() ||
                p.second.empty();  // remove if port is disconnected or if the set is empty
     });
 
-    for (auto p : indicesBySource_) {
-        indices_.insert(p.second.begin(), p.second.end());
+    std::vector<const BitSet *> sets;
+    for (const auto &p : indicesBySource_) {
+        sets.push_back(&p.second);
     }
+    indices_ = BitSet::unionOf(sets);
     onUpdate_.invoke();
 }
 
@@ -41,14 +41,14 @@ BrushingAndLinkingInport::BrushingAndLinkingInport(std::string identifier)
     });
 }
 
-void BrushingAndLinkingInport::sendFilterEvent(const std::unordered_set<size_t> &indices) {
-    if (filterCache_.size() == 0 && indices.size() == 0) return;
+void BrushingAndLinkingInport::sendFilterEvent(const BitSet &indices) {
+    if (filterCache_.empty() && indices.empty()) return;
     filterCache_ = indices;
     FilteringEvent event(this, filterCache_);
     propagateEvent(&event, nullptr);
 }
 
-void BrushingAndLinkingInport::sendSelectionEvent(const std::unordered_set<size_t> &indices) {
+void BrushingAndLinkingInport::sendSelectionEvent(const BitSet &indices) {
     bool noRemoteSelections = false;
     if (isConnected() && hasData()) {
         noRemoteSelections = getData()->getSelectedIndices().empty();
@@ -61,7 +61,7 @@ void BrushingAndLinkingInport::sendSelectionEvent(const std::unordered_set<size_
     propagateEvent(&event, nullptr);
 }
 
-void BrushingAndLinkingInport::sendColumnSelectionEvent(const std::unordered_set<size_t> &indices) {
+void BrushingAndLinkingInport::sendColumnSelectionEvent(const BitSet &indices) {
     bool noRemoteSelections = false;
     if (isConnected() && hasData()) {
         noRemoteSelections = getData()->getSelectedColumns().empty();
@@ -78,11 +78,11 @@ bool BrushingAndLinkingInport::isColumnSelected(size_t idx) const {
     if (isConnected()) {
         return getData()->isColumnSelected(idx);
     } else {
-        return selectionColumnCache_.find(idx) != selectionColumnCache_.end();
+        return selectionColumnCache_.containsIndex(idx);
     }
 }
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getSelectedIndices() const {
+const BitSet &BrushingAndLinkingInport::getSelectedIndices() const {
     if (isConnected()) {
         return getData()->getSelectedIndices();
     } else {
@@ -90,7 +90,7 @@ const std::unordered_set<size_t> &BrushingAndLinkingInport::getSelectedIndices()
     }
 }
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getFilteredIndices() const {
+const BitSet &BrushingAndLinkingInport::getFilteredIndices() const {
     if (isConnected()) {
         return getData()->getFilteredIndices();
     } else {
@@ -98,7 +98,7 @@ const std::unordered_set<size_t> &BrushingAndLinkingInport::getFilteredIndices()
     }
 }
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getSelectedColumns() const {
+const BitSet &BrushingAndLinkingInport::getSelectedColumns() const {
     if (isConnected()) {
         return getData()->getSelectedColumns();
     } else {
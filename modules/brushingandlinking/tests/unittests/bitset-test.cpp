@@ -0,0 +1,220 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/brushingandlinking/datastructures/bitset.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+using Reference = std::set<std::uint32_t>;
+
+// Indices in a few containers, dense enough to go past the 4096 values of an array container
+Reference randomSet(std::mt19937& rand, size_t count, std::uint32_t maxIndex) {
+    std::uniform_int_distribution<std::uint32_t> dist(0, maxIndex);
+    Reference ref;
+    while (ref.size() < count) ref.insert(dist(rand));
+    return ref;
+}
+
+BitSet toBitSet(const Reference& ref) { return BitSet(ref.begin(), ref.end()); }
+
+void check(const Reference& ref, const BitSet& set) {
+    ASSERT_EQ(ref.size(), set.size());
+    EXPECT_EQ(ref.empty(), set.empty());
+    EXPECT_EQ(std::vector<std::uint32_t>(ref.begin(), ref.end()), set.toVector());
+    EXPECT_TRUE(std::equal(ref.begin(), ref.end(), set.begin(), set.end()));
+
+    std::vector<std::uint32_t> values;
+    set.forEach([&](std::uint32_t v) { values.push_back(v); });
+    EXPECT_EQ(std::vector<std::uint32_t>(ref.begin(), ref.end()), values);
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> expectedRanges;
+    for (auto v : ref) {
+        if (!expectedRanges.empty() && expectedRanges.back().second + 1 == v) {
+            expectedRanges.back().second = v;
+        } else {
+            expectedRanges.emplace_back(v, v);
+        }
+    }
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+    set.forEachRange([&](std::uint32_t first, std::uint32_t last) {
+        ranges.emplace_back(first, last);
+    });
+    EXPECT_EQ(expectedRanges, ranges);
+
+    if (!ref.empty()) {
+        EXPECT_EQ(*ref.begin(), set.min());
+        EXPECT_EQ(*ref.rbegin(), set.max());
+    }
+
+    // The representation is unique, so a set built from scratch has to compare equal
+    EXPECT_EQ(toBitSet(ref), set);
+}
+
+}  // namespace
+
+TEST(BitSetTest, empty) {
+    BitSet set;
+    check({}, set);
+    EXPECT_FALSE(set.contains(0));
+    EXPECT_EQ(set.begin(), set.end());
+}
+
+TEST(BitSetTest, containerSwitching) {
+    // Add and remove values across the array / bitmap boundary of a single container
+    std::mt19937 rand(1);
+    std::uniform_int_distribution<std::uint32_t> dist(0, (1 << 16) - 1);
+    const std::uint32_t high = 3 << 16;
+
+    Reference ref;
+    BitSet set;
+    for (size_t count : {4095, 4096, 4097, 6000}) {
+        while (ref.size() < count) {
+            const auto v = high | dist(rand);
+            ref.insert(v);
+            set.add(v);
+        }
+        SCOPED_TRACE(count);
+        check(ref, set);
+    }
+    for (size_t count : {4097, 4096, 4095, 100, 0}) {
+        while (ref.size() > count) {
+            auto it = std::next(ref.begin(), dist(rand) % ref.size());
+            set.remove(*it);
+            ref.erase(it);
+        }
+        SCOPED_TRACE(count);
+        check(ref, set);
+    }
+}
+
+TEST(BitSetTest, addRange) {
+    for (auto [begin, end] : {std::pair<std::uint32_t, std::uint32_t>{10, 10},
+                              {5, 4100},
+                              {65530, 65600},
+                              {100, 3 * 65536 + 7},
+                              {0xFFFFFF00, 0xFFFFFFFF}}) {
+        SCOPED_TRACE(begin);
+        BitSet set{1, 4099, 70000};
+        Reference ref{1, 4099, 70000};
+        set.addRange(begin, end);
+        for (auto v = begin; v < end; ++v) ref.insert(v);
+        check(ref, set);
+    }
+}
+
+TEST(BitSetTest, setOperations) {
+    std::mt19937 rand(2);
+    // a few sizes on both sides of the array / bitmap boundary, over 4 containers
+    for (size_t countA : {10, 3000, 20000}) {
+        for (size_t countB : {10, 3000, 20000}) {
+            const auto refA = randomSet(rand, countA, 4 * 65536 - 1);
+            const auto refB = randomSet(rand, countB, 4 * 65536 - 1);
+            const auto a = toBitSet(refA);
+            const auto b = toBitSet(refB);
+            SCOPED_TRACE(countA);
+            SCOPED_TRACE(countB);
+
+            Reference expected;
+            std::set_union(refA.begin(), refA.end(), refB.begin(), refB.end(),
+                           std::inserter(expected, expected.end()));
+            check(expected, a | b);
+            check(expected, BitSet::unionOf({&a, &b}));
+
+            expected.clear();
+            std::set_intersection(refA.begin(), refA.end(), refB.begin(), refB.end(),
+                                  std::inserter(expected, expected.end()));
+            check(expected, a & b);
+
+            expected.clear();
+            std::set_difference(refA.begin(), refA.end(), refB.begin(), refB.end(),
+                                std::inserter(expected, expected.end()));
+            check(expected, a - b);
+
+            check({}, a - a);
+            check(refA, a & a);
+            check(refA, a | a);
+        }
+    }
+}
+
+TEST(BitSetTest, unionOfMany) {
+    std::mt19937 rand(3);
+    std::vector<BitSet> sets;
+    Reference expected;
+    for (size_t i = 0; i < 8; ++i) {
+        const auto ref = randomSet(rand, 1000, 2 * 65536 - 1);
+        expected.insert(ref.begin(), ref.end());
+        sets.push_back(toBitSet(ref));
+    }
+    std::vector<const BitSet*> pointers;
+    for (auto& set : sets) pointers.push_back(&set);
+    check(expected, BitSet::unionOf(pointers));
+    check({}, BitSet::unionOf({}));
+}
+
+TEST(BitSetTest, iteration) {
+    const Reference ref{0, 1, 2, 65535, 65536, 0xFFFFFFFF};
+    const auto set = toBitSet(ref);
+    check(ref, set);
+
+    auto it = set.begin();
+    EXPECT_EQ(0u, *it++);
+    EXPECT_EQ(1u, *it);
+    EXPECT_EQ(2u, *++it);
+    EXPECT_EQ(4, std::distance(it, set.end()));
+}
+
+TEST(BitSetTest, containsIndex) {
+    const BitSet set{0, 5, 0xFFFFFFFF};
+    EXPECT_TRUE(set.containsIndex(5));
+    EXPECT_TRUE(set.containsIndex(0xFFFFFFFF));
+    EXPECT_FALSE(set.containsIndex(6));
+    if constexpr (sizeof(size_t) > sizeof(std::uint32_t)) {
+        // Must not wrap around to 0 or 5
+        EXPECT_FALSE(set.containsIndex(size_t{1} << 32));
+        EXPECT_FALSE(set.containsIndex((size_t{1} << 32) + 5));
+    }
+}
+
+}  // namespace inviwo
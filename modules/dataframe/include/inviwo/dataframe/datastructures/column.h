@@ -214,6 +214,15 @@ public:
      */
     const std::vector<std::string> &getCategories() const { return lookUpTable_; }
 
+    /**
+     * Add all categories of \p categories which do not exist yet. The IDs can then be added
+     * directly with TemplateColumn<std::uint32_t>::add(), without looking up each value again.
+     *
+     * @param categories   values to add
+     * @return the ID of each value in \p categories
+     */
+    std::vector<std::uint32_t> addCategories(std::vector<std::string> categories);
+
 private:
     virtual glm::uint32_t addOrGetID(const std::string &str);
 
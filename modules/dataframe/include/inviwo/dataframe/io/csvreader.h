@@ -37,6 +37,8 @@
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/dataframe/datastructures/dataframe.h>
 
+#include <string_view>
+
 namespace inviwo {
 
 /**
@@ -58,6 +60,10 @@ public:
  *
  * \brief A reader for comma separated value (CSV) files with customizable delimiters.
  * The default delimiter is ',' and headers are included
+ *
+ * The column types are derived from the first 50 rows. The remaining data is split into chunks
+ * of rows which are parsed in parallel, with numbers being written directly into the column
+ * buffers.
  */
 class IVW_MODULE_DATAFRAME_API CSVReader : public DataReaderType<DataFrame> {
 public:
@@ -74,7 +80,7 @@ public:
     using DataReaderType<DataFrame>::readData;
 
     /**
-     * read a CSV file from a file
+     * read a CSV file from a file. The file is memory mapped instead of being read into memory.
      *
      * @param fileName   name of the input CSV file
      * @return a DataFrame containing the CSV data
@@ -88,6 +94,7 @@ public:
     /**
      * read a CSV file from a input stream, e.g. a std::ifstream. In case
      * file streams are used, the file must have be opened prior calling this function.
+     * The remainder of the stream is read into memory before parsing.
      *
      * @param stream    input stream with the CSV data
      * @return a DataFrame containing the CSV data
@@ -99,6 +106,8 @@ public:
     std::shared_ptr<DataFrame> readData(std::istream& stream) const;
 
 private:
+    std::shared_ptr<DataFrame> parse(std::string_view data) const;
+
     std::string delimiters_;
     bool firstRowHeader_;
 };
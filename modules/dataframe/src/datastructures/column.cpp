@@ -29,6 +29,9 @@
 
 #include <inviwo/dataframe/datastructures/column.h>
 
+#include <string_view>
+#include <unordered_map>
+
 namespace inviwo {
 
 CategoricalColumn::CategoricalColumn(const std::string &header)
@@ -59,6 +62,30 @@ void CategoricalColumn::add(const std::string &value) {
     getTypedBuffer()->getEditableRAMRepresentation()->add(id);
 }
 
+std::vector<std::uint32_t> CategoricalColumn::addCategories(std::vector<std::string> categories) {
+    // Reserve up front to keep the views into the look up table valid while adding to it
+    lookUpTable_.reserve(lookUpTable_.size() + categories.size());
+    std::unordered_map<std::string_view, std::uint32_t> existing;
+    for (size_t i = 0; i < lookUpTable_.size(); ++i) {
+        existing.emplace(lookUpTable_[i], static_cast<std::uint32_t>(i));
+    }
+
+    std::vector<std::uint32_t> ids;
+    ids.reserve(categories.size());
+    for (auto& str : categories) {
+        const auto it = existing.find(str);
+        if (it != existing.end()) {
+            ids.push_back(it->second);
+        } else {
+            const auto id = static_cast<std::uint32_t>(lookUpTable_.size());
+            lookUpTable_.push_back(std::move(str));
+            existing.emplace(lookUpTable_.back(), id);
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
 glm::uint32_t CategoricalColumn::addOrGetID(const std::string &str) {
     auto it = std::find(lookUpTable_.begin(), lookUpTable_.end(), str);
     if (it != lookUpTable_.end()) {
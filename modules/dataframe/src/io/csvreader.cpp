@@ -31,183 +31,541 @@
 
 #include <inviwo/dataframe/datastructures/column.h>
 #include <inviwo/dataframe/datastructures/dataframe.h>
+#include <inviwo/core/io/memorymappedfile.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/foreach.h>
 #include <inviwo/core/util/stringconversion.h>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
 
 namespace inviwo {
 
-CSVDataReaderException::CSVDataReaderException(const std::string& message, ExceptionContext context)
-    : DataReaderException("CSVReader: " + message, context) {}
+namespace {
 
-CSVReader::CSVReader() : DataReaderType<DataFrame>(), delimiters_(","), firstRowHeader_(true) {
-    addExtension(FileExtension("csv", "Comma Separated Values"));
-}
+// Size of the pieces the input is split into for parsing in parallel
+constexpr size_t chunkSize = size_t{1} << 20;
 
-CSVReader* CSVReader::clone() const { return new CSVReader(*this); }
+// Thrown by the Scanner, converted into a CSVDataReaderException once the line number of the
+// scanned range is known
+struct UnmatchedQuotes {
+    size_t line;
+};
 
-void CSVReader::setDelimiters(const std::string& delim) { delimiters_ = delim; }
+CSVDataReaderException unmatchedQuotes(size_t line) {
+    return CSVDataReaderException("Unmatched quotes (starting in line " + std::to_string(line) +
+                                  ")");
+}
 
-void CSVReader::setFirstRowHeader(bool hasHeader) { firstRowHeader_ = hasHeader; }
+enum class FieldEnd { Delimiter, LineBreak, End };
 
-std::shared_ptr<DataFrame> CSVReader::readData(const std::string& fileName) {
-    auto file = filesystem::ifstream(fileName);
+struct Field {
+    std::string_view value;
+    FieldEnd end;
+};
 
-    if (!file.is_open()) {
-        throw FileException(std::string("CSVReader: Could not open file \"" + fileName + "\"."),
-                            IVW_CONTEXT);
-    }
-    file.seekg(0, std::ios::end);
-    std::streampos len = file.tellg();
-    file.seekg(0, std::ios::beg);
+std::string_view trimmed(std::string_view str) {
+    const auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+    while (!str.empty() && isSpace(str.front())) str.remove_prefix(1);
+    while (!str.empty() && isSpace(str.back())) str.remove_suffix(1);
+    return str;
+}
 
-    if (len == std::streampos(0)) {
-        throw CSVDataReaderException("Empty file, no data", IVW_CONTEXT);
-    }
+/*
+ * Line breaks inside quoted fields are returned as they appear in the input, they are converted
+ * to '\n' only when a value is turned into a string.
+ */
+std::string toString(std::string_view str) {
+    if (str.find('\r') == std::string_view::npos) return std::string{str};
 
-    return readData(file);
+    std::string result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '\r') {
+            if (i + 1 < str.size() && str[i + 1] == '\n') ++i;
+            result += '\n';
+        } else {
+            result += str[i];
+        }
+    }
+    return result;
 }
 
-std::shared_ptr<DataFrame> CSVReader::readData(std::istream& stream) const {
-    // Skip BOM if it exists. Added by for example Excel when saving csv files.
-    filesystem::skipByteOrderMark(stream);
+float toFloat(std::string_view str) {
+    auto first = str.data();
+    const auto last = str.data() + str.size();
+    while (first != last && std::isspace(static_cast<unsigned char>(*first))) ++first;
+    // from_chars does not accept a leading plus sign, unlike stream extraction
+    if (last - first > 1 && first[0] == '+' && first[1] != '-' && first[1] != '+') ++first;
 
-    if (stream.bad() || stream.fail()) {
-        throw CSVDataReaderException("Input stream in a bad state", IVW_CONTEXT);
-    }
+    float value;
+    const auto res = std::from_chars(first, last, value);
+    return res.ec == std::errc{} ? value : std::numeric_limits<float>::quiet_NaN();
+}
 
-    // create a string stream from input stream for buffering
-    std::stringstream in;
-    in << stream.rdbuf();
-    if (in.fail()) {
-        throw CSVDataReaderException("No data", IVW_CONTEXT);
+/*
+ * Splits a range of characters into fields without copying them. A field ends at a delimiter or
+ * a line break unless it is enclosed in quotes. Quotes are kept as part of the field.
+ */
+class Scanner {
+public:
+    Scanner(const char* begin, const char* end, const std::string& delimiters, size_t line)
+        : pos_{begin}, end_{end}, line_{line}, isDelimiter_{} {
+        for (auto c : delimiters) isDelimiter_[static_cast<unsigned char>(c)] = true;
     }
 
-    // current line
-    size_t lineNumber = 1u;
+    const char* pos() const { return pos_; }
+    size_t line() const { return line_; }
 
-    // extract exactly one field from the current stream position, the bool return value indicates
-    // whether a line break was detected following the field
-    auto extractField = [&in, &lineNumber, delims = delimiters_]() -> std::pair<std::string, bool> {
-        std::string value;
+    Field nextField() {
+        const char* start = pos_;
         size_t quoteCount = 0;
         size_t quoteBeginLine = 0;
         char prev = 0;
 
-        auto isLineBreak = [](const char ch, std::istream& stream) {
+        while (pos_ != end_) {
+            const char* current = pos_;
+            char ch = *pos_++;
+            bool linebreak = false;
             if (ch == '\r') {
                 // consume potential LF (\n) following CR (\r)
-                if (stream.peek() == '\n') {
-                    stream.get();
-                }
-                return true;
+                if (pos_ != end_ && *pos_ == '\n') ++pos_;
+                linebreak = true;
             } else {
-                return (ch == '\n');
+                linebreak = ch == '\n';
             }
-        };
 
-        char ch;
-        while (in.get(ch) && in.good()) {
-            bool linebreak = isLineBreak(ch, in);
             if (linebreak) {
-                ++lineNumber;  // increase line counter
-                // ensure that ch is equal to '\n'
+                ++line_;
                 ch = '\n';
-                // consume line break, if inside quotes
+                // line breaks inside quotes are part of the field
                 if ((quoteCount & 1) != 0) {
-                    value += ch;
                     prev = ch;
                     continue;
                 }
             }
-            if (ch == '"') {  // found a quote
-                if (quoteCount == 0) quoteBeginLine = lineNumber;
+            if (ch == '"') {
+                if (quoteCount == 0) quoteBeginLine = line_;
                 ++quoteCount;
-            } else if (util::contains(delims, ch) || linebreak) {
+            } else if (isDelimiter_[static_cast<unsigned char>(ch)] || linebreak) {
                 // found a delimiter/newline, ensure that it isn't enclosed by quotes,
                 // i.e. a quote count of 0 or an even count of quotes if the previous
                 // character was a quote
                 if ((quoteCount == 0) || ((prev == '"') && ((quoteCount & 1) == 0))) {
-                    return {value, linebreak};
+                    return {std::string_view(start, current - start),
+                            linebreak ? FieldEnd::LineBreak : FieldEnd::Delimiter};
                 }
             }
             prev = ch;
-            value += ch;
         }
-        if (((quoteCount & 1) != 0) && in.eof()) {
-            throw CSVDataReaderException("Unmatched quotes (starting in line " +
-                                         std::to_string(quoteBeginLine) + ")");
+        if ((quoteCount & 1) != 0) {
+            throw UnmatchedQuotes{quoteBeginLine};
         }
-        return {value, false};
-    };
+        return {std::string_view(start, end_ - start), FieldEnd::End};
+    }
 
-    // extract one row from the current stream position, the bool return value indicates whether
-    // the end-of-file was detected
-    auto extractRow = [&in, extractField,
-                       &lineNumber](size_t maxColCount = std::numeric_limits<size_t>::max())
-        -> std::pair<std::vector<std::string>, bool> {
-        auto val = extractField();
-        if (in.eof() && val.first.empty()) {
-            // reached end of file, no more data
-            return {{}, true};
-        } else if (val.first.empty() && val.second) {
+    /*
+     * Extract the fields of the next row into \p values. Returns false at the end of the input.
+     * \p values is empty for empty lines. All fields but the first one are trimmed.
+     */
+    bool nextRow(std::vector<std::string_view>& values,
+                 size_t maxColCount = std::numeric_limits<size_t>::max()) {
+        values.clear();
+        const auto rowLine = line_;
+        auto field = nextField();
+        if (field.end == FieldEnd::End && field.value.empty()) {
+            // reached end of input, no more data
+            return false;
+        } else if (field.end == FieldEnd::LineBreak && field.value.empty()) {
             // empty line, ignore
-            return {{}, false};
+            return true;
         }
-        std::vector<std::string> values;
-        values.push_back(val.first);
-        while (!val.second && !in.eof()) {
-            val = extractField();
-            values.push_back(trim(val.first));
+        values.push_back(field.value);
+        while (field.end == FieldEnd::Delimiter) {
+            field = nextField();
+            values.push_back(trimmed(field.value));
         }
         // ignore last field _if_ it is empty and would be inserted in the maxColCount+1 column
         if (values.back().empty() && (values.size() - 1 == maxColCount)) {
-            values.resize(values.size() - 1);
+            values.pop_back();
         } else if ((values.size() != maxColCount) &&
                    (maxColCount != std::numeric_limits<size_t>::max())) {
             // mismatch in the number of columns
-            throw CSVDataReaderException("Column counts do not match (line " +
-                                         std::to_string(lineNumber) + ": " +
-                                         std::to_string(values.size()) + " fields; DataFrame has " +
-                                         std::to_string(maxColCount) + " columns)");
+            throw CSVDataReaderException(
+                "Column counts do not match (line " + std::to_string(rowLine) + ": " +
+                std::to_string(values.size()) + " fields; DataFrame has " +
+                std::to_string(maxColCount) + " columns)");
         }
-        return {values, false};
-    };
+        return true;
+    }
 
-    std::vector<std::string> headers;
-    size_t maxColCount = std::numeric_limits<size_t>::max();
-    if (firstRowHeader_) {
-        // read headers
-        auto row = extractRow();
-        if (row.second || row.first.empty()) {
-            throw CSVDataReaderException("Empty file, column headers not found");
+    /*
+     * Skip the next row. Returns false at the end of the input and sets \p empty for empty lines.
+     */
+    bool skipRow(bool& empty) {
+        auto field = nextField();
+        empty = field.value.empty() && field.end != FieldEnd::Delimiter;
+        if (field.end == FieldEnd::End && field.value.empty()) return false;
+        while (field.end == FieldEnd::Delimiter) {
+            field = nextField();
         }
-        headers = row.first;
-        maxColCount = headers.size();
+        return true;
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+    size_t line_;
+    std::array<bool, 256> isDelimiter_;
+};
+
+// Categories of a categorical column found in one chunk, in order of first occurrence
+struct LocalCategories {
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+    std::vector<std::string_view> values;
+    std::vector<std::uint32_t> toColumn;  // maps local IDs to the IDs of the column
+
+    std::uint32_t getID(std::string_view value) {
+        const auto res = ids.try_emplace(value, static_cast<std::uint32_t>(values.size()));
+        if (res.second) values.push_back(value);
+        return res.first->second;
+    }
+};
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t firstLine = 0;
+    size_t lines = 0;     // number of line breaks in the chunk
+    size_t rows = 0;      // number of non-empty lines, an upper bound of the added rows
+    size_t firstRow = 0;  // first row of the chunk in the column buffers
+    size_t addedRows = 0;
+    std::exception_ptr error;
+    std::vector<LocalCategories> categories;
+};
+
+/*
+ * Scan rows starting at \p begin until the first row ending at or after \p stop and count the
+ * lines and non-empty rows.
+ */
+void countRows(Chunk& chunk, const char* stop, const char* end, const std::string& delimiters) {
+    Scanner scanner{chunk.begin, end, delimiters, 0};
+    chunk.rows = 0;
+    chunk.error = nullptr;
+    try {
+        bool empty = false;
+        while (scanner.pos() < stop && scanner.skipRow(empty)) {
+            if (!empty) ++chunk.rows;
+        }
+    } catch (...) {
+        chunk.error = std::current_exception();
+    }
+    chunk.end = chunk.error ? end : scanner.pos();
+    chunk.lines = scanner.line();
+}
+
+template <typename Callback>
+void forEachChunk(const std::vector<Chunk>& chunks, Callback callback) {
+    if (InviwoApplication::isInitialized()) {
+        util::forEachParallel(chunks, callback);
+    } else {
+        util::forEach(chunks, callback);
+    }
+}
+
+/*
+ * Split [begin, end) into chunks of complete rows. The input is cut at line breaks close to
+ * evenly spaced positions and all pieces are scanned in parallel. A cut can be inside a quoted
+ * field, which shows as the previous piece ending past the start of the next one. Those pieces
+ * are scanned again, serially, from the actual end of the previous one.
+ */
+std::vector<Chunk> splitIntoChunks(const char* begin, const char* end, size_t firstLine,
+                                   const std::string& delimiters) {
+    std::vector<const char*> cuts{begin};
+    const size_t size = end - begin;
+    for (size_t i = 1; i < size / chunkSize; ++i) {
+        auto pos = std::find_if(begin + i * size / (size / chunkSize), end,
+                                [](char c) { return c == '\n' || c == '\r'; });
+        if (pos != end && *pos == '\r' && pos + 1 != end && pos[1] == '\n') ++pos;
+        if (pos != end && pos + 1 > cuts.back()) cuts.push_back(pos + 1);
+    }
+    cuts.push_back(end);
+
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i + 1 < cuts.size(); ++i) {
+        chunks.push_back(Chunk{cuts[i], cuts[i + 1]});
+    }
+    forEachChunk(chunks, [&](const Chunk&, size_t i) {
+        countRows(chunks[i], cuts[i + 1], end, delimiters);
+    });
+
+    std::vector<Chunk> result;
+    const char* pos = begin;
+    size_t line = firstLine;
+    for (size_t i = 0; i < chunks.size() && pos != end; ++i) {
+        auto& chunk = chunks[i];
+        if (chunk.begin != pos) {
+            if (pos >= cuts[i + 1]) continue;  // covered by the previous chunk
+            chunk.begin = pos;
+            countRows(chunk, cuts[i + 1], end, delimiters);
+        }
+        if (chunk.error) {
+            try {
+                std::rethrow_exception(chunk.error);
+            } catch (const UnmatchedQuotes& e) {
+                throw unmatchedQuotes(line + e.line);
+            }
+        }
+        chunk.firstLine = line;
+        pos = chunk.end;
+        line += chunk.lines;
+        result.push_back(std::move(chunk));
+    }
+    return result;
+}
+
+struct ColumnTarget {
+    std::vector<float>* values = nullptr;
+    CategoricalColumn* categorical = nullptr;
+    std::vector<std::uint32_t>* ids = nullptr;
+};
+
+/*
+ * Parse all rows of the chunks into the columns of the DataFrame. Numbers are written directly
+ * into the column buffers, categorical values are first given IDs per chunk, which are then
+ * mapped to the IDs of the column in chunk order. This keeps the categories in order of their
+ * first occurrence.
+ */
+void parseChunks(std::vector<Chunk>& chunks, DataFrame& dataFrame, size_t maxColCount,
+                 const std::string& delimiters) {
+    size_t rows = 0;
+    for (auto& chunk : chunks) {
+        chunk.firstRow = rows;
+        rows += chunk.rows;
+    }
+
+    std::vector<ColumnTarget> targets(maxColCount);
+    for (size_t col = 0; col < maxColCount; ++col) {
+        auto column = dataFrame.getColumn(col + 1);
+        if (auto cat = std::dynamic_pointer_cast<CategoricalColumn>(column)) {
+            targets[col].categorical = cat.get();
+            targets[col].ids =
+                &cat->getTypedBuffer()->getEditableRAMRepresentation()->getDataContainer();
+            targets[col].ids->resize(rows);
+        } else if (auto num = std::dynamic_pointer_cast<TemplateColumn<float>>(column)) {
+            targets[col].values =
+                &num->getTypedBuffer()->getEditableRAMRepresentation()->getDataContainer();
+            targets[col].values->resize(rows);
+        }
+    }
+
+    forEachChunk(chunks, [&](const Chunk&, size_t i) {
+        auto& chunk = chunks[i];
+        chunk.categories.resize(maxColCount);
+        try {
+            Scanner scanner{chunk.begin, chunk.end, delimiters, chunk.firstLine};
+            std::vector<std::string_view> values;
+            size_t row = chunk.firstRow;
+            while (scanner.nextRow(values, maxColCount)) {
+                // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
+                if (std::all_of(values.begin(), values.end(),
+                                [](const auto& a) { return a.empty(); })) {
+                    continue;
+                }
+                for (size_t col = 0; col < maxColCount; ++col) {
+                    const auto& target = targets[col];
+                    if (target.values) {
+                        (*target.values)[row] = toFloat(values[col]);
+                    } else if (target.ids) {
+                        (*target.ids)[row] = chunk.categories[col].getID(values[col]);
+                    }
+                }
+                ++row;
+            }
+            chunk.addedRows = row - chunk.firstRow;
+        } catch (const UnmatchedQuotes& e) {
+            chunk.error = std::make_exception_ptr(unmatchedQuotes(e.line));
+        } catch (...) {
+            chunk.error = std::current_exception();
+        }
+        for (auto& categories : chunk.categories) {
+            categories.ids = {};
+        }
+    });
+    for (auto& chunk : chunks) {
+        if (chunk.error) std::rethrow_exception(chunk.error);
+    }
+
+    for (size_t col = 0; col < maxColCount; ++col) {
+        if (!targets[col].categorical) continue;
+
+        // Values with line breaks inside quotes might differ from their string representation
+        std::deque<std::string> converted;
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+        std::vector<std::string> categories;
+        for (auto& chunk : chunks) {
+            auto& local = chunk.categories[col];
+            local.toColumn.reserve(local.values.size());
+            for (auto value : local.values) {
+                if (value.find('\r') != std::string_view::npos) {
+                    value = converted.emplace_back(toString(value));
+                }
+                const auto res =
+                    ids.try_emplace(value, static_cast<std::uint32_t>(categories.size()));
+                if (res.second) categories.emplace_back(value);
+                local.toColumn.push_back(res.first->second);
+            }
+            local.values = {};
+        }
+        const auto columnIDs = targets[col].categorical->addCategories(std::move(categories));
+        for (auto& chunk : chunks) {
+            for (auto& id : chunk.categories[col].toColumn) id = columnIDs[id];
+        }
+    }
+
+    forEachChunk(chunks, [&](const Chunk&, size_t i) {
+        auto& chunk = chunks[i];
+        for (size_t col = 0; col < maxColCount; ++col) {
+            if (!targets[col].categorical) continue;
+            const auto& toColumn = chunk.categories[col].toColumn;
+            auto begin = targets[col].ids->begin() + chunk.firstRow;
+            std::transform(begin, begin + chunk.addedRows, begin,
+                           [&](std::uint32_t id) { return toColumn[id]; });
+        }
+    });
+
+    // Close the gaps left by empty rows
+    size_t dst = 0;
+    for (auto& chunk : chunks) {
+        if (dst != chunk.firstRow) {
+            for (auto& target : targets) {
+                const auto move = [&](auto& vec) {
+                    std::copy(vec.begin() + chunk.firstRow,
+                              vec.begin() + chunk.firstRow + chunk.addedRows, vec.begin() + dst);
+                };
+                if (target.values) move(*target.values);
+                if (target.ids) move(*target.ids);
+            }
+        }
+        dst += chunk.addedRows;
     }
+    for (auto& target : targets) {
+        if (target.values) target.values->resize(dst);
+        if (target.ids) target.ids->resize(dst);
+    }
+}
+
+}  // namespace
+
+CSVDataReaderException::CSVDataReaderException(const std::string& message, ExceptionContext context)
+    : DataReaderException("CSVReader: " + message, context) {}
+
+CSVReader::CSVReader() : DataReaderType<DataFrame>(), delimiters_(","), firstRowHeader_(true) {
+    addExtension(FileExtension("csv", "Comma Separated Values"));
+}
+
+CSVReader* CSVReader::clone() const { return new CSVReader(*this); }
+
+void CSVReader::setDelimiters(const std::string& delim) { delimiters_ = delim; }
+
+void CSVReader::setFirstRowHeader(bool hasHeader) { firstRowHeader_ = hasHeader; }
 
+std::shared_ptr<DataFrame> CSVReader::readData(const std::string& fileName) {
+    const util::MemoryMappedFile file(fileName);
+
+    if (file.empty()) {
+        throw CSVDataReaderException("Empty file, no data", IVW_CONTEXT);
+    }
+
+    return parse(std::string_view(file.data(), file.size()));
+}
+
+std::shared_ptr<DataFrame> CSVReader::readData(std::istream& stream) const {
+    if (stream.bad() || stream.fail()) {
+        throw CSVDataReaderException("Input stream in a bad state", IVW_CONTEXT);
+    }
+
+    // read the remainder of the stream in one go if its size is known
+    std::string data;
+    const auto begin = stream.tellg();
+    stream.seekg(0, std::ios::end);
+    const auto end = stream.tellg();
+    stream.seekg(begin);
+    if (begin != std::streampos(-1) && end != std::streampos(-1) && stream.good()) {
+        data.resize(static_cast<size_t>(end - begin));
+        stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+        data.resize(static_cast<size_t>(stream.gcount()));
+    } else {
+        stream.clear();
+        std::ostringstream in;
+        in << stream.rdbuf();
+        data = in.str();
+    }
+    if (data.empty()) {
+        throw CSVDataReaderException("No data", IVW_CONTEXT);
+    }
+
+    return parse(std::string_view(data));
+}
+
+std::shared_ptr<DataFrame> CSVReader::parse(std::string_view data) const {
+    // Skip BOM if it exists. Added by for example Excel when saving csv files.
+    if (data.size() >= 3 && data.substr(0, 3) == "\xef\xbb\xbf") {
+        data.remove_prefix(3);
+    }
+
+    Scanner scanner{data.data(), data.data() + data.size(), delimiters_, 1};
+    const auto toStrings = [](const std::vector<std::string_view>& values) {
+        std::vector<std::string> strings;
+        strings.reserve(values.size());
+        for (auto value : values) strings.push_back(toString(value));
+        return strings;
+    };
+
+    std::vector<std::string> headers;
     std::vector<std::vector<std::string>> exampleRows;
     std::vector<size_t> exampleLineNumbers;  // line numbers matching the example rows
-    std::streampos streamPos = in.tellg();
-    for (auto exampleRow = 0u; exampleRow < 50u; ++exampleRow) {
-        size_t currentLine = lineNumber;
-        auto row = extractRow(maxColCount);
-        if (row.second) {
-            // reached end-of-file
-            if (exampleRow == 0) {
-                throw CSVDataReaderException("Empty file, no data");
+    size_t maxColCount = std::numeric_limits<size_t>::max();
+    const char* bodyBegin = nullptr;
+    size_t bodyLine = 0;
+    try {
+        std::vector<std::string_view> row;
+        if (firstRowHeader_) {
+            // read headers
+            if (!scanner.nextRow(row) || row.empty()) {
+                throw CSVDataReaderException("Empty file, column headers not found");
+            }
+            headers = toStrings(row);
+            maxColCount = headers.size();
+        }
+
+        bodyBegin = scanner.pos();
+        bodyLine = scanner.line();
+        for (auto exampleRow = 0u; exampleRow < 50u; ++exampleRow) {
+            const size_t currentLine = scanner.line();
+            if (!scanner.nextRow(row, maxColCount)) {
+                break;  // reached end of data
+            } else if (!row.empty()) {  // ignore empty lines
+                exampleRows.push_back(toStrings(row));
+                exampleLineNumbers.push_back(currentLine);
             }
-            in.clear();  // clear eof-bit
-            break;
-        } else if (!row.first.empty()) {  // ignore empty lines
-            exampleRows.emplace_back(row.first);
-            exampleLineNumbers.emplace_back(currentLine);
         }
+    } catch (const UnmatchedQuotes& e) {
+        throw unmatchedQuotes(e.line);
+    }
+    if (exampleRows.empty()) {
+        throw CSVDataReaderException("Empty file, no data");
     }
 
-    // Rewind to start position
-    in.seekg(streamPos, std::ios::beg);
     if (!firstRowHeader_) {
         // assign default column headers
         for (size_t i = 0; i < exampleRows.front().size(); ++i) {
@@ -230,20 +588,9 @@ std::shared_ptr<DataFrame> CSVReader::readData(std::istream& stream) const {
 
     auto dataFrame = createDataFrame(exampleRows, headers);
 
-    size_t rowIndex = firstRowHeader_ ? 1 : 0;
-    auto row = extractRow(maxColCount);
-    while (!row.second) {
-        // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
-        auto emptyIt = std::find_if(std::begin(row.first), std::end(row.first),
-                                    [](const auto& a) { return !a.empty(); });
-        if (emptyIt != row.first.end()) {
-            // May throw DataTypeMismatch, but do not catch it here since it indicates
-            // that the DataFrame is in an invalid state
-            dataFrame->addRow(row.first);
-        }
-        row = extractRow(maxColCount);
-        ++rowIndex;
-    }
+    auto chunks = splitIntoChunks(bodyBegin, data.data() + data.size(), bodyLine, delimiters_);
+    parseChunks(chunks, *dataFrame, maxColCount, delimiters_);
+
     dataFrame->updateIndexBuffer();
     return dataFrame;
 }
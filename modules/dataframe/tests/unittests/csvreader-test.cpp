@@ -34,7 +34,9 @@
 
 #include <inviwo/core/io/tempfilehandle.h>
 #include <inviwo/dataframe/io/csvreader.h>
+#include <inviwo/dataframe/datastructures/column.h>
 
+#include <cstdio>
 #include <sstream>
 
 namespace inviwo {
@@ -53,6 +55,56 @@ TEST(CSVnoData, file) {
     EXPECT_THROW(reader.readData(tmpFile.getFileName()), inviwo::CSVDataReaderException);
 }
 
+TEST(CSVfile, data) {
+    util::TempFileHandle tmpFile("", ".csv");
+    std::fputs("Number,Name\n1,Apple\n2,\"Banana\nsplit\"\n3,Apple", tmpFile);
+    std::fflush(tmpFile);
+
+    CSVReader reader;
+    auto dataframe = reader.readData(tmpFile.getFileName());
+    ASSERT_EQ(3, dataframe->getNumberOfColumns()) << "column count does not match";
+    ASSERT_EQ(3, dataframe->getNumberOfRows()) << "row count does not match";
+    EXPECT_EQ("2", dataframe->getColumn(1)->get(1, false)->toString());
+    EXPECT_EQ("\"Banana\nsplit\"", dataframe->getColumn(2)->get(1, true)->toString());
+    EXPECT_EQ("Apple", dataframe->getColumn(2)->get(2, true)->toString());
+}
+
+TEST(CSVdata, manyChunks) {
+    // large enough to be split into several chunks, with quoted line breaks and empty rows
+    // that may end up at chunk boundaries
+    std::ostringstream ss;
+    ss << "Number,Text\n";
+    const size_t rows = 600000;
+    for (size_t i = 0; i < rows; ++i) {
+        ss << i << ",";
+        if (i % 7 == 0) {
+            ss << "\"row\n" << i % 3 << "\"\r\n";
+        } else {
+            ss << "cat" << i % 5 << "\n";
+        }
+        if (i % 1000 == 0) ss << ",\n\n";
+    }
+    std::istringstream in(ss.str());
+
+    CSVReader reader;
+    auto dataframe = reader.readData(in);
+    ASSERT_EQ(3, dataframe->getNumberOfColumns()) << "column count does not match";
+    ASSERT_EQ(rows, dataframe->getNumberOfRows()) << "row count does not match";
+
+    auto categories = std::dynamic_pointer_cast<CategoricalColumn>(dataframe->getColumn(2));
+    ASSERT_TRUE(categories);
+    const std::vector<std::string> expected{"\"row\n0\"", "cat1", "cat2", "cat3",
+                                            "cat4", "cat0", "\"row\n1\"", "\"row\n2\""};
+    EXPECT_EQ(expected, categories->getCategories()) << "categories are not in order";
+
+    for (size_t i = 0; i < rows; i += 997) {
+        EXPECT_EQ(static_cast<double>(i), dataframe->getColumn(1)->getAsDouble(i));
+        const auto text = i % 7 == 0 ? "\"row\n" + std::to_string(i % 3) + "\""
+                                     : "cat" + std::to_string(i % 5);
+        EXPECT_EQ(text, dataframe->getColumn(2)->getAsString(i)) << "row " << i;
+    }
+}
+
 TEST(CSVdata, numRows) {
     // test for correct row count
     std::istringstream ss("1\n2\n3\n4\n\5\n6");
@@ -33,8 +33,7 @@
 #include <modules/qtwidgets/processors/processorwidgetqt.h>
 #include <inviwo/core/processors/processorobserver.h>
 #include <inviwo/core/util/dispatcher.h>
-
-#include <unordered_set>
+#include <modules/brushingandlinking/datastructures/bitset.h>
 
 namespace inviwo {
 
@@ -51,7 +50,7 @@ class IVW_MODULE_DATAFRAMEQT_API DataFrameTableProcessorWidget : public Processo
     Q_OBJECT
 #include <warn/pop>
 public:
-    using SelectionChangedFunc = void(const std::unordered_set<size_t>&);
+    using SelectionChangedFunc = void(const BitSet&);
     using CallbackHandle = std::shared_ptr<std::function<SelectionChangedFunc>>;
 
     DataFrameTableProcessorWidget(Processor* p);
@@ -60,8 +59,7 @@ public:
     void setDataFrame(std::shared_ptr<const DataFrame> dataframe, bool vectorsIntoColumns = false);
     void setIndexColumnVisible(bool visible);
 
-    void updateSelection(const std::unordered_set<size_t>& columns,
-                         const std::unordered_set<size_t>& rows);
+    void updateSelection(const BitSet& columns, const BitSet& rows);
 
     CallbackHandle setColumnSelectionChangedCallback(std::function<SelectionChangedFunc> callback);
     CallbackHandle setRowSelectionChangedCallback(std::function<SelectionChangedFunc> callback);
@@ -61,7 +61,7 @@ class DataFrameTableProcessorWidget;
 class IVW_MODULE_DATAFRAMEQT_API DataFrameTable : public Processor,
                                                   public ProcessorWidgetMetaDataObserver {
 public:
-    using SelectionChangedFunc = void(const std::unordered_set<size_t>&);
+    using SelectionChangedFunc = void(const BitSet&);
     using CallbackHandle = std::shared_ptr<std::function<SelectionChangedFunc>>;
 
     DataFrameTable();
@@ -63,9 +63,9 @@ DataFrameTableView::DataFrameTableView(QWidget* parent) : QTableWidget(3, 3, par
                                                         ->getRAMRepresentation()
                                                         ->getDataContainer();
 
-                             std::unordered_set<size_t> selection;
+                             BitSet selection;
                              for (auto& index : selectionModel()->selection().indexes()) {
-                                 selection.insert(indexCol[index.row()]);
+                                 selection.add(indexCol[index.row()]);
                              }
                              emit rowSelectionChanged(selection);
                          }
@@ -176,13 +176,13 @@ void DataFrameTableView::setIndexColumnVisible(bool visible) {
 
 bool DataFrameTableView::isIndexColumnVisible() const { return indexVisible_; }
 
-void DataFrameTableView::selectColumns(const std::unordered_set<size_t>& columns) {
+void DataFrameTableView::selectColumns(const BitSet& columns) {
     if (!data_ || ignoreUpdate_) return;
 
     setHorizontalHeaderLabels(generateHeaders(columns));
 }
 
-void DataFrameTableView::selectRows(const std::unordered_set<size_t>& rows) {
+void DataFrameTableView::selectRows(const BitSet& rows) {
     if (!data_ || ignoreUpdate_) return;
 
     util::KeepTrueWhileInScope ignore(&ignoreEvents_);
@@ -196,7 +196,7 @@ void DataFrameTableView::selectRows(const std::unordered_set<size_t>& rows) {
 
     QItemSelection s;
     for (size_t i = 0; i < indexCol.size(); ++i) {
-        if (rows.count(indexCol[i]) > 0) {
+        if (rows.contains(indexCol[i])) {
             QModelIndex start{model()->index(static_cast<int>(i), 0)};
             QModelIndex end{model()->index(static_cast<int>(i), columnCount() - 1)};
             s.select(start, end);
@@ -205,14 +205,13 @@ void DataFrameTableView::selectRows(const std::unordered_set<size_t>& rows) {
     selectionModel()->select(s, QItemSelectionModel::Select);
 }
 
-QStringList DataFrameTableView::generateHeaders(
-    const std::unordered_set<size_t>& selectedCols) const {
+QStringList DataFrameTableView::generateHeaders(const BitSet& selectedCols) const {
 
     const std::array<char, 4> componentNames = {'X', 'Y', 'Z', 'W'};
     QStringList headers;
-    size_t colIndex = 0;
+    std::uint32_t colIndex = 0;
     for (const auto& col : *data_) {
-        const std::string selected = (selectedCols.count(colIndex) > 0) ? " [+]" : "";
+        const std::string selected = selectedCols.contains(colIndex) ? " [+]" : "";
         const auto components = col->getBuffer()->getDataFormat()->getComponents();
         if (components > 1 && vectorsIntoCols_) {
             for (size_t k = 0; k < components; k++) {
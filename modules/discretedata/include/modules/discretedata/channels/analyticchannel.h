@@ -85,6 +85,20 @@ public:
         dataFunction_(destVec, index);
     }
 
+    /**
+     * \brief Range access, constant
+     * Evaluates the function for each index without going through fillRaw.
+     * @param dest Position to write to, expect write of (end - begin) * NumComponents many T
+     * @param begin First linear point index
+     * @param end Linear point index after the last one
+     */
+    void fillRawRange(T* dest, ind begin, ind end) const override {
+        Vec* destVec = reinterpret_cast<Vec*>(dest);
+        for (ind index = begin; index < end; ++index, ++destVec) {
+            dataFunction_(*destVec, index);
+        }
+    }
+
 protected:
     virtual CachedGetter<AnalyticChannel>* newIterator() override {
         return new CachedGetter<AnalyticChannel>(this);
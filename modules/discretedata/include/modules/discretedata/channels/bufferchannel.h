@@ -31,11 +31,14 @@
 
 #include <modules/discretedata/discretedatamoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/stdextensions.h>
 
 #include <modules/discretedata/channels/datachannel.h>
 #include <modules/discretedata/channels/channelgetter.h>
 #include <modules/discretedata/channels/buffergetter.h>
 
+#include <algorithm>
+
 namespace inviwo {
 namespace discretedata {
 
@@ -142,6 +145,32 @@ public:
         return *reinterpret_cast<const VecNT*>(&buffer_[index * N]);
     }
 
+    /**
+     * \brief Range over the buffer memory
+     * The iterators are plain pointers, avoiding the virtual call per element of the generic
+     * channel iterators. Unlike those, they are invalidated when the buffer is resized.
+     */
+    template <typename VecNT = DefaultVec>
+    util::iter_range<VecNT*> dataRange() {
+        static_assert(sizeof(VecNT) == sizeof(T) * N,
+                      "Size and type do not agree with the vector type.");
+        auto begin = reinterpret_cast<VecNT*>(buffer_.data());
+        return util::as_range(begin, begin + size());
+    }
+
+    /**
+     * \brief Range over the buffer memory
+     * The iterators are plain pointers, avoiding the virtual call per element of the generic
+     * channel iterators. Unlike those, they are invalidated when the buffer is resized.
+     */
+    template <typename VecNT = DefaultVec>
+    util::iter_range<const VecNT*> dataRange() const {
+        static_assert(sizeof(VecNT) == sizeof(T) * N,
+                      "Size and type do not agree with the vector type.");
+        auto begin = reinterpret_cast<const VecNT*>(buffer_.data());
+        return util::as_range(begin, begin + size());
+    }
+
 protected:
     virtual BufferGetter<BufferChannel<T, N>>* newIterator() override {
         return new BufferGetter<BufferChannel<T, N>>(this);
@@ -156,6 +185,16 @@ protected:
         memcpy(dest, &buffer_[index * N], sizeof(T) * N);
     }
 
+    /**
+     * \brief Range access, constant
+     * @param dest Position to write to, expect write of (end - begin) * NumComponents many T
+     * @param begin First linear point index
+     * @param end Linear point index after the last one
+     */
+    virtual void fillRawRange(T* dest, ind begin, ind end) const override {
+        std::copy(buffer_.begin() + begin * N, buffer_.begin() + end * N, dest);
+    }
+
     /**
      * \brief Vector containing the buffer data
      * Resizeable only by DataSet. Handle with care:
@@ -47,6 +47,15 @@ public:
 
 protected:
     virtual void fillRaw(T* dest, ind index) const = 0;
+    /**
+     * \brief Copy the elements [begin, end) to dest, expects (end - begin) * N many T.
+     * The default implementation calls fillRaw for each element, override to copy in bulk.
+     */
+    virtual void fillRawRange(T* dest, ind begin, ind end) const {
+        for (ind index = begin; index < end; ++index, dest += N) {
+            fillRaw(dest, index);
+        }
+    }
     virtual ChannelGetter<T, N>* newIterator() = 0;
 };
 
@@ -106,6 +115,33 @@ public:
         fill(dest, index);
     }
 
+    /**
+     * \brief Range access, copy data
+     * A single virtual call for the whole range. Thread safe.
+     * @param begin First linear point index
+     * @param end Linear point index after the last one
+     * @param dest Position to write to, expect (end - begin) many VecNT
+     */
+    template <typename VecNT>
+    void getRange(ind begin, ind end, VecNT* dest) const {
+        static_assert(sizeof(VecNT) == sizeof(T) * N,
+                      "Size and type do not agree with the vector type.");
+        this->fillRawRange(reinterpret_cast<T*>(dest), begin, end);
+    }
+
+    /**
+     * \brief Range access, copy data
+     * A single virtual call for the whole range. Thread safe.
+     * @param begin First linear point index
+     * @param end Linear point index after the last one
+     * @param dest Vector to write to, resized to (end - begin)
+     */
+    template <typename VecNT>
+    void getRange(ind begin, ind end, std::vector<VecNT>& dest) const {
+        dest.resize(end - begin);
+        getRange(begin, end, dest.data());
+    }
+
     template <typename VecNT = DefaultVec>
     iterator<VecNT> begin() {
         return iterator<VecNT>(this->newIterator(), 0);
@@ -55,12 +55,19 @@ public:
 
     bool isPeriodic(ind dim) const { return isDimPeriodic_[dim]; }
 
-    void setPeriodic(ind dim, bool periodic = true) { isDimPeriodic_[dim] = periodic; }
+    void setPeriodic(ind dim, bool periodic = true) {
+        isDimPeriodic_[dim] = periodic;
+        clearConnectionMaps();
+    }
 
     virtual void getConnections(std::vector<ind>& result, ind index, GridPrimitive from,
                                 GridPrimitive to, bool isPosition = false) const override;
 
 protected:
+    //! Periodic connections are computed per element
+    virtual ConnectionMap computeConnectionMap(GridPrimitive from,
+                                               GridPrimitive to) const override;
+
     void sameLevelConnection(std::vector<ind>& result, ind idxLin,
                              const std::vector<ind>& size) const;
 
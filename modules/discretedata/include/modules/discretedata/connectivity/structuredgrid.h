@@ -66,6 +66,10 @@ public:
     static std::vector<ind> indexFromLinear(ind idxLin, const std::vector<ind>& size);
 
 protected:
+    //! Cell to vertex connections are computed directly, all others per element
+    virtual ConnectionMap computeConnectionMap(GridPrimitive from,
+                                               GridPrimitive to) const override;
+
     std::vector<ind> numCellsPerDimension_;
 };
 
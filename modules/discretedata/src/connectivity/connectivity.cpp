@@ -45,6 +45,33 @@ ind Connectivity::getNumElements(GridPrimitive elementType) const {
 
 ElementRange Connectivity::all(GridPrimitive dim) const { return ElementRange(dim, this); }
 
+const ConnectionMap& Connectivity::getConnectionMap(GridPrimitive from, GridPrimitive to) const {
+    std::scoped_lock lock{connectionMapMutex_};
+    auto& map = connectionMaps_[{from, to}];
+    if (!map) map = std::make_unique<const ConnectionMap>(computeConnectionMap(from, to));
+    return *map;
+}
+
+ConnectionMap Connectivity::computeConnectionMap(GridPrimitive from, GridPrimitive to) const {
+    const ind numElements = getNumElements(from);
+
+    ConnectionMap map;
+    map.offsets.reserve(numElements + 1);
+    std::vector<ind> connections;
+    for (ind index = 0; index < numElements; ++index) {
+        connections.clear();
+        getConnections(connections, index, from, to);
+        map.connections.insert(map.connections.end(), connections.begin(), connections.end());
+        map.offsets.push_back(static_cast<ind>(map.connections.size()));
+    }
+    return map;
+}
+
+void Connectivity::clearConnectionMaps() {
+    std::scoped_lock lock{connectionMapMutex_};
+    connectionMaps_.clear();
+}
+
 CellType Connectivity::getCellType(GridPrimitive dim, ind) const {
     switch (dim) {
         case GridPrimitive::Vertex:
@@ -186,6 +186,10 @@ void PeriodicGrid::getConnections(std::vector<ind>& result, ind idxLin, GridPrim
     assert(false && "Not implemented yet.");
 }
 
+ConnectionMap PeriodicGrid::computeConnectionMap(GridPrimitive from, GridPrimitive to) const {
+    return Connectivity::computeConnectionMap(from, to);
+}
+
 ind PeriodicGrid::getNumCellsInDimension(ind dim) const {
     assert(numCellsPerDimension_[dim] >= 0 && "Number of elements not known yet.");
     return numCellsPerDimension_[dim];
@@ -188,6 +188,60 @@ void StructuredGrid::getConnections(std::vector<ind>& result, ind idxLin, GridPr
     assert(false && "Not implemented yet.");
 }
 
+ConnectionMap StructuredGrid::computeConnectionMap(GridPrimitive from, GridPrimitive to) const {
+    if (from != gridDimension_ || to != GridPrimitive::Vertex) {
+        return Connectivity::computeConnectionMap(from, to);
+    }
+
+    const ind numDimensions = numCellsPerDimension_.size();
+    const ind numCorners = ind(1) << numDimensions;
+    const ind numCells = getNumElements(gridDimension_);
+
+    // Vertex Strides - how much to add to the linear index to go forward by 1 in each dimension
+    std::vector<ind> vStrides(numDimensions);
+    ind dimProduct(1);
+    for (ind dim(0); dim < numDimensions; dim++) {
+        vStrides[dim] = dimProduct;
+        dimProduct *= (numCellsPerDimension_[dim] + 1);
+    }
+
+    // Offsets of all corners relative to the lower-left-front corner, same order as in
+    // getConnections
+    std::vector<ind> cornerOffsets(numCorners, 0);
+    for (ind i(1); i < numCorners; i++) {
+        for (ind d(0); d < numDimensions; d++) {
+            if (i & (ind(1) << d)) cornerOffsets[i] += vStrides[d];
+        }
+    }
+
+    ConnectionMap map;
+    map.offsets.resize(numCells + 1);
+    map.connections.resize(numCells * numCorners);
+
+    // Walk the cells in linear order, keeping track of the nD cell index and the linear index of
+    // the lower-left-front corner vertex
+    std::vector<ind> cellIndex(numDimensions, 0);
+    ind lowerLeftFrontVertex = 0;
+    for (ind cell = 0; cell < numCells; ++cell) {
+        map.offsets[cell] = cell * numCorners;
+        auto corners = map.connections.begin() + cell * numCorners;
+        for (ind i(0); i < numCorners; i++) {
+            corners[i] = lowerLeftFrontVertex + cornerOffsets[i];
+        }
+
+        for (ind d(0); d < numDimensions; d++) {
+            lowerLeftFrontVertex += vStrides[d];
+            if (++cellIndex[d] < numCellsPerDimension_[d]) break;
+            // Wrap around, skipping the last vertex of this dimension
+            lowerLeftFrontVertex -= cellIndex[d] * vStrides[d];
+            cellIndex[d] = 0;
+        }
+    }
+    map.offsets[numCells] = numCells * numCorners;
+
+    return map;
+}
+
 ind StructuredGrid::getNumCellsInDimension(ind dim) const {
     assert(numCellsPerDimension_[dim] >= 0 && "Number of elements not known yet.");
     return numCellsPerDimension_[dim];
@@ -39,6 +39,11 @@
 #include <modules/discretedata/connectivity/elementiterator.h>
 #include <modules/discretedata/connectivity/connectioniterator.h>
 #include <modules/discretedata/connectivity/structuredgrid.h>
+#include <modules/discretedata/connectivity/periodicgrid.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 namespace inviwo {
 namespace discretedata {
@@ -73,5 +78,69 @@ TEST(AccessingData, Connectivity) {
     EXPECT_TRUE(allFine && "Connectivity is not bi-directional.");
 }
 
+namespace {
+
+void expectMapMatchesConnections(const Connectivity& grid, GridPrimitive from, GridPrimitive to) {
+    const auto& map = grid.getConnectionMap(from, to);
+    ASSERT_EQ(grid.getNumElements(from), map.size());
+    EXPECT_EQ(&map, &grid.getConnectionMap(from, to)) << "Connection map should be cached";
+
+    std::vector<ind> connections;
+    for (ind index = 0; index < map.size(); ++index) {
+        connections.clear();
+        grid.getConnections(connections, index, from, to);
+        const auto range = map[index];
+        ASSERT_EQ(static_cast<ind>(connections.size()), map.numConnections(index));
+        EXPECT_TRUE(std::equal(range.begin(), range.end(), connections.begin()))
+            << "Mismatch at element " << index;
+    }
+}
+
+}  // namespace
+
+TEST(AccessingData, ConnectionMap) {
+    const std::vector<ind> size = {4, 5, 6};
+    StructuredGrid grid(GridPrimitive::Volume, size);
+    PeriodicGrid periodic(GridPrimitive::Volume, size, {true, false, true});
+
+    for (const Connectivity* g : {static_cast<const Connectivity*>(&grid),
+                                  static_cast<const Connectivity*>(&periodic)}) {
+        expectMapMatchesConnections(*g, GridPrimitive::Volume, GridPrimitive::Vertex);
+        expectMapMatchesConnections(*g, GridPrimitive::Vertex, GridPrimitive::Volume);
+        expectMapMatchesConnections(*g, GridPrimitive::Vertex, GridPrimitive::Vertex);
+        expectMapMatchesConnections(*g, GridPrimitive::Volume, GridPrimitive::Volume);
+    }
+}
+
+TEST(AccessingData, ChannelRange) {
+    const ind numElements = 100;
+    std::vector<float> raw(numElements * 3);
+    std::iota(raw.begin(), raw.end(), 0.0f);
+    BufferChannel<float, 3> buffer(raw, "Buffer");
+    AnalyticChannel<float, 3, glm::vec3> analytic(
+        [](glm::vec3& dest, ind index) { dest = glm::vec3(index * 3.0f) + glm::vec3(0, 1, 2); },
+        numElements, "Analytic");
+
+    for (const DataChannel<float, 3>* channel :
+         {static_cast<const DataChannel<float, 3>*>(&buffer),
+          static_cast<const DataChannel<float, 3>*>(&analytic)}) {
+        std::vector<glm::vec3> range;
+        channel->getRange(10, 60, range);
+        ASSERT_EQ(50u, range.size());
+        for (ind index = 10; index < 60; ++index) {
+            glm::vec3 value;
+            channel->fill(value, index);
+            EXPECT_EQ(value, range[index - 10]) << channel->getName() << " at " << index;
+        }
+    }
+
+    ind index = 0;
+    for (const glm::vec3& value : buffer.dataRange<glm::vec3>()) {
+        EXPECT_EQ(buffer.get<glm::vec3>(index), value);
+        ++index;
+    }
+    EXPECT_EQ(numElements, index);
+}
+
 }  // namespace discretedata
 }  // namespace inviwo
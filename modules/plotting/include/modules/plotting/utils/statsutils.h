@@ -34,7 +34,14 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/util/formatdispatching.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
 #include <ostream>
+#include <vector>
 
 namespace inviwo {
 
@@ -56,6 +63,141 @@ std::basic_ostream<Elem, Traits>& operator<<(std::basic_ostream<Elem, Traits>& o
     return os;
 }
 
+/**
+ * \brief Moments of a pair of variables X and Y.
+ *
+ * Holds the number of observations, the means, and the sums of squared deviations from the
+ * mean. Moments of disjoint sets of observations can be merged, using the pairwise update of
+ * Chan et al., which is numerically stable also for large offsets.
+ */
+struct IVW_MODULE_PLOTTING_API PairMoments {
+    size_t count = 0;
+    double meanX = 0.0;
+    double meanY = 0.0;
+    double m2X = 0.0;  /// sum of (x - meanX)^2
+    double m2Y = 0.0;  /// sum of (y - meanY)^2
+    double cXY = 0.0;  /// sum of (x - meanX) * (y - meanY)
+
+    void merge(const PairMoments& other);
+    /**
+     * The moments with X and Y swapped
+     */
+    PairMoments transposed() const;
+
+    double covariance() const;
+    /**
+     * Pearson correlation coefficient
+     */
+    double correlation() const;
+    /**
+     * The least squares fit of y = kx + m, same as linearRegresion for the observations
+     */
+    RegresionResult regression() const;
+};
+
+/**
+ * \brief Pairwise moments of a set of columns, see covarianceMatrix
+ */
+class IVW_MODULE_PLOTTING_API CovarianceMatrix {
+public:
+    CovarianceMatrix(size_t size = 0);
+
+    size_t size() const;
+    /**
+     * The moments of column \p x and column \p y, where column x is X and column y is Y.
+     */
+    const PairMoments& operator()(size_t x, size_t y) const;
+    PairMoments& operator()(size_t x, size_t y);
+
+    double covariance(size_t x, size_t y) const;
+    double correlation(size_t x, size_t y) const;
+    RegresionResult regression(size_t x, size_t y) const;
+
+    void merge(const CovarianceMatrix& other);
+
+private:
+    size_t size_;
+    std::vector<PairMoments> moments_;  // row major, moments_[x * size_ + y]
+};
+
+/**
+ * \brief Compute the covariance, correlation, and linear regression of all pairs of \p columns
+ * in a single pass over the data.
+ *
+ * The rows are processed in chunks of \p chunkSize, in parallel. Each chunk is accumulated into
+ * a matrix of moments and the chunks are merged in a fixed order, so the result does not depend
+ * on the number of threads. As in linearRegresion, rows where either value of a pair is NaN are
+ * excluded from the statistics of that pair.
+ *
+ * @param columns buffers of scalars, all of the same size
+ * @param chunkSize number of rows accumulated at a time
+ * @throw Exception if the buffers are not of equal size
+ */
+IVW_MODULE_PLOTTING_API CovarianceMatrix
+covarianceMatrix(const std::vector<const BufferBase*>& columns, size_t chunkSize = 1024);
+
+/**
+ * \brief Compute the pairwise statistics of all columns in \p dataFrame, including the index
+ * column. \see covarianceMatrix(const std::vector<const BufferBase*>&, size_t)
+ */
+IVW_MODULE_PLOTTING_API CovarianceMatrix covarianceMatrix(const DataFrame& dataFrame,
+                                                          size_t chunkSize = 1024);
+
+/**
+ * \brief Compute the values below a percentage of observations in the range [\p begin, \p end)
+ * without copying it.
+ *
+ * Works like percentiles but partially reorders the range in place with std::nth_element,
+ * which is O(N) per percentile instead of sorting the whole range. NaNs are moved to the front
+ * of the range and excluded from the computation.
+ *
+ * @param begin start of the data to compute percentiles on, will be reordered
+ * @param end end of the data
+ * @param percentiles in the range [0 1]
+ * @return values below the percentage given by the percentiles, in the order of \p percentiles
+ * @throw Exception if any percentile is less than 0 or larger than 1, or if there is no data
+ */
+template <typename Iter>
+std::vector<typename std::iterator_traits<Iter>::value_type> percentilesInPlace(
+    Iter begin, Iter end, const std::vector<double>& percentiles) {
+    using T = typename std::iterator_traits<Iter>::value_type;
+    if constexpr (util::is_floating_point<T>::value) {
+        begin = std::partition(begin, end, [](const auto& a) { return util::isnan(a); });
+    }
+    const auto nElements = static_cast<size_t>(std::distance(begin, end));
+    if (nElements == 0) {
+        throw Exception("No data to compute percentiles on",
+                        IVW_CONTEXT_CUSTOM("statsutil::percentiles"));
+    }
+
+    std::vector<size_t> ranks;
+    ranks.reserve(percentiles.size());
+    for (auto percentile : percentiles) {
+        if (percentile < 0.0 || percentile > 1.0) {
+            throw Exception("Percentile must be between 0 and 1",
+                            IVW_CONTEXT_CUSTOM("statsutil::percentiles"));
+        }
+        // Take care of percentile == 0 using std::max
+        ranks.push_back(static_cast<size_t>(std::max(std::ceil(nElements * percentile) - 1., 0.)));
+    }
+
+    // Select the ranks in increasing order, each selection only has to consider the elements
+    // after the previous one
+    std::vector<size_t> order(ranks.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+
+    std::vector<T> result(ranks.size());
+    auto first = begin;
+    for (auto i : order) {
+        const auto nth = std::next(begin, ranks[i]);
+        std::nth_element(first, nth, end);
+        result[i] = *nth;
+        first = nth;
+    }
+    return result;
+}
+
 /**
  * \brief Compute value below a percentage of observations in the data.
  * Uses the nearest rank method, i.e. ceil(percentile * N), where N = number of elements in data.
@@ -72,43 +214,31 @@ std::basic_ostream<Elem, Traits>& operator<<(std::basic_ostream<Elem, Traits>& o
  * @return values below the percentage given by the percentiles.
  * @throw Exception if any percentile is less than 0 or larger than 1
  */
-template <typename T, typename std::enable_if<!util::is_floating_point<T>::value, int>::type = 0>
+template <typename T>
 std::vector<T> percentiles(std::vector<T> data, const std::vector<double>& percentiles) {
-    std::sort(data.begin(), data.end());
-    std::vector<T> result;
-    result.reserve(percentiles.size());
-    auto nElements = data.size();
-    for (auto percentile : percentiles) {
-        if (percentile < 0.f || percentile > 1.f) {
-            throw Exception("Percentile must be between 0 and 1",
-                            IVW_CONTEXT_CUSTOM("statsutil::percentiles"));
-        }
-        // Take care of percentile == 1 using std::min
-        result.push_back(
-            data[static_cast<size_t>(std::max(std::ceil(nElements * percentile) - 1., 0.))]);
-    }
-    return result;
+    return percentilesInPlace(data.begin(), data.end(), percentiles);
 }
 
-// Float/double types have special values
-template <typename T, typename std::enable_if<util::is_floating_point<T>::value, int>::type = 0>
-std::vector<T> percentiles(std::vector<T> data, const std::vector<double>& percentiles) {
-    auto noNaN =
-        std::partition(data.begin(), data.end(), [](const auto& a) { return util::isnan(a); });
-    std::sort(noNaN, data.end());
-    std::vector<T> result;
-    result.reserve(percentiles.size());
-    size_t nElements = std::distance(noNaN, data.end());
-    for (auto percentile : percentiles) {
-        if (percentile < 0.f || percentile > 1.f) {
-            throw std::invalid_argument("Percentile must be between 0 and 1");
-        }
-        // Take care of percentile == 1 using std::min
-        result.push_back(
-            data[static_cast<size_t>(std::max(std::ceil(nElements * percentile) - 1., 0.))]);
-    }
-    return result;
-}
+/**
+ * \brief Compute value below a percentage of observations in a buffer of scalars.
+ * \see percentiles(std::vector<T>, const std::vector<double>&)
+ *
+ * The buffer is left untouched, its values are copied once into a scratch vector which is
+ * partially reordered by percentilesInPlace.
+ *
+ * @param buffer of scalars to compute percentiles on
+ * @param percentiles in the range [0 1]
+ * @return values below the percentage given by the percentiles, converted to double
+ * @throw Exception if any percentile is less than 0 or larger than 1, or if there is no data
+ */
+IVW_MODULE_PLOTTING_API std::vector<double> percentiles(const BufferRAM& buffer,
+                                                        const std::vector<double>& percentiles);
+
+/**
+ * \copydoc percentiles(const BufferRAM&, const std::vector<double>&)
+ */
+IVW_MODULE_PLOTTING_API std::vector<double> percentiles(const BufferBase& buffer,
+                                                        const std::vector<double>& percentiles);
 
 }  // namespace statsutil
 
@@ -30,6 +30,8 @@
 #include <modules/plotting/utils/statsutils.h>
 #include <inviwo/core/util/zip.h>
 
+#include <limits>
+
 namespace inviwo {
 namespace statsutil {
 namespace detail {
@@ -117,6 +119,264 @@ RegresionResult linearRegresion(const BufferBase &X, const BufferBase &Y) {
         });
 }
 
+void PairMoments::merge(const PairMoments& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    const auto n = static_cast<double>(count + other.count);
+    const auto weight = static_cast<double>(other.count) / n;
+    const auto factor = static_cast<double>(count) * weight;
+    const auto dx = other.meanX - meanX;
+    const auto dy = other.meanY - meanY;
+
+    meanX += dx * weight;
+    meanY += dy * weight;
+    m2X += other.m2X + dx * dx * factor;
+    m2Y += other.m2Y + dy * dy * factor;
+    cXY += other.cXY + dx * dy * factor;
+    count += other.count;
+}
+
+PairMoments PairMoments::transposed() const { return {count, meanY, meanX, m2Y, m2X, cXY}; }
+
+double PairMoments::covariance() const {
+    return count == 0 ? std::numeric_limits<double>::quiet_NaN()
+                      : cXY / static_cast<double>(count);
+}
+
+double PairMoments::correlation() const { return cXY / std::sqrt(m2X * m2Y); }
+
+RegresionResult PairMoments::regression() const {
+    RegresionResult res;
+    res.k = cXY / m2X;
+    res.m = meanY - res.k * meanX;
+    res.corr = correlation();
+    res.r2 = res.corr * res.corr;
+    return res;
+}
+
+CovarianceMatrix::CovarianceMatrix(size_t size) : size_{size}, moments_(size * size) {}
+
+size_t CovarianceMatrix::size() const { return size_; }
+
+const PairMoments& CovarianceMatrix::operator()(size_t x, size_t y) const {
+    return moments_[x * size_ + y];
+}
+
+PairMoments& CovarianceMatrix::operator()(size_t x, size_t y) { return moments_[x * size_ + y]; }
+
+double CovarianceMatrix::covariance(size_t x, size_t y) const {
+    return (*this)(x, y).covariance();
+}
+
+double CovarianceMatrix::correlation(size_t x, size_t y) const {
+    return (*this)(x, y).correlation();
+}
+
+RegresionResult CovarianceMatrix::regression(size_t x, size_t y) const {
+    return (*this)(x, y).regression();
+}
+
+void CovarianceMatrix::merge(const CovarianceMatrix& other) {
+    if (other.size_ != size_) {
+        throw Exception("Covariance matrices are not of equal size",
+                        IVW_CONTEXT_CUSTOM("statsutil::CovarianceMatrix::merge"));
+    }
+    for (size_t i = 0; i < moments_.size(); ++i) moments_[i].merge(other.moments_[i]);
+}
+
+namespace {
+
+/*
+ * Sums of a chunk of rows, shifted by the first valid value of each column in the chunk to
+ * avoid cancellation when converting into central moments.
+ */
+struct ShiftedSums {
+    double n = 0.0;
+    double sx = 0.0;
+    double sy = 0.0;
+    double sxx = 0.0;
+    double syy = 0.0;
+    double sxy = 0.0;
+
+    PairMoments toMoments(double shiftX, double shiftY) const {
+        if (n == 0.0) return {};
+        return {static_cast<size_t>(n), shiftX + sx / n, shiftY + sy / n, sxx - sx * sx / n,
+                syy - sy * sy / n,      sxy - sx * sy / n};
+    }
+};
+
+class ChunkAccumulator {
+public:
+    ChunkAccumulator(const std::vector<const BufferRAM*>& columns, size_t chunkSize)
+        : columns_{columns}
+        , cols_{columns.size()}
+        , block_(chunkSize * cols_)
+        , shifts_(cols_)
+        , sums_(cols_ * cols_) {}
+
+    // Accumulate the rows [begin, end) into the upper triangle of result
+    void accumulate(size_t begin, size_t end, CovarianceMatrix& result) {
+        const size_t rows = end - begin;
+        bool hasNaN = false;
+
+        // Gather the chunk into a row major block
+        for (size_t c = 0; c < cols_; ++c) {
+            columns_[c]->dispatch<void, dispatching::filter::Scalars>([&](auto buffer) {
+                const auto& data = buffer->getDataContainer();
+                for (size_t r = 0; r < rows; ++r) {
+                    block_[r * cols_ + c] = static_cast<double>(data[begin + r]);
+                }
+            });
+            shifts_[c] = 0.0;
+            for (size_t r = 0; r < rows; ++r) {
+                const auto v = block_[r * cols_ + c];
+                if (std::isnan(v)) {
+                    hasNaN = true;
+                } else if (shifts_[c] == 0.0) {
+                    shifts_[c] = v;
+                }
+            }
+            for (size_t r = 0; r < rows; ++r) block_[r * cols_ + c] -= shifts_[c];
+        }
+
+        std::fill(sums_.begin(), sums_.end(), ShiftedSums{});
+        if (hasNaN) {
+            accumulateWithNaN(rows);
+        } else {
+            accumulateDense(rows);
+        }
+
+        for (size_t x = 0; x < cols_; ++x) {
+            for (size_t y = x; y < cols_; ++y) {
+                result(x, y).merge(sums_[x * cols_ + y].toMoments(shifts_[x], shifts_[y]));
+            }
+        }
+    }
+
+private:
+    // All pairs have the same valid rows, only the cross products differ between the pairs
+    void accumulateDense(size_t rows) {
+        for (size_t r = 0; r < rows; ++r) {
+            const double* row = block_.data() + r * cols_;
+            for (size_t x = 0; x < cols_; ++x) {
+                const auto vx = row[x];
+                ShiftedSums* sums = sums_.data() + x * cols_;
+                for (size_t y = x; y < cols_; ++y) sums[y].sxy += vx * row[y];
+            }
+        }
+        for (size_t x = 0; x < cols_; ++x) {
+            const auto& diag = sums_[x * cols_ + x];
+            double sx = 0.0;
+            for (size_t r = 0; r < rows; ++r) sx += block_[r * cols_ + x];
+            for (size_t y = x; y < cols_; ++y) {
+                auto& sums = sums_[x * cols_ + y];
+                sums.n = static_cast<double>(rows);
+                sums.sx = sx;
+                sums.sxx = diag.sxy;
+            }
+            for (size_t y = 0; y <= x; ++y) {
+                auto& sums = sums_[y * cols_ + x];
+                sums.sy = sx;
+                sums.syy = diag.sxy;
+            }
+        }
+    }
+
+    // Each pair only includes the rows where both values are valid
+    void accumulateWithNaN(size_t rows) {
+        for (size_t r = 0; r < rows; ++r) {
+            const double* row = block_.data() + r * cols_;
+            for (size_t x = 0; x < cols_; ++x) {
+                const auto vx = row[x];
+                if (std::isnan(vx)) continue;
+                ShiftedSums* sums = sums_.data() + x * cols_;
+                for (size_t y = x; y < cols_; ++y) {
+                    const auto vy = row[y];
+                    if (std::isnan(vy)) continue;
+                    auto& s = sums[y];
+                    s.n += 1.0;
+                    s.sx += vx;
+                    s.sy += vy;
+                    s.sxx += vx * vx;
+                    s.syy += vy * vy;
+                    s.sxy += vx * vy;
+                }
+            }
+        }
+    }
+
+    const std::vector<const BufferRAM*>& columns_;
+    size_t cols_;
+    std::vector<double> block_;
+    std::vector<double> shifts_;
+    std::vector<ShiftedSums> sums_;
+};
+
+}  // namespace
+
+CovarianceMatrix covarianceMatrix(const std::vector<const BufferBase*>& columns,
+                                  size_t chunkSize) {
+    const size_t cols = columns.size();
+    CovarianceMatrix result(cols);
+    if (cols == 0) return result;
+
+    const size_t rows = columns.front()->getSize();
+    std::vector<const BufferRAM*> rams;
+    for (auto column : columns) {
+        if (column->getSize() != rows) {
+            throw Exception("Buffers are not of equal length",
+                            IVW_CONTEXT_CUSTOM("statsutil::covarianceMatrix"));
+        }
+        rams.push_back(column->getRepresentation<BufferRAM>());
+    }
+
+    chunkSize = std::max(chunkSize, size_t{1});
+    const size_t chunks = (rows + chunkSize - 1) / chunkSize;
+    // A fixed partition of the chunks into tasks, merged in order, gives the same result for
+    // any number of threads
+    const size_t tasks = std::min(chunks, size_t{64});
+    std::vector<CovarianceMatrix> partial(tasks, CovarianceMatrix(cols));
+
+#pragma omp parallel for schedule(dynamic)
+    for (long long t_ = 0; t_ < static_cast<long long>(tasks); ++t_) {
+        const size_t t = static_cast<size_t>(t_);  // OpenMP need signed integral type.
+        ChunkAccumulator accumulator(rams, chunkSize);
+        for (size_t chunk = t * chunks / tasks; chunk < (t + 1) * chunks / tasks; ++chunk) {
+            const size_t begin = chunk * chunkSize;
+            accumulator.accumulate(begin, std::min(begin + chunkSize, rows), partial[t]);
+        }
+    }
+
+    for (auto& p : partial) result.merge(p);
+    // Fill in the lower triangle
+    for (size_t x = 0; x < cols; ++x) {
+        for (size_t y = 0; y < x; ++y) result(x, y) = result(y, x).transposed();
+    }
+    return result;
+}
+
+CovarianceMatrix covarianceMatrix(const DataFrame& dataFrame, size_t chunkSize) {
+    std::vector<const BufferBase*> columns;
+    for (const auto& column : dataFrame) columns.push_back(column->getBuffer().get());
+    return covarianceMatrix(columns, chunkSize);
+}
+
+std::vector<double> percentiles(const BufferRAM& buffer, const std::vector<double>& percentiles) {
+    return buffer.dispatch<std::vector<double>, dispatching::filter::Scalars>([&](auto ram) {
+        using T = util::PrecisionValueType<decltype(ram)>;
+        std::vector<T> data(ram->getDataContainer());
+        const auto result = percentilesInPlace(data.begin(), data.end(), percentiles);
+        return std::vector<double>(result.begin(), result.end());
+    });
+}
+
+std::vector<double> percentiles(const BufferBase& buffer, const std::vector<double>& percentiles) {
+    return statsutil::percentiles(*buffer.getRepresentation<BufferRAM>(), percentiles);
+}
+
 }  // namespace statsutil
 
 }  // namespace inviwo
@@ -34,6 +34,9 @@
 
 #include <modules/plotting/utils/statsutils.h>
 
+#include <cmath>
+#include <limits>
+
 namespace inviwo {
 
 TEST(StatsUtilsTest, init) {
@@ -68,4 +71,81 @@ TEST(StatsUtilsTest, init) {
     EXPECT_DOUBLE_EQ(50., percentiles[4]) << " 100 percentile";
 }
 
+TEST(StatsUtilsTest, CovarianceMatrix) {
+    Buffer<double> X;
+    Buffer<float> Y;
+    Buffer<int> Z;
+    auto &vecX = X.getEditableRAMRepresentation()->getDataContainer();
+    auto &vecY = Y.getEditableRAMRepresentation()->getDataContainer();
+    auto &vecZ = Z.getEditableRAMRepresentation()->getDataContainer();
+    for (int i = 0; i < 100; ++i) {
+        vecX.push_back(100.0 + std::sin(0.1 * i));
+        vecY.push_back(i % 13 == 0 ? std::numeric_limits<float>::quiet_NaN()
+                                   : static_cast<float>(0.5 * i + std::cos(0.3 * i)));
+        vecZ.push_back((i * 7) % 11);
+    }
+    const std::vector<const BufferBase *> columns{&X, &Y, &Z};
+
+    for (size_t chunkSize : {size_t{1}, size_t{7}, size_t{1024}}) {
+        const auto matrix = statsutil::covarianceMatrix(columns, chunkSize);
+        ASSERT_EQ(3, matrix.size());
+        for (size_t x = 0; x < columns.size(); ++x) {
+            for (size_t y = 0; y < columns.size(); ++y) {
+                if (x == y) continue;
+                const auto expected = statsutil::linearRegresion(*columns[x], *columns[y]);
+                const auto res = matrix.regression(x, y);
+                EXPECT_NEAR(expected.k, res.k, 1e-6) << "chunk size " << chunkSize;
+                EXPECT_NEAR(expected.m, res.m, 1e-3) << "chunk size " << chunkSize;
+                EXPECT_NEAR(expected.corr, res.corr, 1e-6) << "chunk size " << chunkSize;
+                EXPECT_NEAR(expected.r2, res.r2, 1e-6) << "chunk size " << chunkSize;
+            }
+        }
+        // Rows with NaN are only excluded from the pairs involving Y
+        EXPECT_EQ(100, matrix(0, 2).count);
+        EXPECT_EQ(92, matrix(0, 1).count);
+        EXPECT_EQ(matrix(1, 2).count, matrix(2, 1).count);
+    }
+}
+
+TEST(StatsUtilsTest, PercentilesInPlace) {
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    auto data = std::vector<double>({nan, 20., 15., nan, 50., 40., 35.});
+    auto percentiles =
+        statsutil::percentilesInPlace(data.begin(), data.end(), {1.0, 0.05, 0.5, .30, 0.40});
+    EXPECT_DOUBLE_EQ(50., percentiles[0]) << " 100 percentile";
+    EXPECT_DOUBLE_EQ(15., percentiles[1]) << " 5 percentile";
+    EXPECT_DOUBLE_EQ(35., percentiles[2]) << " 50 percentile";
+    EXPECT_DOUBLE_EQ(20., percentiles[3]) << " 30 percentile";
+    EXPECT_DOUBLE_EQ(20., percentiles[4]) << " 40 percentile";
+
+    auto ints = std::vector<int>({5, 1, 4, 2, 3});
+    EXPECT_EQ(std::vector<int>({1, 3, 5}),
+              statsutil::percentilesInPlace(ints.begin(), ints.end(), {0.0, 0.5, 1.0}));
+
+    auto empty = std::vector<double>({nan, nan});
+    EXPECT_THROW(statsutil::percentilesInPlace(empty.begin(), empty.end(), {0.5}), Exception);
+    EXPECT_THROW(statsutil::percentiles(ints, {1.5}), Exception);
+}
+
+TEST(StatsUtilsTest, BufferPercentiles) {
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    Buffer<float> floats;
+    floats.getEditableRAMRepresentation()->getDataContainer() = {20.f, nan, 15.f, 50.f, 40.f,
+                                                                  35.f};
+    EXPECT_EQ(std::vector<double>({15., 20., 35., 50.}),
+              statsutil::percentiles(floats, {0.05, 0.3, 0.5, 1.0}));
+    // The buffer is not reordered
+    EXPECT_EQ(20.f, floats.getRAMRepresentation()->getDataContainer()[0]);
+    EXPECT_EQ(35.f, floats.getRAMRepresentation()->getDataContainer()[5]);
+
+    Buffer<int> ints;
+    ints.getEditableRAMRepresentation()->getDataContainer() = {5, 1, 4, 2, 3};
+    EXPECT_EQ(std::vector<double>({1., 3., 5.}),
+              statsutil::percentiles(*ints.getRAMRepresentation(), {0.0, 0.5, 1.0}));
+
+    EXPECT_THROW(statsutil::percentiles(ints, {-0.5}), Exception);
+    floats.getEditableRAMRepresentation()->getDataContainer() = {nan, nan};
+    EXPECT_THROW(statsutil::percentiles(floats, {0.5}), Exception);
+}
+
 }  // namespace inviwo
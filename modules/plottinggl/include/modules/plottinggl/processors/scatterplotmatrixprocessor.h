@@ -47,6 +47,9 @@
 #include <modules/opengl/rendering/texturequadrenderer.h>
 #include <modules/fontrendering/textrenderer.h>
 #include <modules/brushingandlinking/ports/brushingandlinkingports.h>
+#include <modules/plotting/utils/statsutils.h>
+
+#include <optional>
 
 namespace inviwo {
 
@@ -85,6 +88,8 @@ private:
     void createScatterPlots();
     void createLabels();
     void createStatsLabels();
+    void createBackgrounds();
+    const statsutil::CovarianceMatrix& getStatistics();
     size_t numParams_;
 
     ScatterPlotGL::Properties scatterPlotproperties_;
@@ -110,6 +115,10 @@ private:
     std::vector<std::shared_ptr<Texture2D>> statsTextures_;
     std::vector<std::shared_ptr<Texture2D>> bgTextures_;
 
+    //! Pairwise statistics of the included columns, shared by the stats labels and the
+    //! background colors. Computed on demand and reset when the data or the columns change.
+    std::optional<statsutil::CovarianceMatrix> stats_;
+
     TextRenderer textRenderer_;
     TextureQuadRenderer textureQuadRenderer_;
 
@@ -278,7 +278,7 @@ void PersistenceDiagramPlotGL::plot(const size2_t& dims, IndexBuffer* indices, b
                          buffer = colorBuffer, normalizeValue](uint32_t index) {
             if (hoverEnabled && util::contains(hoveredIndices_, index)) {
                 return properties_.hoverColor_.get();
-            } else if (util::contains(selectedIndices_, index)) {
+            } else if (selectedIndices_.contains(index)) {
                 return properties_.selectionColor_.get();
             } else if (color_) {
                 return properties_.tf_.get().sample(normalizeValue(buffer->getAsDouble(index)));
@@ -436,7 +436,7 @@ void PersistenceDiagramPlotGL::setIndexColumn(
     }
 }
 
-void PersistenceDiagramPlotGL::setSelectedIndices(const std::unordered_set<size_t>& indices) {
+void PersistenceDiagramPlotGL::setSelectedIndices(const BitSet& indices) {
     selectedIndices_ = indices;
 }
 
@@ -512,10 +512,10 @@ void PersistenceDiagramPlotGL::objectPicked(PickingEvent* p) {
     if ((p->getPressState() == PickingPressState::Release) &&
         (p->getPressItem() == PickingPressItem::Primary) &&
         (p->getCurrentGlobalPickingId() == p->getPressedGlobalPickingId())) {
-        if (selectedIndices_.count(id)) {
-            selectedIndices_.erase(id);
+        if (selectedIndices_.contains(id)) {
+            selectedIndices_.remove(id);
         } else {
-            selectedIndices_.insert(id);
+            selectedIndices_.add(id);
         }
         // selection changed, inform processor
         selectionChangedCallback_.invoke(selectedIndices_);
@@ -532,12 +532,14 @@ void ScatterPlotGL::setIndexColumn(std::shared_ptr<const TemplateColumn<uint32_t
     }
 }
 
-void ScatterPlotGL::setSelectedIndices(const std::unordered_set<size_t>& indices) {
+void ScatterPlotGL::setSelectedIndices(const BitSet& indices) {
     ensureSelectAndFilterSizes();
     selected_.resize(xAxis_->getSize(), false);
-    for (auto i : indices) {
-        selected_[i] = true;
-    }
+    indices.forEachRange([&](std::uint32_t first, std::uint32_t last) {
+        if (first >= selected_.size()) return;
+        const auto end = std::min<size_t>(size_t{last} + 1, selected_.size());
+        std::fill(selected_.begin() + first, selected_.begin() + end, true);
+    });
     selectedIndicesGLDirty_ = true;
 }
 
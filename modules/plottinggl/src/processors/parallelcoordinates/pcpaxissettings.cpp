@@ -140,11 +140,11 @@ void PCPAxisSettings::updateFromColumn(std::shared_ptr<const Column> col) {
                 range.set(
                     {minV + prevMinRatio * (maxV - minV), minV + prevMaxRatio * (maxV - minV)});
             }
-            auto pecentiles = statsutil::percentiles(dataVector, {0., 0.25, 0.75, 1.});
-            p0_ = static_cast<double>(pecentiles[0]);
-            p25_ = static_cast<double>(pecentiles[1]);
-            p75_ = static_cast<double>(pecentiles[2]);
-            p100_ = static_cast<double>(pecentiles[3]);
+            auto pecentiles = statsutil::percentiles(*ram, {0., 0.25, 0.75, 1.});
+            p0_ = pecentiles[0];
+            p25_ = pecentiles[1];
+            p75_ = pecentiles[2];
+            p100_ = pecentiles[3];
             at = [vec = &dataVector](size_t idx) { return static_cast<double>(vec->at(idx)); };
         });
 
@@ -157,7 +157,8 @@ ScatterPlotMatrixProcessor::ScatterPlotMatrixProcessor()
 
     fontColor_.onChange(updateStatsLabels);
     statsFontSize_.onChange(updateStatsLabels);
-    correlectionTF_.onChange(updateStatsLabels);
+    // Only the colors depend on the TF, the statistics are kept
+    correlectionTF_.onChange([&]() { bgTextures_.clear(); });
 
     scatterPlotproperties_.onChange([&]() {
         for (auto &p : plots_) {
@@ -169,12 +170,16 @@ ScatterPlotMatrixProcessor::ScatterPlotMatrixProcessor()
         plots_.clear();
         labelsTextures_.clear();
         statsTextures_.clear();
+        bgTextures_.clear();
+        stats_.reset();
     });
 
     parameters_.onChange([&]() {
         plots_.clear();
         labelsTextures_.clear();
         statsTextures_.clear();
+        bgTextures_.clear();
+        stats_.reset();
     });
 }
 
@@ -212,6 +217,9 @@ void ScatterPlotMatrixProcessor::process() {
     if (statsTextures_.empty()) {
         createStatsLabels();
     }
+    if (bgTextures_.empty()) {
+        createBackgrounds();
+    }
 
     std::unique_ptr<IndexBuffer> indicies = nullptr;
     if (brushing_.isConnected()) {
@@ -221,7 +229,7 @@ void ScatterPlotMatrixProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto brushedIndicies = brushing_.getFilteredIndices();
+        const auto &brushedIndicies = brushing_.getFilteredIndices();
         indicies = std::make_unique<IndexBuffer>();
         auto &vec = indicies->getEditableRAMRepresentation()->getDataContainer();
         vec.reserve(dfSize - brushedIndicies.size());
@@ -306,20 +314,29 @@ void ScatterPlotMatrixProcessor::createScatterPlots() {
     }
 }
 
+const statsutil::CovarianceMatrix &ScatterPlotMatrixProcessor::getStatistics() {
+    if (!stats_) {
+        std::vector<const BufferBase *> columns;
+        for (const auto &col : *dataFrame_.getData()) {
+            if (isIncluded(col)) columns.push_back(col->getBuffer().get());
+        }
+        // All pairs are computed in a single pass over the data
+        stats_ = statsutil::covarianceMatrix(columns);
+    }
+    return *stats_;
+}
+
 void ScatterPlotMatrixProcessor::createStatsLabels() {
     if (outport_.hasData()) {
         statsTextures_.clear();
-        bgTextures_.clear();
 
         textRenderer_.setFont(fontFaceStats_.get());
         textRenderer_.setFontSize(statsFontSize_.get());
 
-        auto &dataFrame = *dataFrame_.getData();
-        for (auto x = dataFrame.begin(); x != dataFrame.end(); ++x) {
-            if (!isIncluded(*x)) continue;
-            for (auto y = x + 1; y != dataFrame.end(); ++y) {
-                if (!isIncluded(*y)) continue;
-                auto res = statsutil::linearRegresion(*(*x)->getBuffer(), *(*y)->getBuffer());
+        const auto &stats = getStatistics();
+        for (size_t x = 0; x < stats.size(); ++x) {
+            for (size_t y = x + 1; y < stats.size(); ++y) {
+                auto res = stats.regression(x, y);
 
                 std::ostringstream oss;
                 oss << std::setprecision(2) << "corr ρ = " << res.corr << std::endl
@@ -327,20 +344,29 @@ void ScatterPlotMatrixProcessor::createStatsLabels() {
 
                 auto tex = util::createTextTexture(textRenderer_, oss.str(), fontColor_);
                 statsTextures_.push_back(tex);
+            }
+        }
+    }
+}
+
+void ScatterPlotMatrixProcessor::createBackgrounds() {
+    if (outport_.hasData()) {
+        bgTextures_.clear();
 
-                auto tex2 = std::make_shared<Texture2D>(size2_t(1, 1), GL_RGBA, GL_RGBA, GL_FLOAT,
-                                                        GL_LINEAR);
-                auto v = res.r2;
-                if (res.corr < 0) {
-                    v = -v;
-                }
-                v += 1;
-                v /= 2;
+        const auto &stats = getStatistics();
+        for (size_t x = 0; x < stats.size(); ++x) {
+            for (size_t y = x + 1; y < stats.size(); ++y) {
+                // Map the signed coefficient of determination, corr * |corr|, from [-1 1] to the
+                // TF domain [0 1]
+                const auto corr = stats.correlation(x, y);
+                const auto v = (corr * std::abs(corr) + 1.0) / 2.0;
 
+                auto tex = std::make_shared<Texture2D>(size2_t(1, 1), GL_RGBA, GL_RGBA, GL_FLOAT,
+                                                       GL_LINEAR);
                 auto c = correlectionTF_.get().sample(v);
-                tex2->initialize(&c);
+                tex->initialize(&c);
 
-                bgTextures_.push_back(tex2);
+                bgTextures_.push_back(tex);
             }
         }
     }
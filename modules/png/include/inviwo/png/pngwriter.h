@@ -37,6 +37,8 @@
 
 namespace inviwo {
 
+class ThreadPool;
+
 class IVW_MODULE_PNG_API PNGLayerWriterException : public DataWriterException {
 public:
     PNGLayerWriterException(const std::string& message = "",
@@ -44,9 +46,40 @@ public:
     virtual ~PNGLayerWriterException() noexcept = default;
 };
 
+/**
+ * \brief Compression settings of the PNGLayerWriter
+ *
+ * The rows of the image are filtered using \p filter and then compressed with zlib using
+ * \p level and \p strategy. If \p stripHeight is larger than zero, the image is split into
+ * horizontal strips of that many rows which are filtered and deflated on the thread pool, and then
+ * stitched together into a single zlib stream. Each strip is deflated using the end of the
+ * previous strip as dictionary so the compression ratio is close to the one of a serial encoding.
+ */
+struct IVW_MODULE_PNG_API PNGCompression {
+    /// See the zlib documentation of deflateInit2
+    enum class Strategy { Default, Filtered, HuffmanOnly, RLE };
+    /// The PNG row filter. Adaptive chooses the filter with the smallest sum of absolute
+    /// differences for each row, same as libpng.
+    enum class Filter { None, Sub, Up, Average, Paeth, Adaptive };
+
+    int level = 6;  ///< zlib compression level from 0 to 9, 0 stores the data uncompressed
+    Strategy strategy = Strategy::Default;
+    Filter filter = Filter::Adaptive;
+    size_t stripHeight = 128;  ///< Rows per strip, 0 to encode serially using libpng
+
+    /// No compression at all, the fastest setting. Useful for scratch output
+    static PNGCompression store();
+    /// Fast compression with a cheap row filter
+    static PNGCompression fast();
+    /// Same compression as the libpng defaults
+    static PNGCompression standard();
+    /// The smallest files
+    static PNGCompression best();
+};
+
 class IVW_MODULE_PNG_API PNGLayerWriter : public DataWriterType<Layer> {
 public:
-    PNGLayerWriter();
+    explicit PNGLayerWriter(const PNGCompression& compression = PNGCompression{});
     PNGLayerWriter(const PNGLayerWriter& rhs) = default;
     PNGLayerWriter& operator=(const PNGLayerWriter& that) = default;
     virtual PNGLayerWriter* clone() const override;
@@ -56,6 +89,21 @@ public:
     virtual std::unique_ptr<std::vector<unsigned char>> writeDataToBuffer(
         const Layer* data, const std::string& fileExtension) const override;
     virtual bool writeDataToRepresentation(const repr* src, repr* dst) const override;
+
+    void setCompression(const PNGCompression& compression);
+    const PNGCompression& getCompression() const;
+
+    /**
+     * Set the thread pool used to encode the strips. If no pool is set, the pool of the
+     * InviwoApplication is used if there is one, otherwise the strips are encoded serially.
+     */
+    void setThreadPool(ThreadPool* pool);
+
+private:
+    ThreadPool* getThreadPool() const;
+
+    PNGCompression compression_;
+    ThreadPool* pool_ = nullptr;
 };
 
 }  // namespace inviwo
@@ -29,14 +29,20 @@
 
 #include <inviwo/png/pngwriter.h>
 
+#include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/image/layer.h>
 #include <inviwo/core/datastructures/image/layerram.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 #include <inviwo/core/util/filesystem.h>
 #include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/threadpool.h>
 
 #include <png.h>
+#include <zlib.h>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
 
 namespace inviwo {
 
@@ -44,9 +50,296 @@ namespace detail {
 
 void writeToBuffer(png_structp png_ptr, png_bytep data, png_size_t length) {
     auto buffer = static_cast<std::vector<unsigned char>*>(png_get_io_ptr(png_ptr));
-    for (png_size_t i = 0; i < length; i++) {
-        buffer->push_back(static_cast<unsigned char>(data[i]));
+    buffer->insert(buffer->end(), data, data + length);
+}
+
+int zlibStrategy(PNGCompression::Strategy strategy) {
+    switch (strategy) {
+        case PNGCompression::Strategy::Filtered:
+            return Z_FILTERED;
+        case PNGCompression::Strategy::HuffmanOnly:
+            return Z_HUFFMAN_ONLY;
+        case PNGCompression::Strategy::RLE:
+            return Z_RLE;
+        case PNGCompression::Strategy::Default:
+        default:
+            return Z_DEFAULT_STRATEGY;
+    }
+}
+
+int pngFilters(PNGCompression::Filter filter) {
+    switch (filter) {
+        case PNGCompression::Filter::None:
+            return PNG_FILTER_NONE;
+        case PNGCompression::Filter::Sub:
+            return PNG_FILTER_SUB;
+        case PNGCompression::Filter::Up:
+            return PNG_FILTER_UP;
+        case PNGCompression::Filter::Average:
+            return PNG_FILTER_AVG;
+        case PNGCompression::Filter::Paeth:
+            return PNG_FILTER_PAETH;
+        case PNGCompression::Filter::Adaptive:
+        default:
+            return PNG_ALL_FILTERS;
+    }
+}
+
+inline int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+/**
+ * Apply PNG filter \p type (0 to 4) to \p row given the unfiltered previous row \p prev.
+ * Writes the filter type followed by the rowBytes filtered bytes to \p dst.
+ */
+void filterRow(int type, const unsigned char* row, const unsigned char* prev, size_t rowBytes,
+               size_t bpp, unsigned char* dst) {
+    *dst++ = static_cast<unsigned char>(type);
+    switch (type) {
+        case 0:
+            std::copy(row, row + rowBytes, dst);
+            break;
+        case 1:
+            std::copy(row, row + bpp, dst);
+            for (size_t i = bpp; i < rowBytes; ++i) dst[i] = row[i] - row[i - bpp];
+            break;
+        case 2:
+            for (size_t i = 0; i < rowBytes; ++i) dst[i] = row[i] - prev[i];
+            break;
+        case 3:
+            for (size_t i = 0; i < bpp; ++i) dst[i] = row[i] - (prev[i] >> 1);
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] - static_cast<unsigned char>((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < bpp; ++i) dst[i] = row[i] - prev[i];
+            for (size_t i = bpp; i < rowBytes; ++i) {
+                dst[i] = row[i] -
+                         static_cast<unsigned char>(paeth(row[i - bpp], prev[i], prev[i - bpp]));
+            }
+            break;
+    }
+}
+
+/**
+ * The heuristic of libpng to select a filter, the sum of the filtered bytes seen as signed values
+ */
+size_t filterCost(const unsigned char* filtered, size_t rowBytes) {
+    size_t sum = 0;
+    for (size_t i = 0; i < rowBytes; ++i) {
+        sum += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+    }
+    return sum;
+}
+
+void appendUInt32(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+void appendChunk(std::vector<unsigned char>& out, const char* type, const unsigned char* data,
+                 size_t size) {
+    appendUInt32(out, static_cast<uint32_t>(size));
+    const auto start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    const auto crc = crc32(0, out.data() + start, static_cast<uInt>(size + 4));
+    appendUInt32(out, static_cast<uint32_t>(crc));
+}
+
+// zlib uses 32 bit sizes, feed it large buffers in pieces of this size
+constexpr size_t zlibMaxInput = size_t{1} << 30;
+
+uLong adler32(const unsigned char* data, size_t size) {
+    uLong adler = ::adler32(0, nullptr, 0);
+    for (size_t pos = 0; pos < size; pos += zlibMaxInput) {
+        adler = ::adler32(adler, data + pos, static_cast<uInt>(std::min(size - pos, zlibMaxInput)));
+    }
+    return adler;
+}
+
+/**
+ * Raw deflate \p size bytes of \p data, appending the compressed data to \p out. The last strip
+ * finishes the deflate stream, the others end with a sync flush so they end on a byte boundary and
+ * can be concatenated. \p dictionary is the data preceding \p data in the stream.
+ */
+void deflateStrip(const unsigned char* dictionary, size_t dictionarySize,
+                  const unsigned char* data, size_t size, bool last,
+                  const PNGCompression& compression, std::vector<unsigned char>& out) {
+    z_stream zs{};
+    if (deflateInit2(&zs, std::clamp(compression.level, 0, 9), Z_DEFLATED, -MAX_WBITS, 8,
+                     zlibStrategy(compression.strategy)) != Z_OK) {
+        throw PNGLayerWriterException("Internal PNG Error: Failed to initialize zlib");
+    }
+    util::OnScopeExit cleanup([&]() { deflateEnd(&zs); });
+
+    if (dictionarySize > 0 &&
+        deflateSetDictionary(&zs, dictionary, static_cast<uInt>(dictionarySize)) != Z_OK) {
+        throw PNGLayerWriterException("Internal PNG Error: Failed to set zlib dictionary");
+    }
+
+    auto written = out.size();
+    out.resize(written + deflateBound(&zs, static_cast<uLong>(size)) + 16);
+
+    size_t pos = 0;
+    do {
+        const auto piece = std::min(size - pos, zlibMaxInput);
+        zs.next_in = const_cast<Bytef*>(data + pos);
+        zs.avail_in = static_cast<uInt>(piece);
+        pos += piece;
+        const int flush = pos < size ? Z_NO_FLUSH : (last ? Z_FINISH : Z_SYNC_FLUSH);
+
+        int res = Z_OK;
+        do {
+            if (written == out.size()) out.resize(2 * out.size());
+            zs.next_out = out.data() + written;
+            zs.avail_out = static_cast<uInt>(std::min(out.size() - written, zlibMaxInput));
+            res = deflate(&zs, flush);
+            if (res == Z_STREAM_ERROR) {
+                throw PNGLayerWriterException("Internal PNG Error: Failed to deflate data");
+            }
+            written = static_cast<size_t>(zs.next_out - out.data());
+        } while (zs.avail_out == 0 || (flush == Z_FINISH && res != Z_STREAM_END));
+    } while (pos < size);
+
+    out.resize(written);
+}
+
+/**
+ * Encode an image into a PNG by filtering and deflating strips of rows in parallel.
+ * The rows of \p pixels are stored bottom up as in Inviwo, 16 bit samples are in little endian.
+ */
+std::vector<unsigned char> encodeStrips(const unsigned char* pixels, size_t width, size_t height,
+                                        size_t channels, int bitDepth, int colorType,
+                                        const PNGCompression& compression, ThreadPool* pool) {
+    const size_t bytesPerSample = bitDepth / 8;
+    const size_t bpp = channels * bytesPerSample;
+    const size_t rowBytes = width * bpp;
+    const size_t filteredRowBytes = rowBytes + 1;
+    const size_t stripHeight = std::max(compression.stripHeight, size_t{1});
+    const size_t nStrips = std::max((height + stripHeight - 1) / stripHeight, size_t{1});
+    // Enough rows before each strip to fill the 32 KB deflate window
+    const size_t windowSize = size_t{1} << MAX_WBITS;
+    const size_t dictionaryRows = (windowSize + filteredRowBytes - 1) / filteredRowBytes;
+
+    struct Strip {
+        std::vector<unsigned char> data;
+        uLong adler = 0;
+        size_t size = 0;
+    };
+    std::vector<Strip> strips(nStrips);
+
+    auto encodeStrip = [&](size_t s) {
+        const size_t begin = s * stripHeight;
+        const size_t end = std::min(begin + stripHeight, height);
+        const size_t first = begin - std::min(begin, dictionaryRows);
+
+        // PNG stores the rows top down in big endian
+        std::vector<unsigned char> rowBuffers(2 * rowBytes, 0);
+        const std::vector<unsigned char> zeros(rowBytes, 0);
+        auto getRow = [&](size_t row, unsigned char* buffer) -> const unsigned char* {
+            const auto src = pixels + (height - row - 1) * rowBytes;
+            if (bytesPerSample == 1) return src;
+            for (size_t i = 0; i < rowBytes; i += 2) {
+                buffer[i] = src[i + 1];
+                buffer[i + 1] = src[i];
+            }
+            return buffer;
+        };
+
+        const auto nRows = end - first;
+        std::vector<unsigned char> filtered(nRows * filteredRowBytes);
+        std::vector<unsigned char> candidates;
+        if (compression.filter == PNGCompression::Filter::Adaptive) {
+            candidates.resize(5 * filteredRowBytes);
+        }
+
+        const unsigned char* prev =
+            first == 0 ? zeros.data()
+                       : getRow(first - 1, rowBuffers.data() + ((first + 1) % 2) * rowBytes);
+        for (size_t row = first; row < end; ++row) {
+            // Alternate between the two row buffers to keep the previous row
+            auto buffer = rowBuffers.data() + (row % 2) * rowBytes;
+            const auto cur = getRow(row, buffer);
+            auto dst = filtered.data() + (row - first) * filteredRowBytes;
+            if (compression.filter == PNGCompression::Filter::Adaptive) {
+                size_t best = 0;
+                size_t bestCost = std::numeric_limits<size_t>::max();
+                for (int type = 0; type < 5; ++type) {
+                    auto candidate = candidates.data() + type * filteredRowBytes;
+                    filterRow(type, cur, prev, rowBytes, bpp, candidate);
+                    const auto cost = filterCost(candidate + 1, rowBytes);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        best = type;
+                    }
+                }
+                std::copy_n(candidates.data() + best * filteredRowBytes, filteredRowBytes, dst);
+            } else {
+                filterRow(static_cast<int>(compression.filter), cur, prev, rowBytes, bpp, dst);
+            }
+            prev = cur;
+        }
+
+        const auto dictionarySize = std::min((begin - first) * filteredRowBytes, windowSize);
+        const auto data = filtered.data() + (begin - first) * filteredRowBytes;
+        const auto size = (end - begin) * filteredRowBytes;
+
+        auto& strip = strips[s];
+        if (s == 0) {
+            // The zlib header, FLEVEL only informs about the compression level used
+            const unsigned int cmf = 0x78;  // deflate with a 32 KB window
+            const int level = std::clamp(compression.level, 0, 9);
+            unsigned int flg = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+            flg += 31 - ((cmf << 8) + flg) % 31;
+            strip.data.push_back(static_cast<unsigned char>(cmf));
+            strip.data.push_back(static_cast<unsigned char>(flg));
+        }
+        deflateStrip(data - dictionarySize, dictionarySize, data, size, s + 1 == nStrips,
+                     compression, strip.data);
+        strip.adler = adler32(data, size);
+        strip.size = size;
+    };
+
+    if (pool && nStrips > 1) {
+        ThreadPool::TaskGroup group{*pool};
+        for (size_t s = 0; s < nStrips; ++s) group.run([&encodeStrip, s]() { encodeStrip(s); });
+        group.wait();
+    } else {
+        for (size_t s = 0; s < nStrips; ++s) encodeStrip(s);
     }
+
+    uLong adler = strips.front().adler;
+    for (size_t s = 1; s < nStrips; ++s) {
+        adler = adler32_combine(adler, strips[s].adler, static_cast<z_off_t>(strips[s].size));
+    }
+    appendUInt32(strips.back().data, static_cast<uint32_t>(adler));
+
+    std::vector<unsigned char> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    std::vector<unsigned char> header;
+    appendUInt32(header, static_cast<uint32_t>(width));
+    appendUInt32(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), {static_cast<unsigned char>(bitDepth),
+                                 static_cast<unsigned char>(colorType), 0, 0, 0});
+
+    size_t total = png.size() + header.size() + 3 * 12;
+    for (const auto& strip : strips) total += strip.data.size() + 12;
+    png.reserve(total);
+
+    appendChunk(png, "IHDR", header.data(), header.size());
+    for (const auto& strip : strips) appendChunk(png, "IDAT", strip.data.data(), strip.data.size());
+    appendChunk(png, "IEND", nullptr, 0);
+    return png;
 }
 
 template <typename Result, typename T>
@@ -82,8 +375,9 @@ auto convertToUnsigned(const T*, const size_t, const T, const T) -> std::vector<
 }
 
 template <typename T>
-void write(const LayerRAMPrecision<T>* ram, png_voidp ioPtr, png_rw_ptr writeFunc = nullptr,
-           png_flush_ptr flushFunc = nullptr) {
+std::vector<unsigned char> write(const LayerRAMPrecision<T>* ram,
+                                 const PNGCompression& compression, ThreadPool* pool) {
+    std::vector<unsigned char> buffer;
 
     // TODO better exception messages
     auto png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
@@ -106,7 +400,10 @@ void write(const LayerRAMPrecision<T>* ram, png_voidp ioPtr, png_rw_ptr writeFun
     util::OnScopeExit cleanup2 = std::move(cleanup);
     cleanup2.setAction([&]() { png_destroy_write_struct(&png_ptr, &info_ptr); });
 
-    png_set_write_fn(png_ptr, ioPtr, writeFunc, flushFunc);
+    png_set_write_fn(png_ptr, static_cast<png_voidp>(&buffer), &writeToBuffer, nullptr);
+    png_set_compression_level(png_ptr, std::clamp(compression.level, 0, 9));
+    png_set_compression_strategy(png_ptr, zlibStrategy(compression.strategy));
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, pngFilters(compression.filter));
 
     const auto df = ram->getDataFormat();
     const auto color_type = [&]() {
@@ -129,6 +426,17 @@ void write(const LayerRAMPrecision<T>* ram, png_voidp ioPtr, png_rw_ptr writeFun
     const auto bit_depth = df->getPrecision();
 
     auto writePNG = [&](auto pixels) {
+        const auto pngBitDepth = png_get_bit_depth(png_ptr, info_ptr);
+        if (compression.stripHeight > 0 && (pngBitDepth == 8 || pngBitDepth == 16)) {
+            buffer = encodeStrips(reinterpret_cast<const unsigned char*>(pixels), size.x, size.y,
+                                  df->getComponents(), pngBitDepth, color_type, compression,
+                                  pool);
+            return;
+        }
+
+        png_write_info(png_ptr, info_ptr);
+        png_set_swap(png_ptr);
+
         std::vector<png_bytep> rows(size.y);
         for (png_uint_32 r = 0; r < size.y; ++r) {
             // Inviwo images are upside down compared to how libpng expects them
@@ -144,9 +452,6 @@ void write(const LayerRAMPrecision<T>* ram, png_voidp ioPtr, png_rw_ptr writeFun
                      color_type, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                      PNG_FILTER_TYPE_BASE);
 
-        png_write_info(png_ptr, info_ptr);
-        png_set_swap(png_ptr);
-
         using T2 = typename util::same_extent<T, glm::uint16>::type;
         auto newData = convert<T2>(data, glm::compMul(size), T{0}, T{1});
         writePNG(newData.data());
@@ -155,9 +460,6 @@ void write(const LayerRAMPrecision<T>* ram, png_voidp ioPtr, png_rw_ptr writeFun
                      static_cast<int>(std::min<size_t>(bit_depth, 16)), color_type,
                      PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
 
-        png_write_info(png_ptr, info_ptr);
-        png_set_swap(png_ptr);
-
         if (bit_depth > 16) {
             using T2 = typename util::same_extent<T, glm::uint16>::type;
             auto newData = convert<T2>(data, glm::compMul(size), DataFormat<T>::lowest(),
@@ -171,6 +473,7 @@ void write(const LayerRAMPrecision<T>* ram, png_voidp ioPtr, png_rw_ptr writeFun
             writePNG(const_cast<T*>(ram->getDataTyped()));
         }
     }
+    return buffer;
 }
 
 }  // namespace detail
@@ -179,33 +482,57 @@ PNGLayerWriterException::PNGLayerWriterException(const std::string& message,
                                                  ExceptionContext context)
     : DataWriterException(message, context) {}
 
-PNGLayerWriter::PNGLayerWriter() : DataWriterType<Layer>() {
+PNGCompression PNGCompression::store() { return {0, Strategy::Default, Filter::None}; }
+
+PNGCompression PNGCompression::fast() { return {1, Strategy::Default, Filter::Sub}; }
+
+PNGCompression PNGCompression::standard() { return {}; }
+
+PNGCompression PNGCompression::best() { return {9, Strategy::Default, Filter::Adaptive}; }
+
+PNGLayerWriter::PNGLayerWriter(const PNGCompression& compression)
+    : DataWriterType<Layer>(), compression_{compression} {
     addExtension(FileExtension("png", "Portable Network Graphics"));
 }
 
 PNGLayerWriter* PNGLayerWriter::clone() const { return new PNGLayerWriter(*this); }
 
 void PNGLayerWriter::writeData(const Layer* data, const std::string filePath) const {
-    data->getRepresentation<LayerRAM>()->dispatch<void>([&](auto ram) {
-        FILE* fp = filesystem::fopen(filePath, "wb");
-        if (!fp) throw PNGLayerWriterException("Failed to open file for writing, " + filePath);
-        util::OnScopeExit closeFile([&fp]() { fclose(fp); });
+    auto buffer = data->getRepresentation<LayerRAM>()->dispatch<std::vector<unsigned char>>(
+        [&](auto ram) { return detail::write(ram, compression_, getThreadPool()); });
 
-        detail::write(ram, static_cast<png_voidp>(fp));
-    });
+    FILE* fp = filesystem::fopen(filePath, "wb");
+    if (!fp) throw PNGLayerWriterException("Failed to open file for writing, " + filePath);
+    util::OnScopeExit closeFile([&fp]() { fclose(fp); });
+
+    if (fwrite(buffer.data(), 1, buffer.size(), fp) != buffer.size()) {
+        throw PNGLayerWriterException("Failed to write to file, " + filePath);
+    }
 }
 
 std::unique_ptr<std::vector<unsigned char>> PNGLayerWriter::writeDataToBuffer(
     const Layer* data, const std::string&) const {
 
-    auto buffer = std::make_unique<std::vector<unsigned char>>();
-    data->getRepresentation<LayerRAM>()->dispatch<void>([&](auto ram) {
-        detail::write(ram, static_cast<png_voidp>(buffer.get()), &detail::writeToBuffer);
+    using Buffer = std::vector<unsigned char>;
+    return data->getRepresentation<LayerRAM>()->dispatch<std::unique_ptr<Buffer>>([&](auto ram) {
+        return std::make_unique<Buffer>(detail::write(ram, compression_, getThreadPool()));
     });
-
-    return buffer;
 }
 
 bool PNGLayerWriter::writeDataToRepresentation(const repr*, repr*) const { return false; }
 
+void PNGLayerWriter::setCompression(const PNGCompression& compression) {
+    compression_ = compression;
+}
+
+const PNGCompression& PNGLayerWriter::getCompression() const { return compression_; }
+
+void PNGLayerWriter::setThreadPool(ThreadPool* pool) { pool_ = pool; }
+
+ThreadPool* PNGLayerWriter::getThreadPool() const {
+    if (pool_) return pool_;
+    if (InviwoApplication::isInitialized()) return &InviwoApplication::getPtr()->getThreadPool();
+    return nullptr;
+}
+
 }  // namespace inviwo
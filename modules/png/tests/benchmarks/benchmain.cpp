@@ -0,0 +1,135 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/png/pngwriter.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <warn/push>
+#include <warn/ignore/unused-function>
+
+using namespace inviwo;
+
+namespace {
+
+/**
+ * A snapshot like image: smooth gradients with a few shapes and some noise
+ */
+std::shared_ptr<Layer> createImage(size2_t dims) {
+    auto ram = std::make_shared<LayerRAMPrecision<glm::u8vec4>>(dims);
+    auto data = ram->getDataTyped();
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> noise(-4, 4);
+    for (size_t y = 0; y < dims.y; ++y) {
+        for (size_t x = 0; x < dims.x; ++x) {
+            const vec2 p{static_cast<float>(x) / dims.x, static_cast<float>(y) / dims.y};
+            const bool inside = glm::distance(p, vec2{0.5f}) < 0.3f;
+            const auto n = noise(gen);
+            data[x + y * dims.x] = glm::u8vec4(
+                static_cast<glm::u8>(glm::clamp(255.0f * p.x + n, 0.0f, 255.0f)),
+                static_cast<glm::u8>(glm::clamp(255.0f * p.y + n, 0.0f, 255.0f)),
+                inside ? glm::u8{200} : glm::u8{30}, glm::u8{255});
+        }
+    }
+    return std::make_shared<Layer>(ram);
+}
+
+PNGCompression getCompression(int64_t preset, int64_t stripHeight) {
+    auto compression = [&]() {
+        switch (preset) {
+            case 0:
+                return PNGCompression::store();
+            case 1:
+                return PNGCompression::fast();
+            case 2:
+                return PNGCompression::standard();
+            default:
+                return PNGCompression::best();
+        }
+    }();
+    compression.stripHeight = static_cast<size_t>(stripHeight);
+    return compression;
+}
+
+}  // namespace
+
+// Arguments: preset (0 store, 1 fast, 2 standard, 3 best), strip height (0 for serial libpng)
+static void PNGEncode(benchmark::State& state) {
+    const size2_t dims{3840, 2160};
+    const auto layer = createImage(dims);
+    const PNGLayerWriter writer(getCompression(state.range(0), state.range(1)));
+
+    size_t encodedSize = 0;
+    for (auto _ : state) {
+        auto buffer = writer.writeDataToBuffer(layer.get(), "png");
+        encodedSize = buffer->size();
+        benchmark::DoNotOptimize(buffer->data());
+    }
+
+    const auto rawSize = glm::compMul(dims) * 4;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * rawSize));
+    state.counters["Ratio"] = static_cast<double>(encodedSize) / static_cast<double>(rawSize);
+}
+
+static void PNGEncodeArguments(benchmark::internal::Benchmark* b) {
+    for (int preset : {0, 1, 2, 3}) {
+        for (int stripHeight : {0, 128}) b->Args({preset, stripHeight});
+    }
+}
+
+BENCHMARK(PNGEncode)->Apply(PNGEncodeArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+int main(int argc, char** argv) {
+    LogCentral::init();
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-PNG");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        app.registerModules(std::move(modules));
+    }
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
+
+#include <warn/pop>
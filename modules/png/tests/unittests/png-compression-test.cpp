@@ -0,0 +1,124 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/threadpool.h>
+
+#include <inviwo/png/pngreader.h>
+#include <inviwo/png/pngwriter.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<Layer> roundTrip(const Layer& layer, const PNGCompression& compression,
+                                 ThreadPool* pool) {
+    PNGLayerWriter writer(compression);
+    writer.setThreadPool(pool);
+    util::TempFileHandle tmpFile("png", ".png");
+    writer.writeData(&layer, tmpFile.getFileName());
+
+    PNGLayerReader reader;
+    return reader.readData(tmpFile.getFileName());
+}
+
+void expectEqual(const Layer& expected, const Layer& result, const std::string& msg) {
+    const auto expectedRAM = expected.getRepresentation<LayerRAM>();
+    const auto resultRAM = result.getRepresentation<LayerRAM>();
+    ASSERT_EQ(expectedRAM->getDimensions(), resultRAM->getDimensions()) << msg;
+    ASSERT_EQ(expectedRAM->getDataFormat(), resultRAM->getDataFormat()) << msg;
+    const auto bytes = glm::compMul(expectedRAM->getDimensions()) *
+                       expectedRAM->getDataFormat()->getSize();
+    EXPECT_EQ(0, std::memcmp(expectedRAM->getData(), resultRAM->getData(), bytes)) << msg;
+}
+
+}  // namespace
+
+TEST(PNGCompression, roundTrip) {
+    const auto filename = filesystem::getPath(PathType::Tests, "/images/swirl.png");
+    PNGLayerReader reader;
+    auto layer = reader.readData(filename);
+
+    ThreadPool pool(4);
+    for (auto compression : {PNGCompression::store(), PNGCompression::fast(),
+                             PNGCompression::standard(), PNGCompression::best()}) {
+        for (size_t stripHeight : {0, 1, 7, 128}) {
+            compression.stripHeight = stripHeight;
+            const auto msg = "level " + std::to_string(compression.level) + " strip height " +
+                             std::to_string(stripHeight);
+            expectEqual(*layer, *roundTrip(*layer, compression, &pool), msg);
+            expectEqual(*layer, *roundTrip(*layer, compression, nullptr), msg);
+        }
+    }
+}
+
+TEST(PNGCompression, roundTrip16bit) {
+    auto ram = std::make_shared<LayerRAMPrecision<glm::u16vec3>>(size2_t{37, 53});
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < 37 * 53; ++i) {
+        data[i] = glm::u16vec3(static_cast<std::uint16_t>(i * 41),
+                               static_cast<std::uint16_t>(i % 37),
+                               static_cast<std::uint16_t>(65535 - i));
+    }
+    Layer layer(ram);
+
+    ThreadPool pool(2);
+    for (auto filter : {PNGCompression::Filter::None, PNGCompression::Filter::Sub,
+                        PNGCompression::Filter::Up, PNGCompression::Filter::Average,
+                        PNGCompression::Filter::Paeth, PNGCompression::Filter::Adaptive}) {
+        PNGCompression compression;
+        compression.filter = filter;
+        compression.stripHeight = 5;
+        expectEqual(layer, *roundTrip(layer, compression, &pool),
+                    "filter " + std::to_string(static_cast<int>(filter)));
+    }
+}
+
+TEST(PNGCompression, storeIsLarger) {
+    const auto filename = filesystem::getPath(PathType::Tests, "/images/swirl.png");
+    PNGLayerReader reader;
+    auto layer = reader.readData(filename);
+
+    const auto store = PNGLayerWriter(PNGCompression::store()).writeDataToBuffer(layer.get(), "");
+    const auto best = PNGLayerWriter(PNGCompression::best()).writeDataToBuffer(layer.get(), "");
+    EXPECT_GT(store->size(), best->size());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,86 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <modules/postprocessing/postprocessingmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+
+#include <tcb/span.hpp>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Parameters for warping a rendered view into the simulated views of the light field used by the
+ * approximate depth of field, see DepthOfField.
+ */
+struct IVW_MODULE_POSTPROCESSING_API LightFieldWarpParameters {
+    vec2 cameraPos;         //!< Lens position of the rendered view
+    double focusDepth;      //!< Focus distance in world units
+    double fovy;            //!< Vertical field of view in radians
+    double nearClip;
+    double farClip;
+    float aperture;         //!< Lens diameter
+    size_t renderedViews;   //!< Number of rendered views, the simulated views are stored after them
+    size_t simulatedViews;  //!< Number of simulated views
+    util::span<const float> halton;  //!< Halton sequence, one value per simulated view
+};
+
+/**
+ * Write the rendered view given by \p color and \p depth into slice \p slice of the light field,
+ * and warp it into the simulated views [firstView, lastView). A warped pixel replaces the current
+ * value if that is empty or more than 0.01 units further away.
+ *
+ * The work is split into tiles of simulated view and target rows which are processed on the
+ * thread pool. Every tile visits the source pixels in the same order as the serial version, which
+ * makes the result identical to warpToLightFieldSerial.
+ *
+ * @param lightField color of the light field, dims.x * dims.y * dims.z values
+ * @param lightFieldDepth world space depth of the light field, negative means empty
+ */
+IVW_MODULE_POSTPROCESSING_API void warpToLightField(const LayerRAM& color, const LayerRAM& depth,
+                                                    const LightFieldWarpParameters& params,
+                                                    size_t slice, size_t firstView,
+                                                    size_t lastView, vec4* lightField,
+                                                    float* lightFieldDepth, size3_t dims);
+
+/**
+ * Serial reference version of warpToLightField going through the LayerRAM interface one pixel
+ * at a time.
+ */
+IVW_MODULE_POSTPROCESSING_API void warpToLightFieldSerial(
+    const LayerRAM& color, const LayerRAM& depth, const LightFieldWarpParameters& params,
+    size_t slice, size_t firstView, size_t lastView, vec4* lightField, float* lightFieldDepth,
+    size3_t dims);
+
+}  // namespace util
+
+}  // namespace inviwo
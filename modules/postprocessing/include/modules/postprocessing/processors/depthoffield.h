@@ -78,6 +78,9 @@ namespace inviwo {
  * support transparency in the scene.
  *   * __ViewCount__ The number of times to render the scene. A higher view count leads to smoother
  * blur in the image, but also requires longer computation times.
+ *   * __CPUAccumulation__ Average the rendered views on the CPU instead of with a shader.
+ *   * __ConvergenceThreshold__ Stop rendering new views once the mean change per pixel and channel
+ * of the averaged image drops below this value. Zero disables the early stop.
  *   * __RenderedViewCount__ The number of times to render the scene when using the approximative
  * algorithm. A higher rendered view count improves approximations of partially occluded regions and
  * may reduce artifacts around object boundaries.
@@ -105,6 +108,8 @@ private:
     BoolProperty manualFocus_;
     BoolProperty approximate_;
     IntSizeTProperty viewCountExact_;
+    BoolProperty cpuAccumulation_;
+    FloatProperty convergenceThreshold_;
     IntSizeTProperty viewCountApprox_;
     IntSizeTProperty simViewCountApprox_;
     EventProperty clickToFocus_;
@@ -132,8 +137,6 @@ private:
     Shader averageLightfieldShader_;
 
     void clickToFocus(Event* e);
-    void warp(vec2 st, vec2 uv, vec4 color, double zWorld, size_t viewIndex, vec4* lightFieldData,
-              float* lightFieldDepthData, double fovy, double focusDepth);
     void setApproximate(bool approximate);
 };
 
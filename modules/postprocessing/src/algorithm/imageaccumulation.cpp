@@ -0,0 +1,122 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <modules/postprocessing/algorithm/imageaccumulation.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/glmconvert.h>
+
+#include <numeric>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+/*
+ * Call f(begin, end) for blocks of rows on the thread pool and sum up the returned values. The
+ * partial sums are added in block order to keep the result deterministic.
+ */
+template <typename F>
+double sumRows(size2_t dims, F&& f) {
+    constexpr size_t rowsPerBlock = 16;
+    std::vector<size2_t> blocks;
+    for (size_t begin = 0; begin < dims.y; begin += rowsPerBlock) {
+        blocks.emplace_back(begin, std::min(dims.y, begin + rowsPerBlock));
+    }
+    std::vector<double> sums(blocks.size(), 0.0);
+    util::forEachParallel(blocks, [&](const size2_t& block, size_t i) {
+        sums[i] = f(block.x * dims.x, block.y * dims.x);
+    });
+    return std::accumulate(sums.begin(), sums.end(), 0.0);
+}
+
+double channelSum(const vec4& v) {
+    const vec4 a = glm::abs(v);
+    return static_cast<double>(a.x) + a.y + a.z + a.w;
+}
+
+}  // namespace
+
+double accumulate(LayerRAMPrecision<vec4>& mean, const LayerRAM& sample, size_t count) {
+    const auto dims = mean.getDimensions();
+    if (sample.getDimensions() != dims) {
+        throw Exception("Sample and accumulation buffer dimensions differ",
+                        IVW_CONTEXT_CUSTOM("accumulate"));
+    }
+    const size_t nPixels = dims.x * dims.y;
+    if (nPixels == 0) return 0.0;
+
+    const float oldWeight = static_cast<float>(count) / static_cast<float>(count + 1);
+    const float newWeight = 1.0f / static_cast<float>(count + 1);
+    vec4* meanData = mean.getDataTyped();
+
+    const double sum = sample.dispatch<double>([&](auto ram) {
+        const auto data = ram->getDataTyped();
+        return sumRows(dims, [&](size_t begin, size_t end) {
+            double delta = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                const vec4 s = util::glm_convert_normalized<dvec4>(data[i]);
+                const vec4 m = count == 0 ? s : meanData[i] * oldWeight + s * newWeight;
+                delta += channelSum(m - meanData[i]);
+                meanData[i] = m;
+            }
+            return delta;
+        });
+    });
+    return count == 0 ? 0.0 : sum / (4.0 * nPixels);
+}
+
+double meanPixelDelta(const LayerRAM& a, const LayerRAM& b) {
+    const auto dims = a.getDimensions();
+    if (b.getDimensions() != dims) {
+        throw Exception("Layer dimensions differ", IVW_CONTEXT_CUSTOM("meanPixelDelta"));
+    }
+    const size_t nPixels = dims.x * dims.y;
+    if (nPixels == 0) return 0.0;
+
+    const double sum = a.dispatch<double>([&](auto ramA) {
+        const auto dataA = ramA->getDataTyped();
+        return b.dispatch<double, dispatching::filter::Float4s>([&](auto ramB) {
+            const auto dataB = ramB->getDataTyped();
+            return sumRows(dims, [&](size_t begin, size_t end) {
+                double delta = 0.0;
+                for (size_t i = begin; i < end; ++i) {
+                    delta += channelSum(vec4(util::glm_convert_normalized<dvec4>(dataA[i])) -
+                                        vec4(util::glm_convert_normalized<dvec4>(dataB[i])));
+                }
+                return delta;
+            });
+        });
+    });
+    return sum / (4.0 * nPixels);
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,225 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <modules/postprocessing/algorithm/lightfieldwarp.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/glmconvert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+constexpr size_t tileSize = 32;
+
+vec2 simulatedCameraPos(const LightFieldWarpParameters& params, size_t viewIndex) {
+    double radius = params.aperture / 2.0 * sqrt(params.halton[viewIndex]);
+    double angle = double(viewIndex) / double(params.simulatedViews) * 2.0 * M_PI;
+    return radius * vec2(glm::cos(angle), glm::sin(angle));
+}
+
+double worldDepth(const LightFieldWarpParameters& params, double zNdc) {
+    return params.nearClip * params.farClip /
+           (zNdc * (params.nearClip - params.farClip) + params.farClip);
+}
+
+/*
+ * Both the serial and the tiled version go through this function to make sure the same floating
+ * point operations are used.
+ */
+vec2 warpedPosition(vec2 cameraPos, vec2 simCameraPos, vec2 screenPos, double zWorld,
+                    double focusDepth, size_t height, double scale) {
+    vec2 disparity = (1.0 / zWorld - 1.0 / focusDepth) * (cameraPos - simCameraPos);
+    return screenPos + disparity * height / scale;
+}
+
+void update(size_t index, const vec4& color, double zWorld, vec4* lightField,
+            float* lightFieldDepth) {
+    float currDepth = lightFieldDepth[index];
+    if (currDepth < 0 || currDepth > zWorld + 0.01) {
+        lightField[index] = color;
+        lightFieldDepth[index] = zWorld;
+    }
+}
+
+template <typename F>
+void forEachBlock(size_t size, F&& f) {
+    std::vector<size2_t> blocks;
+    for (size_t begin = 0; begin < size; begin += tileSize) {
+        blocks.emplace_back(begin, std::min(size, begin + tileSize));
+    }
+    util::forEachParallel(blocks, [&](const size2_t& block) { f(block.x, block.y); });
+}
+
+}  // namespace
+
+void warpToLightField(const LayerRAM& color, const LayerRAM& depth,
+                      const LightFieldWarpParameters& params, size_t slice, size_t firstView,
+                      size_t lastView, vec4* lightField, float* lightFieldDepth, size3_t dims) {
+    const size_t nx = dims.x;
+    const size_t ny = dims.y;
+    const size_t sliceOffset = slice * nx * ny;
+    const double scale = 2.0 * std::tan(params.fovy / 2.0);
+
+    // Gather the input column by column, since that is the order the serial version visits
+    // the pixels in, and store the view itself in its slice of the light field.
+    std::vector<double> zWorld(nx * ny);
+    std::vector<vec4> colors(nx * ny);
+
+    depth.dispatch<void>([&](auto ram) {
+        const auto data = ram->getDataTyped();
+        forEachBlock(nx, [&](size_t x0, size_t x1) {
+            for (size_t y = 0; y < ny; ++y) {
+                for (size_t x = x0; x < x1; ++x) {
+                    const double z =
+                        worldDepth(params, util::glm_convert<double>(data[x + y * nx]));
+                    zWorld[x * ny + y] = z;
+                    lightFieldDepth[sliceOffset + x + y * nx] = z;
+                }
+            }
+        });
+    });
+    color.dispatch<void>([&](auto ram) {
+        const auto data = ram->getDataTyped();
+        forEachBlock(nx, [&](size_t x0, size_t x1) {
+            for (size_t y = 0; y < ny; ++y) {
+                for (size_t x = x0; x < x1; ++x) {
+                    const vec4 c = util::glm_convert_normalized<dvec4>(data[x + y * nx]);
+                    colors[x * ny + y] = c;
+                    lightField[sliceOffset + x + y * nx] = c;
+                }
+            }
+        });
+    });
+
+    if (firstView >= lastView || nx * ny == 0) return;
+
+    // Conservative bounds of the vertical disparity, used to limit the source rows each tile has
+    // to visit. Every pixel still goes through the exact test below.
+    const auto [zMin, zMax] = std::minmax_element(zWorld.begin(), zWorld.end());
+    const bool bounded = std::isfinite(*zMin) && std::isfinite(*zMax) && *zMin > 0.0;
+    const double kMin = 1.0 / *zMax - 1.0 / params.focusDepth;
+    const double kMax = 1.0 / *zMin - 1.0 / params.focusDepth;
+
+    struct Tile {
+        size_t view;
+        size_t row0;
+        size_t row1;
+        size_t y0;
+        size_t y1;
+    };
+    std::vector<Tile> tiles;
+    for (size_t view = firstView; view < lastView; ++view) {
+        const vec2 sim = simulatedCameraPos(params, view);
+        const double c = double(params.cameraPos.y - sim.y) * double(ny) / scale;
+        const double dyLo = std::min(kMin * c, kMax * c);
+        const double dyHi = std::max(kMin * c, kMax * c);
+        const double margin = 2.0 + 1e-4 * std::max(std::abs(dyLo), std::abs(dyHi));
+
+        for (size_t row0 = 0; row0 < ny; row0 += tileSize) {
+            const size_t row1 = std::min(ny, row0 + tileSize);
+            size_t y0 = 0;
+            size_t y1 = ny;
+            if (bounded) {
+                const double lo = std::floor(double(row0) - 0.5 - dyHi - margin);
+                const double hi = std::ceil(double(row1) - 0.5 - dyLo + margin);
+                y0 = static_cast<size_t>(std::clamp(lo, 0.0, double(ny)));
+                y1 = static_cast<size_t>(std::clamp(hi, 0.0, double(ny)));
+            }
+            if (y0 < y1) tiles.push_back({view, row0, row1, y0, y1});
+        }
+    }
+
+    // Each tile owns a disjoint set of target pixels and visits the source pixels in the serial
+    // order, hence no races and the same depth resolution as the serial version.
+    util::forEachParallel(tiles, [&](const Tile& tile) {
+        const vec2 sim = simulatedCameraPos(params, tile.view);
+        const size_t viewOffset = (params.renderedViews + tile.view) * nx * ny;
+        const float row0 = static_cast<float>(tile.row0);
+        const float row1 = static_cast<float>(tile.row1);
+        const float width = static_cast<float>(nx);
+
+        for (size_t x = 0; x < nx; ++x) {
+            const double* z = zWorld.data() + x * ny;
+            const vec4* c = colors.data() + x * ny;
+            for (size_t y = tile.y0; y < tile.y1; ++y) {
+                const vec2 pos = warpedPosition(params.cameraPos, sim, vec2(x, y), z[y],
+                                                params.focusDepth, ny, scale);
+                const float ry = std::round(pos.y);
+                const float rx = std::round(pos.x);
+                if (ry >= row0 && ry < row1 && rx >= 0.0f && rx < width) {
+                    const size_t index =
+                        viewOffset + static_cast<size_t>(rx) + static_cast<size_t>(ry) * nx;
+                    update(index, c[y], z[y], lightField, lightFieldDepth);
+                }
+            }
+        }
+    });
+}
+
+void warpToLightFieldSerial(const LayerRAM& color, const LayerRAM& depth,
+                            const LightFieldWarpParameters& params, size_t slice,
+                            size_t firstView, size_t lastView, vec4* lightField,
+                            float* lightFieldDepth, size3_t dims) {
+    const double scale = 2.0 * std::tan(params.fovy / 2.0);
+
+    for (size_t x = 0; x < dims.x; x++) {
+        for (size_t y = 0; y < dims.y; y++) {
+            const size2_t screenPos(x, y);
+            double zWorld = worldDepth(params, depth.getAsDouble(screenPos));
+            vec4 c = color.getAsNormalizedDVec4(screenPos);
+
+            const size_t index = VolumeRAM::posToIndex(size3_t(x, y, slice), dims);
+            lightField[index] = c;
+            lightFieldDepth[index] = zWorld;
+
+            for (size_t view = firstView; view < lastView; view++) {
+                const vec2 pos =
+                    warpedPosition(params.cameraPos, simulatedCameraPos(params, view),
+                                   vec2(x, y), zWorld, params.focusDepth, dims.y, scale);
+                const float rx = std::round(pos.x);
+                const float ry = std::round(pos.y);
+                if (rx < 0.0f || rx >= dims.x || ry < 0.0f || ry >= dims.y) continue;
+
+                const size3_t target(rx, ry, params.renderedViews + view);
+                update(VolumeRAM::posToIndex(target, dims), c, zWorld, lightField,
+                       lightFieldDepth);
+            }
+        }
+    }
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -28,10 +28,14 @@
  *********************************************************************************/
 
 #include <modules/postprocessing/processors/depthoffield.h>
+#include <modules/postprocessing/algorithm/lightfieldwarp.h>
+#include <modules/postprocessing/algorithm/imageaccumulation.h>
 
 #include <inviwo/core/interaction/events/mouseevent.h>
 #include <modules/opengl/openglcapabilities.h>
 
+#include <limits>
+
 namespace inviwo {
 
 const ProcessorInfo DepthOfField::processorInfo_{
@@ -53,6 +57,9 @@ DepthOfField::DepthOfField()
     , manualFocus_("manualFocus", "Manual focus", true)
     , approximate_("approximate", "Approximate", false)
     , viewCountExact_("viewCountExact", "View count", 20, 10, 200)
+    , cpuAccumulation_("cpuAccumulation", "CPU accumulation", false)
+    , convergenceThreshold_("convergenceThreshold", "Convergence threshold", 0.0f, 0.0f, 0.05f,
+                            0.0001f)
     , viewCountApprox_("viewCountApprox", "Rendered view count", 5, 1, 12)
     , simViewCountApprox_("simViewCountApprox", "Simulated view count", 10, 10, 200)
     , clickToFocus_(
@@ -70,7 +77,8 @@ DepthOfField::DepthOfField()
     addPort(trackingInport_);
     addPort(outport_);
     addProperties(aperture_, focusDepth_, manualFocus_, approximate_, viewCountExact_,
-                  viewCountApprox_, simViewCountApprox_, clickToFocus_, camera_);
+                  cpuAccumulation_, convergenceThreshold_, viewCountApprox_, simViewCountApprox_,
+                  clickToFocus_, camera_);
     setApproximate(approximate_);
 
     trackingInport_.setOptional(true);
@@ -89,6 +97,8 @@ DepthOfField::DepthOfField()
 
 void DepthOfField::setApproximate(bool approximate) {
     viewCountExact_.setVisible(!approximate);
+    cpuAccumulation_.setVisible(!approximate);
+    convergenceThreshold_.setVisible(!approximate);
     viewCountApprox_.setVisible(approximate);
     simViewCountApprox_.setVisible(approximate);
     if (approximate && !useComputeShaders_) {
@@ -260,57 +270,65 @@ void DepthOfField::process() {
             float* lightFieldDepthData = static_cast<float*>(
                 lightFieldDepth_->getEditableRepresentation<VolumeRAM>()->getData());
 
-            for (size_t x = 0; x < dim.x; x++) {
-                for (size_t y = 0; y < dim.y; y++) {
-                    vec2 screenPos(x, y);
-                    double zNdc = inDepth->getAsDouble(screenPos);
-                    double zWorld = nearClip * farClip / (zNdc * (nearClip - farClip) + farClip);
-                    vec4 color = inColor->getAsNormalizedDVec4(screenPos);
-
-                    size3_t pos(x, y, evalCount_);
-                    lightFieldData[VolumeRAM::posToIndex(pos, dimLightField_)] = color;
-                    lightFieldDepthData[VolumeRAM::posToIndex(pos, dimLightField_)] = zWorld;
-
-                    if (evalCount_ == 0) {
-                        // Warp central (first) view to all simulated views.
-                        for (size_t i = 0; i < simViewCountApprox_.get(); i++) {
-                            warp(cameraPos, screenPos, color, zWorld, i, lightFieldData,
-                                 lightFieldDepthData, fovy, focusDepth);
-                        }
-                    } else {
-                        // Warp peripheral views to a circle segment of simulated views.
-                        double segmentWidth =
-                            double(simViewCountApprox_.get()) / double(viewCountApprox_.get() - 1);
-                        int start = (evalCount_ - 1) * segmentWidth;
-                        int stop = evalCount_ * segmentWidth;
-                        for (int i = start; i < stop; i++) {
-                            warp(cameraPos, screenPos, color, zWorld, i, lightFieldData,
-                                 lightFieldDepthData, fovy, focusDepth);
-                        }
-                    }
-                }
+            const util::LightFieldWarpParameters params{
+                cameraPos, focusDepth, fovy, nearClip, farClip, aperture_.get(),
+                viewCountApprox_.get(), simViewCountApprox_.get(), haltonX_};
+
+            size_t start = 0;
+            size_t stop = simViewCountApprox_.get();
+            if (evalCount_ != 0) {
+                // Warp peripheral views to a circle segment of simulated views.
+                double segmentWidth =
+                    double(simViewCountApprox_.get()) / double(viewCountApprox_.get() - 1);
+                start = static_cast<size_t>((evalCount_ - 1) * segmentWidth);
+                stop = static_cast<size_t>(evalCount_ * segmentWidth);
             }
+            util::warpToLightField(*inColor, *inDepth, params, evalCount_, start, stop,
+                                   lightFieldData, lightFieldDepthData, dimLightField_);
         }
     } else {
-        // Add new image to accumulation buffer
-        utilgl::activateTargetAndCopySource(*nextOutImg_, inport_, ImageType::ColorOnly);
-        addSampleShader_.activate();
-
-        img->getRepresentation<ImageGL>();
-        prevOutImg_->getRepresentation<ImageGL>();
-        utilgl::bindAndSetUniforms(addSampleShader_, cont, *img, "newImg", ImageType::ColorOnly);
-        utilgl::bindAndSetUniforms(addSampleShader_, cont, *prevOutImg_, "oldImg",
-                                   ImageType::ColorOnly);
-        addSampleShader_.setUniform("nOldImages", evalCount_);
-
-        utilgl::singleDrawImagePlaneRect();
-        addSampleShader_.deactivate();
+        const bool checkConvergence = evalCount_ > 0 && convergenceThreshold_.get() > 0.0f;
+        double delta = std::numeric_limits<double>::max();
+
+        if (cpuAccumulation_) {
+            // Update the running mean in place, no need for the previous image
+            auto mean = static_cast<LayerRAMPrecision<vec4>*>(
+                nextOutImg_->getColorLayer()->getEditableRepresentation<LayerRAM>());
+            delta = util::accumulate(*mean, *img->getRepresentation<ImageRAM>()->getColorLayerRAM(),
+                                     evalCount_);
+        } else {
+            // Add new image to accumulation buffer
+            utilgl::activateTargetAndCopySource(*nextOutImg_, inport_, ImageType::ColorOnly);
+            addSampleShader_.activate();
+
+            img->getRepresentation<ImageGL>();
+            prevOutImg_->getRepresentation<ImageGL>();
+            utilgl::bindAndSetUniforms(addSampleShader_, cont, *img, "newImg",
+                                       ImageType::ColorOnly);
+            utilgl::bindAndSetUniforms(addSampleShader_, cont, *prevOutImg_, "oldImg",
+                                       ImageType::ColorOnly);
+            addSampleShader_.setUniform("nOldImages", evalCount_);
+
+            utilgl::singleDrawImagePlaneRect();
+            addSampleShader_.deactivate();
+
+            if (checkConvergence) {
+                delta = util::meanPixelDelta(
+                    *nextOutImg_->getRepresentation<ImageRAM>()->getColorLayerRAM(),
+                    *prevOutImg_->getRepresentation<ImageRAM>()->getColorLayerRAM());
+            }
+        }
+
+        if (checkConvergence && delta < convergenceThreshold_.get()) {
+            // Converged, skip the remaining views
+            evalCount_ = maxEvalCount - 1;
+        }
     }
 
     evalCount_++;
     if (evalCount_ < maxEvalCount) {
         // Prepare camera for rendering again
-        if (!approximate_) {
+        if (!approximate_ && !cpuAccumulation_) {
             nextOutImg_->copyRepresentationsTo(prevOutImg_.get());
         }
 
@@ -374,25 +392,4 @@ void DepthOfField::clickToFocus(Event* e) {
     focusDepth_.set(depthEye);
 }
 
-void DepthOfField::warp(vec2 cameraPos, vec2 screenPos, vec4 color, double zWorld, size_t viewIndex,
-                        vec4* lightFieldData, float* lightFieldDepthData, double fovy,
-                        double focusDepth) {
-    double radius = aperture_.get() / 2.0 * sqrt(haltonX_[viewIndex]);
-    double angle = double(viewIndex) / double(simViewCountApprox_.get()) * 2.0 * M_PI;
-    vec2 simCameraPos = radius * vec2(glm::cos(angle), glm::sin(angle));
-
-    vec2 disparity = (1.0 / zWorld - 1.0 / focusDepth) * (cameraPos - simCameraPos);
-    vec2 simScreenpos = screenPos + disparity * dimLightField_.y / (2.0 * std::tan(fovy / 2.0));
-    size3_t pos(round(simScreenpos.x), round(simScreenpos.y), viewCountApprox_.get() + viewIndex);
-    if (pos.x < 0 || pos.x >= dimLightField_.x || pos.y < 0 || pos.y >= dimLightField_.y ||
-        pos.z < 0 || pos.z >= dimLightField_.z)
-        return;
-
-    float currDepth = lightFieldDepthData[VolumeRAM::posToIndex(pos, dimLightField_)];
-    if (currDepth < 0 || currDepth > zWorld + 0.01) {
-        lightFieldData[VolumeRAM::posToIndex(pos, dimLightField_)] = color;
-        lightFieldDepthData[VolumeRAM::posToIndex(pos, dimLightField_)] = zWorld;
-    }
-}
-
 }  // namespace inviwo
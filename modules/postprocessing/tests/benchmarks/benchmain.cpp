@@ -0,0 +1,156 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <modules/postprocessing/algorithm/lightfieldwarp.h>
+#include <modules/base/algorithm/randomutils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+
+#include <warn/push>
+#include <warn/ignore/unused-function>
+
+using namespace inviwo;
+
+namespace {
+
+constexpr size_t renderedViews = 5;
+constexpr size_t simulatedViews = 40;
+
+struct Input {
+    Input(size_t size)
+        : dims{size, size, renderedViews + simulatedViews}
+        , color{size2_t{size}}
+        , depth{size2_t{size}, LayerType::Depth}
+        , halton{util::haltonSequence<float>(2, simulatedViews)} {
+
+        // A few overlapping spheres in front of a background plane gives both occlusions and
+        // pixels that end up outside the image
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> rand(0.0f, 1.0f);
+        std::vector<vec4> spheres(16);
+        for (auto& s : spheres) s = vec4(rand(gen), rand(gen), 0.2f + 0.6f * rand(gen), 0.15f);
+
+        auto colors = color.getDataTyped();
+        auto depths = depth.getDataTyped();
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                const vec2 p{(x + 0.5f) / size, (y + 0.5f) / size};
+                float d = 0.999f;
+                for (const auto& s : spheres) {
+                    const float r2 = glm::dot(p - vec2(s), p - vec2(s));
+                    if (r2 < s.w * s.w) d = std::min(d, s.z - std::sqrt(s.w * s.w - r2) * 0.5f);
+                }
+                depths[x + y * size] = d;
+                colors[x + y * size] = vec4(p, d, 1.0f);
+            }
+        }
+        reset();
+    }
+
+    void reset() {
+        lightField.assign(dims.x * dims.y * dims.z, vec4(0.0f));
+        lightFieldDepth.assign(dims.x * dims.y * dims.z, -1.0f);
+    }
+
+    util::LightFieldWarpParameters params() const {
+        return {vec2{0.0f}, 8.0, glm::radians(38.0), 0.1, 100.0, 0.5f, renderedViews,
+                simulatedViews, halton};
+    }
+
+    size3_t dims;
+    LayerRAMPrecision<vec4> color;
+    LayerRAMPrecision<float> depth;
+    std::vector<float> halton;
+    std::vector<vec4> lightField;
+    std::vector<float> lightFieldDepth;
+};
+
+}  // namespace
+
+static void WarpSerial(benchmark::State& state) {
+    Input in(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        in.reset();
+        util::warpToLightFieldSerial(in.color, in.depth, in.params(), 0, 0, simulatedViews,
+                                     in.lightField.data(), in.lightFieldDepth.data(), in.dims);
+        benchmark::ClobberMemory();
+    }
+    state.counters["Pixels"] = static_cast<double>(in.dims.x * in.dims.y);
+}
+
+static void WarpTiled(benchmark::State& state) {
+    Input in(static_cast<size_t>(state.range(0)));
+    Input ref(static_cast<size_t>(state.range(0)));
+    util::warpToLightFieldSerial(ref.color, ref.depth, ref.params(), 0, 0, simulatedViews,
+                                 ref.lightField.data(), ref.lightFieldDepth.data(), ref.dims);
+
+    for (auto _ : state) {
+        in.reset();
+        util::warpToLightField(in.color, in.depth, in.params(), 0, 0, simulatedViews,
+                               in.lightField.data(), in.lightFieldDepth.data(), in.dims);
+        benchmark::ClobberMemory();
+    }
+
+    if (in.lightField != ref.lightField || in.lightFieldDepth != ref.lightFieldDepth) {
+        state.SkipWithError("Tiled warp differs from the serial warp");
+    }
+    state.counters["Pixels"] = static_cast<double>(in.dims.x * in.dims.y);
+}
+
+BENCHMARK(WarpSerial)->RangeMultiplier(2)->Range(128, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK(WarpTiled)->RangeMultiplier(2)->Range(128, 1024)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    LogCentral::init();
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-PostProcessing");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        app.registerModules(std::move(modules));
+    }
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
+
+#include <warn/pop>
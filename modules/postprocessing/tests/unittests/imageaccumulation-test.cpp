@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/postprocessing/algorithm/imageaccumulation.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace {
+
+LayerRAMPrecision<vec4> filledLayer(size2_t dims, vec4 value) {
+    LayerRAMPrecision<vec4> layer(dims);
+    std::fill(layer.getDataTyped(), layer.getDataTyped() + dims.x * dims.y, value);
+    return layer;
+}
+
+}  // namespace
+
+TEST(ImageAccumulation, FirstSampleInitializesMean) {
+    const size2_t dims{7, 33};
+    auto mean = filledLayer(dims, vec4{9.0f});
+    const auto sample = filledLayer(dims, vec4{0.25f, 0.5f, 0.75f, 1.0f});
+
+    EXPECT_DOUBLE_EQ(0.0, util::accumulate(mean, sample, 0));
+    for (size_t i = 0; i < dims.x * dims.y; ++i) {
+        ASSERT_EQ(vec4(0.25f, 0.5f, 0.75f, 1.0f), mean.getDataTyped()[i]);
+    }
+}
+
+TEST(ImageAccumulation, RunningMean) {
+    const size2_t dims{5, 20};
+    auto mean = filledLayer(dims, vec4{0.0f});
+    util::accumulate(mean, filledLayer(dims, vec4{1.0f}), 0);
+    // (1 + 0) / 2, every channel moves by 0.5
+    EXPECT_NEAR(0.5, util::accumulate(mean, filledLayer(dims, vec4{0.0f}), 1), 1e-6);
+    // (1 + 0 + 0.25) / 3, every channel moves from 0.5 to 1.25 / 3
+    EXPECT_NEAR(0.5 - 1.25 / 3.0,
+                util::accumulate(mean, filledLayer(dims, vec4{0.25f}), 2), 1e-6);
+    for (size_t i = 0; i < dims.x * dims.y; ++i) {
+        ASSERT_NEAR(1.25f / 3.0f, mean.getDataTyped()[i].x, 1e-6f);
+    }
+}
+
+TEST(ImageAccumulation, NormalizesIntegerSamples) {
+    const size2_t dims{4, 4};
+    auto mean = filledLayer(dims, vec4{0.0f});
+    LayerRAMPrecision<glm::u8vec4> sample(dims);
+    std::fill(sample.getDataTyped(), sample.getDataTyped() + dims.x * dims.y,
+              glm::u8vec4{255, 0, 255, 0});
+
+    util::accumulate(mean, sample, 0);
+    for (size_t i = 0; i < dims.x * dims.y; ++i) {
+        ASSERT_EQ(vec4(1.0f, 0.0f, 1.0f, 0.0f), mean.getDataTyped()[i]);
+    }
+}
+
+TEST(ImageAccumulation, DeltaFallsBelowThreshold) {
+    // Alternating samples never agree, but the change of the mean shrinks as 1 / (count + 1)
+    const size2_t dims{16, 16};
+    const double threshold = 0.01;
+    auto mean = filledLayer(dims, vec4{0.0f});
+    const auto white = filledLayer(dims, vec4{1.0f});
+    const auto black = filledLayer(dims, vec4{0.0f});
+
+    double previous = 1.0;
+    size_t converged = 0;
+    for (size_t count = 0; count < 200 && converged == 0; ++count) {
+        const auto delta = util::accumulate(mean, count % 2 == 0 ? white : black, count);
+        if (count > 0) {
+            EXPECT_LE(delta, previous + 1e-6);
+            previous = delta;
+            if (delta < threshold) converged = count;
+        }
+    }
+    EXPECT_GT(converged, 10u);
+    EXPECT_LT(converged, 100u);
+}
+
+TEST(ImageAccumulation, DimensionMismatchThrows) {
+    auto mean = filledLayer(size2_t{4, 4}, vec4{0.0f});
+    EXPECT_THROW(util::accumulate(mean, filledLayer(size2_t{4, 5}, vec4{0.0f}), 0), Exception);
+    EXPECT_THROW(util::meanPixelDelta(mean, filledLayer(size2_t{5, 4}, vec4{0.0f})), Exception);
+}
+
+TEST(ImageAccumulation, MeanPixelDelta) {
+    const size2_t dims{2, 2};
+    const auto a = filledLayer(dims, vec4{0.5f});
+    auto b = filledLayer(dims, vec4{0.5f});
+    EXPECT_DOUBLE_EQ(0.0, util::meanPixelDelta(a, b));
+
+    // A single channel of a single pixel differs, averaged over 4 pixels with 4 channels
+    b.getDataTyped()[3].y = 0.0f;
+    EXPECT_NEAR(0.5 / 16.0, util::meanPixelDelta(a, b), 1e-7);
+    EXPECT_NEAR(0.5 / 16.0, util::meanPixelDelta(b, a), 1e-7);
+}
+
+}  // namespace inviwo
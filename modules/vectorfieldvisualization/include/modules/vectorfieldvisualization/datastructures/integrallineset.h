@@ -38,6 +38,10 @@
 #include <inviwo/core/ports/port.h>
 #include <inviwo/core/datastructures/datatraits.h>
 
+#include <tcb/span.hpp>
+
+#include <mutex>
+
 namespace inviwo {
 
 /**
@@ -49,24 +53,86 @@ class IVW_MODULE_VECTORFIELDVISUALIZATION_API IntegralLineSet {
 public:
     enum class SetIndex { Yes, No };
 
+    /**
+     * Structure-of-arrays storage for many integral lines. The positions of all lines are stored
+     * back to back, line i occupies the range [offsets[i], offsets[i+1]). Each meta data channel is
+     * a single buffer running parallel to the positions.
+     */
+    struct IVW_MODULE_VECTORFIELDVISUALIZATION_API Packed {
+        Packed();
+
+        size_t size() const;
+        bool empty() const;
+
+        util::span<const dvec3> getPositions(size_t line) const;
+
+        template <typename T>
+        util::span<const T> getMetaData(const std::string& name, size_t line) const;
+        template <typename T>
+        const std::vector<T>& getMetaData(const std::string& name) const;
+        template <typename T>
+        std::vector<T>& getMetaData(const std::string& name, bool create = false);
+
+        std::shared_ptr<const BufferBase> getMetaDataBuffer(const std::string& name) const;
+        bool hasMetaData(const std::string& name) const;
+        std::vector<std::string> getMetaDataKeys() const;
+
+        /**
+         * Close the line made up of all positions added since the previous call.
+         */
+        void finishLine(size_t index, IntegralLine::TerminationReason backward,
+                        IntegralLine::TerminationReason forward);
+        /**
+         * Append all lines of \p other, which has to have the same set of meta data channels.
+         */
+        void append(const Packed& other);
+
+        /**
+         * Create a standalone copy of a line
+         */
+        IntegralLine getLine(size_t line) const;
+
+        std::vector<dvec3> positions;
+        std::vector<size_t> offsets;
+        std::vector<size_t> indices;
+        std::vector<IntegralLine::TerminationReason> backwardTerminationReasons;
+        std::vector<IntegralLine::TerminationReason> forwardTerminationReasons;
+        std::map<std::string, std::shared_ptr<BufferBase>> metaData;
+    };
+
     using value_type = IntegralLine;
     IntegralLineSet(mat4 modelMatrix, mat4 worldMatrix = mat4(1));
+    /**
+     * Create a set backed by packed storage. IntegralLine objects are only created if the lines
+     * are accessed one by one, consumers that can handle packed data should use getPacked().
+     */
+    IntegralLineSet(Packed lines, mat4 modelMatrix, mat4 worldMatrix = mat4(1));
+    IntegralLineSet(const IntegralLineSet& rhs);
+    IntegralLineSet(IntegralLineSet&& rhs);
+    IntegralLineSet& operator=(const IntegralLineSet& that);
+    IntegralLineSet& operator=(IntegralLineSet&& that);
     virtual ~IntegralLineSet();
 
     mat4 getModelMatrix() const;
     mat4 getWorldMatrix() const;
 
+    /**
+     * Returns the packed storage or nullptr if the set was built line by line or has been
+     * modified through any of the non-const accessors.
+     */
+    const Packed* getPacked() const;
+
     std::vector<IntegralLine>::const_iterator begin() const;
     std::vector<IntegralLine>::const_iterator end() const;
 
     std::vector<IntegralLine>::iterator begin();
     std::vector<IntegralLine>::iterator end();
 
-    const IntegralLine& back() const { return lines_.back(); }
-    IntegralLine& back() { return lines_.back(); }
+    const IntegralLine& back() const { return unpacked().back(); }
+    IntegralLine& back() { return editable().back(); }
 
-    const IntegralLine& front() const { return lines_.front(); }
-    IntegralLine& front() { return lines_.front(); }
+    const IntegralLine& front() const { return unpacked().front(); }
+    IntegralLine& front() { return editable().front(); }
 
     size_t size() const;
 
@@ -82,15 +148,72 @@ public:
     void push_back(IntegralLine&& line, SetIndex updateIndex);
     void push_back(IntegralLine&& line, size_t idx);
 
-    std::vector<IntegralLine>& getVector() { return lines_; }
-    const std::vector<IntegralLine>& getVector() const { return lines_; }
+    std::vector<IntegralLine>& getVector() { return editable(); }
+    const std::vector<IntegralLine>& getVector() const { return unpacked(); }
 
 private:
-    std::vector<IntegralLine> lines_;
+    // Create lines_ from packed_ if not done yet, mutex_ has to be locked
+    void unpack() const;
+    const std::vector<IntegralLine>& unpacked() const;
+    std::vector<IntegralLine>& editable();
+
+    std::shared_ptr<const Packed> packed_;
+    mutable std::vector<IntegralLine> lines_;
+    mutable bool unpacked_;
+    mutable std::mutex mutex_;  // guards packed_, lines_ and unpacked_
     mat4 modelMatrix_;
     mat4 worldMatrix_;
 };
 
+template <typename T>
+util::span<const T> IntegralLineSet::Packed::getMetaData(const std::string& name,
+                                                         size_t line) const {
+    const auto& data = getMetaData<T>(name);
+    return util::span<const T>(data.data() + offsets[line], offsets[line + 1] - offsets[line]);
+}
+
+template <typename T>
+const std::vector<T>& IntegralLineSet::Packed::getMetaData(const std::string& name) const {
+    auto it = metaData.find(name);
+    if (it == metaData.end()) {
+        throw Exception("No meta data with name: " + name, IVW_CONTEXT);
+    }
+    auto askedDF = DataFormat<T>::get();
+    auto isDF = it->second->getDataFormat();
+    if (isDF != askedDF) {
+        std::ostringstream oss;
+        oss << "Incorrect dataformat for meta data " << name << " asking for "
+            << askedDF->getString() << " but is " << isDF->getString();
+        throw Exception(oss.str(), IVW_CONTEXT);
+    }
+    return static_cast<const Buffer<T>*>(it->second.get())
+        ->getRAMRepresentation()
+        ->getDataContainer();
+}
+
+template <typename T>
+std::vector<T>& IntegralLineSet::Packed::getMetaData(const std::string& name, bool create) {
+    auto it = metaData.find(name);
+    if (it == metaData.end() && !create) {
+        throw Exception("No meta data with name: " + name, IVW_CONTEXT);
+    } else if (it == metaData.end()) {
+        auto md = std::make_shared<Buffer<T>>(positions.size());
+        metaData[name] = md;
+        return md->getEditableRAMRepresentation()->getDataContainer();
+    }
+    auto askedDF = DataFormat<T>::get();
+    auto isDF = it->second->getDataFormat();
+    if (isDF != askedDF) {
+        std::ostringstream oss;
+        oss << "Incorrect dataformat for meta data " << name << " asking for "
+            << askedDF->getString() << " but is " << isDF->getString();
+        throw Exception(oss.str(), IVW_CONTEXT);
+    }
+    return static_cast<Buffer<T>*>(it->second.get())
+        ->getEditableRAMRepresentation()
+        ->getDataContainer();
+}
+
 using IntegralLineSetInport = DataInport<IntegralLineSet>;
 using IntegralLineSetOutport = DataOutport<IntegralLineSet>;
 
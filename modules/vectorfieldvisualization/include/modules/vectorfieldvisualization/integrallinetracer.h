@@ -35,10 +35,15 @@
 #include <inviwo/core/util/spatialsampler.h>
 #include <inviwo/core/util/spatial4dsampler.h>
 #include <inviwo/core/util/bufferutils.h>
+#include <inviwo/core/util/foreach.h>
 #include <modules/vectorfieldvisualization/properties/integrallineproperties.h>
 #include <modules/vectorfieldvisualization/datastructures/integralline.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
 
 #include <unordered_map>
+#include <numeric>
+#include <array>
+#include <cmath>
 
 namespace inviwo {
 
@@ -76,19 +81,91 @@ public:
 
     Result traceFrom(const SpatialVector &pIn);
 
+    /**
+     * Trace lines from all \p seeds using the thread pool and append them to \p lines. The seeds
+     * are split into contiguous chunks that are traced into separate packed stores and then
+     * concatenated, so the lines end up in seed order. Lines with fewer than two points are
+     * discarded, the index of each line is set to \p startIndex plus the index of its seed.
+     */
+    template <typename T>
+    void traceFrom(const std::vector<T> &seeds, size_t startIndex, IntegralLineSet::Packed &lines);
+
     void addMetaDataSampler(const std::string &name, std::shared_ptr<const Sampler> sampler);
 
     const DataHomogenouSpatialMatrixrix &getSeedTransformationMatrix() const;
 
 private:
+    /**
+     * Destination for the points of a line. Refers either to the storage of an IntegralLine or
+     * to the tail, starting at \p begin, of a packed line set.
+     */
+    struct LineWriter {
+        std::vector<dvec3> *positions = nullptr;
+        std::vector<dvec3> *velocities = nullptr;
+        std::vector<double> *timestamps = nullptr;
+        std::vector<std::vector<typename Sampler::ReturnType> *> metaData;
+        size_t begin = 0;
+
+        size_t size() const { return positions->size() - begin; }
+        template <typename F>
+        void forEachChannel(F f) {
+            f(*positions);
+            f(*velocities);
+            if (timestamps) f(*timestamps);
+            for (auto m : metaData) f(*m);
+        }
+        void reverse() {
+            forEachChannel([b = begin](auto &v) { std::reverse(v.begin() + b, v.end()); });
+        }
+        void discard() {
+            forEachChannel([b = begin](auto &v) { v.resize(b); });
+        }
+    };
+
+    struct Termination {
+        IntegralLine::TerminationReason backward = IntegralLine::TerminationReason::Unknown;
+        IntegralLine::TerminationReason forward = IntegralLine::TerminationReason::Unknown;
+        size_t seedIndex{0};
+    };
+
+    template <typename Line>
+    LineWriter createWriter(Line &line, std::vector<dvec3> &positions, size_t reserve);
+
+    Termination trace(const SpatialVector &p, LineWriter &line);
+
     inline SpatialVector seedTransform(const SpatialVector &seed) const;
 
     std::pair<SpatialVector, DataVector> step(const SpatialVector &oldPos, const double stepSize);
 
-    bool addPoint(IntegralLine &line, const SpatialVector &pos);
-    bool addPoint(IntegralLine &line, const SpatialVector &pos, const DataVector &worldVelocity);
+    /**
+     * Result of one Dormand-Prince step from y0 to y1. \p velocity is the sample at y1 which is
+     * reused as the first stage of the next step. at(theta) evaluates the fourth order dense
+     * output for theta in [0, 1].
+     */
+    struct AdaptiveStep {
+        SpatialVector y1;
+        DataVector velocity;
+        double error;
+        std::array<SpatialVector, 5> dense;
+
+        SpatialVector at(double theta) const {
+            const double eta = 1.0 - theta;
+            return dense[0] +
+                   theta * (dense[1] +
+                            eta * (dense[2] + theta * (dense[3] + eta * dense[4])));
+        }
+    };
+
+    SpatialVector slope(const DataVector &velocity) const;
+    AdaptiveStep adaptiveStep(const SpatialVector &y0, const DataVector &velocity,
+                              const double stepSize) const;
+    IntegralLine::TerminationReason integrateAdaptive(size_t steps, SpatialVector pos,
+                                                      LineWriter &line, bool fwd);
+
+    bool addPoint(LineWriter &line, const SpatialVector &pos);
+    bool addPoint(LineWriter &line, const SpatialVector &pos, const DataVector &worldVelocity);
 
-    IntegralLine::TerminationReason integrate(size_t steps, SpatialVector pos, IntegralLine &line,
+    IntegralLine::TerminationReason integrate(size_t steps, SpatialVector pos, LineWriter &line,
                                               bool fwd);
 
     IntegralLineProperties::IntegrationScheme integrationScheme_;
@@ -98,6 +175,11 @@ private:
     IntegralLineProperties::Direction dir_;
     bool normalizeSamples_;
 
+    double errorTolerance_;
+    double minStepSize_;
+    double maxStepSize_;
+    bool denseOutput_;
+
     std::shared_ptr<const Sampler> sampler_;
     std::unordered_map<std::string, std::shared_ptr<const Sampler>> metaSamplers_;
 
@@ -113,6 +195,10 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::IntegralLineTracer(
     , stepSize_(properties.getStepSize())
     , dir_(properties.getStepDirection())
     , normalizeSamples_(properties.getNormalizeSamples())
+    , errorTolerance_(properties.getErrorTolerance())
+    , minStepSize_(properties.getMinStepSize())
+    , maxStepSize_(std::max(properties.getMaxStepSize(), properties.getMinStepSize()))
+    , denseOutput_(properties.getDenseOutput())
     , sampler_(sampler)
     , invBasis_(glm::inverse(DataMatrix(sampler->getModelMatrix())))
     , seedTransformation_(
@@ -121,18 +207,101 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::IntegralLineTracer(
 template <typename SpatialSampler, bool TimeDependent>
 typename IntegralLineTracer<SpatialSampler, TimeDependent>::Result
 IntegralLineTracer<SpatialSampler, TimeDependent>::traceFrom(const SpatialVector &pIn) {
-    const SpatialVector p = seedTransform(pIn);
     Result res;
     IntegralLine &line = res.line;
 
+    auto writer = createWriter(line, line.getPositions(), steps_ + 2);
+    const auto termination = trace(seedTransform(pIn), writer);
+
+    line.setBackwardTerminationReason(termination.backward);
+    line.setForwardTerminationReason(termination.forward);
+    res.seedIndex = termination.seedIndex;
+    return res;
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+template <typename T>
+void IntegralLineTracer<SpatialSampler, TimeDependent>::traceFrom(const std::vector<T> &seeds,
+                                                                  size_t startIndex,
+                                                                  IntegralLineSet::Packed &lines) {
+    if (seeds.empty()) return;
+
+    const size_t jobs = std::min(
+        seeds.size(), 4 * std::max(size_t{1}, InviwoApplication::getPtr()->getPoolSize()));
+
+    std::vector<IntegralLineSet::Packed> chunks(jobs);
+    std::vector<size_t> jobIds(jobs);
+    std::iota(jobIds.begin(), jobIds.end(), size_t{0});
+
+    auto futures = util::forEachParallelAsync(
+        jobIds,
+        [&](size_t job) {
+            auto &chunk = chunks[job];
+            const size_t begin = (seeds.size() * job) / jobs;
+            const size_t end = (seeds.size() * (job + 1)) / jobs;
+
+            auto writer = createWriter(chunk, chunk.positions, 0);
+            for (size_t i = begin; i < end; ++i) {
+                writer.begin = chunk.positions.size();
+                const auto termination =
+                    trace(seedTransform(util::glm_convert<SpatialVector>(seeds[i])), writer);
+                if (writer.size() > 1) {
+                    chunk.finishLine(startIndex + i, termination.backward, termination.forward);
+                } else {
+                    writer.discard();
+                }
+            }
+        },
+        jobs);
+
+    for (auto &future : futures) {
+        future.get();  // rethrow any exceptions from the jobs
+    }
+    for (auto &chunk : chunks) {
+        lines.append(chunk);
+    }
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+template <typename Line>
+typename IntegralLineTracer<SpatialSampler, TimeDependent>::LineWriter
+IntegralLineTracer<SpatialSampler, TimeDependent>::createWriter(Line &line,
+                                                                std::vector<dvec3> &positions,
+                                                                size_t reserve) {
+    LineWriter writer;
+    writer.begin = positions.size();
+    writer.positions = &positions;
+    writer.velocities = &line.template getMetaData<dvec3>("velocity", true);
+
+    if constexpr (TimeDependent) {
+        writer.timestamps = &line.template getMetaData<double>("timestamp", true);
+    }
+
+    for (auto &m : metaSamplers_) {
+        writer.metaData.push_back(
+            &line.template getMetaData<typename Sampler::ReturnType>(m.first, true));
+    }
+
+    if (reserve != 0) {
+        writer.forEachChannel([reserve](auto &v) { v.reserve(reserve); });
+    }
+    return writer;
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+typename IntegralLineTracer<SpatialSampler, TimeDependent>::Termination
+IntegralLineTracer<SpatialSampler, TimeDependent>::trace(const SpatialVector &p,
+                                                         LineWriter &line) {
+    Termination termination;
+
     const auto [stepsBWD, stepsFWD] = [dir = dir_, steps = steps_,
-                                       &line]() -> std::pair<size_t, size_t> {
+                                       &termination]() -> std::pair<size_t, size_t> {
         switch (dir) {
             case inviwo::IntegralLineProperties::Direction::FWD:
-                line.setBackwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
+                termination.backward = IntegralLine::TerminationReason::StartPoint;
                 return {1, steps + 1};
             case inviwo::IntegralLineProperties::Direction::BWD:
-                line.setForwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
+                termination.forward = IntegralLine::TerminationReason::StartPoint;
                 return {steps + 1, 1};
             default:
             case inviwo::IntegralLineProperties::Direction::BOTH: {
@@ -141,30 +310,19 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::traceFrom(const SpatialVector
         }
     }();
 
-    line.getPositions().reserve(steps_ + 2);
-    line.getMetaData<dvec3>("velocity", true).reserve(steps_ + 2);
-
-    if constexpr (TimeDependent) {
-        line.getMetaData<double>("timestamp", true).reserve(steps_ + 2);
-    }
-
-    for (auto &m : metaSamplers_) {
-        line.getMetaData<typename Sampler::ReturnType>(m.first, true).reserve(steps_ + 2);
-    }
-
     if (!addPoint(line, p)) {
-        return res;  // Zero velocity at seed point
+        return termination;  // Zero velocity at seed point
     }
 
-    line.setBackwardTerminationReason(integrate(stepsBWD, p, line, false));
+    termination.backward = integrate(stepsBWD, p, line, false);
 
-    if (line.getPositions().size() > 1) {
+    if (line.size() > 1) {
         line.reverse();
-        res.seedIndex = line.getPositions().size() - 1;
+        termination.seedIndex = line.size() - 1;
     }
 
-    line.setForwardTerminationReason(integrate(stepsFWD, p, line, true));
-    return res;
+    termination.forward = integrate(stepsFWD, p, line, true);
+    return termination;
 }
 
 template <typename SpatialSampler, bool TimeDependent>
@@ -241,13 +399,13 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::step(const SpatialVector &old
 }
 
 template <typename SpatialSampler, bool TimeDependent>
-bool IntegralLineTracer<SpatialSampler, TimeDependent>::addPoint(IntegralLine &line,
+bool IntegralLineTracer<SpatialSampler, TimeDependent>::addPoint(LineWriter &line,
                                                                  const SpatialVector &pos) {
     return addPoint(line, pos, sampler_->sample(pos));
 }
 
 template <typename SpatialSampler, bool TimeDependent>
-bool IntegralLineTracer<SpatialSampler, TimeDependent>::addPoint(IntegralLine &line,
+bool IntegralLineTracer<SpatialSampler, TimeDependent>::addPoint(LineWriter &line,
                                                                  const SpatialVector &pos,
                                                                  const DataVector &worldVelocity) {
 
@@ -255,24 +413,27 @@ bool IntegralLineTracer<SpatialSampler, TimeDependent>::addPoint(IntegralLine &l
         return false;
     }
 
-    line.getPositions().emplace_back(util::glm_convert<dvec3>(pos));
-    line.getMetaData<dvec3>("velocity").emplace_back(util::glm_convert<dvec3>(worldVelocity));
+    line.positions->emplace_back(util::glm_convert<dvec3>(pos));
+    line.velocities->emplace_back(util::glm_convert<dvec3>(worldVelocity));
 
     if constexpr (TimeDependent) {
-        line.getMetaData<double>("timestamp").emplace_back(pos[Sampler::SpatialDimensions - 1]);
+        line.timestamps->emplace_back(pos[Sampler::SpatialDimensions - 1]);
     }
 
+    auto metaData = line.metaData.begin();
     for (auto &m : metaSamplers_) {
-        line.getMetaData<typename Sampler::ReturnType>(m.first).emplace_back(
-            util::glm_convert<dvec3>(m.second->sample(pos)));
+        (*metaData++)->emplace_back(util::glm_convert<dvec3>(m.second->sample(pos)));
     }
     return true;
 }
 
 template <typename SpatialSampler, bool TimeDependent>
 IntegralLine::TerminationReason IntegralLineTracer<SpatialSampler, TimeDependent>::integrate(
-    size_t steps, SpatialVector pos, IntegralLine &line, bool fwd) {
+    size_t steps, SpatialVector pos, LineWriter &line, bool fwd) {
     if (steps == 0) return IntegralLine::TerminationReason::StartPoint;
+    if (integrationScheme_ == IntegralLineProperties::IntegrationScheme::RK45) {
+        return integrateAdaptive(steps, pos, line, fwd);
+    }
     for (size_t i = 0; i < steps; i++) {
         if (!sampler_->withinBounds(pos)) {
             return IntegralLine::TerminationReason::OutOfBounds;
@@ -287,6 +448,115 @@ IntegralLine::TerminationReason IntegralLineTracer<SpatialSampler, TimeDependent
     return IntegralLine::TerminationReason::Steps;
 }
 
+template <typename SpatialSampler, bool TimeDependent>
+typename IntegralLineTracer<SpatialSampler, TimeDependent>::SpatialVector
+IntegralLineTracer<SpatialSampler, TimeDependent>::slope(const DataVector &velocity) const {
+    auto v = velocity;
+    if (normalizeSamples_) {
+        const auto l = glm::length(v);
+        if (l != 0) v /= l;
+    }
+    if constexpr (TimeDependent) {
+        return SpatialVector(invBasis_ * v, 1.0);
+    } else {
+        return invBasis_ * v;
+    }
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+typename IntegralLineTracer<SpatialSampler, TimeDependent>::AdaptiveStep
+IntegralLineTracer<SpatialSampler, TimeDependent>::adaptiveStep(const SpatialVector &y0,
+                                                                const DataVector &velocity,
+                                                                const double h) const {
+    // Dormand-Prince 5(4) tableau, see Hairer, Norsett & Wanner, Solving Ordinary Differential
+    // Equations I, section II.5. The seventh stage is evaluated at the new position (FSAL).
+    const auto k1 = slope(velocity);
+    const auto k2 = slope(sampler_->sample(y0 + h * (1.0 / 5.0) * k1));
+    const auto k3 = slope(sampler_->sample(y0 + h * ((3.0 / 40.0) * k1 + (9.0 / 40.0) * k2)));
+    const auto k4 = slope(sampler_->sample(
+        y0 + h * ((44.0 / 45.0) * k1 - (56.0 / 15.0) * k2 + (32.0 / 9.0) * k3)));
+    const auto k5 = slope(sampler_->sample(
+        y0 + h * ((19372.0 / 6561.0) * k1 - (25360.0 / 2187.0) * k2 + (64448.0 / 6561.0) * k3 -
+                  (212.0 / 729.0) * k4)));
+    const auto k6 = slope(sampler_->sample(
+        y0 + h * ((9017.0 / 3168.0) * k1 - (355.0 / 33.0) * k2 + (46732.0 / 5247.0) * k3 +
+                  (49.0 / 176.0) * k4 - (5103.0 / 18656.0) * k5)));
+
+    AdaptiveStep res;
+    res.y1 = y0 + h * ((35.0 / 384.0) * k1 + (500.0 / 1113.0) * k3 + (125.0 / 192.0) * k4 -
+                       (2187.0 / 6784.0) * k5 + (11.0 / 84.0) * k6);
+    res.velocity = sampler_->sample(res.y1);
+    const auto k7 = slope(res.velocity);
+
+    // Difference between the fifth and fourth order solutions
+    const auto err = h * ((71.0 / 57600.0) * k1 - (71.0 / 16695.0) * k3 + (71.0 / 1920.0) * k4 -
+                          (17253.0 / 339200.0) * k5 + (22.0 / 525.0) * k6 - (1.0 / 40.0) * k7);
+    res.error = glm::length(err);
+
+    res.dense[0] = y0;
+    res.dense[1] = res.y1 - y0;
+    res.dense[2] = h * k1 - res.dense[1];
+    res.dense[3] = res.dense[1] - h * k7 - res.dense[2];
+    res.dense[4] = h * ((-12715105075.0 / 11282082432.0) * k1 +
+                        (87487479700.0 / 32700410799.0) * k3 +
+                        (-10690763975.0 / 1880347072.0) * k4 +
+                        (701980252875.0 / 199316789632.0) * k5 +
+                        (-1453857185.0 / 822651844.0) * k6 + (69997945.0 / 29380423.0) * k7);
+    return res;
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+IntegralLine::TerminationReason
+IntegralLineTracer<SpatialSampler, TimeDependent>::integrateAdaptive(size_t steps,
+                                                                     SpatialVector pos,
+                                                                     LineWriter &line, bool fwd) {
+    // Integrate the same length as the fixed step schemes would, but let the error estimate pick
+    // the step size. With dense output the line is resampled at the fixed step size.
+    const double length = static_cast<double>(steps) * stepSize_;
+    const double sign = fwd ? 1.0 : -1.0;
+    const auto factor = [tol = errorTolerance_](double error) {
+        if (error == 0.0) return 5.0;
+        return std::clamp(0.9 * std::pow(tol / error, 0.2), 0.2, 5.0);
+    };
+
+    DataVector velocity = sampler_->sample(pos);
+    double h = std::clamp(stepSize_, minStepSize_, maxStepSize_);
+    double t = 0.0;
+    size_t output = 1;
+
+    while (t < length) {
+        if (!sampler_->withinBounds(pos)) {
+            return IntegralLine::TerminationReason::OutOfBounds;
+        }
+        h = std::min(h, length - t);
+        const auto res = adaptiveStep(pos, velocity, sign * h);
+
+        if (res.error > errorTolerance_ && h > minStepSize_) {
+            h = std::max(minStepSize_, h * factor(res.error));
+            continue;
+        }
+
+        if (denseOutput_) {
+            const double end = t + h;
+            for (double next = output * stepSize_; next <= end * (1.0 + 1e-12);
+                 next = ++output * stepSize_) {
+                const double theta = (next - t) / h;
+                if (!addPoint(line, res.at(theta), glm::mix(velocity, res.velocity, theta))) {
+                    return IntegralLine::TerminationReason::ZeroVelocity;
+                }
+            }
+        } else if (!addPoint(line, res.y1, res.velocity)) {
+            return IntegralLine::TerminationReason::ZeroVelocity;
+        }
+
+        t += h;
+        pos = res.y1;
+        velocity = res.velocity;
+        h = std::clamp(h * factor(res.error), minStepSize_, maxStepSize_);
+    }
+    return IntegralLine::TerminationReason::Steps;
+}
+
 using StreamLine2DTracer = IntegralLineTracer<SpatialSampler<2, 2, double>>;
 using StreamLine3DTracer = IntegralLineTracer<SpatialSampler<3, 3, double>>;
 using PathLine3DTracer = IntegralLineTracer<Spatial4DSampler<3, double>>;
@@ -104,8 +104,6 @@ IntegralLineTracerProcessor<Tracer>::~IntegralLineTracerProcessor() {}
 template <typename Tracer>
 void IntegralLineTracerProcessor<Tracer>::process() {
     auto sampler = sampler_.getData();
-    auto lines =
-        std::make_shared<IntegralLineSet>(sampler->getModelMatrix(), sampler->getWorldMatrix());
 
     Tracer tracer(sampler, properties_);
 
@@ -115,20 +113,16 @@ void IntegralLineTracerProcessor<Tracer>::process() {
         tracer.addMetaDataSampler(key, meta.second);
     }
 
-    std::mutex mutex;
+    IntegralLineSet::Packed packed;
     size_t startID = 0;
     for (const auto &seeds : seeds_) {
-        util::forEachParallel(*seeds, [&](const auto &p, size_t i) {
-            IntegralLine line = tracer.traceFrom(p);
-            auto size = line.getPositions().size();
-            if (size > 1) {
-                std::lock_guard<std::mutex> lock(mutex);
-                lines->push_back(std::move(line), startID + i);
-            }
-        });
+        tracer.traceFrom(*seeds, startID, packed);
         startID += seeds->size();
     }
 
+    auto lines = std::make_shared<IntegralLineSet>(std::move(packed), sampler->getModelMatrix(),
+                                                   sampler->getWorldMatrix());
+
     if (calculateCurvature_) {
         util::curvature(*lines);
     }
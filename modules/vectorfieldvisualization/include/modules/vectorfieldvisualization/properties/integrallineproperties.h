@@ -43,7 +43,12 @@ namespace inviwo {
 
 class IVW_MODULE_VECTORFIELDVISUALIZATION_API IntegralLineProperties : public CompositeProperty {
 public:
-    enum class IntegrationScheme { Euler, RK4 };
+    /**
+     * Euler and RK4 use a fixed step size. RK45 is the adaptive Dormand-Prince method, it
+     * integrates the same length (number of steps times step size) but chooses the step size
+     * between the min and max step to keep the local error estimate below the tolerance.
+     */
+    enum class IntegrationScheme { Euler, RK4, RK45 };
 
     enum class Direction { FWD = 1, BWD = 2, BOTH = 3 };
 
@@ -64,6 +69,11 @@ public:
     CoordinateSpace getSeedPointsSpace() const;
     bool getNormalizeSamples() const;
 
+    double getErrorTolerance() const;
+    float getMinStepSize() const;
+    float getMaxStepSize() const;
+    bool getDenseOutput() const;
+
 private:
     void setUpProperties();
 
@@ -75,6 +85,11 @@ public:
     TemplateOptionProperty<IntegralLineProperties::Direction> stepDirection_;
     TemplateOptionProperty<IntegralLineProperties::IntegrationScheme> integrationScheme_;
     TemplateOptionProperty<CoordinateSpace> seedPointsSpace_;
+
+    DoubleProperty errorTolerance_;
+    FloatProperty minStepSize_;
+    FloatProperty maxStepSize_;
+    BoolProperty denseOutput_;
 };
 
 template <unsigned int N>
@@ -29,58 +29,235 @@
 
 #include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
 
+#include <inviwo/core/util/formatdispatching.h>
+
 namespace inviwo {
 
+IntegralLineSet::Packed::Packed() : offsets{0} {}
+
+size_t IntegralLineSet::Packed::size() const { return offsets.size() - 1; }
+
+bool IntegralLineSet::Packed::empty() const { return size() == 0; }
+
+util::span<const dvec3> IntegralLineSet::Packed::getPositions(size_t line) const {
+    return util::span<const dvec3>(positions.data() + offsets[line],
+                                   offsets[line + 1] - offsets[line]);
+}
+
+std::shared_ptr<const BufferBase> IntegralLineSet::Packed::getMetaDataBuffer(
+    const std::string& name) const {
+    auto it = metaData.find(name);
+    if (it == metaData.end()) {
+        throw Exception("No meta data with name: " + name, IVW_CONTEXT);
+    }
+    return it->second;
+}
+
+bool IntegralLineSet::Packed::hasMetaData(const std::string& name) const {
+    return metaData.find(name) != metaData.end();
+}
+
+std::vector<std::string> IntegralLineSet::Packed::getMetaDataKeys() const {
+    std::vector<std::string> keys;
+    for (auto& m : metaData) {
+        keys.push_back(m.first);
+    }
+    return keys;
+}
+
+void IntegralLineSet::Packed::finishLine(size_t index, IntegralLine::TerminationReason backward,
+                                         IntegralLine::TerminationReason forward) {
+    offsets.push_back(positions.size());
+    indices.push_back(index);
+    backwardTerminationReasons.push_back(backward);
+    forwardTerminationReasons.push_back(forward);
+}
+
+void IntegralLineSet::Packed::append(const Packed& other) {
+    if (other.empty()) return;
+
+    const auto base = positions.size();
+    positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+    std::transform(std::next(other.offsets.begin()), other.offsets.end(),
+                   std::back_inserter(offsets), [base](size_t o) { return base + o; });
+    indices.insert(indices.end(), other.indices.begin(), other.indices.end());
+    backwardTerminationReasons.insert(backwardTerminationReasons.end(),
+                                      other.backwardTerminationReasons.begin(),
+                                      other.backwardTerminationReasons.end());
+    forwardTerminationReasons.insert(forwardTerminationReasons.end(),
+                                     other.forwardTerminationReasons.begin(),
+                                     other.forwardTerminationReasons.end());
+
+    for (auto& m : other.metaData) {
+        auto it = metaData.find(m.first);
+        if (it == metaData.end()) {
+            if (base != 0) {
+                throw Exception("Meta data " + m.first + " missing in packed lines", IVW_CONTEXT);
+            }
+            metaData[m.first] = std::shared_ptr<BufferBase>(m.second->clone());
+        } else {
+            it->second->append(*m.second);
+        }
+    }
+    if (metaData.size() != other.metaData.size()) {
+        throw Exception("Packed lines have different meta data", IVW_CONTEXT);
+    }
+}
+
+IntegralLine IntegralLineSet::Packed::getLine(size_t line) const {
+    IntegralLine res;
+    const auto begin = offsets[line];
+    const auto end = offsets[line + 1];
+
+    res.getPositions().assign(positions.begin() + begin, positions.begin() + end);
+    for (auto& m : metaData) {
+        auto slice = m.second->getRepresentation<BufferRAM>()
+                         ->dispatch<std::shared_ptr<BufferBase>>([&](auto ram) {
+                             using ValueType = util::PrecisionValueType<decltype(ram)>;
+                             const auto& data = ram->getDataContainer();
+                             return std::static_pointer_cast<BufferBase>(util::makeBuffer(
+                                 std::vector<ValueType>(data.begin() + begin, data.begin() + end)));
+                         });
+        res.addMetaDataBuffer(m.first, slice);
+    }
+    res.setIndex(indices[line]);
+    res.setBackwardTerminationReason(backwardTerminationReasons[line]);
+    res.setForwardTerminationReason(forwardTerminationReasons[line]);
+    return res;
+}
+
 IntegralLineSet::IntegralLineSet(mat4 modelMatrix, mat4 worldMatrix)
-    : lines_(), modelMatrix_(modelMatrix), worldMatrix_(worldMatrix) {}
+    : packed_(), lines_(), unpacked_(true), modelMatrix_(modelMatrix), worldMatrix_(worldMatrix) {}
+
+IntegralLineSet::IntegralLineSet(Packed lines, mat4 modelMatrix, mat4 worldMatrix)
+    : packed_(std::make_shared<const Packed>(std::move(lines)))
+    , lines_()
+    , unpacked_(false)
+    , modelMatrix_(modelMatrix)
+    , worldMatrix_(worldMatrix) {}
+
+IntegralLineSet::IntegralLineSet(const IntegralLineSet& rhs)
+    : packed_()
+    , lines_()
+    , unpacked_(true)
+    , modelMatrix_(rhs.modelMatrix_)
+    , worldMatrix_(rhs.worldMatrix_) {
+    std::scoped_lock lock{rhs.mutex_};
+    packed_ = rhs.packed_;
+    lines_ = rhs.lines_;
+    unpacked_ = rhs.unpacked_;
+}
+
+IntegralLineSet::IntegralLineSet(IntegralLineSet&& rhs)
+    : packed_(std::move(rhs.packed_))
+    , lines_(std::move(rhs.lines_))
+    , unpacked_(rhs.unpacked_)
+    , modelMatrix_(rhs.modelMatrix_)
+    , worldMatrix_(rhs.worldMatrix_) {}
+
+IntegralLineSet& IntegralLineSet::operator=(const IntegralLineSet& that) {
+    if (this != &that) {
+        std::scoped_lock lock{mutex_, that.mutex_};
+        packed_ = that.packed_;
+        lines_ = that.lines_;
+        unpacked_ = that.unpacked_;
+        modelMatrix_ = that.modelMatrix_;
+        worldMatrix_ = that.worldMatrix_;
+    }
+    return *this;
+}
+
+IntegralLineSet& IntegralLineSet::operator=(IntegralLineSet&& that) {
+    if (this != &that) {
+        packed_ = std::move(that.packed_);
+        lines_ = std::move(that.lines_);
+        unpacked_ = that.unpacked_;
+        modelMatrix_ = that.modelMatrix_;
+        worldMatrix_ = that.worldMatrix_;
+    }
+    return *this;
+}
 
 IntegralLineSet::~IntegralLineSet() {}
 
 mat4 IntegralLineSet::getModelMatrix() const { return modelMatrix_; }
 mat4 IntegralLineSet::getWorldMatrix() const { return worldMatrix_; }
 
-std::vector<IntegralLine>::const_iterator IntegralLineSet::begin() const { return lines_.begin(); }
+const IntegralLineSet::Packed* IntegralLineSet::getPacked() const {
+    std::scoped_lock lock{mutex_};
+    return packed_.get();
+}
 
-std::vector<IntegralLine>::iterator IntegralLineSet::begin() { return lines_.begin(); }
+void IntegralLineSet::unpack() const {
+    if (!unpacked_) {
+        lines_.reserve(packed_->size());
+        for (size_t i = 0; i < packed_->size(); ++i) {
+            lines_.push_back(packed_->getLine(i));
+        }
+        unpacked_ = true;
+    }
+}
 
-std::vector<IntegralLine>::const_iterator IntegralLineSet::end() const { return lines_.end(); }
+const std::vector<IntegralLine>& IntegralLineSet::unpacked() const {
+    std::scoped_lock lock{mutex_};
+    unpack();
+    return lines_;
+}
 
-std::vector<IntegralLine>::iterator IntegralLineSet::end() { return lines_.end(); }
+std::vector<IntegralLine>& IntegralLineSet::editable() {
+    std::scoped_lock lock{mutex_};
+    unpack();
+    packed_.reset();
+    return lines_;
+}
 
-size_t IntegralLineSet::size() const { return lines_.size(); }
+std::vector<IntegralLine>::const_iterator IntegralLineSet::begin() const {
+    return unpacked().begin();
+}
+
+std::vector<IntegralLine>::iterator IntegralLineSet::begin() { return editable().begin(); }
+
+std::vector<IntegralLine>::const_iterator IntegralLineSet::end() const { return unpacked().end(); }
+
+std::vector<IntegralLine>::iterator IntegralLineSet::end() { return editable().end(); }
+
+size_t IntegralLineSet::size() const {
+    std::scoped_lock lock{mutex_};
+    return packed_ ? packed_->size() : lines_.size();
+}
 
-IntegralLine& IntegralLineSet::operator[](size_t idx) { return lines_[idx]; }
+IntegralLine& IntegralLineSet::operator[](size_t idx) { return editable()[idx]; }
 
-const IntegralLine& IntegralLineSet::operator[](size_t idx) const { return lines_[idx]; }
+const IntegralLine& IntegralLineSet::operator[](size_t idx) const { return unpacked()[idx]; }
 
-IntegralLine& IntegralLineSet::at(size_t idx) { return lines_.at(idx); }
+IntegralLine& IntegralLineSet::at(size_t idx) { return editable().at(idx); }
 
-const IntegralLine& IntegralLineSet::at(size_t idx) const { return lines_.at(idx); }
+const IntegralLine& IntegralLineSet::at(size_t idx) const { return unpacked().at(idx); }
 
 void IntegralLineSet::push_back(const IntegralLine& line, SetIndex updateIndex) {
     if (updateIndex == SetIndex::No) {
-        lines_.push_back(line);
+        editable().push_back(line);
     } else {
-        push_back(line, lines_.size());
+        push_back(line, size());
     }
 }
 
 void IntegralLineSet::push_back(const IntegralLine& line, size_t idx) {
     IntegralLine copy(line);
     copy.setIndex(idx);
-    lines_.push_back(std::move(copy));
+    editable().push_back(std::move(copy));
 }
 
 void IntegralLineSet::push_back(IntegralLine&& line, SetIndex updateIndex) {
     if (updateIndex == SetIndex::Yes) {
-        line.setIndex(lines_.size());
+        line.setIndex(size());
     }
-    lines_.push_back(line);
+    editable().push_back(line);
 }
 
 void IntegralLineSet::push_back(IntegralLine&& line, size_t idx) {
     line.setIndex(idx);
-    lines_.push_back(line);
+    editable().push_back(line);
 }
 
 }  // namespace inviwo
@@ -131,10 +131,10 @@ const ProcessorInfo IntegralLineVectorToMesh::processorInfo_{
     Tags::CPU,                              // Tags
 };
 
-bool IntegralLineVectorToMesh::isFiltered(const IntegralLine &line, size_t idx) const {
+bool IntegralLineVectorToMesh::isFiltered(size_t lineIndex, size_t idx) const {
     switch (brushBy_.get()) {
         case BrushBy::LineIndex:
-            return brushingList_.isFiltered(line.getIndex());
+            return brushingList_.isFiltered(lineIndex);
         case BrushBy::VectorPosition:
             return brushingList_.isFiltered(idx);
         case BrushBy::Nothing:
@@ -143,10 +143,10 @@ bool IntegralLineVectorToMesh::isFiltered(const IntegralLine &line, size_t idx)
     }
 }
 
-bool IntegralLineVectorToMesh::isSelected(const IntegralLine &line, size_t idx) const {
+bool IntegralLineVectorToMesh::isSelected(size_t lineIndex, size_t idx) const {
     switch (brushBy_.get()) {
         case BrushBy::LineIndex:
-            return brushingList_.isSelected(line.getIndex());
+            return brushingList_.isSelected(lineIndex);
         case BrushBy::VectorPosition:
             return brushingList_.isSelected(idx);
         case BrushBy::Nothing:
@@ -161,7 +161,9 @@ void IntegralLineVectorToMesh::updateOptions() {
 
     std::vector<OptionPropertyStringOption> options = {{"constant", "constant color"}};
 
-    for (const auto &key : lines->front().getMetaDataKeys()) {
+    const auto keys = lines->getPacked() ? lines->getPacked()->getMetaDataKeys()
+                                         : lines->front().getMetaDataKeys();
+    for (const auto &key : keys) {
         options.emplace_back(key, key);
 
         if (!getPropertyByIdentifier(key)) {
@@ -244,25 +246,36 @@ IntegralLineVectorToMesh::IntegralLineVectorToMesh()
             double minT = std::numeric_limits<double>::max();
             double maxT = std::numeric_limits<double>::lowest();
 
-            size_t idx = 0;
-            for (auto &line : (*lines_.getData())) {
-                util::OnScopeExit incIdx([&idx]() { idx++; });
-                auto size = line.getPositions().size();
-                if (size == 0) continue;
+            auto update = [&](size_t lineIndex, size_t idx, size_t size, auto timestamps) {
+                if (size == 0 || this->isFiltered(lineIndex, idx)) return;
 
-                if (this->isFiltered(line, idx)) {
-                    continue;
-                }
-
-                if (!line.hasMetaData("timestamp")) {
+                if (!timestamps) {
                     minT = std::min(minT, 0.);
                     maxT = std::max(maxT, 1.);
                 } else {
-                    for (const auto &t : line.getMetaData<double>("timestamp")) {
+                    for (const auto &t : *timestamps) {
                         minT = std::min(minT, t);
                         maxT = std::max(t, maxT);
                     }
                 }
+            };
+
+            if (auto packed = lines_.getData()->getPacked()) {
+                const bool hasTime = packed->hasMetaData("timestamp");
+                for (size_t i = 0; i < packed->size(); ++i) {
+                    auto timestamps = hasTime ? packed->getMetaData<double>("timestamp", i)
+                                              : util::span<const double>{};
+                    update(packed->indices[i], i, packed->getPositions(i).size(),
+                           hasTime ? &timestamps : nullptr);
+                }
+            } else {
+                size_t idx = 0;
+                for (auto &line : (*lines_.getData())) {
+                    util::OnScopeExit incIdx([&idx]() { idx++; });
+                    update(line.getIndex(), idx, line.getPositions().size(),
+                           line.hasMetaData("timestamp") ? &line.getMetaData<double>("timestamp")
+                                                         : nullptr);
+                }
             }
             NetworkLock lock(getNetwork());
             minMaxT_.setRangeMin(minT);
@@ -327,12 +340,11 @@ void IntegralLineVectorToMesh::process() {
 
     Output output = output_.get();
 
-    size_t lineIdx = 0;
-    for (auto &line : (*lines_.getData())) {
-        util::OnScopeExit incIdx([&lineIdx]() { lineIdx++; });
-        auto size = line.getPositions().size();
-
-        if (size == 0 || isFiltered(line, lineIdx)) continue;
+    const auto lineLoop = [&](size_t lineIndex, size_t lineIdx, util::span<const dvec3> positions,
+                              util::span<const dvec3> velocities, auto &&mdContainer,
+                              util::span<const dvec3> vorticities) {
+        const auto size = positions.size();
+        if (size == 0 || isFiltered(lineIndex, lineIdx)) return;
 
         auto indexBuffer = [&]() -> std::shared_ptr<IndexBufferRAM> {
             if (output == Output::Lines) {
@@ -347,8 +359,8 @@ void IntegralLineVectorToMesh::process() {
             throw Exception("Unsupported output type", IVW_CONTEXT);
         }();
 
-        auto coloring = [&, this](auto sample, size_t lineIndex, size_t lineNumber) -> vec4 {
-            if (constantColor || this->isSelected(line, lineIdx)) {
+        auto coloring = [&, this](auto sample) -> vec4 {
+            if (constantColor || this->isSelected(lineIndex, lineIdx)) {
                 return selectedColor_.get();
             }
 
@@ -356,7 +368,7 @@ void IntegralLineVectorToMesh::process() {
                 auto colors = colors_.getData();
                 size_t index = 0;
                 if (colorByPortNumber) {
-                    index = lineNumber;
+                    index = lineIdx;
                 } else if (colorByPortIndex) {
                     index = lineIndex;
                 }
@@ -385,14 +397,12 @@ void IntegralLineVectorToMesh::process() {
             }
         };
 
-        auto lineLoop = [&coloring, &vertices, &indexBuffer, &lineIdx, this](
-                            const IntegralLine &line, auto mdContainter) {
+        if (output == Output::Lines) {
             size_t pointIdx = 0;
-            for (auto &&sample : util::zip(line.getPositions(), line.getMetaData<dvec3>("velocity"),
-                                           mdContainter)) {
+            for (auto &&sample : util::zip(positions, velocities, mdContainer)) {
                 util::OnScopeExit incPointIdx([&pointIdx]() { pointIdx++; });
                 bool first = pointIdx <= 1;
-                bool last = pointIdx >= line.getPositions().size() - 2;
+                bool last = pointIdx >= size - 2;
                 // need to keep the two first and two last when using adjendency information
                 if (!first && !last && pointIdx % stride_.get() != 0) {
                     continue;
@@ -401,22 +411,18 @@ void IntegralLineVectorToMesh::process() {
                 vec3 pos = get<0>(sample);
                 vec3 vel = get<1>(sample);
 
-                vec4 color = coloring(sample, line.getIndex(), lineIdx);
+                vec4 color = coloring(sample);
 
                 indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
                 vertices.push_back({pos, glm::normalize(vel), pos, color});
             }
-        };
-
-        auto ribbonLoop = [&coloring, &vertices, &indexBuffer, &lineIdx, this](
-                              const IntegralLine &line, auto mdContainter) {
-            for (auto &&sample : util::zip(line.getPositions(), line.getMetaData<dvec3>("velocity"),
-                                           mdContainter, line.getMetaData<dvec3>("vorticity"))) {
+        } else {
+            for (auto &&sample : util::zip(positions, velocities, mdContainer, vorticities)) {
                 vec3 pos = get<0>(sample);
                 vec3 vel = get<1>(sample);
                 vec3 vor = get<3>(sample);
 
-                vec4 color = coloring(sample, line.getIndex(), lineIdx);
+                vec4 color = coloring(sample);
 
                 auto N = glm::normalize(glm::cross(vor, vel));
 
@@ -428,23 +434,58 @@ void IntegralLineVectorToMesh::process() {
                 indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
                 vertices.push_back({pos2, N, pos2, color});
             }
+        }
+    };
+
+    if (auto packed = lines_.getData()->getPacked()) {
+        // Read the packed storage directly, every line is a range of the shared arrays
+        const auto &velocities = packed->getMetaData<dvec3>("velocity");
+        const auto *vorticities = output == Output::Ribbons
+                                      ? &packed->getMetaData<dvec3>("vorticity")
+                                      : nullptr;
+        const auto range = [packed](const auto &data, size_t line) {
+            using T = typename std::decay_t<decltype(data)>::value_type;
+            return util::span<const T>(data.data() + packed->offsets[line],
+                                       packed->offsets[line + 1] - packed->offsets[line]);
+        };
+        const auto forEachLine = [&](auto &&mdRange) {
+            for (size_t i = 0; i < packed->size(); ++i) {
+                lineLoop(packed->indices[i], i, packed->getPositions(i), range(velocities, i),
+                         mdRange(i),
+                         vorticities ? range(*vorticities, i) : util::span<const dvec3>{});
+            }
         };
 
         if (mdProp) {
-            line.getMetaDataBuffer(metaDataKey)
+            packed->getMetaDataBuffer(metaDataKey)
                 ->getRepresentation<BufferRAM>()
                 ->dispatch<void>([&](auto mdBuf) {
-                    if (output == Output::Lines)
-                        lineLoop(line, mdBuf->getDataContainer());
-                    else {
-                        ribbonLoop(line, mdBuf->getDataContainer());
-                    }
+                    const auto &data = mdBuf->getDataContainer();
+                    forEachLine([&](size_t i) { return range(data, i); });
                 });
         } else {
-            if (output == Output::Lines)
-                lineLoop(line, std::vector<int>(line.getPositions().size()));
-            else {
-                ribbonLoop(line, std::vector<int>(line.getPositions().size()));
+            forEachLine(
+                [&](size_t i) { return std::vector<int>(packed->getPositions(i).size()); });
+        }
+    } else {
+        size_t lineIdx = 0;
+        for (auto &line : (*lines_.getData())) {
+            util::OnScopeExit incIdx([&lineIdx]() { lineIdx++; });
+
+            const auto &positions = line.getPositions();
+            const auto &velocities = line.getMetaData<dvec3>("velocity");
+            util::span<const dvec3> vorticities{};
+            if (output == Output::Ribbons) vorticities = line.getMetaData<dvec3>("vorticity");
+            if (mdProp) {
+                line.getMetaDataBuffer(metaDataKey)
+                    ->getRepresentation<BufferRAM>()
+                    ->dispatch<void>([&](auto mdBuf) {
+                        lineLoop(line.getIndex(), lineIdx, positions, velocities,
+                                 mdBuf->getDataContainer(), vorticities);
+                    });
+            } else {
+                lineLoop(line.getIndex(), lineIdx, positions, velocities,
+                         std::vector<int>(positions.size()), vorticities);
             }
         }
     }
@@ -38,7 +38,12 @@ IntegralLineProperties::IntegralLineProperties(std::string identifier, std::stri
     , normalizeSamples_("normalizeSamples", "Normalize Samples", true)
     , stepDirection_("stepDirection", "Step Direction")
     , integrationScheme_("integrationScheme", "Integration Scheme")
-    , seedPointsSpace_("seedPointsSpace", "Seed Points Space") {
+    , seedPointsSpace_("seedPointsSpace", "Seed Points Space")
+    , errorTolerance_("errorTolerance", "Error Tolerance", 1e-5, 1e-10, 1e-1, 1e-6,
+                      InvalidationLevel::InvalidOutput, PropertySemantics::Text)
+    , minStepSize_("minStepSize", "Min Step Size", 0.0001f, 0.00001f, 0.1f, 0.00001f)
+    , maxStepSize_("maxStepSize", "Max Step Size", 0.05f, 0.001f, 1.0f, 0.001f)
+    , denseOutput_("denseOutput", "Dense Output", false) {
     setUpProperties();
 }
 
@@ -49,7 +54,11 @@ IntegralLineProperties::IntegralLineProperties(const IntegralLineProperties& rhs
     , normalizeSamples_(rhs.normalizeSamples_)
     , stepDirection_(rhs.stepDirection_)
     , integrationScheme_(rhs.integrationScheme_)
-    , seedPointsSpace_(rhs.seedPointsSpace_) {
+    , seedPointsSpace_(rhs.seedPointsSpace_)
+    , errorTolerance_(rhs.errorTolerance_)
+    , minStepSize_(rhs.minStepSize_)
+    , maxStepSize_(rhs.maxStepSize_)
+    , denseOutput_(rhs.denseOutput_) {
     setUpProperties();
 }
 
@@ -77,6 +86,14 @@ CoordinateSpace IntegralLineProperties::getSeedPointsSpace() const {
 
 bool IntegralLineProperties::getNormalizeSamples() const { return normalizeSamples_; }
 
+double IntegralLineProperties::getErrorTolerance() const { return errorTolerance_.get(); }
+
+float IntegralLineProperties::getMinStepSize() const { return minStepSize_.get(); }
+
+float IntegralLineProperties::getMaxStepSize() const { return maxStepSize_.get(); }
+
+bool IntegralLineProperties::getDenseOutput() const { return denseOutput_.get(); }
+
 void IntegralLineProperties::setUpProperties() {
     stepDirection_.addOption("fwd", "Forward", IntegralLineProperties::Direction::FWD);
     stepDirection_.addOption("bwd", "Backwards", IntegralLineProperties::Direction::BWD);
@@ -86,6 +103,8 @@ void IntegralLineProperties::setUpProperties() {
                                  IntegralLineProperties::IntegrationScheme::Euler);
     integrationScheme_.addOption("rk4", "Runge-Kutta (RK4)",
                                  IntegralLineProperties::IntegrationScheme::RK4);
+    integrationScheme_.addOption("rk45", "Adaptive Dormand-Prince (RK45)",
+                                 IntegralLineProperties::IntegrationScheme::RK45);
     integrationScheme_.setSelectedValue(IntegralLineProperties::IntegrationScheme::RK4);
 
     seedPointsSpace_.addOption("data", "Data", CoordinateSpace::Data);
@@ -98,6 +117,18 @@ void IntegralLineProperties::setUpProperties() {
     addProperty(integrationScheme_);
     addProperty(seedPointsSpace_);
     addProperty(normalizeSamples_);
+    addProperty(errorTolerance_);
+    addProperty(minStepSize_);
+    addProperty(maxStepSize_);
+    addProperty(denseOutput_);
+
+    const auto isAdaptive = [](const auto& p) {
+        return p.get() == IntegralLineProperties::IntegrationScheme::RK45;
+    };
+    errorTolerance_.visibilityDependsOn(integrationScheme_, isAdaptive);
+    minStepSize_.visibilityDependsOn(integrationScheme_, isAdaptive);
+    maxStepSize_.visibilityDependsOn(integrationScheme_, isAdaptive);
+    denseOutput_.visibilityDependsOn(integrationScheme_, isAdaptive);
 
     setAllPropertiesCurrentStateAsDefault();
 }
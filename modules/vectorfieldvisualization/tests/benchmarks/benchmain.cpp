@@ -0,0 +1,144 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/spatialdata.h>
+#include <inviwo/core/util/spatialsampler.h>
+#include <modules/vectorfieldvisualization/integrallinetracer.h>
+#include <modules/vectorfieldvisualization/properties/integrallineproperties.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+#include <warn/push>
+#include <warn/ignore/unused-function>
+
+using namespace inviwo;
+
+namespace {
+
+class UnitCube : public SpatialEntity<3> {
+public:
+    virtual UnitCube* clone() const override { return new UnitCube(*this); }
+};
+
+/**
+ * Rotation around the line x = y = 0.5 with an angular velocity that is much higher close to the
+ * axis. Stream lines are circles, which makes the radius drift a simple measure of the error.
+ * Counts the number of samples taken.
+ */
+class VortexSampler : public SpatialSampler<3, 3, double> {
+public:
+    VortexSampler(const UnitCube& cube) : SpatialSampler<3, 3, double>(cube) {}
+
+    mutable size_t calls = 0;
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec3& pos) const override {
+        ++calls;
+        const dvec2 r = dvec2(pos) - dvec2(0.5);
+        const double w = 1.0 + 20.0 * std::exp(-glm::dot(r, r) / 0.01);
+        return dvec3(-r.y * w, r.x * w, 0.0);
+    }
+    virtual bool withinBoundsDataSpace(const dvec3& pos) const override {
+        return glm::all(glm::greaterThanEqual(pos, dvec3(0.0))) &&
+               glm::all(glm::lessThanEqual(pos, dvec3(1.0)));
+    }
+};
+
+void trace(benchmark::State& state, IntegralLineProperties& properties) {
+    UnitCube cube;
+    auto sampler = std::make_shared<VortexSampler>(cube);
+
+    properties.normalizeSamples_.set(false);
+    properties.stepDirection_.set(IntegralLineProperties::Direction::FWD);
+
+    constexpr size_t nLines = 64;
+    size_t points = 0;
+    double maxError = 0.0;
+
+    for (auto _ : state) {
+        StreamLine3DTracer tracer(sampler, properties);
+        sampler->calls = 0;
+        points = 0;
+        maxError = 0.0;
+        for (size_t i = 0; i < nLines; ++i) {
+            const double r0 = 0.02 + 0.38 * static_cast<double>(i) / nLines;
+            auto res = tracer.traceFrom(dvec3(0.5 + r0, 0.5, 0.5));
+            const auto& positions = res.line.getPositions();
+            points += positions.size();
+            const double r1 = glm::length(dvec2(positions.back()) - dvec2(0.5));
+            maxError = std::max(maxError, std::abs(r1 - r0));
+            benchmark::DoNotOptimize(positions.data());
+        }
+    }
+    state.counters["SamplerCallsPerLine"] =
+        static_cast<double>(sampler->calls) / static_cast<double>(nLines);
+    state.counters["PointsPerLine"] = static_cast<double>(points) / static_cast<double>(nLines);
+    state.counters["MaxRadiusError"] = maxError;
+}
+
+}  // namespace
+
+// Fixed step RK4, argument is the number of steps used to integrate a unit length
+static void RK4(benchmark::State& state) {
+    IntegralLineProperties properties("properties", "Properties");
+    properties.integrationScheme_.set(IntegralLineProperties::IntegrationScheme::RK4);
+    properties.numberOfSteps_.set(static_cast<int>(state.range(0)));
+    properties.stepSize_.set(1.0f / static_cast<float>(state.range(0)));
+    trace(state, properties);
+}
+
+// Adaptive Dormand-Prince over the same length, argument is the negative exponent of the tolerance
+static void RK45(benchmark::State& state) {
+    IntegralLineProperties properties("properties", "Properties");
+    properties.integrationScheme_.set(IntegralLineProperties::IntegrationScheme::RK45);
+    properties.numberOfSteps_.set(1000);
+    properties.stepSize_.set(0.001f);
+    properties.errorTolerance_.set(std::pow(10.0, -static_cast<double>(state.range(0))));
+    trace(state, properties);
+}
+
+BENCHMARK(RK4)->Arg(100)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(RK45)->DenseRange(4, 10, 2);
+
+int main(int argc, char** argv) {
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
+
+#include <warn/pop>
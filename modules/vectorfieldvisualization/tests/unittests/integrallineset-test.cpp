@@ -0,0 +1,166 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+using Reason = IntegralLine::TerminationReason;
+
+// Three lines with 3, 0 and 2 positions, and a velocity and a time meta data channel
+IntegralLineSet::Packed makePacked() {
+    IntegralLineSet::Packed packed;
+    std::vector<dvec3> velocities;
+    std::vector<double> times;
+    const auto addLine = [&](size_t length, size_t index, Reason backward, Reason forward) {
+        for (size_t i = 0; i < length; ++i) {
+            const auto t = static_cast<double>(packed.positions.size());
+            packed.positions.emplace_back(t, 2.0 * t, -t);
+            velocities.emplace_back(1.0, t, 0.5);
+            times.push_back(0.1 * t);
+        }
+        packed.finishLine(index, backward, forward);
+    };
+    addLine(3, 7, Reason::StartPoint, Reason::Steps);
+    addLine(0, 8, Reason::OutOfBounds, Reason::ZeroVelocity);
+    addLine(2, 9, Reason::Unknown, Reason::OutOfBounds);
+
+    packed.metaData["velocity"] = util::makeBuffer(std::move(velocities));
+    packed.metaData["time"] = util::makeBuffer(std::move(times));
+    return packed;
+}
+
+void checkLines(const IntegralLineSet::Packed& packed, const IntegralLineSet& set) {
+    ASSERT_EQ(packed.size(), set.size());
+    for (size_t i = 0; i < packed.size(); ++i) {
+        SCOPED_TRACE(i);
+        const auto& line = set[i];
+        const auto positions = packed.getPositions(i);
+        EXPECT_EQ(std::vector<dvec3>(positions.begin(), positions.end()), line.getPositions());
+
+        EXPECT_EQ(packed.getMetaDataKeys(), line.getMetaDataKeys());
+        const auto velocities = packed.getMetaData<dvec3>("velocity", i);
+        EXPECT_EQ(std::vector<dvec3>(velocities.begin(), velocities.end()),
+                  line.getMetaData<dvec3>("velocity"));
+        const auto times = packed.getMetaData<double>("time", i);
+        EXPECT_EQ(std::vector<double>(times.begin(), times.end()),
+                  line.getMetaData<double>("time"));
+
+        EXPECT_EQ(packed.indices[i], line.getIndex());
+        EXPECT_EQ(packed.backwardTerminationReasons[i], line.getBackwardTerminationReason());
+        EXPECT_EQ(packed.forwardTerminationReasons[i], line.getForwardTerminationReason());
+    }
+}
+
+}  // namespace
+
+TEST(IntegralLineSetTest, packedToUnpacked) {
+    const auto packed = makePacked();
+    const IntegralLineSet set(packed, mat4(1));
+
+    ASSERT_NE(nullptr, set.getPacked());
+    EXPECT_EQ(size_t{3}, set.size());
+    checkLines(packed, set);
+
+    // Reading the lines keeps the packed storage
+    EXPECT_NE(nullptr, set.getPacked());
+    EXPECT_EQ(3, std::distance(set.begin(), set.end()));
+}
+
+TEST(IntegralLineSetTest, editDropsPacked) {
+    const auto packed = makePacked();
+    IntegralLineSet set(packed, mat4(1));
+
+    auto& line = set[2];
+    EXPECT_EQ(nullptr, set.getPacked());
+    checkLines(packed, set);
+
+    line.getPositions().push_back(dvec3(1.0));
+    EXPECT_EQ(size_t{3}, set[2].getPositions().size());
+
+    set.push_back(IntegralLine{}, IntegralLineSet::SetIndex::Yes);
+    EXPECT_EQ(size_t{4}, set.size());
+    EXPECT_EQ(size_t{3}, set.back().getIndex());
+}
+
+TEST(IntegralLineSetTest, copyPacked) {
+    const auto packed = makePacked();
+    IntegralLineSet set(packed, mat4(1));
+    const IntegralLineSet copy(set);
+
+    ASSERT_NE(nullptr, copy.getPacked());
+    set.front().setIndex(42);
+    EXPECT_EQ(nullptr, set.getPacked());
+    EXPECT_NE(nullptr, copy.getPacked());
+    checkLines(packed, copy);
+}
+
+TEST(IntegralLineSetTest, concurrentUnpack) {
+    const auto packed = makePacked();
+    const IntegralLineSet set(packed, mat4(1));
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> sizes(4, 0);
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        threads.emplace_back([&set, &size = sizes[i]]() {
+            for (const auto& line : set) size += line.getPositions().size();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (auto size : sizes) EXPECT_EQ(packed.positions.size(), size);
+    checkLines(packed, set);
+}
+
+TEST(IntegralLineSetTest, appendPacked) {
+    auto packed = makePacked();
+    packed.append(makePacked());
+    ASSERT_EQ(size_t{6}, packed.size());
+    EXPECT_EQ(size_t{10}, packed.positions.size());
+    EXPECT_EQ(size_t{10}, packed.getMetaData<double>("time").size());
+
+    const IntegralLineSet set(packed, mat4(1));
+    checkLines(packed, set);
+
+    auto other = makePacked();
+    other.metaData.erase("time");
+    EXPECT_THROW(packed.append(other), Exception);
+}
+
+}  // namespace inviwo
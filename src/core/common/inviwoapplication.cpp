@@ -170,6 +170,11 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
         systemSettings_->poolSize_.onChange([this]() { resizePool(systemSettings_->poolSize_); });
     }
 
+    processorNetworkEvaluator_->setConcurrentEvaluation(systemSettings_->concurrentEvaluation_);
+    systemSettings_->concurrentEvaluation_.onChange([this]() {
+        processorNetworkEvaluator_->setConcurrentEvaluation(systemSettings_->concurrentEvaluation_);
+    });
+
     resourceManager_->setEnabled(systemSettings_->enableResourceManager_.get());
     systemSettings_->enableResourceManager_.onChange(
         [this]() { resourceManager_->setEnabled(systemSettings_->enableResourceManager_.get()); });
@@ -230,7 +235,12 @@ InviwoApplication::InviwoApplication() : InviwoApplication(0, nullptr, "Inviwo")
 InviwoApplication::InviwoApplication(std::string displayName)
     : InviwoApplication(0, nullptr, displayName) {}
 
-InviwoApplication::~InviwoApplication() { resizePool(0); }
+InviwoApplication::~InviwoApplication() {
+    resizePool(0);
+    // Deliver any queued log messages and stop the log thread while the console and file loggers
+    // are still alive
+    if (LogCentral::isInitialized()) LogCentral::getPtr()->setAsync(false);
+}
 
 void InviwoApplication::registerModules(
     std::vector<std::unique_ptr<InviwoModuleFactoryObject>> moduleFactories) {
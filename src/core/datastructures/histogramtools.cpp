@@ -29,8 +29,12 @@
 
 #include <inviwo/core/datastructures/histogramtools.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/common/inviwoapplication.h>
 
+#include <algorithm>
+#include <mutex>
+
 namespace inviwo {
 
 void HistogramCalculationState::whenDone(std::function<void(const HistogramContainer&)> callback) {
@@ -41,6 +45,11 @@ void HistogramCalculationState::whenDone(std::function<void(const HistogramConta
     }
 }
 
+void HistogramCalculationState::whenProgress(
+    std::function<void(const HistogramContainer&, double)> callback) {
+    if (!done) progressCallbackHandles_.push_back(progressCallbacks_.add(callback));
+}
+
 HistogramSupplier::HistogramSupplier() : histograms_{std::make_shared<HistogramContainer>()} {}
 
 HistogramSupplier::HistogramSupplier(const HistogramSupplier& rhs)
@@ -53,28 +62,112 @@ HistogramSupplier& HistogramSupplier::operator=(const HistogramSupplier& that) {
     return *this;
 }
 
-std::shared_ptr<HistogramCalculationState> HistogramSupplier::startCalculation(
-    std::shared_ptr<const VolumeRAM> volumeRam, dvec2 dataRange, size_t bins) const {
-    if (!calculation_ || calculation_->getBins() != bins ||
-        calculation_->getDataRange() != dataRange) {
-
-        histograms_ = std::make_shared<HistogramContainer>();
-        calculation_ = std::make_shared<HistogramCalculationState>(histograms_, bins, dataRange);
-
-        dispatchPool([weakState = std::weak_ptr<HistogramCalculationState>(calculation_),
-                      stop = calculation_->stop_, volumeRam, dataRange, bins]() {
-            auto histograms = volumeRam->dispatch<HistogramContainer>([&](auto vr) {
-                return HistogramContainer(dataRange, bins, vr->getDataTyped(),
-                                          vr->getDataTyped() + glm::compMul(vr->getDimensions()));
-            });
+namespace {
+
+// Split the work into at least one and at most four jobs per pool thread
+size_t numberOfJobs(size_t items, size_t minItemsPerJob) {
+    const auto maxJobs = std::max(size_t{1}, 4 * InviwoApplication::getPtr()->getPoolSize());
+    return std::clamp(items / minItemsPerJob, size_t{1}, maxJobs);
+}
+
+}  // namespace
+
+bool HistogramSupplier::newCalculation(dvec2 dataRange, size_t bins) const {
+    if (calculation_ && calculation_->getBins() == bins &&
+        calculation_->getDataRange() == dataRange) {
+        return false;
+    }
+    histograms_ = std::make_shared<HistogramContainer>();
+    calculation_ = std::make_shared<HistogramCalculationState>(histograms_, bins, dataRange);
+    return true;
+}
+
+template <typename T, typename Job>
+void HistogramSupplier::calculate(const std::shared_ptr<HistogramCalculationState>& state,
+                                  size_t jobs, Job job) {
+    struct Merged {
+        Merged(dvec2 dataRange, size_t bins, size_t jobs)
+            : builder{dataRange, bins}, remaining{jobs} {}
+        std::mutex mutex;
+        util::HistogramBuilder<T> builder;
+        size_t remaining;
+    };
+    auto merged = std::make_shared<Merged>(state->getDataRange(), state->getBins(), jobs);
+
+    for (size_t i = 0; i < jobs; ++i) {
+        dispatchPool([weakState = std::weak_ptr<HistogramCalculationState>(state),
+                      stop = state->stop_, dataRange = state->getDataRange(),
+                      bins = state->getBins(), merged, job, i, jobs]() {
+            if (*stop) return;
+            util::HistogramBuilder<T> builder(dataRange, bins);
+            job(i, builder);
+
+            std::scoped_lock lock{merged->mutex};
+            merged->builder.merge(builder);
+            const auto finished = jobs - --merged->remaining;
             if (*stop) return;
-            dispatchFrontAndForget([hist = std::move(histograms), weakState]() {
-                if (auto s = weakState.lock()) {
-                    done(s, std::move(hist));
-                }
-            });
+
+            if (finished == jobs) {
+                dispatchFrontAndForget(
+                    [hist = HistogramContainer{merged->builder.finish()}, weakState]() {
+                        if (auto s = weakState.lock()) {
+                            done(s, std::move(hist));
+                        }
+                    });
+            } else if (finished * 10 / jobs != (finished - 1) * 10 / jobs) {
+                const auto fraction = static_cast<double>(finished) / static_cast<double>(jobs);
+                dispatchFrontAndForget(
+                    [hist = HistogramContainer{merged->builder.finish()}, fraction, weakState]() {
+                        if (auto s = weakState.lock()) {
+                            progress(s, hist, fraction);
+                        }
+                    });
+            }
         });
     }
+}
+
+std::shared_ptr<HistogramCalculationState> HistogramSupplier::startCalculation(
+    std::shared_ptr<const VolumeRAM> volumeRam, dvec2 dataRange, size_t bins) const {
+    if (!newCalculation(dataRange, bins)) return calculation_;
+
+    volumeRam->dispatch<void>([&](auto vr) {
+        using T = util::PrecisionValueType<decltype(vr)>;
+        const size_t size = glm::compMul(vr->getDimensions());
+        const auto jobs = numberOfJobs(size, size_t{1} << 18);
+
+        calculate<T>(calculation_, jobs, [volumeRam, size, jobs](size_t job, auto& builder) {
+            const auto data = static_cast<const T*>(volumeRam->getData());
+            builder.add(data + size * job / jobs, data + size * (job + 1) / jobs);
+        });
+    });
+    return calculation_;
+}
+
+std::shared_ptr<HistogramCalculationState> HistogramSupplier::startCalculation(
+    std::shared_ptr<const VolumeBricked> volumeBricked, dvec2 dataRange, size_t bins) const {
+    if (!newCalculation(dataRange, bins)) return calculation_;
+
+    // the first brick is only used to dispatch on the data format
+    volumeBricked->getBrick(size3_t{0})->dispatch<void>([&](auto vr) {
+        using T = util::PrecisionValueType<decltype(vr)>;
+        const auto bricks = volumeBricked->getNumberOfBricks();
+        const size_t size = glm::compMul(bricks);
+        const auto jobs = numberOfJobs(size, 1);
+
+        // each job handles a consecutive range of bricks
+        calculate<T>(calculation_, jobs, [volumeBricked, bricks, size, jobs](size_t job,
+                                                                              auto& builder) {
+            for (size_t i = size * job / jobs; i < size * (job + 1) / jobs; ++i) {
+                const size3_t index{i % bricks.x, (i / bricks.x) % bricks.y,
+                                    i / (bricks.x * bricks.y)};
+                const auto brick = std::static_pointer_cast<const VolumeRAMPrecision<T>>(
+                    volumeBricked->getBrick(index));
+                builder.add(brick->getDataTyped(),
+                            brick->getDataTyped() + glm::compMul(brick->getDimensions()));
+            }
+        });
+    });
     return calculation_;
 }
 
@@ -87,4 +180,10 @@ void HistogramSupplier::done(std::shared_ptr<HistogramCalculationState> state,
     }
 }
 
+void HistogramSupplier::progress(std::shared_ptr<HistogramCalculationState> state,
+                                 const HistogramContainer& histograms, double fraction) {
+    if (state->done) return;
+    state->progressCallbacks_.invoke(histograms, fraction);
+}
+
 }  // namespace inviwo
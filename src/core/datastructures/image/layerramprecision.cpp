@@ -44,6 +44,19 @@ struct LayerRAMCreationDispatcher {
     }
 };
 
+struct LayerRAMAllocationDispatcher {
+    using type = std::shared_ptr<LayerRAM>;
+    template <typename Result, typename T>
+    std::shared_ptr<LayerRAM> operator()(const size2_t& dimensions, LayerType type,
+                                         RAMAllocation allocation, const SwizzleMask& swizzleMask,
+                                         InterpolationType interpolation,
+                                         const Wrapping2D& wrapping) {
+        using F = typename T::type;
+        return std::make_shared<LayerRAMPrecision<F>>(dimensions, type, allocation, swizzleMask,
+                                                      interpolation, wrapping);
+    }
+};
+
 std::shared_ptr<LayerRAM> createLayerRAM(const size2_t& dimensions, LayerType type,
                                          const DataFormatBase* format,
                                          const SwizzleMask& swizzleMask,
@@ -54,4 +67,15 @@ std::shared_ptr<LayerRAM> createLayerRAM(const size2_t& dimensions, LayerType ty
         format->getId(), disp, dimensions, type, swizzleMask, interpolation, wrapping);
 }
 
+std::shared_ptr<LayerRAM> createLayerRAM(const size2_t& dimensions, LayerType type,
+                                         const DataFormatBase* format, RAMAllocation allocation,
+                                         const SwizzleMask& swizzleMask,
+                                         InterpolationType interpolation,
+                                         const Wrapping2D& wrapping) {
+    LayerRAMAllocationDispatcher disp;
+    return dispatching::dispatch<std::shared_ptr<LayerRAM>, dispatching::filter::All>(
+        format->getId(), disp, dimensions, type, allocation, swizzleMask, interpolation,
+        wrapping);
+}
+
 }  // namespace inviwo
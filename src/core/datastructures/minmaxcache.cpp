@@ -0,0 +1,69 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/minmaxcache.h>
+
+namespace inviwo {
+
+MinMaxCache::MinMaxCache(const MinMaxCache& rhs) {
+    std::scoped_lock lock{rhs.mutex_};
+    values_ = rhs.values_;
+    empty_ = rhs.empty_.load();
+}
+
+MinMaxCache& MinMaxCache::operator=(const MinMaxCache& that) {
+    if (this != &that) {
+        std::scoped_lock lock{mutex_, that.mutex_};
+        values_ = that.values_;
+        empty_ = that.empty_.load();
+    }
+    return *this;
+}
+
+std::optional<std::pair<dvec4, dvec4>> MinMaxCache::get(bool ignoreSpecialValues) const {
+    if (empty_) return std::nullopt;
+    std::scoped_lock lock{mutex_};
+    return values_[ignoreSpecialValues ? 1 : 0];
+}
+
+void MinMaxCache::set(bool ignoreSpecialValues, const std::pair<dvec4, dvec4>& minMax) {
+    std::scoped_lock lock{mutex_};
+    values_[ignoreSpecialValues ? 1 : 0] = minMax;
+    empty_ = false;
+}
+
+void MinMaxCache::clear() {
+    // Called on every write access, avoid taking the lock when there is nothing to clear
+    if (empty_) return;
+    std::scoped_lock lock{mutex_};
+    values_.fill(std::nullopt);
+    empty_ = true;
+}
+
+}  // namespace inviwo
@@ -0,0 +1,170 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/ramallocation.h>
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace inviwo {
+
+namespace {
+
+constexpr size_t defaultAlignment = 64;
+constexpr size_t hugePageSize = size_t{2} << 20;
+
+void* alignedAlloc(size_t bytes, size_t alignment) {
+    return ::operator new(bytes, std::align_val_t{alignment});
+}
+
+void alignedFree(void* ptr, size_t alignment) {
+    ::operator delete(ptr, std::align_val_t{alignment});
+}
+
+class RAMPool {
+public:
+    ~RAMPool() { clear(); }
+
+    void* get(size_t bytes) {
+        {
+            std::scoped_lock lock{mutex_};
+            auto it = buffers_.find(bytes);
+            if (it != buffers_.end() && !it->second.empty()) {
+                auto ptr = it->second.back();
+                it->second.pop_back();
+                size_ -= bytes;
+                return ptr;
+            }
+        }
+        return alignedAlloc(bytes, defaultAlignment);
+    }
+
+    void release(void* ptr, size_t bytes) {
+        {
+            std::scoped_lock lock{mutex_};
+            if (size_ + bytes <= capacity_) {
+                buffers_[bytes].push_back(ptr);
+                size_ += bytes;
+                return;
+            }
+        }
+        alignedFree(ptr, defaultAlignment);
+    }
+
+    void setCapacity(size_t bytes) {
+        std::vector<void*> freed;
+        {
+            std::scoped_lock lock{mutex_};
+            capacity_ = bytes;
+            // drop the largest buffers first until the pool fits
+            for (auto it = buffers_.rbegin(); it != buffers_.rend() && size_ > capacity_; ++it) {
+                while (!it->second.empty() && size_ > capacity_) {
+                    freed.push_back(it->second.back());
+                    it->second.pop_back();
+                    size_ -= it->first;
+                }
+            }
+        }
+        for (auto ptr : freed) alignedFree(ptr, defaultAlignment);
+    }
+
+    size_t getCapacity() const {
+        std::scoped_lock lock{mutex_};
+        return capacity_;
+    }
+
+    void clear() {
+        std::map<size_t, std::vector<void*>> buffers;
+        {
+            std::scoped_lock lock{mutex_};
+            std::swap(buffers, buffers_);
+            size_ = 0;
+        }
+        for (auto& item : buffers) {
+            for (auto ptr : item.second) alignedFree(ptr, defaultAlignment);
+        }
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<size_t, std::vector<void*>> buffers_;
+    size_t size_ = 0;
+    size_t capacity_ = size_t{1} << 30;
+};
+
+// Buffers hold on to the pool, that way it outlives any static volume or layer
+const std::shared_ptr<RAMPool>& pool() {
+    static const auto pool = std::make_shared<RAMPool>();
+    return pool;
+}
+
+}  // namespace
+
+std::shared_ptr<void> util::allocateRAM(size_t bytes, RAMAllocation allocation) {
+    switch (allocation) {
+        case RAMAllocation::Zeroed: {
+            auto ptr = alignedAlloc(bytes, defaultAlignment);
+            std::memset(ptr, 0, bytes);
+            return {ptr, [](void* p) { alignedFree(p, defaultAlignment); }};
+        }
+        case RAMAllocation::HugePages: {
+            if (bytes < hugePageSize) return allocateRAM(bytes, RAMAllocation::Uninitialized);
+            auto ptr = alignedAlloc(bytes, hugePageSize);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            // Only a hint for transparent huge pages, failure just means normal pages
+            madvise(ptr, bytes - bytes % hugePageSize, MADV_HUGEPAGE);
+#endif
+            return {ptr, [](void* p) { alignedFree(p, hugePageSize); }};
+        }
+        case RAMAllocation::Pooled: {
+            auto ptr = pool()->get(bytes);
+            return {ptr, [bytes, p = pool()](void* ptr) { p->release(ptr, bytes); }};
+        }
+        case RAMAllocation::Uninitialized:
+        default: {
+            auto ptr = alignedAlloc(bytes, defaultAlignment);
+            return {ptr, [](void* p) { alignedFree(p, defaultAlignment); }};
+        }
+    }
+}
+
+void util::setRAMPoolCapacity(size_t bytes) { pool()->setCapacity(bytes); }
+
+size_t util::getRAMPoolCapacity() { return pool()->getCapacity(); }
+
+void util::clearRAMPool() { pool()->clear(); }
+
+}  // namespace inviwo
@@ -34,6 +34,7 @@
 #include <inviwo/core/util/vectoroperations.h>
 
 #include <algorithm>
+#include <iterator>
 #include <set>
 
 namespace inviwo {
@@ -377,30 +378,37 @@ vec4 TFPrimitiveSet::interpolateColor(double t) const {
     return glm::mix(it->getColor(), next->getColor(), x);
 }
 
-void TFPrimitiveSet::interpolateAndStoreColors(vec4* dataArray, const size_t dataSize) const {
-    const auto toInd = [&](const TFPrimitive& p) {
-        return static_cast<size_t>(ceil(p.getPosition() * (dataSize - 1)));
+namespace {
+
+template <typename Iter, typename Pos, typename Color>
+void interpolateAndStore(Iter begin, Iter end, Pos pos, Color color, vec4* dataArray,
+                         const size_t dataSize) {
+    const auto toInd = [&](const auto& p) {
+        return static_cast<size_t>(ceil(pos(p) * (dataSize - 1)));
     };
+    const auto count = std::distance(begin, end);
 
-    if (empty()) {  // in case of 0 points
+    if (count == 0) {  // in case of 0 points
         std::fill(dataArray, dataArray + dataSize, vec4(0.0f));
-    } else if (size() == 1) {  // in case of 1 point
-        std::fill(dataArray, dataArray + dataSize, front().getColor());
+    } else if (count == 1) {  // in case of 1 point
+        std::fill(dataArray, dataArray + dataSize, color(*begin));
     } else {  // in case of more than 1 points
-        const size_t leftX = toInd(front());
-        const size_t rightX = toInd(back());
+        const auto& front = *begin;
+        const auto& back = *std::next(begin, count - 1);
+        const size_t leftX = toInd(front);
+        const size_t rightX = toInd(back);
 
-        std::fill(dataArray, dataArray + leftX + 1, front().getColor());
-        std::fill(dataArray + rightX, dataArray + dataSize, back().getColor());
+        std::fill(dataArray, dataArray + leftX + 1, color(front));
+        std::fill(dataArray + rightX, dataArray + dataSize, color(back));
 
-        auto pLeft = begin();
-        auto pRight = ++begin();
+        auto pLeft = begin;
+        auto pRight = std::next(begin);
 
-        while (pRight != end()) {
-            const auto lrgba = pLeft->getColor();
-            const auto rrgba = pRight->getColor();
-            const auto lx = pLeft->getPosition() * (dataSize - 1);
-            const auto rx = pRight->getPosition() * (dataSize - 1);
+        while (pRight != end) {
+            const auto lrgba = color(*pLeft);
+            const auto rrgba = color(*pRight);
+            const auto lx = pos(*pLeft) * (dataSize - 1);
+            const auto rx = pos(*pRight) * (dataSize - 1);
 
             for (size_t n = toInd(*pLeft); n < toInd(*pRight); ++n) {
                 const float x = static_cast<float>((n - lx) / (rx - lx));
@@ -412,6 +420,21 @@ void TFPrimitiveSet::interpolateAndStoreColors(vec4* dataArray, const size_t dat
     }
 }
 
+}  // namespace
+
+void TFPrimitiveSet::interpolateAndStoreColors(vec4* dataArray, const size_t dataSize) const {
+    interpolateAndStore(
+        begin(), end(), [](const TFPrimitive& p) { return p.getPosition(); },
+        [](const TFPrimitive& p) { return p.getColor(); }, dataArray, dataSize);
+}
+
+void TFPrimitiveSet::interpolateAndStoreColors(const std::vector<TFPrimitiveData>& points,
+                                               vec4* dataArray, const size_t dataSize) {
+    interpolateAndStore(
+        points.begin(), points.end(), [](const TFPrimitiveData& p) { return p.pos; },
+        [](const TFPrimitiveData& p) { return p.color; }, dataArray, dataSize);
+}
+
 void TFPrimitiveSet::flipPositions(const std::vector<TFPrimitive*>& primitives) {
     dvec2 range{};
     std::vector<TFPrimitive*> selection;
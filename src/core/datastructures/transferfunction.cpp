@@ -45,6 +45,9 @@
 #include <inviwo/core/util/zip.h>
 
 #include <cmath>
+#include <limits>
+#include <queue>
+#include <tuple>
 
 namespace inviwo {
 
@@ -219,6 +222,8 @@ void TransferFunction::load(const std::string& filename, const FileExtension& ex
 
             const auto simplified = simplify(points, 0.01);
             this->add(simplified);
+            // The TF now consists of exactly the simplified points, fill the texture from them
+            this->calcTransferValues(simplified);
         });
     }
 }
@@ -226,34 +231,71 @@ void TransferFunction::load(const std::string& filename, const FileExtension& ex
 std::vector<TFPrimitiveData> TransferFunction::simplify(const std::vector<TFPrimitiveData>& points,
                                                         double delta) {
     if (points.size() < 3) return points;
-    std::vector<TFPrimitiveData> simple{points};
+    const auto size = points.size();
+
+    // The remaining points form a doubly linked list over the indices into points
+    std::vector<size_t> prev(size);
+    std::vector<size_t> next(size);
+    for (size_t i = 0; i < size; ++i) {
+        prev[i] = i - 1;
+        next[i] = i + 1;
+    }
 
     // Calculate the error resulting from using a linear interpolation between the prev and next
     // point instead of including the current one
     const auto error = [&](size_t i) {
-        const auto& prev = simple[i - 1];
-        const auto& curr = simple[i];
-        const auto& next = simple[i + 1];
-
-        const double x = (curr.pos - prev.pos) / (next.pos - prev.pos);
-        return glm::compMax(glm::abs(glm::mix(prev.color, next.color, x) - curr.color));
+        const auto& p = points[prev[i]];
+        const auto& curr = points[i];
+        const auto& n = points[next[i]];
+
+        const double x = (curr.pos - p.pos) / (n.pos - p.pos);
+        const auto err = glm::compMax(glm::abs(glm::mix(p.color, n.color, x) - curr.color));
+        // Coinciding neighbors give NaN, never remove such a point
+        return std::isnan(err) ? std::numeric_limits<decltype(err)>::infinity() : err;
     };
+    using Error = decltype(error(1));
 
-    // Find the point which will result in the smallest error when removed.
-    const auto nextToRemove = [&]() {
-        const auto index = util::make_sequence<size_t>(1, simple.size() - 1, 1);
-        return *std::min_element(index.begin(), index.end(),
-                                 [&](size_t a, size_t b) { return error(a) < error(b); });
+    struct Candidate {
+        Error error;
+        size_t index;
+        size_t version;
+    };
+    // Order by smallest error first, and then by position, as a linear search would
+    const auto worse = [](const Candidate& a, const Candidate& b) {
+        return std::tie(a.error, a.index) > std::tie(b.error, b.index);
     };
+    // Errors in the queue go stale when a neighbor is removed, a candidate is only valid if its
+    // version matches the current version of the point
+    std::vector<size_t> version(size, 0);
+    std::vector<Candidate> candidates;
+    candidates.reserve(size - 2);
+    for (size_t i = 1; i < size - 1; ++i) candidates.push_back({error(i), i, 0});
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(worse)> queue{
+        worse, std::move(candidates)};
 
     // Iteratively remove the point with the smallest error until the error gets larger then delta
     // or only 2 points are left
-    auto toRemove = nextToRemove();
-    while (error(toRemove) < delta && simple.size() > 2) {
-        simple.erase(simple.begin() + toRemove);
-        toRemove = nextToRemove();
+    size_t remaining = size;
+    while (remaining > 2 && !queue.empty()) {
+        const auto candidate = queue.top();
+        queue.pop();
+        if (candidate.version != version[candidate.index]) continue;
+        if (!(candidate.error < delta)) break;
+
+        const auto i = candidate.index;
+        next[prev[i]] = next[i];
+        prev[next[i]] = prev[i];
+        --remaining;
+
+        for (auto neighbor : {prev[i], next[i]}) {
+            if (neighbor == 0 || neighbor == size - 1) continue;
+            queue.push({error(neighbor), neighbor, ++version[neighbor]});
+        }
     }
 
+    std::vector<TFPrimitiveData> simple;
+    simple.reserve(remaining);
+    for (size_t i = 0; i < size; i = next[i]) simple.push_back(points[i]);
     return simple;
 }
 
@@ -261,11 +303,24 @@ void TransferFunction::calcTransferValues() const {
     ivwAssert(std::is_sorted(sorted_.begin(), sorted_.end(), comparePtr{}), "Should be sorted");
 
     // We assume the the points a sorted here.
+    interpolateAndStoreColors(dataRepr_->getDataTyped(), dataRepr_->getDimensions().x);
+    applyMaskAndUpdate();
+}
+
+void TransferFunction::calcTransferValues(const std::vector<TFPrimitiveData>& points) const {
+    ivwAssert(std::is_sorted(points.begin(), points.end(),
+                             [](const auto& a, const auto& b) { return a.pos < b.pos; }),
+              "Should be sorted");
+
+    TFPrimitiveSet::interpolateAndStoreColors(points, dataRepr_->getDataTyped(),
+                                              dataRepr_->getDimensions().x);
+    applyMaskAndUpdate();
+}
+
+void TransferFunction::applyMaskAndUpdate() const {
     auto dataArray = dataRepr_->getDataTyped();
     const auto size = dataRepr_->getDimensions().x;
 
-    interpolateAndStoreColors(dataArray, size);
-
     for (size_t i = 0; i < size_t(maskMin_ * size); i++) dataArray[i].a = 0.0;
     for (size_t i = size_t(maskMax_ * size); i < size; i++) dataArray[i].a = 0.0;
 
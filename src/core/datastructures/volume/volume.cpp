@@ -29,6 +29,7 @@
 
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/util/document.h>
 
 namespace inviwo {
@@ -40,6 +41,7 @@ Volume::Volume(size3_t defaultDimensions, const DataFormatBase* defaultFormat,
     , StructuredGridEntity<3>{}
     , MetaDataOwner{}
     , HistogramSupplier{}
+    , VolumePyramidSupplier{}
     , dataMap_{defaultFormat}
     , defaultDimensions_{defaultDimensions}
     , defaultDataFormat_{defaultFormat}
@@ -52,6 +54,7 @@ Volume::Volume(std::shared_ptr<VolumeRepresentation> in)
     , StructuredGridEntity<3>{}
     , MetaDataOwner{}
     , HistogramSupplier{}
+    , VolumePyramidSupplier{}
     , dataMap_{in->getDataFormat()}
     , defaultDimensions_{in->getDimensions()}
     , defaultDataFormat_{in->getDataFormat()}
@@ -67,6 +70,7 @@ Volume::~Volume() = default;
 
 void Volume::setDimensions(const size3_t& dim) {
     defaultDimensions_ = dim;
+    resetPyramid();
 
     if (lastValidRepresentation_) {
         // Resize last valid representation
@@ -221,12 +225,21 @@ const StructuredCameraCoordinateTransformer<3>& Volume::getCoordinateTransformer
 }
 
 std::shared_ptr<HistogramCalculationState> Volume::calculateHistograms(size_t bins) const {
+    // avoid loading all of the volume if it is only on disk
+    if (auto bricked = util::getBrickedRepresentation(*this)) {
+        return HistogramSupplier::startCalculation(
+            std::shared_ptr<const VolumeBricked>(bricked->clone()), dataMap_.dataRange, bins);
+    }
 
     getRepresentation<VolumeRAM>();  // make sure lastValidRepresentation_ is VolumeRAM
     return HistogramSupplier::startCalculation(
         std::static_pointer_cast<VolumeRAM>(lastValidRepresentation_), dataMap_.dataRange, bins);
 }
 
+const VolumePyramid& Volume::getPyramid() const {
+    return VolumePyramidSupplier::getPyramid(*this);
+}
+
 template class IVW_CORE_TMPL_INST DataReaderType<Volume>;
 template class IVW_CORE_TMPL_INST DataWriterType<Volume>;
 template class IVW_CORE_TMPL_INST DataReaderType<VolumeSequence>;
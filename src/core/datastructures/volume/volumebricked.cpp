@@ -0,0 +1,309 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/exception.h>
+
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace inviwo {
+
+namespace {
+
+/*
+ * Copy the box [srcOffset, srcOffset + extent) of src into [dstOffset, dstOffset + extent) of dst,
+ * one x-row at the time.
+ */
+void copyRegion(const void* src, size3_t srcDims, size3_t srcOffset, void* dst, size3_t dstDims,
+                size3_t dstOffset, size3_t extent, size_t voxelSize) {
+    const auto srcData = static_cast<const char*>(src);
+    const auto dstData = static_cast<char*>(dst);
+    const auto rowSize = extent.x * voxelSize;
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            const auto srcIndex =
+                ((srcOffset.z + z) * srcDims.y + srcOffset.y + y) * srcDims.x + srcOffset.x;
+            const auto dstIndex =
+                ((dstOffset.z + z) * dstDims.y + dstOffset.y + y) * dstDims.x + dstOffset.x;
+            std::memcpy(dstData + dstIndex * voxelSize, srcData + srcIndex * voxelSize, rowSize);
+        }
+    }
+}
+
+size_t sizeInBytes(const VolumeRAM& volume) {
+    return glm::compMul(volume.getDimensions()) * volume.getDataFormat()->getSize();
+}
+
+}  // namespace
+
+/*
+ * Least recently used cache of bricks, keyed by linear brick index. Loading is done without holding
+ * the lock, so several bricks can be loaded concurrently.
+ */
+class VolumeBricked::BrickCache {
+public:
+    explicit BrickCache(size_t capacity) : capacity_{capacity} {}
+
+    template <typename Load>
+    std::shared_ptr<const VolumeRAM> get(size_t key, Load&& load) {
+        {
+            std::scoped_lock lock{mutex_};
+            if (auto brick = find(key)) return brick;
+        }
+
+        std::shared_ptr<const VolumeRAM> loaded = load();
+
+        std::scoped_lock lock{mutex_};
+        // some other thread might have loaded the brick in the meantime
+        if (auto brick = find(key)) return brick;
+
+        lru_.emplace_front(key, loaded);
+        map_[key] = lru_.begin();
+        size_ += sizeInBytes(*loaded);
+        evict();
+        return loaded;
+    }
+
+    void setCapacity(size_t capacity) {
+        std::scoped_lock lock{mutex_};
+        capacity_ = capacity;
+        evict();
+    }
+    size_t getCapacity() const {
+        std::scoped_lock lock{mutex_};
+        return capacity_;
+    }
+    size_t getSize() const {
+        std::scoped_lock lock{mutex_};
+        return size_;
+    }
+    void clear() {
+        std::scoped_lock lock{mutex_};
+        lru_.clear();
+        map_.clear();
+        size_ = 0;
+    }
+
+private:
+    std::shared_ptr<const VolumeRAM> find(size_t key) {
+        auto it = map_.find(key);
+        if (it == map_.end()) return nullptr;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+
+    void evict() {
+        while (size_ > capacity_ && lru_.size() > 1) {
+            size_ -= sizeInBytes(*lru_.back().second);
+            map_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+    }
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    size_t size_ = 0;
+    std::list<std::pair<size_t, std::shared_ptr<const VolumeRAM>>> lru_;
+    std::unordered_map<size_t, decltype(lru_)::iterator> map_;
+};
+
+VolumeBricked::VolumeBricked(std::shared_ptr<const VolumeDisk> source, size3_t brickDimensions,
+                             size_t cacheSize)
+    : VolumeRepresentation(source ? source->getDataFormat() : DataUInt8::get())
+    , source_{std::move(source)}
+    , brickDimensions_{glm::max(brickDimensions, size3_t{1})}
+    , swizzleMask_{swizzlemasks::rgba}
+    , interpolation_{InterpolationType::Linear}
+    , wrapping_{wrapping3d::clampAll}
+    , cache_{std::make_shared<BrickCache>(cacheSize)} {
+    if (!source_) throw Exception("VolumeBricked requires a source", IVW_CONTEXT);
+    if (!source_->canReadRegion()) {
+        throw Exception("VolumeBricked requires a source that can read regions", IVW_CONTEXT);
+    }
+    swizzleMask_ = source_->getSwizzleMask();
+    interpolation_ = source_->getInterpolation();
+    wrapping_ = source_->getWrapping();
+}
+
+VolumeBricked* VolumeBricked::clone() const { return new VolumeBricked(*this); }
+
+std::type_index VolumeBricked::getTypeIndex() const {
+    return std::type_index(typeid(VolumeBricked));
+}
+
+void VolumeBricked::setDimensions(size3_t) {
+    throw Exception("Can not set dimension of a Volume Bricked", IVW_CONTEXT);
+}
+
+const size3_t& VolumeBricked::getDimensions() const { return source_->getDimensions(); }
+
+void VolumeBricked::setSwizzleMask(const SwizzleMask& mask) { swizzleMask_ = mask; }
+
+SwizzleMask VolumeBricked::getSwizzleMask() const { return swizzleMask_; }
+
+void VolumeBricked::setInterpolation(InterpolationType interpolation) {
+    interpolation_ = interpolation;
+}
+
+InterpolationType VolumeBricked::getInterpolation() const { return interpolation_; }
+
+void VolumeBricked::setWrapping(const Wrapping3D& wrapping) { wrapping_ = wrapping; }
+
+Wrapping3D VolumeBricked::getWrapping() const { return wrapping_; }
+
+const std::shared_ptr<const VolumeDisk>& VolumeBricked::getSource() const { return source_; }
+
+void VolumeBricked::setSource(std::shared_ptr<const VolumeDisk> source) {
+    if (!source) throw Exception("VolumeBricked requires a source", IVW_CONTEXT);
+    if (!source->canReadRegion()) {
+        throw Exception("VolumeBricked requires a source that can read regions", IVW_CONTEXT);
+    }
+    source_ = std::move(source);
+    setDataFormat(source_->getDataFormat());
+    swizzleMask_ = source_->getSwizzleMask();
+    interpolation_ = source_->getInterpolation();
+    wrapping_ = source_->getWrapping();
+    // Don't clear the old cache, clones might still use it
+    cache_ = std::make_shared<BrickCache>(cache_->getCapacity());
+}
+
+size3_t VolumeBricked::getBrickDimensions() const { return brickDimensions_; }
+
+size3_t VolumeBricked::getNumberOfBricks() const {
+    return (getDimensions() + brickDimensions_ - size3_t{1}) / brickDimensions_;
+}
+
+size3_t VolumeBricked::getBrickOffset(size3_t brick) const { return brick * brickDimensions_; }
+
+size3_t VolumeBricked::getBrickExtent(size3_t brick) const {
+    const auto offset = getBrickOffset(brick);
+    return glm::min(offset + brickDimensions_, getDimensions()) - offset;
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::getBrick(size3_t brick) const {
+    const auto bricks = getNumberOfBricks();
+    if (glm::any(glm::greaterThanEqual(brick, bricks))) {
+        throw RangeException("Brick index is outside of the volume", IVW_CONTEXT);
+    }
+
+    const auto key = (brick.z * bricks.y + brick.y) * bricks.x + brick.x;
+    return cache_->get(key, [&]() -> std::shared_ptr<const VolumeRAM> {
+        const auto offset = getBrickOffset(brick);
+        const auto extent = getBrickExtent(brick);
+        // bricks are read completely, and evicted bricks free buffers of the same size
+        auto ram = createVolumeRAM(extent, getDataFormat(), RAMAllocation::Pooled, swizzleMask_,
+                                   interpolation_, wrapping_);
+        source_->readRegion(offset, extent, ram->getData());
+        return ram;
+    });
+}
+
+void VolumeBricked::prefetch(size3_t offset, size3_t extent) const {
+    if (glm::compMul(extent) == 0) return;
+    const auto last = glm::min(offset + extent, getDimensions()) - size3_t{1};
+    const auto firstBrick = offset / brickDimensions_;
+    const auto lastBrick = last / brickDimensions_;
+
+    // the clone shares the source and the cache, and keeps them alive while loading
+    std::shared_ptr<const VolumeBricked> self{clone()};
+    for (size_t z = firstBrick.z; z <= lastBrick.z; ++z) {
+        for (size_t y = firstBrick.y; y <= lastBrick.y; ++y) {
+            for (size_t x = firstBrick.x; x <= lastBrick.x; ++x) {
+                const size3_t brick{x, y, z};
+                if (InviwoApplication::isInitialized()) {
+                    dispatchPool([self, brick]() { self->getBrick(brick); });
+                } else {
+                    self->getBrick(brick);
+                }
+            }
+        }
+    }
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked::getRegion(size3_t offset, size3_t extent) const {
+    const auto end = offset + extent;
+    if (glm::any(glm::greaterThan(end, getDimensions()))) {
+        throw RangeException("The region is outside of the volume", IVW_CONTEXT);
+    }
+
+    auto dest = createVolumeRAM(extent, getDataFormat(), RAMAllocation::Uninitialized,
+                                swizzleMask_, interpolation_, wrapping_);
+    if (glm::compMul(extent) == 0) return dest;
+
+    const auto firstBrick = offset / brickDimensions_;
+    const auto lastBrick = (end - size3_t{1}) / brickDimensions_;
+    for (size_t z = firstBrick.z; z <= lastBrick.z; ++z) {
+        for (size_t y = firstBrick.y; y <= lastBrick.y; ++y) {
+            for (size_t x = firstBrick.x; x <= lastBrick.x; ++x) {
+                const size3_t brick{x, y, z};
+                const auto data = getBrick(brick);
+                const auto brickOffset = getBrickOffset(brick);
+                const auto brickEnd = brickOffset + data->getDimensions();
+
+                const auto from = glm::max(offset, brickOffset);
+                const auto to = glm::min(end, brickEnd);
+                copyRegion(data->getData(), data->getDimensions(), from - brickOffset,
+                           dest->getData(), extent, from - offset, to - from,
+                           getDataFormat()->getSize());
+            }
+        }
+    }
+    return dest;
+}
+
+void VolumeBricked::setCacheSize(size_t bytes) { cache_->setCapacity(bytes); }
+
+size_t VolumeBricked::getCacheSize() const { return cache_->getCapacity(); }
+
+size_t VolumeBricked::getCachedBytes() const { return cache_->getSize(); }
+
+void VolumeBricked::clearCache() const { cache_->clear(); }
+
+const VolumeBricked* util::getBrickedRepresentation(const Volume& volume) {
+    if (volume.hasValidRepresentation<VolumeRAM>()) return nullptr;
+    if (volume.hasValidRepresentation<VolumeBricked>()) {
+        return volume.getRepresentation<VolumeBricked>();
+    }
+    // Only worth it if the bricks can be read directly, otherwise the whole volume would have to
+    // be loaded anyway
+    if (volume.hasValidRepresentation<VolumeDisk>() &&
+        volume.getRepresentation<VolumeDisk>()->canReadRegion()) {
+        return volume.getRepresentation<VolumeBricked>();
+    }
+    return nullptr;
+}
+
+}  // namespace inviwo
@@ -75,4 +75,17 @@ void VolumeDisk::setWrapping(const Wrapping3D& wrapping) { wrapping_ = wrapping;
 
 Wrapping3D VolumeDisk::getWrapping() const { return wrapping_; }
 
+bool VolumeDisk::canReadRegion() const {
+    return dynamic_cast<const VolumeRegionLoader*>(getLoader()) != nullptr;
+}
+
+void VolumeDisk::readRegion(size3_t offset, size3_t extent, void* dest) const {
+    auto loader = dynamic_cast<const VolumeRegionLoader*>(getLoader());
+    if (!loader) throw Exception("The loader can not read parts of the volume", IVW_CONTEXT);
+    if (glm::any(glm::greaterThan(offset + extent, dimensions_))) {
+        throw Exception("The region is outside of the volume", IVW_CONTEXT);
+    }
+    loader->readRegion(*this, offset, extent, dest);
+}
+
 }  // namespace inviwo
@@ -0,0 +1,283 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumepyramid.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace inviwo {
+
+namespace {
+
+size3_t halve(size3_t dims) { return (dims + size3_t{1}) / size3_t{2}; }
+
+template <typename T>
+T roundedDivideBy8(T sum) {
+    if constexpr (std::is_signed_v<T>) {
+        return sum >= 0 ? (sum + 4) / 8 : (sum - 4) / 8;
+    } else {
+        return (sum + 4) / 8;
+    }
+}
+
+/*
+ * Mean of eight values, integers are rounded to nearest with halves away from zero
+ */
+template <typename C>
+C mean8(const std::array<C, 8>& values) {
+    if constexpr (!std::is_integral_v<C>) {
+        double sum = 0.0;
+        for (auto v : values) sum += static_cast<double>(v);
+        return static_cast<C>(sum / 8.0);
+    } else if constexpr (sizeof(C) < sizeof(std::int64_t)) {
+        using A = std::conditional_t<std::is_signed_v<C>, std::int64_t, std::uint64_t>;
+        A sum = 0;
+        for (auto v : values) sum += static_cast<A>(v);
+        return static_cast<C>(roundedDivideBy8(sum));
+    } else {
+        // The sum of eight 64-bit values can overflow. Write each value as 8 * q + r with
+        // 0 <= r < 8 and sum the quotients and the remainders separately, the sum of the
+        // quotients is then bounded by the extremes of the values.
+        C q = 0;
+        C r = 0;
+        for (auto v : values) {
+            C vq = v / 8;
+            C vr = v % 8;
+            if constexpr (std::is_signed_v<C>) {
+                if (vr < 0) {
+                    vr += 8;
+                    --vq;
+                }
+            }
+            q += vq;
+            r += vr;
+        }
+        q += r / 8;
+        r %= 8;
+        // sum = 8 * q + r, which is negative exactly when q is
+        if constexpr (std::is_signed_v<C>) {
+            if (q < 0) return r > 4 ? q + 1 : q;
+        }
+        return r >= 4 ? q + 1 : q;
+    }
+}
+
+}  // namespace
+
+VolumePyramid::VolumePyramid(const Volume& volume)
+    : volume_{volume}, dimensions_{volume.getDimensions()} {
+    levels_.resize(getNumberOfLevels());
+    files_.resize(levels_.size());
+}
+
+const Volume& VolumePyramid::getVolume() const { return volume_; }
+
+size_t VolumePyramid::getNumberOfLevels() const {
+    size_t levels = 1;
+    for (auto dims = dimensions_; glm::compMax(dims) > 1; dims = halve(dims)) {
+        ++levels;
+    }
+    return levels;
+}
+
+size3_t VolumePyramid::getLevelDimensions(size_t level) const {
+    auto dims = dimensions_;
+    for (size_t i = 0; i < level; ++i) {
+        dims = halve(dims);
+    }
+    return dims;
+}
+
+size_t VolumePyramid::getLevelFor(size_t maxVoxels) const {
+    const auto levels = getNumberOfLevels();
+    auto dims = dimensions_;
+    for (size_t level = 0; level < levels; ++level, dims = halve(dims)) {
+        if (glm::compMul(dims) <= maxVoxels) return level;
+    }
+    return levels - 1;
+}
+
+std::shared_ptr<const Volume> VolumePyramid::getLevel(size_t level) const {
+    if (level == 0 || level >= levels_.size()) {
+        throw RangeException("Pyramid level " + std::to_string(level) + " does not exist",
+                             IVW_CONTEXT);
+    }
+
+    std::scoped_lock lock{mutex_};
+    size_t first = level;
+    while (first > 0 && !levels_[first]) --first;
+
+    for (size_t i = first + 1; i <= level; ++i) {
+        levels_[i] = createLevel(i == 1 ? volume_ : *levels_[i - 1]);
+    }
+    return levels_[level];
+}
+
+std::shared_ptr<const Volume> VolumePyramid::createLevel(const Volume& previous) const {
+    auto volume =
+        std::make_shared<Volume>(util::volumeSubSample2x(previous.getRepresentation<VolumeRAM>()));
+    volume->copyMetaDataFrom(volume_);
+    volume->dataMap_ = volume_.dataMap_;
+    volume->setModelMatrix(volume_.getModelMatrix());
+    volume->setWorldMatrix(volume_.getWorldMatrix());
+    return volume;
+}
+
+bool VolumePyramid::hasLevel(size_t level) const {
+    std::scoped_lock lock{mutex_};
+    return level == 0 || (level < levels_.size() && levels_[level]);
+}
+
+bool VolumePyramid::setLevel(size_t level, std::shared_ptr<const Volume> volume,
+                             const std::string& file) const {
+    if (level == 0 || level >= levels_.size()) {
+        throw RangeException("Pyramid level " + std::to_string(level) + " does not exist",
+                             IVW_CONTEXT);
+    }
+    if (volume->getDimensions() != getLevelDimensions(level) ||
+        volume->getDataFormat() != volume_.getDataFormat()) {
+        throw Exception("Volume does not match pyramid level " + std::to_string(level),
+                        IVW_CONTEXT);
+    }
+
+    std::scoped_lock lock{mutex_};
+    if (levels_[level]) return false;
+    levels_[level] = std::move(volume);
+    files_[level] = file;
+    return true;
+}
+
+std::string VolumePyramid::getLevelFile(size_t level) const {
+    std::scoped_lock lock{mutex_};
+    return level < files_.size() ? files_[level] : std::string{};
+}
+
+void VolumePyramid::setLevelFile(size_t level, const std::string& file) const {
+    std::scoped_lock lock{mutex_};
+    if (level < files_.size()) files_[level] = file;
+}
+
+VolumePyramidSupplier::VolumePyramidSupplier(const VolumePyramidSupplier&) {}
+
+VolumePyramidSupplier& VolumePyramidSupplier::operator=(const VolumePyramidSupplier& that) {
+    if (this != &that) resetPyramid();
+    return *this;
+}
+
+bool VolumePyramidSupplier::hasPyramid() const {
+    std::scoped_lock lock{mutex_};
+    return pyramid_ != nullptr;
+}
+
+const VolumePyramid& VolumePyramidSupplier::getPyramid(const Volume& volume) const {
+    std::scoped_lock lock{mutex_};
+    if (!pyramid_) pyramid_ = std::make_unique<VolumePyramid>(volume);
+    return *pyramid_;
+}
+
+void VolumePyramidSupplier::resetPyramid() {
+    std::scoped_lock lock{mutex_};
+    pyramid_.reset();
+}
+
+std::shared_ptr<VolumeRAM> util::volumeSubSample2x(const VolumeRAM* volume) {
+    return volume->dispatch<std::shared_ptr<VolumeRAM>>(
+        [](auto srcVol) -> std::shared_ptr<VolumeRAM> {
+            using ValueType = util::PrecisionValueType<decltype(srcVol)>;
+            using C = typename util::value_type<ValueType>::type;
+
+            const size3_t srcDims{srcVol->getDimensions()};
+            const size3_t destDims{halve(srcDims)};
+
+            auto destVol = std::make_shared<VolumeRAMPrecision<ValueType>>(
+                destDims, RAMAllocation::Uninitialized, srcVol->getSwizzleMask(),
+                srcVol->getInterpolation(), srcVol->getWrapping());
+
+            const auto src = srcVol->getDataTyped();
+            auto dst = destVol->getDataTyped();
+
+            util::IndexMapper3D o(srcDims);
+            util::IndexMapper3D n(destDims);
+
+#pragma omp parallel for
+            for (long long z_ = 0; z_ < static_cast<long long>(destDims.z); ++z_) {
+                const size_t z = static_cast<size_t>(z_);  // OpenMP need signed integral type.
+                // repeat the last voxel for odd dimensions
+                const size_t z0 = std::min(2 * z, srcDims.z - 1);
+                const size_t z1 = std::min(2 * z + 1, srcDims.z - 1);
+                for (size_t y = 0; y < destDims.y; ++y) {
+                    const size_t y0 = std::min(2 * y, srcDims.y - 1);
+                    const size_t y1 = std::min(2 * y + 1, srcDims.y - 1);
+                    for (size_t x = 0; x < destDims.x; ++x) {
+                        const size_t x0 = std::min(2 * x, srcDims.x - 1);
+                        const size_t x1 = std::min(2 * x + 1, srcDims.x - 1);
+
+                        const std::array<ValueType, 8> values{
+                            src[o(x0, y0, z0)], src[o(x1, y0, z0)], src[o(x0, y1, z0)],
+                            src[o(x1, y1, z0)], src[o(x0, y0, z1)], src[o(x1, y0, z1)],
+                            src[o(x0, y1, z1)], src[o(x1, y1, z1)]};
+
+                        ValueType res{};
+                        for (size_t c = 0; c < util::flat_extent<ValueType>::value; ++c) {
+                            std::array<C, 8> components;
+                            for (size_t i = 0; i < 8; ++i) {
+                                components[i] = util::glmcomp(values[i], c);
+                            }
+                            util::glmcomp(res, c) = mean8(components);
+                        }
+                        dst[n(x, y, z)] = res;
+                    }
+                }
+            }
+
+            return destVol;
+        });
+}
+
+std::shared_ptr<const Volume> util::getVolumePyramidLevel(std::shared_ptr<const Volume> volume,
+                                                          size_t level) {
+    if (level == 0) return volume;
+    return volume->getPyramid().getLevel(level);
+}
+
+std::shared_ptr<const Volume> util::getVolumeWithMaxVoxels(std::shared_ptr<const Volume> volume,
+                                                           size_t maxVoxels) {
+    const auto level = volume->getPyramid().getLevelFor(maxVoxels);
+    return getVolumePyramidLevel(std::move(volume), level);
+}
+
+}  // namespace inviwo
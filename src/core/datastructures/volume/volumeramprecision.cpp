@@ -34,23 +34,64 @@ namespace inviwo {
 struct VolumeRamCreationDispatcher {
     using type = std::shared_ptr<VolumeRAM>;
     template <typename Result, typename T>
-    std::shared_ptr<VolumeRAM> operator()(void* dataPtr, const size3_t& dimensions,
+    std::shared_ptr<VolumeRAM> operator()(void* dataPtr, std::shared_ptr<void> dataOwner,
+                                          const size3_t& dimensions,
                                           const SwizzleMask& swizzleMask,
                                           InterpolationType interpolation,
                                           const Wrapping3D& wrapping) {
         using F = typename T::type;
+        if (dataOwner) {
+            return std::make_shared<VolumeRAMPrecision<F>>(static_cast<F*>(dataPtr),
+                                                           std::move(dataOwner), dimensions,
+                                                           swizzleMask, interpolation, wrapping);
+        }
         return std::make_shared<VolumeRAMPrecision<F>>(static_cast<F*>(dataPtr), dimensions,
                                                        swizzleMask, interpolation, wrapping);
     }
 };
 
+struct VolumeRamAllocationDispatcher {
+    using type = std::shared_ptr<VolumeRAM>;
+    template <typename Result, typename T>
+    std::shared_ptr<VolumeRAM> operator()(const size3_t& dimensions, RAMAllocation allocation,
+                                          const SwizzleMask& swizzleMask,
+                                          InterpolationType interpolation,
+                                          const Wrapping3D& wrapping) {
+        using F = typename T::type;
+        return std::make_shared<VolumeRAMPrecision<F>>(dimensions, allocation, swizzleMask,
+                                                       interpolation, wrapping);
+    }
+};
+
 std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions, const DataFormatBase* format,
                                            void* dataPtr, const SwizzleMask& swizzleMask,
                                            InterpolationType interpolation,
                                            const Wrapping3D& wrapping) {
     VolumeRamCreationDispatcher disp;
     return dispatching::dispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::All>(
-        format->getId(), disp, dataPtr, dimensions, swizzleMask, interpolation, wrapping);
+        format->getId(), disp, dataPtr, std::shared_ptr<void>{}, dimensions, swizzleMask,
+        interpolation, wrapping);
+}
+
+std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions, const DataFormatBase* format,
+                                           void* dataPtr, std::shared_ptr<void> dataOwner,
+                                           const SwizzleMask& swizzleMask,
+                                           InterpolationType interpolation,
+                                           const Wrapping3D& wrapping) {
+    VolumeRamCreationDispatcher disp;
+    return dispatching::dispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::All>(
+        format->getId(), disp, dataPtr, std::move(dataOwner), dimensions, swizzleMask,
+        interpolation, wrapping);
+}
+
+std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions, const DataFormatBase* format,
+                                           RAMAllocation allocation,
+                                           const SwizzleMask& swizzleMask,
+                                           InterpolationType interpolation,
+                                           const Wrapping3D& wrapping) {
+    VolumeRamAllocationDispatcher disp;
+    return dispatching::dispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::All>(
+        format->getId(), disp, dimensions, allocation, swizzleMask, interpolation, wrapping);
 }
 
 }  // namespace inviwo
@@ -32,8 +32,77 @@
 #include <inviwo/core/util/raiiutils.h>
 #include <inviwo/core/util/filesystem.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
 namespace inviwo {
 
+namespace {
+
+inline std::uint16_t swapWord(std::uint16_t x) {
+#if defined(_MSC_VER)
+    return _byteswap_ushort(x);
+#else
+    return __builtin_bswap16(x);
+#endif
+}
+inline std::uint32_t swapWord(std::uint32_t x) {
+#if defined(_MSC_VER)
+    return _byteswap_ulong(x);
+#else
+    return __builtin_bswap32(x);
+#endif
+}
+inline std::uint64_t swapWord(std::uint64_t x) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(x);
+#else
+    return __builtin_bswap64(x);
+#endif
+}
+
+// memcpy instead of a cast since the data is not necessarily aligned, compilers turn it into
+// plain (vector) loads and stores
+template <typename Word>
+void swapWords(char* data, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Word word;
+        std::memcpy(&word, data + i * sizeof(Word), sizeof(Word));
+        word = swapWord(word);
+        std::memcpy(data + i * sizeof(Word), &word, sizeof(Word));
+    }
+}
+
+}  // namespace
+
+void util::byteSwap(void* data, size_t bytes, size_t elementSize) {
+    auto bytePtr = static_cast<char*>(data);
+    switch (elementSize) {
+        case 0:
+        case 1:
+            break;
+        case 2:
+            swapWords<std::uint16_t>(bytePtr, bytes / 2);
+            break;
+        case 4:
+            swapWords<std::uint32_t>(bytePtr, bytes / 4);
+            break;
+        case 8:
+            swapWords<std::uint64_t>(bytePtr, bytes / 8);
+            break;
+        default:
+            for (size_t i = 0; i + elementSize <= bytes; i += elementSize) {
+                std::reverse(bytePtr + i, bytePtr + i + elementSize);
+            }
+            break;
+    }
+}
+
 void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
                                bool littleEndian, size_t elementSize, void* dest) {
     auto fin = filesystem::ifstream(file, std::ios::in | std::ios::binary);
@@ -44,17 +113,7 @@ void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t by
         fin.read(static_cast<char*>(dest), bytes);
 
         if (!littleEndian && elementSize > 1) {
-            char* temp = new char[elementSize];
-
-            for (std::size_t i = 0; i < bytes; i += elementSize) {
-                for (std::size_t j = 0; j < elementSize; j++)
-                    temp[j] = static_cast<char*>(dest)[i + j];
-
-                for (std::size_t j = 0; j < elementSize; j++)
-                    static_cast<char*>(dest)[i + j] = temp[elementSize - j - 1];
-            }
-
-            delete[] temp;
+            byteSwap(dest, bytes, elementSize);
         }
     } else {
         throw DataReaderException("Error: Could not read from file: " + file,
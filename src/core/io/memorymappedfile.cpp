@@ -0,0 +1,201 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/memorymappedfile.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/util/exception.h>
+
+#ifdef WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace inviwo {
+
+namespace util {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename, size_t offset, size_t length,
+                                   Access access)
+    : filename_{filename}
+    , access_{access}
+    , mapping_{nullptr}
+    , mappedSize_{0}
+    , data_{nullptr}
+    , size_{0}
+#ifdef WIN32
+    , file_{INVALID_HANDLE_VALUE}
+    , fileMapping_{nullptr}
+#endif
+{
+    const auto fail = [&](const std::string& what) {
+        cleanup();
+        throw FileException("Could not " + what + " \"" + filename + "\"", IVW_CONTEXT);
+    };
+
+#ifdef WIN32
+    file_ = CreateFileW(util::toWstring(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) fail("open file");
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file_, &fileSize)) fail("get the size of file");
+    const auto total = static_cast<size_t>(fileSize.QuadPart);
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t granularity = info.dwAllocationGranularity;
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) fail("open file");
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1) {
+        ::close(fd);
+        fail("get the size of file");
+    }
+    const auto total = static_cast<size_t>(status.st_size);
+    const auto granularity = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+
+    if (offset > total || (length != 0 && length > total - offset)) {
+#ifndef WIN32
+        ::close(fd);
+#endif
+        fail("map the requested range of file");
+    }
+    size_ = length == 0 ? total - offset : length;
+
+    if (size_ != 0) {
+        const size_t alignedOffset = offset - offset % granularity;
+        mappedSize_ = size_ + (offset - alignedOffset);
+
+#ifdef WIN32
+        fileMapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!fileMapping_) fail("map file");
+
+        const auto off = static_cast<unsigned long long>(alignedOffset);
+        const DWORD mode = access == Access::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ;
+        mapping_ = MapViewOfFile(fileMapping_, mode, static_cast<DWORD>(off >> 32),
+                                 static_cast<DWORD>(off & 0xFFFFFFFFull), mappedSize_);
+        if (!mapping_) fail("map file");
+#else
+        const int protection =
+            access == Access::CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        mapping_ = ::mmap(nullptr, mappedSize_, protection, MAP_PRIVATE, fd,
+                          static_cast<off_t>(alignedOffset));
+        ::close(fd);  // the mapping keeps its own reference to the file
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            fail("map file");
+        }
+#endif
+        data_ = static_cast<char*>(mapping_) + (offset - alignedOffset);
+    } else {
+#ifndef WIN32
+        ::close(fd);
+#endif
+    }
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) noexcept
+    : filename_{std::move(rhs.filename_)}
+    , access_{rhs.access_}
+    , mapping_{std::exchange(rhs.mapping_, nullptr)}
+    , mappedSize_{std::exchange(rhs.mappedSize_, 0)}
+    , data_{std::exchange(rhs.data_, nullptr)}
+    , size_{std::exchange(rhs.size_, 0)}
+#ifdef WIN32
+    , file_{std::exchange(rhs.file_, INVALID_HANDLE_VALUE)}
+    , fileMapping_{std::exchange(rhs.fileMapping_, nullptr)}
+#endif
+{
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) noexcept {
+    if (this != &rhs) {
+        cleanup();
+        filename_ = std::move(rhs.filename_);
+        access_ = rhs.access_;
+        mapping_ = std::exchange(rhs.mapping_, nullptr);
+        mappedSize_ = std::exchange(rhs.mappedSize_, 0);
+        data_ = std::exchange(rhs.data_, nullptr);
+        size_ = std::exchange(rhs.size_, 0);
+#ifdef WIN32
+        file_ = std::exchange(rhs.file_, INVALID_HANDLE_VALUE);
+        fileMapping_ = std::exchange(rhs.fileMapping_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MemoryMappedFile::~MemoryMappedFile() { cleanup(); }
+
+const std::string& MemoryMappedFile::getFileName() const { return filename_; }
+
+auto MemoryMappedFile::getAccess() const -> Access { return access_; }
+
+const char* MemoryMappedFile::data() const { return data_; }
+
+char* MemoryMappedFile::data() { return data_; }
+
+size_t MemoryMappedFile::size() const { return size_; }
+
+bool MemoryMappedFile::empty() const { return size_ == 0; }
+
+const char* MemoryMappedFile::begin() const { return data_; }
+
+const char* MemoryMappedFile::end() const { return data_ + size_; }
+
+void MemoryMappedFile::cleanup() {
+#ifdef WIN32
+    if (mapping_) UnmapViewOfFile(mapping_);
+    if (fileMapping_) CloseHandle(fileMapping_);
+    if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+    fileMapping_ = nullptr;
+    file_ = INVALID_HANDLE_VALUE;
+#else
+    if (mapping_) ::munmap(mapping_, mappedSize_);
+#endif
+    mapping_ = nullptr;
+    mappedSize_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -30,25 +30,65 @@
 #include <inviwo/core/io/rawvolumeramloader.h>
 
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/io/memorymappedfile.h>
+#include <inviwo/core/util/exception.h>
+
+#include <cstdint>
+#include <cstring>
 
 namespace inviwo {
 
+namespace {
+
+// Byte order is swapped per component, not per (possibly multi-component) voxel
+size_t componentSize(const DataFormatBase* format) {
+    return format->getSize() / format->getComponents();
+}
+
+}  // namespace
+
 RawVolumeRAMLoader::RawVolumeRAMLoader(const std::string& rawFile, size_t offset, bool littleEndian)
-    : rawFile_(rawFile), offset_(offset), littleEndian_(littleEndian) {}
+    : rawFile_(rawFile)
+    , offset_(offset)
+    , littleEndian_(littleEndian)
+    , mapping_{std::make_shared<Mapping>()} {}
 
 RawVolumeRAMLoader* RawVolumeRAMLoader::clone() const { return new RawVolumeRAMLoader(*this); }
 
 std::shared_ptr<VolumeRepresentation> RawVolumeRAMLoader::createRepresentation(
     const VolumeRepresentation& src) const {
 
-    const auto size = glm::compMul(src.getDimensions()) * src.getDataFormat()->getSize();
-    auto data = std::make_unique<char[]>(size);
-    util::readBytesIntoBuffer(rawFile_, offset_, size, littleEndian_,
-                              src.getDataFormat()->getSize(), data.get());
+    const auto format = src.getDataFormat();
+    const auto size = glm::compMul(src.getDimensions()) * format->getSize();
+
+    // Map the file copy-on-write and use the mapping as voxel data. Nothing is read until a page
+    // is touched and the pages are shared with the file cache until someone writes to them.
+    if (size != 0) {
+        auto file = [&]() {
+            try {
+                return std::make_shared<util::MemoryMappedFile>(
+                    rawFile_, offset_, size, util::MemoryMappedFile::Access::CopyOnWrite);
+            } catch (const FileException& e) {
+                throw DataReaderException(e.getMessage(), IVW_CONTEXT);
+            }
+        }();
+
+        auto data = file->data();
+        if (reinterpret_cast<std::uintptr_t>(data) % componentSize(format) == 0) {
+            if (!littleEndian_) util::byteSwap(data, size, componentSize(format));
+            return createVolumeRAM(src.getDimensions(), format, data, std::move(file),
+                                   src.getSwizzleMask(), src.getInterpolation(),
+                                   src.getWrapping());
+        }
+    }
+
+    // The offset leaves the data misaligned for the format, fall back to reading a copy
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    util::readBytesIntoBuffer(rawFile_, offset_, size, littleEndian_, componentSize(format),
+                              data.get());
 
-    auto volumeRAM =
-        createVolumeRAM(src.getDimensions(), src.getDataFormat(), data.get(), src.getSwizzleMask(),
-                        src.getInterpolation(), src.getWrapping());
+    auto volumeRAM = createVolumeRAM(src.getDimensions(), format, data.get(), src.getSwizzleMask(),
+                                     src.getInterpolation(), src.getWrapping());
     data.release();
 
     return volumeRAM;
@@ -64,10 +104,47 @@ void RawVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentati
 
     const auto size = glm::compMul(src.getDimensions());
     util::readBytesIntoBuffer(rawFile_, offset_, size * src.getDataFormat()->getSize(),
-                              littleEndian_, src.getDataFormat()->getSize(), volumeDst->getData());
+                              littleEndian_, componentSize(src.getDataFormat()),
+                              volumeDst->getData());
 
     volumeDst->setSwizzleMask(src.getSwizzleMask());
     volumeDst->setInterpolation(src.getInterpolation());
     volumeDst->setWrapping(src.getWrapping());
 }
+
+void RawVolumeRAMLoader::readRegion(const VolumeRepresentation& src, size3_t offset,
+                                    size3_t extent, void* dest) const {
+    if (glm::compMul(extent) == 0) return;
+
+    const auto format = src.getDataFormat();
+    const auto dims = src.getDimensions();
+    const auto elementSize = format->getSize();
+
+    auto file = [&]() {
+        std::scoped_lock lock{mapping_->mutex};
+        if (!mapping_->file) {
+            try {
+                mapping_->file = std::make_shared<const util::MemoryMappedFile>(
+                    rawFile_, offset_, glm::compMul(dims) * elementSize);
+            } catch (const FileException& e) {
+                throw DataReaderException(e.getMessage(), IVW_CONTEXT);
+            }
+        }
+        return mapping_->file;
+    }();
+
+    // copy the region row by row, rows are contiguous in both the file and the destination
+    const auto rowSize = extent.x * elementSize;
+    auto dst = static_cast<char*>(dest);
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            const auto srcIndex = ((offset.z + z) * dims.y + offset.y + y) * dims.x + offset.x;
+            std::memcpy(dst, file->data() + srcIndex * elementSize, rowSize);
+            dst += rowSize;
+        }
+    }
+    if (!littleEndian_) {
+        util::byteSwap(dest, glm::compMul(extent) * elementSize, componentSize(format));
+    }
+}
 }  // namespace inviwo
@@ -0,0 +1,277 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/io/serialization/serializationexception.h>
+#include <inviwo/core/io/serialization/ticpp.h>
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+/*
+ * Layout, all integers are unsigned LEB128 varints unless noted:
+ *   magic (4 bytes), format version (1 byte)
+ *   string count, then for each string: length, bytes
+ *   nodes of the document, terminated by NodeKind::End
+ * Node:
+ *   Element:     kind, name, attribute count, (key, value) * count, child nodes, End
+ *   Text:        kind, value
+ *   Comment:     kind, value
+ *   Declaration: kind, version, encoding, standalone
+ * Strings, including attribute values, are referenced by their index in the string table.
+ */
+constexpr std::array<char, 4> magic{'\x89', 'I', 'V', 'B'};
+constexpr std::uint8_t formatVersion = 2;
+// Elements are read recursively, limit the nesting to not overflow the stack on corrupt data
+constexpr size_t maxDepth = 256;
+
+enum class NodeKind : std::uint8_t { End = 0, Element, Text, Comment, Declaration };
+
+SerializationException binaryError(const std::string& message) {
+    return SerializationException("Invalid binary document: " + message,
+                                  IVW_CONTEXT_CUSTOM("BinaryDocument"));
+}
+
+class BinaryWriter : public TiXmlVisitor {
+public:
+    virtual bool VisitExit(const TiXmlDocument&) override {
+        tag(NodeKind::End);
+        return true;
+    }
+
+    virtual bool VisitEnter(const TiXmlElement& element, const TiXmlAttribute* first) override {
+        tag(NodeKind::Element);
+        string(element.ValueStr());
+        size_t count = 0;
+        for (auto attribute = first; attribute; attribute = attribute->Next()) ++count;
+        varint(count);
+        for (auto attribute = first; attribute; attribute = attribute->Next()) {
+            string(attribute->NameTStr());
+            string(attribute->ValueStr());
+        }
+        return true;
+    }
+
+    virtual bool VisitExit(const TiXmlElement&) override {
+        tag(NodeKind::End);
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlText& text) override {
+        tag(NodeKind::Text);
+        string(text.ValueStr());
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlComment& comment) override {
+        tag(NodeKind::Comment);
+        string(comment.ValueStr());
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlDeclaration& declaration) override {
+        tag(NodeKind::Declaration);
+        string(declaration.Version());
+        string(declaration.Encoding());
+        string(declaration.Standalone());
+        return true;
+    }
+
+    virtual bool Visit(const TiXmlUnknown&) override {
+        throw SerializationException("Unknown xml nodes can not be stored in a binary document",
+                                     IVW_CONTEXT_CUSTOM("BinaryDocument"));
+    }
+
+    void write(std::ostream& stream) {
+        // The string table goes before the nodes, but is only complete once all nodes are visited
+        std::string nodes;
+        std::swap(nodes, data_);
+        data_.assign(magic.begin(), magic.end());
+        data_.push_back(static_cast<char>(formatVersion));
+        varint(strings_.size());
+        for (auto str : strings_) {
+            varint(str.size());
+            data_.append(str.data(), str.size());
+        }
+        stream.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+        stream.write(nodes.data(), static_cast<std::streamsize>(nodes.size()));
+    }
+
+private:
+    void tag(NodeKind kind) { data_.push_back(static_cast<char>(kind)); }
+
+    void varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        data_.push_back(static_cast<char>(value));
+    }
+
+    void string(std::string_view str) {
+        // The views point into the document, which outlives the writer
+        const auto [it, inserted] = stringIndices_.try_emplace(str, strings_.size());
+        if (inserted) strings_.push_back(str);
+        varint(it->second);
+    }
+
+    std::string data_;
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, size_t> stringIndices_;
+};
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::istream& stream)
+        : data_{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()}
+        , pos_{data_.data()}
+        , end_{data_.data() + data_.size()} {
+        if (data_.size() < magic.size() + 1 ||
+            !std::equal(magic.begin(), magic.end(), data_.begin())) {
+            throw binaryError("missing header");
+        }
+        pos_ += magic.size();
+        if (const auto version = byte(); version != formatVersion) {
+            throw binaryError("unsupported format version " + std::to_string(version));
+        }
+
+        strings_.resize(count());
+        for (auto& str : strings_) {
+            const auto size = count();
+            str.assign(pos_, size);
+            pos_ += size;
+        }
+    }
+
+    void read(TxDocument& doc) {
+        readChildren(doc, 0);
+        if (pos_ != end_) throw binaryError("unexpected data after the last node");
+    }
+
+private:
+    void readChildren(TxNode& parent, size_t depth) {
+        if (depth > maxDepth) throw binaryError("elements are nested too deep");
+        for (;;) {
+            switch (static_cast<NodeKind>(byte())) {
+                case NodeKind::End:
+                    return;
+                case NodeKind::Element: {
+                    TxElement element(string());
+                    for (auto i = count(); i > 0; --i) {
+                        const auto& key = string();
+                        element.SetAttribute(key, string());
+                    }
+                    parent.LinkEndChild(&element);
+                    readChildren(element, depth + 1);
+                    break;
+                }
+                case NodeKind::Text: {
+                    TxText text(string());
+                    parent.LinkEndChild(&text);
+                    break;
+                }
+                case NodeKind::Comment: {
+                    TxComment comment(string());
+                    parent.LinkEndChild(&comment);
+                    break;
+                }
+                case NodeKind::Declaration: {
+                    const auto& version = string();
+                    const auto& encoding = string();
+                    TxDeclaration declaration(version, encoding, string());
+                    parent.LinkEndChild(&declaration);
+                    break;
+                }
+                default:
+                    throw binaryError("unknown node kind");
+            }
+        }
+    }
+
+    std::uint8_t byte() {
+        if (pos_ == end_) throw binaryError("unexpected end of data");
+        return static_cast<std::uint8_t>(*pos_++);
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const auto b = byte();
+            value |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) return value;
+        }
+        throw binaryError("malformed integer");
+    }
+
+    // A varint that counts items or bytes that still have to fit in the remaining data
+    size_t count() {
+        const auto value = varint();
+        if (value > static_cast<std::uint64_t>(end_ - pos_)) throw binaryError("invalid size");
+        return static_cast<size_t>(value);
+    }
+
+    const std::string& string() {
+        const auto index = varint();
+        if (index >= strings_.size()) throw binaryError("invalid string index");
+        return strings_[static_cast<size_t>(index)];
+    }
+
+    std::string data_;
+    const char* pos_;
+    const char* end_;
+    std::vector<std::string> strings_;
+};
+
+}  // namespace
+
+void util::writeBinaryDocument(const TxDocument& doc, std::ostream& stream) {
+    BinaryWriter writer;
+    doc.Accept(&writer);
+    writer.write(stream);
+}
+
+void util::readBinaryDocument(std::istream& stream, TxDocument& doc) {
+    BinaryReader reader{stream};
+    reader.read(doc);
+}
+
+bool util::isBinaryDocument(std::istream& stream) {
+    return stream.peek() == static_cast<unsigned char>(magic.front());
+}
+
+}  // namespace inviwo
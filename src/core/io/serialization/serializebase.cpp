@@ -29,6 +29,7 @@
 
 #include <inviwo/core/io/serialization/serializebase.h>
 #include <inviwo/core/io/serialization/ticpp.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
 
 namespace inviwo {
 
@@ -131,7 +132,11 @@ SerializeBase::SerializeBase(std::istream& stream, const std::string& path, bool
     , rootElement_{nullptr}
     , allowRef_{allowReference}
     , retrieveChild_{true} {
-    stream >> *doc_;
+    if (util::isBinaryDocument(stream)) {
+        util::readBinaryDocument(stream, *doc_);
+    } else {
+        stream >> *doc_;
+    }
 }
 
 SerializeBase::~SerializeBase() = default;
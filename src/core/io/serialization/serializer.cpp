@@ -31,6 +31,7 @@
 #include <inviwo/core/io/serialization/serializer.h>
 #include <inviwo/core/util/exception.h>
 #include <inviwo/core/io/serialization/ticpp.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
 
 namespace inviwo {
 
@@ -114,4 +115,15 @@ void Serializer::writeFile(std::ostream& stream, bool format) {
     }
 }
 
+void Serializer::writeFile(std::ostream& stream, SerializationFormat format) {
+    if (format == SerializationFormat::Xml) return writeFile(stream, false);
+
+    try {
+        refDataContainer_.setReferenceAttributes();
+        util::writeBinaryDocument(*doc_, stream);
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IVW_CONTEXT);
+    }
+}
+
 }  // namespace inviwo
@@ -59,7 +59,7 @@ void LinkEvaluator::addLink(const PropertyLink& propertyLink) {
         propertyLinkPrimaryCache_.erase(src);
     }
 
-    propertyLinkSecondaryCache_.clear();
+    invalidateSecondaryCache(src);
 }
 
 bool LinkEvaluator::canLink(const Property* src, const Property* dst) const {
@@ -93,7 +93,7 @@ void LinkEvaluator::removeLink(const PropertyLink& propertyLink) {
         propertyLinkPrimaryCache_.erase(src);
     }
 
-    propertyLinkSecondaryCache_.clear();
+    invalidateSecondaryCache(src);
 }
 
 std::vector<PropertyLink> LinkEvaluator::getLinksBetweenProcessors(Processor* p1, Processor* p2) {
@@ -106,63 +106,109 @@ std::vector<PropertyLink> LinkEvaluator::getLinksBetweenProcessors(Processor* p1
 }
 
 std::vector<LinkEvaluator::Link>& LinkEvaluator::getTriggerdLinksForProperty(Property* property) {
-    if (propertyLinkSecondaryCache_.find(property) != propertyLinkSecondaryCache_.end()) {
-        return propertyLinkSecondaryCache_[property];
+    auto it = propertyLinkSecondaryCache_.find(property);
+    if (it != propertyLinkSecondaryCache_.end()) {
+        return it->second.links;
     } else {
-        return addToSecondaryCache(property);
+        return addToSecondaryCache(property).links;
     }
 }
 
 std::vector<Property*> LinkEvaluator::getPropertiesLinkedTo(Property* property) {
     // check if link connectivity has been computed and cached already
-    auto& list = (propertyLinkSecondaryCache_.find(property) != propertyLinkSecondaryCache_.end())
-                     ? propertyLinkSecondaryCache_[property]
-                     : addToSecondaryCache(property);
+    auto& list = getTriggerdLinksForProperty(property);
 
     return util::transform(list, [](const Link& link) { return link.dst_; });
 }
 
-std::vector<LinkEvaluator::Link>& LinkEvaluator::addToSecondaryCache(Property* src) {
-    for (auto& dst : propertyLinkPrimaryCache_[src]) {
-        if (src != dst) secondaryCacheHelper(propertyLinkSecondaryCache_[src], src, dst);
+LinkEvaluator::SecondaryCacheEntry& LinkEvaluator::addToSecondaryCache(Property* src) {
+    Traversal traversal;
+    followLinks(traversal, src);
+
+    auto& entry = propertyLinkSecondaryCache_[src];
+    entry.links = std::move(traversal.links);
+    entry.followed.assign(traversal.followed.begin(), traversal.followed.end());
+    // An entry always depends on its own source, that case is handled directly in
+    // invalidateSecondaryCache to not keep a dependents set for every property.
+    for (auto followed : entry.followed) {
+        if (followed != src) secondaryCacheDependents_[followed].insert(src);
     }
-    return propertyLinkSecondaryCache_[src];
+    return entry;
 }
 
-void LinkEvaluator::secondaryCacheHelper(std::vector<Link>& links, Property* src, Property* dst) {
+void LinkEvaluator::followLinks(Traversal& traversal, Property* src) {
+    // Following the links of a property again after it is completed can not add any new links,
+    // everything reachable from them was either added the first time or is already linked.
+    if (traversal.completed.count(src) != 0) return;
+    traversal.followed.insert(src);
+
+    auto it = propertyLinkPrimaryCache_.find(src);
+    if (it != propertyLinkPrimaryCache_.end()) {
+        for (auto dst : it->second) {
+            if (src != dst) secondaryCacheHelper(traversal, src, dst);
+        }
+    }
+    traversal.completed.insert(src);
+}
+
+void LinkEvaluator::secondaryCacheHelper(Traversal& traversal, Property* src, Property* dst) {
     // Check that we don't use a previous source or destination as the new destination.
-    if (!util::contains_if(
-            links, [dst](const Link& link) { return link.src_ == dst || link.dst_ == dst; })) {
+    if (traversal.linked.count(dst) == 0) {
         auto manager = network_->getApplication()->getPropertyConverterManager();
         if (auto converter = manager->getConverter(src, dst)) {
-            links.emplace_back(src, dst, converter);
+            traversal.links.emplace_back(src, dst, converter);
+            traversal.linked.insert(src);
+            traversal.linked.insert(dst);
         }
 
         // Follow the links of destination all links of all owners (CompositeProperties).
         for (Property* newSrc = dst; newSrc != nullptr;
              newSrc = dynamic_cast<Property*>(newSrc->getOwner())) {
             // Recurse over outgoing links.
-            for (auto& elem : propertyLinkPrimaryCache_[newSrc]) {
-                if (newSrc != elem) secondaryCacheHelper(links, newSrc, elem);
-            }
+            followLinks(traversal, newSrc);
         }
 
         // If we link to a CompositeProperty, make sure to evaluate sub-links.
         if (auto cp = dynamic_cast<CompositeProperty*>(dst)) {
             for (auto& srcProp : cp->getProperties()) {
                 // Recurse over outgoing links.
-                for (auto& elem : propertyLinkPrimaryCache_[srcProp]) {
-                    if (srcProp != elem) secondaryCacheHelper(links, srcProp, elem);
-                }
+                followLinks(traversal, srcProp);
             }
         }
     }
 }
 
+void LinkEvaluator::invalidateSecondaryCache(Property* src) {
+    // Only the entries that followed the links of src can change. An entry that followed a
+    // CompositeProperty only recorded the sub properties that existed at the time, hence the
+    // entries depending on any owner of src have to go as well.
+    std::vector<Property*> sources;
+    for (Property* prop = src; prop != nullptr; prop = dynamic_cast<Property*>(prop->getOwner())) {
+        sources.push_back(prop);
+        auto it = secondaryCacheDependents_.find(prop);
+        if (it != secondaryCacheDependents_.end()) {
+            sources.insert(sources.end(), it->second.begin(), it->second.end());
+            secondaryCacheDependents_.erase(it);
+        }
+    }
+
+    for (auto source : sources) {
+        auto entry = propertyLinkSecondaryCache_.find(source);
+        if (entry == propertyLinkSecondaryCache_.end()) continue;
+        for (auto followed : entry->second.followed) {
+            auto dependents = secondaryCacheDependents_.find(followed);
+            if (dependents == secondaryCacheDependents_.end()) continue;
+            dependents->second.erase(source);
+            if (dependents->second.empty()) secondaryCacheDependents_.erase(dependents);
+        }
+        propertyLinkSecondaryCache_.erase(entry);
+    }
+}
+
 bool LinkEvaluator::isLinking() const { return !visited_.empty(); }
 
 void LinkEvaluator::evaluateLinksFromProperty(Property* modifiedProperty) {
-    if (util::contains(visited_, modifiedProperty)) return;
+    if (visited_.count(modifiedProperty) != 0) return;
 
     NetworkLock lock(network_);
 
@@ -216,12 +216,16 @@ vec2 PropertyDistanceSorter::getPosition(const Processor* processor) {
     return util::getPosition(processor);
 }
 
-void serializeSelected(ProcessorNetwork* network, std::ostream& os, const std::string& refPath) {
+void serializeSelected(ProcessorNetwork* network, std::ostream& os, const std::string& refPath,
+                       SerializationFormat format) {
     Serializer serializer(refPath);
+    serializeSelected(network, serializer);
+    serializer.writeFile(os, format);
+}
 
+void serializeSelected(ProcessorNetwork* network, Serializer& serializer) {
     detail::PartialProcessorNetwork ppc(network);
     serializer.serialize("ProcessorNetwork", ppc);
-    serializer.writeFile(os);
 }
 
 std::vector<Processor*> appendDeserialized(ProcessorNetwork* network, std::istream& is,
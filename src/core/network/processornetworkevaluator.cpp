@@ -35,22 +35,57 @@
 #include <inviwo/core/network/networkutils.h>
 #include <inviwo/core/network/networklock.h>
 #include <inviwo/core/util/clock.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/ports/inport.h>
+#include <inviwo/core/ports/outport.h>
+
+#include <algorithm>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <unordered_map>
 
 namespace inviwo {
 
 ProcessorNetworkEvaluator::ProcessorNetworkEvaluator(ProcessorNetwork* processorNetwork)
     : processorNetwork_(processorNetwork)
-    , processorsSorted_(util::topologicalSortFiltered(processorNetwork_))
+    , order_{}
+    , position_{}
+    , removed_{0}
+    , filtered_{}
+    , filterDirty_{true}
+    , invalid_{}
+    , pending_{}
+    , evaluating_{false}
+    , current_{0}
     , evaulationQueued_(false)
+    , concurrentEvaluation_(false)
     , exceptionHandler_(StandardEvaluationErrorHandler()) {
 
     processorNetwork_->addObserver(this);
+
+    std::unordered_set<Processor*> state;
+    processorNetwork_->forEachProcessor([&](Processor* processor) {
+        util::traverseNetwork<util::TraversalDirection::Up, util::VisitPattern::Post>(
+            state, processor, [this](Processor* p) { addToOrder(p); });
+    });
+    for (auto processor : order_) {
+        processor->ProcessorObservable::addObserver(this);
+        if (!processor->isValid()) invalid_.insert(processor);
+    }
 }
 
 void ProcessorNetworkEvaluator::setExceptionHandler(EvaluationErrorHandler handler) {
     exceptionHandler_ = handler;
 }
 
+void ProcessorNetworkEvaluator::setConcurrentEvaluation(bool enable) {
+    concurrentEvaluation_ = enable;
+}
+
+bool ProcessorNetworkEvaluator::getConcurrentEvaluation() const { return concurrentEvaluation_; }
+
 void ProcessorNetworkEvaluator::onProcessorNetworkEvaluateRequest() {
     // Direct request, thus we don't want to queue the evaluation anymore
     evaulationQueued_ = false;
@@ -93,94 +128,356 @@ void ProcessorNetworkEvaluator::requestEvaluate() {
     evaluate();
 }
 
-void ProcessorNetworkEvaluator::evaluate() {
-    // lock processor network to avoid concurrent evaluation
-    NetworkLock lock(processorNetwork_);
+namespace {
 
-    notifyObserversProcessorNetworkEvaluationBegin();
+template <typename F>
+void forEachSuccessor(Processor* processor, F&& f) {
+    for (auto outport : processor->getOutports()) {
+        for (auto inport : outport->getConnectedInports()) f(inport->getProcessor());
+    }
+}
 
-    IVW_CPU_PROFILING_IF(500, "Evaluated Processor Network");
+template <typename F>
+void forEachPredecessor(Processor* processor, F&& f) {
+    for (auto inport : processor->getInports()) {
+        for (auto outport : inport->getConnectedOutports()) f(outport->getProcessor());
+    }
+}
 
-    for (auto processor : processorsSorted_) {
-        if (!processor->isValid()) {
-            if (processor->isReady()) {
-                try {
-                    // re-initialize resources (e.g., shaders) if necessary
-                    if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
-                        processor->initializeResources();
-                    }
+}  // namespace
 
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::InitResource, IVW_CONTEXT);
-                    processor->setValid();
-                    continue;
-                }
+void ProcessorNetworkEvaluator::addToOrder(Processor* processor) {
+    position_[processor] = order_.size();
+    order_.push_back(processor);
+}
 
-                try {
-                    // call onChange for all invalid inports
-                    for (auto inport : processor->getInports()) {
-                        inport->callOnChangeIfChanged();
+void ProcessorNetworkEvaluator::removeFromOrder(Processor* processor) {
+    auto it = position_.find(processor);
+    if (it == position_.end()) return;
+    order_[it->second] = nullptr;
+    position_.erase(it);
+    ++removed_;
+
+    // Compact the order once half of it is removed processors, positions are kept stable during
+    // evaluation
+    if (!evaluating_ && 2 * removed_ > order_.size()) {
+        util::erase_remove(order_, nullptr);
+        for (size_t i = 0; i < order_.size(); ++i) position_[order_[i]] = i;
+        removed_ = 0;
+    }
+}
+
+/**
+ * Restore the topological order after adding a connection from -> to, following
+ * Pearce and Kelly, "A Dynamic Topological Sort Algorithm for Directed Acyclic Graphs". Only the
+ * processors with positions between to and from that are reachable from "to" or can reach "from"
+ * have to be reordered.
+ */
+void ProcessorNetworkEvaluator::updateOrder(Processor* from, Processor* to) {
+    const auto lower = position_.at(to);
+    const auto upper = position_.at(from);
+    if (upper < lower) return;
+
+    const auto collect = [&](Processor* start, auto neighbours, auto inRange) {
+        std::vector<Processor*> found{start};
+        std::unordered_set<Processor*> visited{start};
+        for (size_t i = 0; i < found.size(); ++i) {
+            neighbours(found[i], [&](Processor* p) {
+                if (inRange(position_.at(p)) && visited.insert(p).second) found.push_back(p);
+            });
+        }
+        std::sort(found.begin(), found.end(),
+                  [&](Processor* a, Processor* b) { return position_[a] < position_[b]; });
+        return found;
+    };
+
+    const auto forward = collect(
+        to, [](Processor* p, auto f) { forEachSuccessor(p, f); },
+        [&](size_t pos) { return pos < upper; });
+    const auto backward = collect(
+        from, [](Processor* p, auto f) { forEachPredecessor(p, f); },
+        [&](size_t pos) { return pos > lower; });
+
+    std::vector<size_t> positions;
+    positions.reserve(forward.size() + backward.size());
+    for (auto p : backward) positions.push_back(position_[p]);
+    for (auto p : forward) positions.push_back(position_[p]);
+    std::sort(positions.begin(), positions.end());
+
+    // Everything that leads to "from" goes before everything reachable from "to"
+    auto pos = positions.begin();
+    for (auto p : backward) {
+        order_[*pos] = p;
+        position_[p] = *pos++;
+    }
+    for (auto p : forward) {
+        order_[*pos] = p;
+        position_[p] = *pos++;
+    }
+}
+
+void ProcessorNetworkEvaluator::updateFilter() {
+    if (!filterDirty_) return;
+    filtered_.clear();
+    for (auto processor : order_) {
+        if (!processor || !processor->isSink()) continue;
+        util::traverseNetwork<util::TraversalDirection::Up, util::VisitPattern::Pre>(
+            filtered_, processor, [](Processor*) {},
+            [](Processor* p, Inport* from, Outport* to) {
+                return p->isConnectionActive(from, to);
+            });
+    }
+    filterDirty_ = false;
+}
+
+std::vector<Processor*> ProcessorNetworkEvaluator::getInvalidProcessors() {
+    std::vector<size_t> positions;
+    for (auto processor : invalid_) {
+        if (filtered_.count(processor) != 0) positions.push_back(position_.at(processor));
+    }
+    std::sort(positions.begin(), positions.end());
+    return util::transform(positions, [&](size_t pos) { return order_[pos]; });
+}
+
+bool ProcessorNetworkEvaluator::prepareProcess(Processor* processor) {
+    try {
+        // re-initialize resources (e.g., shaders) if necessary
+        if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
+            processor->initializeResources();
+        }
+
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::InitResource, IVW_CONTEXT);
+        processor->setValid();
+        return false;
+    }
+
+    try {
+        // call onChange for all invalid inports
+        for (auto inport : processor->getInports()) {
+            inport->callOnChangeIfChanged();
+        }
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::PortOnChange, IVW_CONTEXT);
+        processor->setValid();
+        return false;
+    }
+    return true;
+}
+
+void ProcessorNetworkEvaluator::finishProcess(Processor* processor) {
+    // Set processor as valid only if we still are ready.
+    // Callbacks might have made our inports invalid, if so abort
+    // the evaluation by not setting the processor valid.
+    if (processor->isReady()) processor->setValid();
+
+    processor->notifyObserversFinishedProcess(processor);
+}
+
+void ProcessorNetworkEvaluator::evaluateProcessor(Processor* processor) {
+    if (processor->isValid()) return;
+
+    if (processor->isReady()) {
+        if (!prepareProcess(processor)) return;
+
+        processor->notifyObserversAboutToProcess(processor);
+
+        try {
+            IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+            // do the actual processing
+            processor->process();
+        } catch (...) {
+            exceptionHandler_(processor, EvaluationType::Process, IVW_CONTEXT);
+        }
+
+        finishProcess(processor);
+
+    } else {
+        try {
+            processor->doIfNotReady();
+        } catch (...) {
+            exceptionHandler_(processor, EvaluationType::NotReady, IVW_CONTEXT);
+        }
+    }
+}
+
+void ProcessorNetworkEvaluator::evaluateConcurrent(const std::vector<Processor*>& processors) {
+    auto& pool = processorNetwork_->getApplication()->getThreadPool();
+
+    // Build the dependency graph, edges go from a processor to the processors connected to its
+    // outports. Indices refer to positions in processors.
+    const auto nProcessors = processors.size();
+    std::unordered_map<Processor*, size_t> indices;
+    for (size_t i = 0; i < nProcessors; ++i) indices[processors[i]] = i;
+
+    std::vector<std::vector<size_t>> successors(nProcessors);
+    std::vector<size_t> waitingFor(nProcessors, 0);
+    for (size_t i = 0; i < nProcessors; ++i) {
+        for (auto inport : processors[i]->getInports()) {
+            for (auto outport : inport->getConnectedOutports()) {
+                auto it = indices.find(outport->getProcessor());
+                if (it == indices.end()) continue;
+                successors[it->second].push_back(i);
+                ++waitingFor[i];
+            }
+        }
+    }
+
+    // Ready processors in topological order
+    std::set<size_t> ready;
+    for (size_t i = 0; i < nProcessors; ++i) {
+        if (waitingFor[i] == 0) ready.insert(i);
+    }
+    const auto done = [&](size_t i) {
+        for (auto s : successors[i]) {
+            if (--waitingFor[s] == 0) ready.insert(s);
+        }
+    };
+
+    struct {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<std::pair<size_t, std::exception_ptr>> processed;
+    } results;
+    size_t running = 0;
+
+    for (;;) {
+        // Dispatch all ready processors that can be processed concurrently, and skip the valid ones
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto it = ready.begin(); it != ready.end();) {
+                const auto i = *it;
+                auto processor = processors[i];
+                if (processor->isValid()) {
+                    it = ready.erase(it);
+                    done(i);
+                    changed = true;
+                } else if (processor->supportsConcurrentProcessing() && processor->isReady()) {
+                    it = ready.erase(it);
+                    if (!prepareProcess(processor)) {
+                        done(i);
+                        changed = true;
+                        continue;
                     }
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::PortOnChange, IVW_CONTEXT);
-                    processor->setValid();
-                    continue;
+                    processor->notifyObserversAboutToProcess(processor);
+                    ++running;
+                    pool.enqueueRaw([processor, i, &results]() {
+                        std::exception_ptr exception;
+                        try {
+                            processor->process();
+                        } catch (...) {
+                            exception = std::current_exception();
+                        }
+                        std::scoped_lock lock{results.mutex};
+                        results.processed.emplace_back(i, exception);
+                        results.condition.notify_one();
+                    });
+                } else {
+                    ++it;
                 }
+            }
+        }
 
-                processor->notifyObserversAboutToProcess(processor);
+        if (running == 0) {
+            // Everything else is processed on this thread, one at the time in topological order
+            if (ready.empty()) break;
+            const auto i = *ready.begin();
+            ready.erase(ready.begin());
+            evaluateProcessor(processors[i]);
+            done(i);
+            continue;
+        }
 
+        std::vector<std::pair<size_t, std::exception_ptr>> processed;
+        {
+            std::unique_lock<std::mutex> lock{results.mutex};
+            results.condition.wait(lock, [&]() { return !results.processed.empty(); });
+            std::swap(processed, results.processed);
+        }
+        for (auto& [i, exception] : processed) {
+            --running;
+            auto processor = processors[i];
+            if (exception) {
                 try {
-                    IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
-                    // do the actual processing
-                    processor->process();
+                    std::rethrow_exception(exception);
                 } catch (...) {
                     exceptionHandler_(processor, EvaluationType::Process, IVW_CONTEXT);
                 }
+            }
+            finishProcess(processor);
+            done(i);
+        }
+    }
+}
 
-                // Set processor as valid only if we still are ready.
-                // Callbacks might have made our inports invalid, if so abort
-                // the evaluation by not setting the processor valid.
-                if (processor->isReady()) processor->setValid();
+void ProcessorNetworkEvaluator::evaluate() {
+    // lock processor network to avoid concurrent evaluation
+    NetworkLock lock(processorNetwork_);
 
-                processor->notifyObserversFinishedProcess(processor);
+    notifyObserversProcessorNetworkEvaluationBegin();
 
-            } else {
-                try {
-                    processor->doIfNotReady();
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::NotReady, IVW_CONTEXT);
-                }
-            }
+    IVW_CPU_PROFILING_IF(500, "Evaluated Processor Network");
+
+    updateFilter();
+    if (concurrentEvaluation_) {
+        evaluateConcurrent(getInvalidProcessors());
+    } else {
+        // Processors later in the order that get invalidated during the evaluation are added to
+        // pending_ and evaluated in the same pass.
+        for (auto processor : getInvalidProcessors()) pending_.insert(position_[processor]);
+        evaluating_ = true;
+        util::OnScopeExit reset{[this]() {
+            evaluating_ = false;
+            pending_.clear();
+        }};
+        while (!pending_.empty()) {
+            current_ = *pending_.begin();
+            pending_.erase(pending_.begin());
+            if (auto processor = order_[current_]) evaluateProcessor(processor);
         }
     }
+    util::map_erase_remove_if(invalid_, [](Processor* p) { return p->isValid(); });
 
     notifyObserversProcessorNetworkEvaluationEnd();
 }
 
-void ProcessorNetworkEvaluator::onProcessorSinkChanged(Processor*) {
-    processorsSorted_ = util::topologicalSortFiltered(processorNetwork_);
-}
+void ProcessorNetworkEvaluator::onProcessorSinkChanged(Processor*) { filterDirty_ = true; }
 
 void ProcessorNetworkEvaluator::onProcessorActiveConnectionsChanged(Processor*) {
-    processorsSorted_ = util::topologicalSortFiltered(processorNetwork_);
+    filterDirty_ = true;
+}
+
+void ProcessorNetworkEvaluator::onProcessorInvalidationEnd(Processor* p) {
+    if (p->isValid()) return;
+    invalid_.insert(p);
+    if (evaluating_ && filtered_.count(p) != 0) {
+        auto it = position_.find(p);
+        if (it != position_.end() && it->second > current_) pending_.insert(it->second);
+    }
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkDidAddProcessor(Processor* p) {
     p->ProcessorObservable::addObserver(this);
-    processorsSorted_ = util::topologicalSortFiltered(processorNetwork_);
+    addToOrder(p);
+    if (!p->isValid()) invalid_.insert(p);
+    filterDirty_ = true;
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveProcessor(Processor* p) {
     p->ProcessorObservable::removeObserver(this);
-    processorsSorted_ = util::topologicalSortFiltered(processorNetwork_);
+    removeFromOrder(p);
+    invalid_.erase(p);
+    filterDirty_ = true;
 }
 
-void ProcessorNetworkEvaluator::onProcessorNetworkDidAddConnection(const PortConnection&) {
-    processorsSorted_ = util::topologicalSortFiltered(processorNetwork_);
+void ProcessorNetworkEvaluator::onProcessorNetworkDidAddConnection(const PortConnection& con) {
+    updateOrder(con.getOutport()->getProcessor(), con.getInport()->getProcessor());
+    filterDirty_ = true;
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveConnection(const PortConnection&) {
-    processorsSorted_ = util::topologicalSortFiltered(processorNetwork_);
+    // Removing a connection never invalidates the order
+    filterDirty_ = true;
 }
 
 }  // namespace inviwo
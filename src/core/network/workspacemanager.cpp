@@ -148,7 +148,11 @@ void WorkspaceManager::save(std::ostream& stream, const std::string& refPath,
     }
 
     serializers_.invoke(serializer, exceptionHandler, mode);
-    serializer.writeFile(stream, true);
+    if (mode == WorkspaceSaveMode::Undo) {
+        serializer.writeFile(stream, SerializationFormat::Binary);
+    } else {
+        serializer.writeFile(stream, true);
+    }
 }
 
 void WorkspaceManager::load(std::istream& stream, const std::string& refPath,
@@ -0,0 +1,256 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/datastructures/transferfunction.h>
+#include <inviwo/core/io/serialization/serialization.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/network/workspacemanager.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/util/logcentral.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <warn/push>
+#include <warn/ignore/unused-function>
+
+using namespace inviwo;
+
+namespace {
+
+struct LinkProcessor : Processor {
+    LinkProcessor(const std::string& id, size_t properties) : Processor(id, id) {
+        for (size_t i = 0; i < properties; ++i) {
+            auto prop = std::make_unique<FloatProperty>("prop" + std::to_string(i),
+                                                        "Prop " + std::to_string(i));
+            addProperty(prop.get());
+            properties_.push_back(std::move(prop));
+        }
+    }
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+    virtual void process() override {}
+
+    static const ProcessorInfo processorInfo_;
+    std::vector<std::unique_ptr<FloatProperty>> properties_;
+};
+
+const ProcessorInfo LinkProcessor::processorInfo_{
+    "org.inviwo.LinkProcessor",  // Class identifier
+    "LinkProcessor",             // Display name
+    "Benchmark",                 // Category
+    CodeState::Stable,           // Code state
+    Tags::CPU,                   // Tags
+};
+
+/**
+ * A network of processors where every property is linked both ways to the same property of
+ * the next processor, like synced cameras or transfer functions over many canvases.
+ * 26 processors with 200 properties give 10000 links.
+ */
+struct LinkedNetwork {
+    LinkedNetwork(size_t processors, size_t properties) : network{InviwoApplication::getPtr()} {
+        for (size_t i = 0; i < processors; ++i) {
+            network.addProcessor(
+                std::make_unique<LinkProcessor>("p" + std::to_string(i), properties));
+        }
+        for (size_t i = 0; i + 1 < processors; ++i) {
+            for (size_t j = 0; j < properties; ++j) {
+                network.addLink(property(i, j), property(i + 1, j));
+                network.addLink(property(i + 1, j), property(i, j));
+            }
+        }
+    }
+
+    FloatProperty* property(size_t processor, size_t prop) {
+        auto p = static_cast<LinkProcessor*>(
+            network.getProcessorByIdentifier("p" + std::to_string(processor)));
+        return p->properties_[prop].get();
+    }
+
+    ProcessorNetwork network;
+};
+
+}  // namespace
+
+// Edit one link and query the links of all properties, most of which are unaffected by the edit
+static void LinkEditAndQuery(benchmark::State& state) {
+    const auto properties = static_cast<size_t>(state.range(0));
+    LinkedNetwork linked(26, properties);
+    for (size_t j = 0; j < properties; ++j) {
+        linked.network.getPropertiesLinkedTo(linked.property(0, j));
+    }
+
+    auto src = linked.property(12, 0);
+    auto dst = linked.property(13, 0);
+    for (auto _ : state) {
+        linked.network.removeLink(src, dst);
+        linked.network.addLink(src, dst);
+        for (size_t j = 0; j < properties; ++j) {
+            benchmark::DoNotOptimize(linked.network.getPropertiesLinkedTo(linked.property(0, j)));
+        }
+    }
+    state.counters["Links"] = static_cast<double>(25 * 2 * properties);
+}
+
+// Propagate a change through all linked properties, the first drag after an edit
+static void LinkEditAndEvaluate(benchmark::State& state) {
+    const auto properties = static_cast<size_t>(state.range(0));
+    LinkedNetwork linked(26, properties);
+
+    auto src = linked.property(12, 0);
+    auto dst = linked.property(13, 0);
+    auto modified = linked.property(0, 0);
+    float value = 0.0f;
+    for (auto _ : state) {
+        linked.network.removeLink(src, dst);
+        linked.network.addLink(src, dst);
+        modified->set(value += 1.0f);
+    }
+    state.counters["Links"] = static_cast<double>(25 * 2 * properties);
+}
+
+/**
+ * Points sampled from a smooth function with some noise, similar to a TF imported from an image
+ */
+static std::vector<TFPrimitiveData> noisyTFPoints(size_t size) {
+    std::mt19937 rng{0};
+    std::normal_distribution<float> noise{0.0f, 0.002f};
+    std::vector<TFPrimitiveData> points;
+    points.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        const double x = static_cast<double>(i) / (size - 1);
+        const auto v = static_cast<float>(0.5 + 0.5 * std::sin(20.0 * x));
+        points.push_back({x, vec4{v + noise(rng), v * v, 1.0f - v, v}});
+    }
+    return points;
+}
+
+static void TransferFunctionSimplify(benchmark::State& state) {
+    const auto points = noisyTFPoints(static_cast<size_t>(state.range(0)));
+    size_t remaining = 0;
+    for (auto _ : state) {
+        const auto simplified = TransferFunction::simplify(points, 0.01);
+        remaining = simplified.size();
+        benchmark::DoNotOptimize(simplified.data());
+    }
+    state.counters["Remaining"] = static_cast<double>(remaining);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Load the state of many processors, like an undo snapshot of a large workspace
+static void SerializedStateLoad(benchmark::State& state, SerializationFormat format) {
+    std::vector<std::unique_ptr<LinkProcessor>> processors;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        processors.push_back(std::make_unique<LinkProcessor>("p" + std::to_string(i), 50));
+    }
+
+    Serializer serializer("");
+    for (auto& p : processors) serializer.serialize(p->getIdentifier(), *p);
+    std::stringstream ss;
+    serializer.writeFile(ss, format);
+    const auto data = std::move(ss).str();
+
+    auto wm = InviwoApplication::getPtr()->getWorkspaceManager();
+    for (auto _ : state) {
+        std::stringstream stream{data};
+        auto deserializer = wm->createWorkspaceDeserializer(stream, "");
+        for (auto& p : processors) deserializer.deserialize(p->getIdentifier(), *p);
+    }
+    state.counters["Bytes"] = static_cast<double>(data.size());
+}
+
+// Save the state of many processors, like taking an undo snapshot of a large workspace
+static void SerializedStateSave(benchmark::State& state, SerializationFormat format) {
+    std::vector<std::unique_ptr<LinkProcessor>> processors;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        processors.push_back(std::make_unique<LinkProcessor>("p" + std::to_string(i), 50));
+    }
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        Serializer serializer("");
+        for (auto& p : processors) serializer.serialize(p->getIdentifier(), *p);
+        std::stringstream ss;
+        serializer.writeFile(ss, format);
+        bytes = ss.str().size();
+    }
+    state.counters["Bytes"] = static_cast<double>(bytes);
+}
+
+BENCHMARK(LinkEditAndQuery)->RangeMultiplier(2)->Range(25, 200);
+BENCHMARK(LinkEditAndEvaluate)->RangeMultiplier(2)->Range(25, 200);
+BENCHMARK(TransferFunctionSimplify)->RangeMultiplier(10)->Range(100, 10000);
+BENCHMARK_CAPTURE(SerializedStateSave, Xml, SerializationFormat::Xml)
+    ->RangeMultiplier(2)
+    ->Range(100, 800)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SerializedStateSave, Binary, SerializationFormat::Binary)
+    ->RangeMultiplier(2)
+    ->Range(100, 800)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SerializedStateLoad, Xml, SerializationFormat::Xml)
+    ->RangeMultiplier(2)
+    ->Range(100, 800)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SerializedStateLoad, Binary, SerializationFormat::Binary)
+    ->RangeMultiplier(2)
+    ->Range(100, 800)
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    LogCentral::init();
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-Core");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        app.registerModules(std::move(modules));
+    }
+    app.processFront();
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
+
+#include <warn/pop>
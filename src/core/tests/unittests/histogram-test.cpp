@@ -0,0 +1,136 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/histogram.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::vector<NormalizedHistogram> singlePass(const std::vector<T>& data, dvec2 range,
+                                            size_t bins) {
+    util::HistogramBuilder<T> builder(range, bins);
+    builder.add(data.begin(), data.end());
+    return builder.finish();
+}
+
+template <typename T>
+std::vector<NormalizedHistogram> merged(const std::vector<T>& data, dvec2 range, size_t bins,
+                                        size_t parts) {
+    util::HistogramBuilder<T> builder(range, bins);
+    for (size_t i = 0; i < parts; ++i) {
+        util::HistogramBuilder<T> part(range, bins);
+        part.add(data.begin() + data.size() * i / parts,
+                 data.begin() + data.size() * (i + 1) / parts);
+        builder.merge(part);
+    }
+    EXPECT_EQ(data.size(), builder.getCount());
+    return builder.finish();
+}
+
+void expectEqual(const NormalizedHistogram& a, const NormalizedHistogram& b) {
+    ASSERT_EQ(a.getData().size(), b.getData().size());
+    for (size_t i = 0; i < a.getData().size(); ++i) {
+        EXPECT_DOUBLE_EQ(a.getData()[i], b.getData()[i]);
+    }
+    EXPECT_DOUBLE_EQ(a.getMaximumBinValue(), b.getMaximumBinValue());
+    EXPECT_DOUBLE_EQ(a.stats_.min, b.stats_.min);
+    EXPECT_DOUBLE_EQ(a.stats_.max, b.stats_.max);
+    EXPECT_NEAR(a.stats_.mean, b.stats_.mean, 1e-9 * std::abs(a.stats_.mean) + 1e-12);
+    EXPECT_NEAR(a.stats_.standardDeviation, b.stats_.standardDeviation,
+                1e-9 * a.stats_.standardDeviation + 1e-12);
+}
+
+}  // namespace
+
+TEST(HistogramBuilder, MergeEqualsSinglePassFloat) {
+    std::mt19937 gen(1);
+    std::normal_distribution<float> dist(3.0f, 2.0f);
+    std::vector<float> data(100'003);
+    for (auto& v : data) v = dist(gen);
+
+    const dvec2 range{-10.0, 16.0};
+    const auto expected = singlePass(data, range, 64);
+    ASSERT_EQ(1u, expected.size());
+    for (size_t parts : {2, 7, 31}) {
+        expectEqual(expected[0], merged(data, range, 64, parts)[0]);
+    }
+}
+
+TEST(HistogramBuilder, MergeEqualsSinglePassUInt16) {
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<int> dist(0, 4095);
+    std::vector<std::uint16_t> data(50'000);
+    for (auto& v : data) v = static_cast<std::uint16_t>(dist(gen));
+
+    const dvec2 range{0.0, 4095.0};
+    const auto expected = singlePass(data, range, 256);
+    for (size_t parts : {3, 16}) {
+        expectEqual(expected[0], merged(data, range, 256, parts)[0]);
+    }
+}
+
+TEST(HistogramBuilder, UInt8Counts) {
+    // 0..255 four times, every bin of a 256 bin histogram gets the same count
+    std::vector<std::uint8_t> data;
+    for (int i = 0; i < 4; ++i) {
+        for (int v = 0; v < 256; ++v) data.push_back(static_cast<std::uint8_t>(v));
+    }
+    const auto hist = singlePass(data, dvec2{0.0, 255.0}, 256);
+    ASSERT_EQ(256u, hist[0].getData().size());
+    for (auto bin : hist[0].getData()) EXPECT_DOUBLE_EQ(1.0, bin);
+    EXPECT_DOUBLE_EQ(4.0, hist[0].getMaximumBinValue());
+    EXPECT_DOUBLE_EQ(0.0, hist[0].stats_.min);
+    EXPECT_DOUBLE_EQ(255.0, hist[0].stats_.max);
+    EXPECT_DOUBLE_EQ(127.5, hist[0].stats_.mean);
+}
+
+TEST(HistogramBuilder, StableStandardDeviation) {
+    // A large offset and a small spread cancels catastrophically with a sum of squares
+    std::vector<double> data;
+    for (int i = 0; i < 10'000; ++i) data.push_back(1.0e9 + (i % 2 == 0 ? -1.0 : 1.0));
+
+    const auto hist = singlePass(data, dvec2{1.0e9 - 2.0, 1.0e9 + 2.0}, 4);
+    const double n = static_cast<double>(data.size());
+    EXPECT_NEAR(std::sqrt(n / (n - 1.0)), hist[0].stats_.standardDeviation, 1e-9);
+    EXPECT_DOUBLE_EQ(1.0e9, hist[0].stats_.mean);
+}
+
+}  // namespace inviwo
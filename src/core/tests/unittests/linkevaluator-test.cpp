@@ -0,0 +1,200 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/links/linkevaluator.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+struct LinkTestProcessor : Processor {
+    LinkTestProcessor(const std::string& id) : Processor(id, id) {}
+
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+
+    static const ProcessorInfo processorInfo_;
+
+    virtual void process() override {}
+};
+
+const ProcessorInfo LinkTestProcessor::processorInfo_{
+    "org.inviwo.LinkTestProcessor",  // Class identifier
+    "LinkTestProcessor",             // Display name
+    "Testing",                       // Category
+    CodeState::Stable,               // Code state
+    Tags::CPU,                       // Tags
+};
+
+std::vector<Property*> sorted(std::vector<Property*> props) {
+    std::sort(props.begin(), props.end());
+    return props;
+}
+
+/**
+ * Compares the cached links of the network for all the given properties with the links found by
+ * a new LinkEvaluator built from scratch with the current links of the network.
+ */
+void checkAgainstRebuild(ProcessorNetwork& network, const std::vector<Property*>& properties) {
+    LinkEvaluator rebuild(&network);
+    for (auto& link : network.getLinks()) rebuild.addLink(link);
+
+    for (auto prop : properties) {
+        SCOPED_TRACE(joinString(prop->getPath(), "."));
+        EXPECT_EQ(sorted(rebuild.getPropertiesLinkedTo(prop)),
+                  sorted(network.getPropertiesLinkedTo(prop)));
+    }
+}
+
+// Fill the secondary cache so that stale entries would show up in later checks
+void query(ProcessorNetwork& network, const std::vector<Property*>& properties) {
+    for (auto prop : properties) network.getPropertiesLinkedTo(prop);
+}
+
+struct LinkEvaluatorTest : ::testing::Test {
+    LinkEvaluatorTest() : network{InviwoApplication::getPtr()} {
+        for (auto id : {"p1", "p2", "p3", "p4"}) {
+            auto p = std::make_unique<LinkTestProcessor>(id);
+            auto i = new IntProperty("i", "i");
+            auto j = new IntProperty("j", "j");
+            auto comp = new CompositeProperty("comp", "comp");
+            auto c = new IntProperty("c", "c");
+            comp->addProperty(c);
+            p->addProperty(i);
+            p->addProperty(j);
+            p->addProperty(comp);
+            props.insert(props.end(), {i, j, comp, c});
+            network.addProcessor(std::move(p));
+        }
+    }
+
+    IntProperty* i(size_t p) { return static_cast<IntProperty*>(props[4 * p]); }
+    IntProperty* j(size_t p) { return static_cast<IntProperty*>(props[4 * p + 1]); }
+    CompositeProperty* comp(size_t p) { return static_cast<CompositeProperty*>(props[4 * p + 2]); }
+    IntProperty* c(size_t p) { return static_cast<IntProperty*>(props[4 * p + 3]); }
+
+    void check() {
+        SCOPED_TRACE("Compare against rebuild");
+        checkAgainstRebuild(network, props);
+    }
+
+    ProcessorNetwork network;
+    std::vector<Property*> props;
+};
+
+}  // namespace
+
+TEST_F(LinkEvaluatorTest, chain) {
+    network.addLink(i(0), i(1));
+    network.addLink(i(1), i(2));
+    network.addLink(i(2), i(3));
+    check();
+    EXPECT_EQ(sorted({i(1), i(2), i(3)}), sorted(network.getPropertiesLinkedTo(i(0))));
+    EXPECT_EQ(std::vector<Property*>{}, network.getPropertiesLinkedTo(i(3)));
+}
+
+TEST_F(LinkEvaluatorTest, cycle) {
+    network.addLink(i(0), i(1));
+    network.addLink(i(1), i(2));
+    network.addLink(i(2), i(0));
+    network.addLink(i(2), j(2));
+    check();
+    EXPECT_EQ(sorted({i(1), i(2), j(2)}), sorted(network.getPropertiesLinkedTo(i(0))));
+    EXPECT_EQ(sorted({i(0), i(2), j(2)}), sorted(network.getPropertiesLinkedTo(i(1))));
+}
+
+TEST_F(LinkEvaluatorTest, compositeSubLinks) {
+    network.addLink(comp(0), comp(1));
+    network.addLink(c(1), c(2));
+    network.addLink(comp(2), i(3));  // No converter, should not be linked
+    check();
+    EXPECT_EQ(sorted({comp(1), c(2)}), sorted(network.getPropertiesLinkedTo(comp(0))));
+    EXPECT_EQ(std::vector<Property*>{}, network.getPropertiesLinkedTo(c(0)));
+}
+
+TEST_F(LinkEvaluatorTest, addAndRemoveLinks) {
+    network.addLink(i(0), i(1));
+    network.addLink(i(2), i(3));
+    network.addLink(comp(0), comp(1));
+    query(network, props);
+    check();
+
+    {
+        SCOPED_TRACE("Join chains");
+        network.addLink(i(1), i(2));
+        check();
+        EXPECT_EQ(sorted({i(1), i(2), i(3)}), sorted(network.getPropertiesLinkedTo(i(0))));
+    }
+    {
+        SCOPED_TRACE("Split chains");
+        query(network, props);
+        network.removeLink(i(1), i(2));
+        check();
+        EXPECT_EQ(std::vector<Property*>{i(1)}, network.getPropertiesLinkedTo(i(0)));
+    }
+    {
+        SCOPED_TRACE("Link from sub property");
+        query(network, props);
+        network.addLink(c(1), j(3));
+        check();
+        EXPECT_EQ(sorted({comp(1), j(3)}), sorted(network.getPropertiesLinkedTo(comp(0))));
+    }
+    {
+        SCOPED_TRACE("Link from sub property added later");
+        query(network, props);
+        auto d = new IntProperty("d", "d");
+        comp(1)->addProperty(d);
+        props.push_back(d);
+        network.addLink(d, j(2));
+        check();
+        EXPECT_EQ(sorted({comp(1), j(3), j(2)}), sorted(network.getPropertiesLinkedTo(comp(0))));
+    }
+    {
+        SCOPED_TRACE("Remove link from sub property");
+        query(network, props);
+        network.removeLink(c(1), j(3));
+        check();
+        EXPECT_EQ(sorted({comp(1), j(2)}), sorted(network.getPropertiesLinkedTo(comp(0))));
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,116 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/logcentral.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+class RecordingLogger : public Logger {
+public:
+    virtual void log(std::string logSource, LogLevel, LogAudience, const char*, const char*, int,
+                     std::string logMsg) override {
+        std::scoped_lock lock{mutex_};
+        messages_[logSource].push_back(logMsg);
+    }
+
+    std::map<std::string, std::vector<std::string>> messages() {
+        std::scoped_lock lock{mutex_};
+        return messages_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::vector<std::string>> messages_;
+};
+
+}  // namespace
+
+TEST(LogCentral, asyncKeepsOrderPerThread) {
+    LogCentral central;
+    auto logger = std::make_shared<RecordingLogger>();
+    central.registerLogger(logger);
+    central.setAsync(true, 16, LogOverflowPolicy::Block);
+    EXPECT_TRUE(central.isAsync());
+
+    constexpr int nThreads = 4;
+    constexpr int nMessages = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < nMessages; ++i) {
+                central.log(std::to_string(t), LogLevel::Info, LogAudience::Developer, __FILE__,
+                            __FUNCTION__, __LINE__, std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    central.flush();
+
+    const auto messages = logger->messages();
+    ASSERT_EQ(static_cast<size_t>(nThreads), messages.size());
+    for (const auto& [source, msgs] : messages) {
+        ASSERT_EQ(static_cast<size_t>(nMessages), msgs.size()) << "source " << source;
+        for (int i = 0; i < nMessages; ++i) {
+            EXPECT_EQ(std::to_string(i), msgs[i]);
+        }
+    }
+}
+
+TEST(LogCentral, disablingAsyncDeliversQueued) {
+    LogCentral central;
+    auto logger = std::make_shared<RecordingLogger>();
+    central.registerLogger(logger);
+    central.setAsync(true, 1024, LogOverflowPolicy::Drop);
+    for (int i = 0; i < 100; ++i) {
+        central.log("source", LogLevel::Info, LogAudience::Developer, __FILE__, __FUNCTION__,
+                    __LINE__, std::to_string(i));
+    }
+    central.setAsync(false);
+    EXPECT_FALSE(central.isAsync());
+    EXPECT_EQ(100u, logger->messages()["source"].size());
+
+    central.log("source", LogLevel::Info, LogAudience::Developer, __FILE__, __FUNCTION__,
+                __LINE__, "sync");
+    EXPECT_EQ("sync", logger->messages()["source"].back());
+}
+
+}  // namespace inviwo
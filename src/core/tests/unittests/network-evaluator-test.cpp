@@ -44,6 +44,7 @@
 #include <inviwo/core/ports/dataoutport.h>
 
 #include <functional>
+#include <atomic>
 
 namespace inviwo {
 
@@ -65,6 +66,9 @@ struct TestProcessor : Processor {
     virtual void doIfNotReady() override {
         if (onDoIfNotReady) onDoIfNotReady(*this);
     }
+    virtual bool supportsConcurrentProcessing() const override { return concurrent; }
+
+    bool concurrent = false;
 
     std::function<void(TestProcessor&)> onInitializeResources;
     std::function<void(TestProcessor&)> onProcess;
@@ -124,6 +128,13 @@ const auto createB = []() {
     return bt;
 };
 
+const auto createAB = [](const std::string& id) {
+    auto abt = std::make_unique<TestProcessor>(id);
+    abt->addPort(std::make_unique<DataInport<int>>("in"));
+    abt->addPort(std::make_unique<DataOutport<int>>("out"));
+    return abt;
+};
+
 TEST(NetworkEvaluator, Eval) {
     ProcessorNetwork network{InviwoApplication::getPtr()};
     ProcessorNetworkEvaluator evaluator{&network};
@@ -257,4 +268,123 @@ TEST(NetworkEvaluator, Error) {
     }
 }
 
+TEST(NetworkEvaluator, Order) {
+    ProcessorNetwork network{InviwoApplication::getPtr()};
+    ProcessorNetworkEvaluator evaluator{&network};
+
+    std::vector<std::string> order;
+    const auto record = [&order](TestProcessor& p) {
+        order.push_back(p.getIdentifier());
+        if (!p.getOutports().empty()) {
+            static_cast<DataOutport<int>*>(p.getOutports()[0])->setData(std::make_shared<int>(0));
+        }
+    };
+
+    // Add the processors in reverse order, every connection has to reorder the processors
+    auto sinkt = createB();
+    auto sink = sinkt.get();
+    sink->onProcess = record;
+    auto midt = createAB("mid");
+    auto mid = midt.get();
+    mid->onProcess = record;
+    auto sourcet = createA();
+    auto source = sourcet.get();
+    source->onProcess = record;
+
+    {
+        NetworkLock lock(&network);
+        network.addProcessor(std::move(sinkt));
+        network.addProcessor(std::move(midt));
+        network.addProcessor(std::move(sourcet));
+        network.addConnection(mid->getOutports()[0], sink->getInports()[0]);
+        network.addConnection(source->getOutports()[0], mid->getInports()[0]);
+    }
+    EXPECT_EQ(order, (std::vector<std::string>{"a", "mid", "b"}));
+
+    {
+        SCOPED_TRACE("Only invalid processors are evaluated");
+        order.clear();
+        mid->invalidate(InvalidationLevel::InvalidOutput);
+        EXPECT_EQ(order, (std::vector<std::string>{"mid", "b"}));
+    }
+}
+
+TEST(NetworkEvaluator, Concurrent) {
+    ProcessorNetwork network{InviwoApplication::getPtr()};
+    ProcessorNetworkEvaluator evaluator{&network};
+    evaluator.setConcurrentEvaluation(true);
+    EXPECT_TRUE(evaluator.getConcurrentEvaluation());
+
+    auto at = createA();
+    auto a = at.get();
+    Instrument ai(*a);
+    a->concurrent = true;
+
+    std::atomic<int> aProcessed{0};
+    a->onProcess = [func = a->onProcess, &aProcessed](TestProcessor& p) {
+        func(p);
+        static_cast<DataOutport<int>*>(p.getOutports()[0])->setData(std::make_shared<int>(0));
+        ++aProcessed;
+    };
+
+    auto bt = createB();
+    auto b = bt.get();
+    Instrument bi(*b);
+    b->concurrent = true;
+
+    auto ct = createB();
+    auto c = ct.get();
+    c->setIdentifier("c");
+    Instrument ci(*c);
+
+    // Both branches have to see the result of a
+    int bSawA = 0;
+    int cSawA = 0;
+    b->onProcess = [func = b->onProcess, &aProcessed, &bSawA](TestProcessor& p) {
+        func(p);
+        bSawA = aProcessed.load();
+    };
+    c->onProcess = [func = c->onProcess, &aProcessed, &cSawA](TestProcessor& p) {
+        func(p);
+        cSawA = aProcessed.load();
+    };
+
+    {
+        SCOPED_TRACE("Add processors");
+        NetworkLock lock(&network);
+        network.addProcessor(std::move(at));
+        network.addProcessor(std::move(bt));
+        network.addProcessor(std::move(ct));
+        network.addConnection(a->getOutports()[0], b->getInports()[0]);
+        network.addConnection(a->getOutports()[0], c->getInports()[0]);
+    }
+    ai.checkAndReset(1, 1, 0);
+    bi.checkAndReset(1, 1, 0);
+    ci.checkAndReset(1, 1, 0);
+    EXPECT_EQ(bSawA, 1);
+    EXPECT_EQ(cSawA, 1);
+    EXPECT_TRUE(a->isValid());
+    EXPECT_TRUE(b->isValid());
+    EXPECT_TRUE(c->isValid());
+
+    {
+        SCOPED_TRACE("Invalid output with throw");
+        unsigned int throwCount = 0;
+        evaluator.setExceptionHandler(
+            [&throwCount](Processor*, EvaluationType, ExceptionContext) { ++throwCount; });
+        b->onProcess = [func = b->onProcess](TestProcessor& p) {
+            func(p);
+            throw Exception("Error", IVW_CONTEXT_CUSTOM("TestProcessor"));
+        };
+
+        a->invalidate(InvalidationLevel::InvalidOutput);
+        EXPECT_EQ(throwCount, 1);
+        ai.checkAndReset(0, 1, 0);
+        bi.checkAndReset(0, 1, 0);
+        ci.checkAndReset(0, 1, 0);
+        EXPECT_EQ(bSawA, 2);
+        EXPECT_EQ(cSawA, 2);
+    }
+}
+
 }  // namespace inviwo
@@ -0,0 +1,131 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/ramallocation.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace inviwo {
+
+TEST(RAMAllocation, pooledBuffersAreReused) {
+    util::clearRAMPool();
+    void* first = nullptr;
+    {
+        auto buffer = util::allocateRAM(1000, RAMAllocation::Pooled);
+        first = buffer.get();
+    }
+    auto again = util::allocateRAM(1000, RAMAllocation::Pooled);
+    EXPECT_EQ(first, again.get());
+    auto other = util::allocateRAM(1000, RAMAllocation::Pooled);
+    EXPECT_NE(first, other.get());
+    util::clearRAMPool();
+}
+
+TEST(RAMAllocation, alignment) {
+    for (auto allocation : {RAMAllocation::Zeroed, RAMAllocation::Uninitialized,
+                            RAMAllocation::HugePages, RAMAllocation::Pooled}) {
+        auto buffer = util::allocateRAM(size_t{3} << 20, allocation);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(buffer.get()) % 64);
+    }
+    auto zeroed = util::allocateRAM(4096, RAMAllocation::Zeroed);
+    const auto bytes = static_cast<const std::uint8_t*>(zeroed.get());
+    EXPECT_TRUE(std::all_of(bytes, bytes + 4096, [](auto b) { return b == 0; }));
+}
+
+TEST(RAMAllocation, volumeKeepsPolicy) {
+    for (auto allocation : {RAMAllocation::Uninitialized, RAMAllocation::HugePages,
+                            RAMAllocation::Pooled}) {
+        VolumeRAMPrecision<float> ram(size3_t{4, 5, 6}, allocation);
+        EXPECT_EQ(allocation, ram.getAllocation());
+        std::iota(ram.getDataTyped(), ram.getDataTyped() + 120, 0.0f);
+
+        VolumeRAMPrecision<float> copy(ram);
+        EXPECT_EQ(allocation, copy.getAllocation());
+        EXPECT_TRUE(std::equal(ram.getDataTyped(), ram.getDataTyped() + 120,
+                               copy.getDataTyped()));
+
+        ram.setDimensions(size3_t{8, 8, 8});
+        EXPECT_EQ(allocation, ram.getAllocation());
+        std::fill(ram.getDataTyped(), ram.getDataTyped() + 512, 1.0f);
+    }
+    util::clearRAMPool();
+}
+
+TEST(RAMAllocation, copyAssignmentKeepsPolicy) {
+    VolumeRAMPrecision<float> pooled(size3_t{4, 5, 6}, RAMAllocation::Pooled);
+    std::iota(pooled.getDataTyped(), pooled.getDataTyped() + 120, 0.0f);
+    VolumeRAMPrecision<float> zeroed(size3_t{2, 2, 2});
+
+    // The memory has to be released the way it was allocated, also after resizing
+    zeroed = pooled;
+    EXPECT_EQ(RAMAllocation::Pooled, zeroed.getAllocation());
+    EXPECT_EQ(size3_t(4, 5, 6), zeroed.getDimensions());
+    EXPECT_TRUE(
+        std::equal(pooled.getDataTyped(), pooled.getDataTyped() + 120, zeroed.getDataTyped()));
+    zeroed.setDimensions(size3_t{8, 8, 8});
+
+    pooled = VolumeRAMPrecision<float>(size3_t{3, 3, 3});
+    EXPECT_EQ(RAMAllocation::Zeroed, pooled.getAllocation());
+    pooled.setDimensions(size3_t{4, 4, 4});
+
+    LayerRAMPrecision<float> layer(size2_t{3, 3}, LayerType::Color, RAMAllocation::Pooled);
+    std::fill(layer.getDataTyped(), layer.getDataTyped() + 9, 2.0f);
+    LayerRAMPrecision<float> assigned(size2_t{1, 1});
+    assigned = layer;
+    EXPECT_EQ(RAMAllocation::Pooled, assigned.getAllocation());
+    EXPECT_EQ(2.0f, assigned.getDataTyped()[8]);
+    assigned.setDimensions(size2_t{5, 5});
+    util::clearRAMPool();
+}
+
+TEST(RAMAllocation, zeroedLayerInitialization) {
+    LayerRAMPrecision<float> color(size2_t{3, 3}, LayerType::Color, RAMAllocation::Zeroed);
+    EXPECT_TRUE(std::all_of(color.getDataTyped(), color.getDataTyped() + 9,
+                            [](float v) { return v == 0.0f; }));
+    LayerRAMPrecision<float> depth(size2_t{3, 3}, LayerType::Depth, RAMAllocation::Zeroed);
+    EXPECT_TRUE(std::all_of(depth.getDataTyped(), depth.getDataTyped() + 9,
+                            [](float v) { return v == 1.0f; }));
+
+    LayerRAMPrecision<float> pooled(size2_t{3, 3}, LayerType::Color, RAMAllocation::Pooled);
+    std::fill(pooled.getDataTyped(), pooled.getDataTyped() + 9, 2.0f);
+    LayerRAMPrecision<float> copy(pooled);
+    EXPECT_EQ(2.0f, copy.getDataTyped()[8]);
+    util::clearRAMPool();
+}
+
+}  // namespace inviwo
@@ -0,0 +1,134 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <array>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+
+TEST(ByteSwap, words) {
+    std::vector<std::uint16_t> a16{0x0102, 0xA0B0, 0x00FF};
+    util::byteSwap(a16.data(), a16.size() * sizeof(std::uint16_t), sizeof(std::uint16_t));
+    EXPECT_EQ((std::vector<std::uint16_t>{0x0201, 0xB0A0, 0xFF00}), a16);
+
+    std::vector<std::uint32_t> a32{0x01020304, 0xA0B0C0D0};
+    util::byteSwap(a32.data(), a32.size() * sizeof(std::uint32_t), sizeof(std::uint32_t));
+    EXPECT_EQ((std::vector<std::uint32_t>{0x04030201, 0xD0C0B0A0}), a32);
+
+    std::vector<std::uint64_t> a64{0x0102030405060708};
+    util::byteSwap(a64.data(), a64.size() * sizeof(std::uint64_t), sizeof(std::uint64_t));
+    EXPECT_EQ((std::vector<std::uint64_t>{0x0807060504030201}), a64);
+}
+
+TEST(ByteSwap, unalignedAndOddSizes) {
+    std::array<char, 7> bytes{0, 1, 2, 3, 4, 5, 6};
+    util::byteSwap(bytes.data() + 1, 4, 2);
+    EXPECT_EQ((std::array<char, 7>{0, 2, 1, 4, 3, 5, 6}), bytes);
+
+    std::array<char, 6> triples{1, 2, 3, 4, 5, 6};
+    util::byteSwap(triples.data(), triples.size(), 3);
+    EXPECT_EQ((std::array<char, 6>{3, 2, 1, 6, 5, 4}), triples);
+}
+
+namespace {
+
+std::shared_ptr<VolumeRAMPrecision<std::uint16_t>> loadRaw(const std::string& file, size_t offset,
+                                                           bool littleEndian, size3_t dims) {
+    RawVolumeRAMLoader loader(file, offset, littleEndian);
+    VolumeDisk disk(dims, DataUInt16::get());
+    return std::dynamic_pointer_cast<VolumeRAMPrecision<std::uint16_t>>(
+        loader.createRepresentation(disk));
+}
+
+}  // namespace
+
+TEST(RawVolumeRAMLoader, mappedData) {
+    util::TempFileHandle tmpFile("", ".raw");
+    // two bytes of header, data aligned for uint16
+    const std::array<unsigned char, 10> bytes{0xFF, 0xFF, 0x01, 0x00, 0x02, 0x00,
+                                              0x03, 0x00, 0x04, 0x01};
+    std::fwrite(bytes.data(), 1, bytes.size(), tmpFile);
+    std::fflush(tmpFile);
+
+    const size3_t dims{2, 2, 1};
+    auto little = loadRaw(tmpFile.getFileName(), 2, true, dims);
+    ASSERT_TRUE(little);
+    auto data = little->getDataTyped();
+    EXPECT_EQ((std::vector<std::uint16_t>{1, 2, 3, 0x0104}),
+              (std::vector<std::uint16_t>(data, data + 4)));
+
+    auto big = loadRaw(tmpFile.getFileName(), 2, false, dims);
+    ASSERT_TRUE(big);
+    data = big->getDataTyped();
+    EXPECT_EQ((std::vector<std::uint16_t>{0x0100, 0x0200, 0x0300, 0x0401}),
+              (std::vector<std::uint16_t>(data, data + 4)));
+
+    // writes go to private copies and neither touch the file nor other volumes
+    little->getDataTyped()[0] = 42;
+    EXPECT_EQ(0x0100, big->getDataTyped()[0]);
+    EXPECT_EQ(1, loadRaw(tmpFile.getFileName(), 2, true, dims)->getDataTyped()[0]);
+
+    // copies own their memory
+    auto copy = std::shared_ptr<VolumeRAMPrecision<std::uint16_t>>(little->clone());
+    little.reset();
+    EXPECT_EQ(42, copy->getDataTyped()[0]);
+    EXPECT_EQ(0x0104, copy->getDataTyped()[3]);
+}
+
+TEST(RawVolumeRAMLoader, misalignedOffset) {
+    util::TempFileHandle tmpFile("", ".raw");
+    const std::array<unsigned char, 5> bytes{0xFF, 0x01, 0x00, 0x02, 0x00};
+    std::fwrite(bytes.data(), 1, bytes.size(), tmpFile);
+    std::fflush(tmpFile);
+
+    auto volume = loadRaw(tmpFile.getFileName(), 1, true, size3_t{2, 1, 1});
+    ASSERT_TRUE(volume);
+    EXPECT_EQ(1, volume->getDataTyped()[0]);
+    EXPECT_EQ(2, volume->getDataTyped()[1]);
+}
+
+TEST(RawVolumeRAMLoader, missingData) {
+    util::TempFileHandle tmpFile("", ".raw");
+    EXPECT_THROW(loadRaw(tmpFile.getFileName(), 0, true, size3_t{2, 2, 2}), DataReaderException);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,228 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/serialization/serialization.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/io/serialization/ticpp.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+class BinaryTestClass : public Serializable {
+public:
+    BinaryTestClass(int i = 0, double d = 0.0, std::string s = "") : i_{i}, d_{d}, s_{s} {}
+
+    virtual void serialize(Serializer& s) const override {
+        s.serialize("i", i_);
+        s.serialize("d", d_);
+        s.serialize("s", s_, SerializationTarget::Attribute);
+    }
+    virtual void deserialize(Deserializer& d) override {
+        d.deserialize("i", i_);
+        d.deserialize("d", d_);
+        d.deserialize("s", s_, SerializationTarget::Attribute);
+    }
+
+    bool operator==(const BinaryTestClass& rhs) const {
+        return i_ == rhs.i_ && d_ == rhs.d_ && s_ == rhs.s_;
+    }
+
+    int i_;
+    double d_;
+    std::string s_;
+};
+
+template <typename T>
+T binaryRoundTrip(const T& inValue) {
+    const std::string refpath = filesystem::findBasePath();
+    std::stringstream ss;
+    Serializer serializer(refpath);
+    serializer.serialize("serializedValue", inValue);
+    serializer.writeFile(ss, SerializationFormat::Binary);
+    Deserializer deserializer(ss, refpath);
+    T outValue{};
+    deserializer.deserialize("serializedValue", outValue);
+    return outValue;
+}
+
+std::string toXml(const TxDocument& doc) {
+    std::stringstream ss;
+    ss << doc;
+    return ss.str();
+}
+
+}  // namespace
+
+TEST(BinarySerializationTest, integers) {
+    for (int value : {0, 1, -1, 7, -42, 1000000, std::numeric_limits<int>::min(),
+                      std::numeric_limits<int>::max()}) {
+        EXPECT_EQ(value, binaryRoundTrip(value));
+    }
+    EXPECT_EQ(std::numeric_limits<long long>::min(),
+              binaryRoundTrip(std::numeric_limits<long long>::min()));
+    EXPECT_EQ(std::numeric_limits<unsigned long long>::max(),
+              binaryRoundTrip(std::numeric_limits<unsigned long long>::max()));
+    EXPECT_EQ('c', binaryRoundTrip('c'));
+    EXPECT_TRUE(binaryRoundTrip(true));
+}
+
+TEST(BinarySerializationTest, reals) {
+    for (float value : {0.0f, -0.0f, 0.1f, 3.14f, -1.5e-7f, std::numeric_limits<float>::min(),
+                        std::numeric_limits<float>::max(), 1.0f - 1e-7f}) {
+        EXPECT_EQ(value, binaryRoundTrip(value));
+    }
+    for (double value : {0.0, 0.1, 6.28, -2.5e300, std::numeric_limits<double>::epsilon(),
+                         std::numeric_limits<double>::min(), std::numeric_limits<double>::max(),
+                         1.0 - std::numeric_limits<double>::epsilon()}) {
+        EXPECT_EQ(value, binaryRoundTrip(value));
+    }
+}
+
+TEST(BinarySerializationTest, strings) {
+    for (std::string value : {"", "text", "-0", "007", "1e5", "1,5", "<&>\"'", "line\nbreak",
+                              "  padded  ", "\xc3\xa5\xc3\xa4\xc3\xb6"}) {
+        EXPECT_EQ(value, binaryRoundTrip(value));
+    }
+}
+
+TEST(BinarySerializationTest, glm) {
+    const vec3 v{1.1f, -2.2f, 3.3f};
+    EXPECT_EQ(v, binaryRoundTrip(v));
+    const ivec4 iv{1, -2, 3, std::numeric_limits<int>::max()};
+    EXPECT_EQ(iv, binaryRoundTrip(iv));
+    const dmat4 m{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0,
+                  9.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7};
+    EXPECT_EQ(m, binaryRoundTrip(m));
+}
+
+TEST(BinarySerializationTest, containers) {
+    const std::vector<BinaryTestClass> vector{{1, 0.5, "a"}, {2, -0.25, "b"}, {3, 1e10, ""}};
+    EXPECT_EQ(vector, binaryRoundTrip(vector));
+
+    const std::map<std::string, int> map{{"one", 1}, {"two", 2}, {"three", 3}};
+    EXPECT_EQ(map, binaryRoundTrip(map));
+
+    const std::vector<std::string> strings{"x", "x", "y", "x"};
+    EXPECT_EQ(strings, binaryRoundTrip(strings));
+}
+
+TEST(BinarySerializationTest, sameDocumentAsXml) {
+    Serializer serializer(filesystem::findBasePath());
+    serializer.serialize("vector", std::vector<BinaryTestClass>{{1, 0.1, "a"}, {-5, 2.0, "&b"}});
+    serializer.serialize("value", 0.30000000000000004);
+    serializer.serialize("vec", vec4{0.1f, 0.2f, 0.3f, 0.4f});
+
+    std::stringstream xml;
+    serializer.writeFile(xml, SerializationFormat::Xml);
+    std::stringstream binary;
+    serializer.writeFile(binary, SerializationFormat::Binary);
+
+    EXPECT_FALSE(util::isBinaryDocument(xml));
+    EXPECT_TRUE(util::isBinaryDocument(binary));
+
+    TxDocument xmlDoc;
+    xml >> xmlDoc;
+    TxDocument binaryDoc;
+    util::readBinaryDocument(binary, binaryDoc);
+    EXPECT_EQ(toXml(xmlDoc), toXml(binaryDoc));
+}
+
+TEST(BinarySerializationTest, smallerThanXml) {
+    Serializer serializer(filesystem::findBasePath());
+    std::vector<BinaryTestClass> vector;
+    for (int i = 0; i < 100; ++i) vector.emplace_back(i, i * 0.5, "item");
+    serializer.serialize("vector", vector);
+
+    std::stringstream xml;
+    serializer.writeFile(xml, SerializationFormat::Xml);
+    std::stringstream binary;
+    serializer.writeFile(binary, SerializationFormat::Binary);
+    EXPECT_LT(binary.str().size(), xml.str().size());
+}
+
+TEST(BinarySerializationTest, invalidData) {
+    Serializer serializer(filesystem::findBasePath());
+    serializer.serialize("value", BinaryTestClass{1, 2.0, "three"});
+    std::stringstream binary;
+    serializer.writeFile(binary, SerializationFormat::Binary);
+    const auto data = binary.str();
+
+    // Every truncation of the data has to be detected
+    for (size_t size = 0; size < data.size(); ++size) {
+        std::stringstream truncated{data.substr(0, size)};
+        TxDocument doc;
+        EXPECT_THROW(util::readBinaryDocument(truncated, doc), SerializationException);
+    }
+
+    std::stringstream trailing{data + "x"};
+    TxDocument doc;
+    EXPECT_THROW(util::readBinaryDocument(trailing, doc), SerializationException);
+}
+
+TEST(BinarySerializationTest, nestingLimit) {
+    auto write = [](size_t depth) {
+        TxDocument doc;
+        std::vector<std::unique_ptr<TxElement>> elements;
+        elements.push_back(std::make_unique<TxElement>("root"));
+        doc.LinkEndChild(elements.back().get());
+        for (size_t i = 0; i < depth; ++i) {
+            auto element = std::make_unique<TxElement>("child");
+            elements.back()->LinkEndChild(element.get());
+            elements.push_back(std::move(element));
+        }
+        std::stringstream binary;
+        util::writeBinaryDocument(doc, binary);
+        return binary;
+    };
+
+    auto shallow = write(100);
+    TxDocument shallowDoc;
+    EXPECT_NO_THROW(util::readBinaryDocument(shallow, shallowDoc));
+
+    // Corrupt data could nest arbitrarily deep, which would overflow the stack
+    auto deep = write(1000);
+    TxDocument deepDoc;
+    EXPECT_THROW(util::readBinaryDocument(deep, deepDoc), SerializationException);
+}
+
+}  // namespace inviwo
@@ -36,7 +36,9 @@
 #include <inviwo/core/datastructures/tfprimitiveset.h>
 #include <inviwo/core/datastructures/transferfunction.h>
 
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 namespace inviwo {
 
@@ -82,4 +84,54 @@ TEST(TFSampling, linear) {
     EXPECT_EQ(color2, tf.sample(1.0));
 }
 
+TEST(TFSimplify, linear) {
+    vec4 color1{0.0f, 1.0f, 0.0f, 0.5f};
+    vec4 color2{1.0f, 0.0f, 0.5f, 1.0f};
+    std::vector<TFPrimitiveData> points;
+    for (int i = 0; i <= 100; ++i) {
+        const double x = i / 100.0;
+        points.push_back({x, glm::mix(color1, color2, static_cast<float>(x))});
+    }
+    const auto simple = TransferFunction::simplify(points, 0.01);
+    ASSERT_EQ(2u, simple.size());
+    EXPECT_EQ(points.front(), simple.front());
+    EXPECT_EQ(points.back(), simple.back());
+}
+
+TEST(TFSimplify, keepsCorners) {
+    vec4 color1{0.0f, 0.0f, 0.0f, 0.0f};
+    vec4 color2{1.0f, 1.0f, 1.0f, 1.0f};
+    std::vector<TFPrimitiveData> points;
+    for (int i = 0; i <= 100; ++i) {
+        const double x = i / 100.0;
+        // a triangle with its peak at 0.5
+        const float t = static_cast<float>(1.0 - std::abs(2.0 * x - 1.0));
+        points.push_back({x, glm::mix(color1, color2, t)});
+    }
+    const auto simple = TransferFunction::simplify(points, 0.01);
+    ASSERT_EQ(3u, simple.size());
+    EXPECT_EQ(0.0, simple[0].pos);
+    EXPECT_EQ(0.5, simple[1].pos);
+    EXPECT_EQ(1.0, simple[2].pos);
+}
+
+TEST(TFSimplify, keepsErrorBelowDelta) {
+    std::vector<TFPrimitiveData> points;
+    for (int i = 0; i <= 1000; ++i) {
+        const double x = i / 1000.0;
+        const float v = static_cast<float>(0.5 + 0.5 * std::sin(20.0 * x));
+        points.push_back({x, vec4{v, v * v, 1.0f - v, 1.0f}});
+    }
+    const double delta = 0.01;
+    const auto simple = TransferFunction::simplify(points, delta);
+    EXPECT_LT(simple.size(), points.size());
+
+    const TransferFunction tf{simple};
+    for (const auto& p : points) {
+        const auto error = glm::compMax(glm::abs(tf.sample(p.pos) - p.color));
+        // errors may accumulate when neighboring points are removed
+        EXPECT_LT(error, 4 * delta) << "at " << p.pos;
+    }
+}
+
 }  // namespace inviwo
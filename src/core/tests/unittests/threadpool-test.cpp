@@ -0,0 +1,150 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/threadpool.h>
+
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+TEST(ThreadPool, EnqueueReturnsResult) {
+    ThreadPool pool(4);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.enqueue([](int a, int b) { return a * b; }, i, 2));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(2 * i, futures[i].get());
+    }
+}
+
+TEST(ThreadPool, EnqueueWithoutWorkers) {
+    ThreadPool pool(0);
+    auto f = pool.enqueue([]() { return 42; });
+    ASSERT_EQ(std::future_status::ready, f.wait_for(std::chrono::seconds(0)));
+    EXPECT_EQ(42, f.get());
+}
+
+TEST(ThreadPool, EnqueuePropagatesExceptions) {
+    ThreadPool pool(2);
+    auto f = pool.enqueue([]() -> int { throw std::runtime_error("fail"); });
+    EXPECT_THROW(f.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, EnqueueRawAndResize) {
+    ThreadPool pool(3);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 10000; ++i) {
+        pool.enqueueRaw([&count]() { ++count; });
+    }
+    // Shrinking to zero will block until all tasks are done
+    while (pool.trySetSize(0) != 0) {
+    }
+    EXPECT_EQ(10000, count.load());
+    EXPECT_EQ(0, pool.getQueueSize());
+
+    EXPECT_EQ(5, pool.trySetSize(5));
+    auto f = pool.enqueue(ThreadPool::Priority::High, [&count]() { return count.load(); });
+    EXPECT_EQ(10000, f.get());
+}
+
+TEST(ThreadPool, ConcurrentProducers) {
+    ThreadPool pool(4);
+    std::atomic<int> count{0};
+    {
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t) {
+            producers.emplace_back([&pool, &count]() {
+                for (int i = 0; i < 5000; ++i) pool.enqueueRaw([&count]() { ++count; });
+            });
+        }
+        for (auto& producer : producers) producer.join();
+    }
+    while (pool.trySetSize(0) != 0) {
+    }
+    EXPECT_EQ(20000, count.load());
+    EXPECT_EQ(0, pool.getQueueSize());
+}
+
+TEST(ThreadPool, TaskStoresLargeFunctors) {
+    std::array<size_t, 64> data{};
+    std::iota(data.begin(), data.end(), size_t{0});
+    size_t sum = 0;
+    ThreadPool::Task task{[data, &sum]() { sum = std::accumulate(data.begin(), data.end(), size_t{0}); }};
+    ThreadPool::Task moved{std::move(task)};
+    EXPECT_FALSE(task);
+    ASSERT_TRUE(moved);
+    moved();
+    EXPECT_EQ(63 * 64 / 2, sum);
+}
+
+namespace {
+size_t fib(ThreadPool& pool, size_t n) {
+    if (n < 10) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    size_t a = 0;
+    size_t b = 0;
+    ThreadPool::TaskGroup group{pool};
+    group.run([&]() { a = fib(pool, n - 1); });
+    group.run([&]() { b = fib(pool, n - 2); });
+    group.wait();
+    return a + b;
+}
+}  // namespace
+
+TEST(ThreadPool, TaskGroupForkJoin) {
+    ThreadPool pool(4);
+    auto f = pool.enqueue([&pool]() { return fib(pool, 22); });
+    EXPECT_EQ(17711, f.get());
+}
+
+TEST(ThreadPool, TaskGroupPropagatesExceptions) {
+    ThreadPool pool(2);
+    ThreadPool::TaskGroup group{pool};
+    std::atomic<int> count{0};
+    for (int i = 0; i < 100; ++i) {
+        group.run([&count, i]() {
+            ++count;
+            if (i == 50) throw std::runtime_error("fail");
+        });
+    }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(100, count.load());
+}
+
+}  // namespace inviwo
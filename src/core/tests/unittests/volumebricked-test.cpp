@@ -0,0 +1,214 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/datastructures/histogram.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+const size3_t dims{7, 5, 6};
+
+std::vector<std::uint16_t> voxels() {
+    std::vector<std::uint16_t> data(glm::compMul(dims));
+    std::iota(data.begin(), data.end(), std::uint16_t{0});
+    return data;
+}
+
+std::uint16_t voxel(size3_t pos) {
+    return static_cast<std::uint16_t>((pos.z * dims.y + pos.y) * dims.x + pos.x);
+}
+
+// Loads the whole volume but can not read regions
+class FullLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    FullLoader(int& loads) : loads_{loads} {}
+    virtual FullLoader* clone() const override { return new FullLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation(
+        const VolumeRepresentation& src) const override {
+        ++loads_;
+        auto data = voxels();
+        auto ram = std::make_shared<VolumeRAMPrecision<std::uint16_t>>(src.getDimensions());
+        std::copy(data.begin(), data.end(), ram->getDataTyped());
+        return ram;
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>,
+                                      const VolumeRepresentation&) const override {}
+
+private:
+    int& loads_;
+};
+
+void checkRegion(const VolumeBricked& bricked, size3_t offset, size3_t extent) {
+    auto region = std::dynamic_pointer_cast<VolumeRAMPrecision<std::uint16_t>>(
+        bricked.getRegion(offset, extent));
+    ASSERT_TRUE(region);
+    ASSERT_EQ(extent, region->getDimensions());
+    const auto data = region->getDataTyped();
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            for (size_t x = 0; x < extent.x; ++x) {
+                EXPECT_EQ(voxel(offset + size3_t{x, y, z}),
+                          data[(z * extent.y + y) * extent.x + x]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+class VolumeBrickedTest : public ::testing::Test {
+protected:
+    virtual void SetUp() override {
+        const auto data = voxels();
+        std::fwrite(data.data(), sizeof(std::uint16_t), data.size(), tmpFile_);
+        std::fflush(tmpFile_);
+
+        auto disk = std::make_shared<VolumeDisk>(tmpFile_.getFileName(), dims, DataUInt16::get());
+        disk->setLoader(new RawVolumeRAMLoader(tmpFile_.getFileName(), 0, true));
+        disk_ = disk;
+    }
+
+    util::TempFileHandle tmpFile_{"", ".raw"};
+    std::shared_ptr<const VolumeDisk> disk_;
+};
+
+TEST_F(VolumeBrickedTest, bricks) {
+    VolumeBricked bricked(disk_, size3_t{4, 4, 4});
+    EXPECT_EQ(dims, bricked.getDimensions());
+    EXPECT_EQ(DataUInt16::get(), bricked.getDataFormat());
+    EXPECT_EQ(size3_t(2, 2, 2), bricked.getNumberOfBricks());
+    EXPECT_EQ(size3_t(4, 4, 4), bricked.getBrickExtent(size3_t{0}));
+    EXPECT_EQ(size3_t(3, 1, 2), bricked.getBrickExtent(size3_t{1}));
+    EXPECT_EQ(size3_t(4, 0, 4), bricked.getBrickOffset(size3_t{1, 0, 1}));
+    EXPECT_THROW(bricked.getBrick(size3_t{2, 0, 0}), RangeException);
+
+    size_t count = 0;
+    bricked.forEachBrick([&](const VolumeRAM& brick, size3_t offset) {
+        auto typed = static_cast<const VolumeRAMPrecision<std::uint16_t>&>(brick).getDataTyped();
+        EXPECT_EQ(voxel(offset), typed[0]);
+        count += glm::compMul(brick.getDimensions());
+    });
+    EXPECT_EQ(glm::compMul(dims), count);
+}
+
+TEST_F(VolumeBrickedTest, regions) {
+    VolumeBricked bricked(disk_, size3_t{3, 2, 4});
+    checkRegion(bricked, size3_t{0}, dims);
+    checkRegion(bricked, size3_t{2, 1, 3}, size3_t{4, 3, 2});
+    checkRegion(bricked, size3_t{6, 4, 5}, size3_t{1, 1, 1});
+    checkRegion(bricked, size3_t{0, 3, 0}, size3_t{7, 1, 6});
+    checkRegion(bricked, size3_t{1}, size3_t{0});
+    EXPECT_THROW(bricked.getRegion(size3_t{1, 0, 0}, dims), RangeException);
+}
+
+TEST_F(VolumeBrickedTest, cacheIsBounded) {
+    const size_t brickBytes = 2 * 2 * 2 * sizeof(std::uint16_t);
+    VolumeBricked bricked(disk_, size3_t{2}, 3 * brickBytes);
+
+    auto first = bricked.getBrick(size3_t{0});
+    EXPECT_EQ(first, bricked.getBrick(size3_t{0}));
+    EXPECT_EQ(brickBytes, bricked.getCachedBytes());
+
+    bricked.forEachBrick([](const VolumeRAM&, size3_t) {});
+    EXPECT_LE(bricked.getCachedBytes(), bricked.getCacheSize());
+    EXPECT_NE(first, bricked.getBrick(size3_t{0}));
+
+    // clones share the cache
+    std::unique_ptr<VolumeBricked> clone{bricked.clone()};
+    EXPECT_EQ(bricked.getBrick(size3_t{0}), clone->getBrick(size3_t{0}));
+
+    clone->clearCache();
+    EXPECT_EQ(0, bricked.getCachedBytes());
+
+    bricked.setCacheSize(0);
+    bricked.getBrick(size3_t{0});
+    EXPECT_EQ(brickBytes, bricked.getCachedBytes());
+}
+
+TEST_F(VolumeBrickedTest, prefetch) {
+    VolumeBricked bricked(disk_, size3_t{2});
+    bricked.prefetch(size3_t{1, 1, 1}, size3_t{4, 2, 2});
+    checkRegion(bricked, size3_t{1, 1, 1}, size3_t{4, 2, 2});
+    EXPECT_NO_THROW(bricked.prefetch(size3_t{6, 4, 5}, size3_t{8}));
+}
+
+TEST_F(VolumeBrickedTest, histograms) {
+    VolumeBricked bricked(disk_, size3_t{4});
+    const dvec2 range{0.0, static_cast<double>(glm::compMul(dims) - 1)};
+    const size_t bins = 16;
+
+    util::HistogramBuilder<std::uint16_t> builder(range, bins);
+    bricked.forEachBrick([&](const VolumeRAM& brick, size3_t) {
+        auto data = static_cast<const VolumeRAMPrecision<std::uint16_t>&>(brick).getDataTyped();
+        builder.add(data, data + glm::compMul(brick.getDimensions()));
+    });
+    HistogramContainer bricks{builder.finish()};
+
+    const auto data = voxels();
+    HistogramContainer whole{range, bins, data.begin(), data.end()};
+
+    ASSERT_EQ(1, bricks.size());
+    EXPECT_EQ(whole[0].getData(), bricks[0].getData());
+    EXPECT_DOUBLE_EQ(whole[0].stats_.mean, bricks[0].stats_.mean);
+    EXPECT_DOUBLE_EQ(whole[0].stats_.max, bricks[0].stats_.max);
+}
+
+TEST(VolumeBricked, requiresRegionLoader) {
+    int loads = 0;
+    auto disk = std::make_shared<VolumeDisk>(dims, DataUInt16::get());
+    disk->setLoader(new FullLoader(loads));
+    ASSERT_FALSE(disk->canReadRegion());
+
+    EXPECT_THROW(VolumeBricked(disk, size3_t{4}), Exception);
+
+    // Bricking would load the whole volume anyway, use the VolumeRAM instead
+    Volume volume(disk);
+    EXPECT_EQ(nullptr, util::getBrickedRepresentation(volume));
+    EXPECT_EQ(0, loads);
+}
+
+}  // namespace inviwo
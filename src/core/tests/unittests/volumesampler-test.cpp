@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2020 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<Volume> createVolume(const DataFormatBase* format) {
+    const size3_t dims{7, 5, 3};
+    auto volume = std::make_shared<Volume>(dims, format);
+    auto ram = volume->getEditableRepresentation<VolumeRAM>();
+    size_t i = 0;
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x, ++i) {
+                ram->setFromDVec4(size3_t{x, y, z},
+                                  dvec4{i % 11, (3 * i) % 7, (5 * i) % 13, i % 2});
+            }
+        }
+    }
+    return volume;
+}
+
+// Reference implementation using the virtual VolumeRAM accessors
+dvec4 referenceSample(const VolumeRAM& ram, const dvec3& pos) {
+    if (glm::any(glm::lessThan(pos, dvec3(0.0))) || glm::any(glm::greaterThan(pos, dvec3(1.0)))) {
+        return dvec4(0.0);
+    }
+    const auto dims = ram.getDimensions();
+    const dvec3 samplePos = pos * dvec3(dims - size3_t(1));
+    const size3_t indexPos = size3_t(samplePos);
+    const dvec3 interpolants = samplePos - dvec3(indexPos);
+
+    const auto voxel = [&](const size3_t& offset) {
+        return ram.getAsDVec4(glm::clamp(indexPos + offset, size3_t(0), dims - size3_t(1)));
+    };
+    const dvec4 samples[8] = {voxel({0, 0, 0}), voxel({1, 0, 0}), voxel({0, 1, 0}),
+                              voxel({1, 1, 0}), voxel({0, 0, 1}), voxel({1, 0, 1}),
+                              voxel({0, 1, 1}), voxel({1, 1, 1})};
+    return Interpolation<dvec4>::trilinear(samples, interpolants);
+}
+
+std::vector<dvec3> samplePositions() {
+    std::vector<dvec3> positions;
+    for (double z = -0.1; z <= 1.1; z += 0.07) {
+        for (double y = -0.1; y <= 1.1; y += 0.09) {
+            for (double x = -0.1; x <= 1.1; x += 0.11) {
+                positions.emplace_back(x, y, z);
+            }
+        }
+    }
+    positions.emplace_back(0.0, 0.0, 0.0);
+    positions.emplace_back(1.0, 1.0, 1.0);
+    positions.emplace_back(1.0, 0.5, 0.0);
+    return positions;
+}
+
+}  // namespace
+
+TEST(VolumeSampler, MatchesVirtualAccess) {
+    for (auto format : {static_cast<const DataFormatBase*>(DataUInt8::get()),
+                        static_cast<const DataFormatBase*>(DataFloat32::get()),
+                        static_cast<const DataFormatBase*>(DataVec3Float64::get()),
+                        static_cast<const DataFormatBase*>(DataVec4Int16::get())}) {
+        SCOPED_TRACE(format->getString());
+        auto volume = createVolume(format);
+        const auto& ram = *volume->getRepresentation<VolumeRAM>();
+        VolumeDoubleSampler<4> sampler(volume);
+
+        const auto positions = samplePositions();
+        std::vector<dvec4> batch(positions.size());
+        sampler.sample(positions, batch);
+
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const auto expected = referenceSample(ram, positions[i]);
+            EXPECT_EQ(expected, sampler.sample(positions[i]));
+            EXPECT_EQ(expected, batch[i]);
+        }
+    }
+}
+
+TEST(VolumeSampler, ScalarMatchesVirtualAccess) {
+    auto volume = createVolume(DataUInt16::get());
+    const auto& ram = *volume->getRepresentation<VolumeRAM>();
+    VolumeDoubleSampler<1> sampler(volume);
+
+    for (const auto& pos : samplePositions()) {
+        EXPECT_EQ(referenceSample(ram, pos).x, sampler.sample(pos));
+    }
+}
+
+}  // namespace inviwo
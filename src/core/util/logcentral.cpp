@@ -34,6 +34,9 @@
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/util/threadutil.h>
+
+#include <chrono>
 
 namespace inviwo {
 
@@ -83,13 +86,236 @@ void Logger::logAssertion(const char* file, const char* function, int line, std:
     log("Assertion failed", LogLevel::Error, LogAudience::Developer, file, function, line, msg);
 }
 
+struct LogCentral::Record {
+    enum class Kind { Log, Network };
+    Kind kind = Kind::Log;
+    std::string source;
+    LogLevel level = LogLevel::Info;
+    LogAudience audience = LogAudience::Developer;
+    // file and function might point into temporaries, see util::log, hence we copy them
+    std::string file;
+    std::string function;
+    int line = 0;
+    std::string msg;
+};
+
+/**
+ * Bounded multi-producer queue of log records. Producers reserve a slot with a single
+ * compare-and-swap on the enqueue position, and publish it by bumping the sequence number of the
+ * slot. Only the thread holding LogCentral::drainMutex_ pops records.
+ */
+class LogCentral::RecordQueue {
+public:
+    explicit RecordQueue(size_t capacity)
+        : mask_{capacity - 1}, slots_{std::make_unique<Slot[]>(capacity)} {
+        for (size_t i = 0; i < capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(Record& record) {
+        auto pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& slot = slots_[pos & mask_];
+            const auto seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(Record& record) {
+        const auto pos = dequeuePos_.load(std::memory_order_relaxed);
+        auto& slot = slots_[pos & mask_];
+        const auto seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != pos + 1) return false;  // empty, or the slot is not yet published
+        record = std::move(slot.record);
+        slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool empty() const {
+        const auto pos = dequeuePos_.load(std::memory_order_relaxed);
+        return slots_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        Record record;
+    };
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+};
+
+namespace {
+// Set while a thread is calling the loggers. Messages logged by a logger are then delivered
+// directly, the queue might be full and this thread might be the only one draining it.
+thread_local bool delivering = false;
+
+const char* orEmpty(const char* str) { return str ? str : ""; }
+
+struct DeliveringScope {
+    DeliveringScope() : previous{delivering} { delivering = true; }
+    ~DeliveringScope() { delivering = previous; }
+    bool previous;
+};
+}  // namespace
+
 LogCentral::LogCentral() : logVerbosity_(LogVerbosity::Info), logStacktrace_(false) {}
 
+LogCentral::~LogCentral() { setAsync(false); }
+
 void LogCentral::setVerbosity(LogVerbosity verbosity) { logVerbosity_ = verbosity; }
 
 LogVerbosity LogCentral::getVerbosity() { return logVerbosity_; }
 
-void LogCentral::registerLogger(std::weak_ptr<Logger> logger) { loggers_.push_back(logger); }
+void LogCentral::registerLogger(std::weak_ptr<Logger> logger) {
+    std::scoped_lock lock{loggersMutex_};
+    loggers_.push_back(logger);
+}
+
+template <typename Callback>
+void LogCentral::forEachLogger(Callback&& callback) {
+    std::scoped_lock lock{loggersMutex_};
+    DeliveringScope scope;
+    // use remove if here to remove expired weak pointers while calling the loggers.
+    util::erase_remove_if(loggers_, [&](const std::weak_ptr<Logger>& logger) {
+        if (auto l = logger.lock()) {
+            callback(*l);
+            return false;
+        } else {
+            return true;
+        }
+    });
+}
+
+void LogCentral::deliver(Record& record) {
+    switch (record.kind) {
+        case Record::Kind::Log:
+            forEachLogger([&](Logger& l) {
+                l.log(record.source, record.level, record.audience, record.file.c_str(),
+                      record.function.c_str(), record.line, record.msg);
+            });
+            break;
+        case Record::Kind::Network:
+            forEachLogger([&](Logger& l) {
+                l.logNetwork(record.level, record.audience, record.msg, record.file.c_str(),
+                             record.function.c_str(), record.line);
+            });
+            break;
+    }
+}
+
+bool LogCentral::enqueue(Record& record) {
+    if (!async_.load(std::memory_order_acquire) || delivering) return false;
+    auto* queue = queuePtr_.load(std::memory_order_acquire);
+
+    while (!queue->push(record)) {
+        if (overflow_.load(std::memory_order_relaxed) == LogOverflowPolicy::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (!async_.load(std::memory_order_acquire)) return false;
+        wake_.notify_one();
+        std::this_thread::yield();
+    }
+    if (sleeping_.load(std::memory_order_acquire)) wake_.notify_one();
+    return true;
+}
+
+void LogCentral::drain() {
+    auto* queue = queuePtr_.load(std::memory_order_acquire);
+    if (!queue) return;
+
+    Record record;
+    while (queue->pop(record)) {
+        deliver(record);
+    }
+    if (const auto dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+        Record warning;
+        warning.source = "LogCentral";
+        warning.level = LogLevel::Warn;
+        warning.file = __FILE__;
+        warning.function = __FUNCTION__;
+        warning.line = __LINE__;
+        warning.msg =
+            std::to_string(dropped) + " log messages were dropped, the log queue was full";
+        deliver(warning);
+    }
+}
+
+void LogCentral::drainLoop() {
+    auto* queue = queuePtr_.load(std::memory_order_acquire);
+    for (;;) {
+        {
+            std::scoped_lock lock{drainMutex_};
+            drain();
+        }
+        std::unique_lock lock{wakeMutex_};
+        if (stop_) break;
+        sleeping_.store(true, std::memory_order_release);
+        // Producers only notify when they see us sleeping, the timeout covers the case where a
+        // record is published after our check but before we announced that we sleep.
+        wake_.wait_for(lock, std::chrono::milliseconds{50},
+                       [&]() { return stop_ || !queue->empty(); });
+        sleeping_.store(false, std::memory_order_release);
+    }
+}
+
+void LogCentral::setAsync(bool async, size_t capacity, LogOverflowPolicy overflow) {
+    std::scoped_lock asyncLock{asyncMutex_};
+    overflow_.store(overflow, std::memory_order_relaxed);
+    if (async == async_.load()) return;
+
+    if (async) {
+        if (!queue_) {
+            size_t size = 1;
+            while (size < std::max(capacity, size_t{2})) size <<= 1;
+            queue_ = std::make_unique<RecordQueue>(size);
+            queuePtr_.store(queue_.get(), std::memory_order_release);
+        }
+        {
+            std::scoped_lock lock{wakeMutex_};
+            stop_ = false;
+        }
+        thread_ = std::thread([this]() { drainLoop(); });
+        util::setThreadDescription(thread_, "Inviwo Log Thread");
+        async_.store(true, std::memory_order_release);
+    } else {
+        async_.store(false, std::memory_order_release);
+        {
+            std::scoped_lock lock{wakeMutex_};
+            stop_ = true;
+        }
+        wake_.notify_one();
+        if (thread_.joinable()) thread_.join();
+        flush();
+    }
+}
+
+bool LogCentral::isAsync() const { return async_.load(std::memory_order_acquire); }
+
+void LogCentral::flush() {
+    // A logger that logs is already delivering, its messages go directly to the loggers.
+    if (delivering) return;
+    auto* queue = queuePtr_.load(std::memory_order_acquire);
+    if (!queue || (queue->empty() && dropped_.load(std::memory_order_relaxed) == 0)) return;
+    std::scoped_lock lock{drainMutex_};
+    drain();
+}
 
 void LogCentral::log(std::string source, LogLevel level, LogAudience audience, const char* file,
                      const char* function, int line, std::string msg) {
@@ -109,15 +335,13 @@ void LogCentral::log(std::string source, LogLevel level, LogAudience audience, c
     }
 
     if (level >= logVerbosity_) {
-        // use remove if here to remove expired weak pointers while calling the loggers.
-        util::erase_remove_if(loggers_, [&](const std::weak_ptr<Logger>& logger) {
-            if (auto l = logger.lock()) {
-                l->log(source, level, audience, file, function, line, msg);
-                return false;
-            } else {
-                return true;
-            }
-        });
+        Record record{Record::Kind::Log, std::move(source), level, audience, orEmpty(file),
+                      orEmpty(function), line, std::move(msg)};
+        if (!enqueue(record)) {
+            // keep the order of any messages still in the queue
+            flush();
+            deliver(record);
+        }
     }
 
     switch (breakLevel_) {
@@ -140,14 +364,9 @@ void LogCentral::log(std::string source, LogLevel level, LogAudience audience, c
 void LogCentral::logProcessor(Processor* processor, LogLevel level, LogAudience audience,
                               std::string msg, const char* file, const char* function, int line) {
     if (level >= logVerbosity_) {
-        // use remove if here to remove expired weak pointers while calling the loggers.
-        util::erase_remove_if(loggers_, [&](const std::weak_ptr<Logger>& logger) {
-            if (auto l = logger.lock()) {
-                l->logProcessor(processor, level, audience, msg, file, function, line);
-                return false;
-            } else {
-                return true;
-            }
+        flush();
+        forEachLogger([&](Logger& l) {
+            l.logProcessor(processor, level, audience, msg, file, function, line);
         });
     }
 }
@@ -155,27 +374,18 @@ void LogCentral::logProcessor(Processor* processor, LogLevel level, LogAudience
 void LogCentral::logNetwork(LogLevel level, LogAudience audience, std::string msg, const char* file,
                             const char* function, int line) {
     if (level >= logVerbosity_) {
-        // use remove if here to remove expired weak pointers while calling the loggers.
-        util::erase_remove_if(loggers_, [&](const std::weak_ptr<Logger>& logger) {
-            if (auto l = logger.lock()) {
-                l->logNetwork(level, audience, msg, file, function, line);
-                return false;
-            } else {
-                return true;
-            }
-        });
+        Record record{Record::Kind::Network, "ProcessorNetwork", level, audience, orEmpty(file),
+                      orEmpty(function), line, std::move(msg)};
+        if (!enqueue(record)) {
+            flush();
+            deliver(record);
+        }
     }
 }
 
 void LogCentral::logAssertion(const char* file, const char* function, int line, std::string msg) {
-    util::erase_remove_if(loggers_, [&](const std::weak_ptr<Logger>& logger) {
-        if (auto l = logger.lock()) {
-            l->logAssertion(file, function, line, msg);
-            return false;
-        } else {
-            return true;
-        }
-    });
+    flush();
+    forEachLogger([&](Logger& l) { l.logAssertion(file, function, line, msg); });
 }
 
 void LogCentral::setLogStacktrace(const bool& logStacktrace) { logStacktrace_ = logStacktrace; }
@@ -41,6 +41,7 @@ SystemSettings::SystemSettings(InviwoApplication* app)
                              {"developerMode", "Developer Mode", UsageMode::Development}},
                             1)
     , poolSize_("poolSize", "Pool Size", defaultPoolSize(), 0, 32)
+    , concurrentEvaluation_("concurrentEvaluation", "Concurrent Network Evaluation", false)
     , enablePortInspectors_("enablePortInspectors", "Enable port inspectors", true)
     , portInspectorSize_("portInspectorSize", "Port inspector size", 128, 1, 1024)
 #if __APPLE__
@@ -51,6 +52,11 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     , enablePickingProperty_("enablePicking", "Enable picking", true)
     , enableSoundProperty_("enableSound", "Enable sound", true)
     , logStackTraceProperty_("logStackTraceProperty", "Error stack trace log", false)
+    , asyncLogging_("asyncLogging", "Asynchronous Logging", false)
+    , logOverflow_("logOverflow", "Full Log Queue",
+                   {{"block", "Wait for Room", LogOverflowPolicy::Block},
+                    {"drop", "Drop Messages", LogOverflowPolicy::Drop}},
+                   0)
     , runtimeModuleReloading_("runtimeModuleReloding", "Runtime Module Reloading", false)
     , enableResourceManager_("enableResourceManager", "Enable Resource Manager", false)
     , breakOnMessage_{"breakOnMessage",
@@ -66,12 +72,15 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     addProperty(workspaceAuthor_);
     addProperty(applicationUsageMode_);
     addProperty(poolSize_);
+    addProperty(concurrentEvaluation_);
     addProperty(enablePortInspectors_);
     addProperty(portInspectorSize_);
     addProperty(enableTouchProperty_);
     addProperty(enablePickingProperty_);
     addProperty(enableSoundProperty_);
     addProperty(logStackTraceProperty_);
+    addProperty(asyncLogging_);
+    addProperty(logOverflow_);
     addProperty(runtimeModuleReloading_);
     addProperty(enableResourceManager_);
     addProperty(breakOnMessage_);
@@ -83,6 +92,13 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     logStackTraceProperty_.onChange(
         [this]() { LogCentral::getPtr()->setLogStacktrace(logStackTraceProperty_.get()); });
 
+    logOverflow_.visibilityDependsOn(asyncLogging_, [](const BoolProperty& p) { return p.get(); });
+    const auto updateAsyncLogging = [this]() {
+        LogCentral::getPtr()->setAsync(asyncLogging_.get(), 4096, logOverflow_.get());
+    };
+    asyncLogging_.onChange(updateAsyncLogging);
+    logOverflow_.onChange(updateAsyncLogging);
+
     runtimeModuleReloading_.onChange([this]() {
         if (isDeserializing_) return;
         LogInfo("Inviwo needs to be restarted for Runtime Module Reloading change to take effect");
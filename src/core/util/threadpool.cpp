@@ -32,20 +32,66 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/threadutil.h>
 
+#include <chrono>
+
 namespace inviwo {
 
+namespace {
+// The pool and queue of the currently running worker thread, if any.
+thread_local ThreadPool* currentPool = nullptr;
+thread_local void* currentQueue = nullptr;
+}  // namespace
+
+bool ThreadPool::WorkQueue::pop(Task& task, Priority priority) {
+    const auto p = static_cast<size_t>(priority);
+    if (sizes[p].load(std::memory_order_relaxed) == 0) return false;
+    std::scoped_lock lock{mutex};
+    if (tasks[p].empty()) return false;
+    task = std::move(tasks[p].back());
+    tasks[p].pop_back();
+    sizes[p].store(tasks[p].size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::WorkQueue::steal(Task& task, Priority priority, bool wait) {
+    const auto p = static_cast<size_t>(priority);
+    if (sizes[p].load(std::memory_order_relaxed) == 0) return false;
+    std::unique_lock lock{mutex, std::defer_lock};
+    if (wait) {
+        lock.lock();
+    } else if (!lock.try_lock()) {
+        return false;
+    }
+    if (tasks[p].empty()) return false;
+    task = std::move(tasks[p].front());
+    tasks[p].pop_front();
+    sizes[p].store(tasks[p].size(), std::memory_order_relaxed);
+    return true;
+}
+
+void ThreadPool::WorkQueue::push(Task&& task, Priority priority, bool local) {
+    const auto p = static_cast<size_t>(priority);
+    std::scoped_lock lock{mutex};
+    if (local) {
+        tasks[p].push_back(std::move(task));
+    } else {
+        tasks[p].push_front(std::move(task));
+    }
+    sizes[p].store(tasks[p].size(), std::memory_order_relaxed);
+}
+
 // the constructor just launches some amount of workers
 ThreadPool::ThreadPool(size_t threads, std::function<void()> onThreadStart,
                        std::function<void()> onThreadStop)
     : onThreadStart_{std::move(onThreadStart)}, onThreadStop_{std::move(onThreadStop)} {
     while (workers.size() < threads) {
-        workers.push_back(std::make_unique<Worker>(*this));
+        workers.push_back(std::make_unique<Worker>(*this, acquireQueue()));
     }
 }
 
 size_t ThreadPool::trySetSize(size_t size) {
     while (workers.size() < size) {
-        workers.push_back(std::make_unique<Worker>(*this));
+        workers.push_back(std::make_unique<Worker>(*this, acquireQueue()));
     }
 
     if (workers.size() > size) {
@@ -60,7 +106,7 @@ size_t ThreadPool::trySetSize(size_t size) {
             if (active <= size) break;
         }
 
-        condition.notify_all();
+        notifyAll();
 
         util::erase_remove_if(
             workers, [](std::unique_ptr<Worker>& worker) { return worker->state == State::Done; });
@@ -70,41 +116,144 @@ size_t ThreadPool::trySetSize(size_t size) {
 
 size_t ThreadPool::getSize() const { return workers.size(); }
 
-size_t ThreadPool::getQueueSize() {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    return tasks.size();
-}
+size_t ThreadPool::getQueueSize() { return pending_.load(); }
+
+bool ThreadPool::isWorkerThread() const { return currentPool == this; }
 
 ThreadPool::~ThreadPool() {
     for (auto& worker : workers) worker->state = State::Abort;
-    condition.notify_all();
+    notifyAll();
     workers.clear();  // this will join all threads.
 }
 
-ThreadPool::Worker::~Worker() { thread.join(); }
+ThreadPool::WorkQueue& ThreadPool::acquireQueue() {
+    const auto nQueues = nQueues_.load();
+    for (size_t i = 0; i < nQueues; ++i) {
+        auto queue = queues_[i].load();
+        auto expected = false;
+        if (queue->owned.compare_exchange_strong(expected, true)) return *queue;
+    }
+    if (nQueues < maxQueues) {
+        auto& queue = ownedQueues_.emplace_back(std::make_unique<WorkQueue>());
+        queue->owned = true;
+        queues_[nQueues] = queue.get();
+        nQueues_ = nQueues + 1;
+        return *queue;
+    }
+    // More workers than queues, let the new worker share a queue.
+    return *queues_[workers.size() % maxQueues].load();
+}
+
+void ThreadPool::push(Task&& task, Priority priority) {
+    // Count the task before it is published, a worker could otherwise pop it and decrement
+    // pending_ before it was incremented.
+    pending_.fetch_add(1);
+    if (currentPool == this) {
+        static_cast<WorkQueue*>(currentQueue)->push(std::move(task), priority, true);
+    } else {
+        const auto nQueues = nQueues_.load();
+        const auto index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % nQueues;
+        queues_[index].load()->push(std::move(task), priority, false);
+    }
+    notifyOne();
+}
+
+bool ThreadPool::tryPop(WorkQueue* own, Task& task) {
+    if (pending_.load() == 0) return false;
 
-ThreadPool::Worker::Worker(ThreadPool& pool)
-    : state{State::Free}, thread{[this, &pool]() {
+    const auto nQueues = nQueues_.load();
+    const auto start = nextQueue_.load(std::memory_order_relaxed);
+    // The first sweep skips queues locked by other threads. If that misses all pending tasks,
+    // sweep again waiting for the locks, otherwise contention would leave us spinning.
+    for (const bool wait : {false, true}) {
+        for (size_t p = 0; p < nPriorities; ++p) {
+            const auto priority = static_cast<Priority>(p);
+            if (own && own->pop(task, priority)) {
+                pending_.fetch_sub(1);
+                return true;
+            }
+            for (size_t i = 0; i < nQueues; ++i) {
+                auto queue = queues_[(start + i) % nQueues].load();
+                if (queue != own && queue->steal(task, priority, wait)) {
+                    pending_.fetch_sub(1);
+                    return true;
+                }
+            }
+        }
+        if (pending_.load() == 0) break;
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    if (currentPool != this) return false;
+    Task task;
+    if (!tryPop(static_cast<WorkQueue*>(currentQueue), task)) return false;
+    try {
+        task();
+    } catch (...) {  // Make sure we don't leak any exceptions.
+    }
+    return true;
+}
+
+void ThreadPool::notifyOne() {
+    if (sleeping_.load() > 0) {
+        std::scoped_lock lock{sleep_mutex};
+        condition.notify_one();
+    }
+}
+
+void ThreadPool::notifyAll() {
+    std::scoped_lock lock{sleep_mutex};
+    condition.notify_all();
+}
+
+ThreadPool::Worker::~Worker() {
+    thread.join();
+    queue.owned = false;
+}
+
+ThreadPool::Worker::Worker(ThreadPool& pool, WorkQueue& aQueue)
+    : state{State::Free}, queue{aQueue}, thread{[this, &pool]() {
+        currentPool = &pool;
+        currentQueue = &queue;
         pool.onThreadStart_();
-        util::OnScopeExit cleanup{[&pool]() { pool.onThreadStop_(); }};
+        util::OnScopeExit cleanup{[&pool]() {
+            pool.onThreadStop_();
+            currentPool = nullptr;
+            currentQueue = nullptr;
+        }};
 
         for (;;) {
-            std::function<void()> task;
-            state = State::Free;
-            {
-                std::unique_lock<std::mutex> lock(pool.queue_mutex);
-                pool.condition.wait(lock, [this, &pool] {
-                    return state == State::Abort || state == State::Stop || !pool.tasks.empty();
-                });
-                if (state == State::Abort || (state == State::Stop && pool.tasks.empty())) break;
-                task = std::move(pool.tasks.front());
-                pool.tasks.pop();
+            Task task;
+            if (pool.tryPop(&queue, task)) {
+                auto expected = State::Free;
+                state.compare_exchange_strong(expected, State::Working);
+                try {
+                    task();
+                } catch (...) {  // Make sure we don't leak any exceptions.
+                }
+                expected = State::Working;
+                state.compare_exchange_strong(expected, State::Free);
+                continue;
             }
-            state = State::Working;
-            try {
-                task();
-            } catch (...) {  // Make sure we don't leak any exceptions.
+
+            if (state == State::Abort || (state == State::Stop && pool.pending_ == 0)) break;
+
+            if (pool.pending_ > 0) {
+                // The task is counted but push has not published it yet, or another worker took
+                // it and has not decremented the count. The wait below would return right away,
+                // so yield to the other thread instead of spinning.
+                std::this_thread::yield();
+                continue;
             }
+
+            std::unique_lock<std::mutex> lock(pool.sleep_mutex);
+            ++pool.sleeping_;
+            pool.condition.wait(lock, [this, &pool] {
+                return state == State::Abort || state == State::Stop || pool.pending_ > 0;
+            });
+            --pool.sleeping_;
         }
         state = State::Done;
     }} {
@@ -112,14 +261,53 @@ ThreadPool::Worker::Worker(ThreadPool& pool)
     util::setThreadDescription(thread, "Inviwo Worker Thread");
 }
 
-void ThreadPool::enqueueRaw(std::function<void()> task) {
+void ThreadPool::enqueueRaw(Task task, Priority priority) {
     if (workers.empty()) {
         task();  // No worker threads, just run the task.
     } else {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace(std::move(task));
+        push(std::move(task), priority);
+    }
+}
+
+ThreadPool::TaskGroup::TaskGroup(ThreadPool& pool) : pool_{pool}, pending_{0} {}
+
+ThreadPool::TaskGroup::~TaskGroup() { waitForTasks(); }
+
+void ThreadPool::TaskGroup::finish(std::exception_ptr e) {
+    std::scoped_lock lock{mutex_};
+    if (e && !exception_) exception_ = e;
+    if (--pending_ == 0) done_.notify_all();
+}
+
+void ThreadPool::TaskGroup::waitForTasks() {
+    if (pool_.isWorkerThread()) {
+        // Help out with pending tasks while waiting, otherwise we might end up in a deadlock when
+        // all workers are waiting for their children.
+        for (;;) {
+            {
+                std::scoped_lock lock{mutex_};
+                if (pending_ == 0) return;
+            }
+            if (!pool_.runPendingTask()) {
+                std::unique_lock<std::mutex> lock{mutex_};
+                done_.wait_for(lock, std::chrono::microseconds{100},
+                               [this]() { return pending_ == 0; });
+            }
+        }
+    } else {
+        std::unique_lock<std::mutex> lock{mutex_};
+        done_.wait(lock, [this]() { return pending_ == 0; });
+    }
+}
+
+void ThreadPool::TaskGroup::wait() {
+    waitForTasks();
+    std::exception_ptr e;
+    {
+        std::scoped_lock lock{mutex_};
+        std::swap(e, exception_);
     }
-    condition.notify_one();
+    if (e) std::rethrow_exception(e);
 }
 
 }  // namespace inviwo
@@ -348,6 +348,7 @@ QRectF NetworkEditor::getProcessorsBoundingRect() const {
 }
 
 std::string NetworkEditor::getMimeTag() { return "application/x.vnd.inviwo.network+xml"; }
+std::string NetworkEditor::getBinaryMimeTag() { return "application/x.vnd.inviwo.network"; }
 
 ProcessorGraphicsItem* NetworkEditor::getProcessorGraphicsItemAt(const QPointF pos) const {
     return getGraphicsItemAt<ProcessorGraphicsItem>(pos);
@@ -692,21 +693,13 @@ void NetworkEditor::contextMenuEvent(QGraphicsSceneContextMenuEvent* e) {
         auto cutAction = menu.addAction(QIcon(":/svgicons/edit-cut.svg"), tr("Cu&t"));
         cutAction->setEnabled(clickedProcessor || selectedItems().size() > 0);
         connect(cutAction, &QAction::triggered, this, [this]() {
-            auto data = cut();
-            auto mimedata = std::make_unique<QMimeData>();
-            mimedata->setData(utilqt::toQString(getMimeTag()), data);
-            mimedata->setData(QString("text/plain"), data);
-            QApplication::clipboard()->setMimeData(mimedata.release());
+            QApplication::clipboard()->setMimeData(cut().release());
         });
 
         auto copyAction = menu.addAction(QIcon(":/svgicons/edit-copy.svg"), tr("&Copy"));
         copyAction->setEnabled(clickedProcessor || selectedItems().size() > 0);
         connect(copyAction, &QAction::triggered, this, [this]() {
-            auto data = copy();
-            auto mimedata = std::make_unique<QMimeData>();
-            mimedata->setData(utilqt::toQString(getMimeTag()), data);
-            mimedata->setData(QString("text/plain"), data);
-            QApplication::clipboard()->setMimeData(mimedata.release());
+            QApplication::clipboard()->setMimeData(copy().release());
         });
 
         auto pasteAction = menu.addAction(QIcon(":/svgicons/edit-paste.svg"), tr("&Paste"));
@@ -722,7 +715,9 @@ void NetworkEditor::contextMenuEvent(QGraphicsSceneContextMenuEvent* e) {
         connect(pasteAction, &QAction::triggered, this, [this]() {
             auto clipboard = QApplication::clipboard();
             auto mimeData = clipboard->mimeData();
-            if (mimeData->formats().contains(utilqt::toQString(getMimeTag()))) {
+            if (mimeData->formats().contains(utilqt::toQString(getBinaryMimeTag()))) {
+                paste(mimeData->data(utilqt::toQString(getBinaryMimeTag())));
+            } else if (mimeData->formats().contains(utilqt::toQString(getMimeTag()))) {
                 paste(mimeData->data(utilqt::toQString(getMimeTag())));
             } else if (mimeData->formats().contains(QString("text/plain"))) {
                 paste(mimeData->data(QString("text/plain")));
@@ -802,8 +797,7 @@ void NetworkEditor::deleteItems(QList<QGraphicsItem*> items) {
     });
 }
 
-QByteArray NetworkEditor::copy() const {
-    std::stringstream ss;
+std::unique_ptr<QMimeData> NetworkEditor::copy() const {
     std::vector<ProcessorGraphicsItem*> items;
     for (auto& item : clickedOnItems_) {
         if (auto processor = qgraphicsitem_cast<ProcessorGraphicsItem*>(item)) {
@@ -814,18 +808,31 @@ QByteArray NetworkEditor::copy() const {
         }
     }
 
-    util::serializeSelected(network_, ss, "");
-    auto str = ss.str();
-    QByteArray byteArray(str.c_str(), static_cast<int>(str.length()));
+    Serializer serializer("");
+    util::serializeSelected(network_, serializer);
+
+    const auto toByteArray = [&](SerializationFormat format) {
+        std::stringstream ss;
+        serializer.writeFile(ss, format);
+        auto str = ss.str();
+        return QByteArray(str.c_str(), static_cast<int>(str.length()));
+    };
+    // The binary format is faster to paste, the xml is kept for other applications
+    auto mimedata = std::make_unique<QMimeData>();
+    mimedata->setData(utilqt::toQString(getBinaryMimeTag()),
+                      toByteArray(SerializationFormat::Binary));
+    const auto xml = toByteArray(SerializationFormat::Xml);
+    mimedata->setData(utilqt::toQString(getMimeTag()), xml);
+    mimedata->setData(QString("text/plain"), xml);
 
     for (auto& item : items) item->setSelected(false);
 
     pastePos_.first = false;
 
-    return byteArray;
+    return mimedata;
 }
 
-QByteArray NetworkEditor::cut() {
+std::unique_ptr<QMimeData> NetworkEditor::cut() {
     auto res = copy();
     deleteSelection();
     return res;
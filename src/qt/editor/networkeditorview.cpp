@@ -139,27 +139,23 @@ NetworkEditorView::NetworkEditorView(NetworkEditor* networkEditor, InviwoMainWin
             switch (t) {
                 case MenuItemType::cut: {
                     if (editor_->selectedItems().empty()) return;
-                    auto data = editor_->cut();
-                    auto mimedata = std::make_unique<QMimeData>();
-                    mimedata->setData(utilqt::toQString(NetworkEditor::getMimeTag()), data);
-                    mimedata->setData(QString("text/plain"), data);
-                    QApplication::clipboard()->setMimeData(mimedata.release());
+                    QApplication::clipboard()->setMimeData(editor_->cut().release());
                     return;
                 }
                 case MenuItemType::copy: {
                     if (editor_->selectedItems().empty()) return;
-                    auto data = editor_->copy();
-                    auto mimedata = std::make_unique<QMimeData>();
-                    mimedata->setData(utilqt::toQString(NetworkEditor::getMimeTag()), data);
-                    mimedata->setData(QString("text/plain"), data);
-                    QApplication::clipboard()->setMimeData(mimedata.release());
+                    QApplication::clipboard()->setMimeData(editor_->copy().release());
                     return;
                 }
                 case MenuItemType::paste: {
                     auto clipboard = QApplication::clipboard();
                     auto mimeData = clipboard->mimeData();
                     if (mimeData->formats().contains(
-                            utilqt::toQString(NetworkEditor::getMimeTag()))) {
+                            utilqt::toQString(NetworkEditor::getBinaryMimeTag()))) {
+                        editor_->paste(
+                            mimeData->data(utilqt::toQString(NetworkEditor::getBinaryMimeTag())));
+                    } else if (mimeData->formats().contains(
+                                   utilqt::toQString(NetworkEditor::getMimeTag()))) {
                         editor_->paste(
                             mimeData->data(utilqt::toQString(NetworkEditor::getMimeTag())));
                     } else if (mimeData->formats().contains(QString("text/plain"))) {
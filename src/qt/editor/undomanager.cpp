@@ -33,6 +33,9 @@
 #include <inviwo/qt/editor/undomanager.h>
 #include <inviwo/core/util/raiiutils.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/io/serialization/serializationexception.h>
+#include <inviwo/core/io/serialization/ticpp.h>
 #include <inviwo/qt/applicationbase/inviwoapplicationqt.h>
 
 #include <warn/push>
@@ -86,8 +89,22 @@ public:
                 }
 
                 if (str) {
+                    // Undo states are binary, but the file on disk is kept as xml
+                    std::string xml;
+                    try {
+                        std::istringstream binary{*str};
+                        TxDocument doc;
+                        util::readBinaryDocument(binary, doc);
+                        TiXmlPrinter printer;
+                        printer.SetIndent("    ");
+                        doc.Accept(&printer);
+                        xml = printer.Str();
+                    } catch (const SerializationException&) {
+                        continue;
+                    }
+
                     auto ofstream = filesystem::ofstream(path_ + "/autosave.inv.tmp");
-                    ofstream << *str;
+                    ofstream << xml;
                     filesystem::copyFile(path_ + "/autosave.inv.tmp", path_ + "/autosave.inv");
                 }
             }